@@ -17,6 +17,9 @@ save_event(size_t thread_id,
 )
 {
     const size_t id = next_id_.fetch_add(1, std::memory_order_relaxed);
+    if (id >= rows_.size()) {
+        return {false, id};   // store full (e.g. a warm start left no headroom)
+    }
 
     // Direct reference into the pre-sized + pre-reserved row slot.
     // Strings already have capacity reserved at construction; we write straight into them (no per-event alloc).
@@ -69,7 +72,7 @@ save_event(size_t thread_id,
 
     // (no rows_[id] = move; we wrote directly into the slot)
 
-    if (persistence_writer_) {
+    if (persistence_writer_ || sharded_writer_) {
         const auto& stored = rows_[id];
 
         PersistedEvent pe;
@@ -88,7 +91,11 @@ save_event(size_t thread_id,
         pe.int_metrics.assign(stored.int_metrics.begin(), stored.int_metrics.end());
         pe.dbl_metrics.assign(stored.dbl_metrics.begin(), stored.dbl_metrics.end());
 
-        persistence_writer_->submit_event(std::move(pe));
+        if (persistence_writer_) {
+            persistence_writer_->submit_event(std::move(pe));
+        } else {
+            sharded_writer_->submit_event(std::move(pe));
+        }
     }
 
     return {true, id};
@@ -23,6 +23,28 @@ struct TestOptions {
     size_t events_per_thread = 4000;
     size_t runs = 50;
     std::string test_size;  // "smoke" | "full" (optional profile selector)
+    // Persistence thread placement (forwarded as TS_STORE_PERSIST_* / TS_STORE_IO_* env, see ThreadPlacement.hpp)
+    std::string persist_cpus;   // e.g. "2-3"
+    std::string persist_sched;  // other | batch | idle | fifo | rr
+    std::string persist_prio;   // fifo / rr static priority (1..99)
+    std::string persist_nice;
+    std::string io_cpus;
+    std::string io_sched;
+    std::string io_prio;
+    std::string io_nice;
+    // Adaptive writer batch size (TS_STORE_PERSIST_ADAPTIVE / _BATCH_MIN / _BATCH_MAX)
+    bool persist_adaptive = false;
+    std::string persist_batch_min;
+    std::string persist_batch_max;
+    // Rolling binary log segments (TS_STORE_SEGMENT_BYTES / TS_STORE_RETAIN_SEGMENTS)
+    std::string segment_bytes;
+    std::string retain_segments;
+    // File output backend (TS_STORE_FILE_OUTPUT: mmap | pwritev | io_uring | direct)
+    std::string file_output;
+    // Binary record encoding (TS_STORE_BINARY_ENCODING: raw | compact)
+    std::string binary_encoding;
+    // Binary log Bloom filters (TS_STORE_BINARY_BLOOM: none | category | tokens)
+    std::string binary_bloom;
 };
 
 inline TestOptions parse_test_options(int argc, char** argv) {
@@ -77,6 +99,38 @@ inline TestOptions parse_test_options(int argc, char** argv) {
             opts.test_size = (arg + 12);
         } else if (std::strcmp(arg, "--test-size") == 0 && (i + 1) < argc) {
             opts.test_size = argv[++i];
+        } else if (std::strncmp(arg, "--persist-cpus=", 15) == 0) {
+            opts.persist_cpus = (arg + 15);
+        } else if (std::strncmp(arg, "--persist-sched=", 16) == 0) {
+            opts.persist_sched = (arg + 16);
+        } else if (std::strncmp(arg, "--persist-prio=", 15) == 0) {
+            opts.persist_prio = (arg + 15);
+        } else if (std::strncmp(arg, "--persist-nice=", 15) == 0) {
+            opts.persist_nice = (arg + 15);
+        } else if (std::strncmp(arg, "--io-cpus=", 10) == 0) {
+            opts.io_cpus = (arg + 10);
+        } else if (std::strncmp(arg, "--io-sched=", 11) == 0) {
+            opts.io_sched = (arg + 11);
+        } else if (std::strncmp(arg, "--io-prio=", 10) == 0) {
+            opts.io_prio = (arg + 10);
+        } else if (std::strncmp(arg, "--io-nice=", 10) == 0) {
+            opts.io_nice = (arg + 10);
+        } else if (std::strcmp(arg, "--persist-adaptive") == 0) {
+            opts.persist_adaptive = true;
+        } else if (std::strncmp(arg, "--persist-batch-min=", 20) == 0) {
+            opts.persist_batch_min = (arg + 20);
+        } else if (std::strncmp(arg, "--persist-batch-max=", 20) == 0) {
+            opts.persist_batch_max = (arg + 20);
+        } else if (std::strncmp(arg, "--segment-bytes=", 16) == 0) {
+            opts.segment_bytes = (arg + 16);
+        } else if (std::strncmp(arg, "--retain-segments=", 18) == 0) {
+            opts.retain_segments = (arg + 18);
+        } else if (std::strncmp(arg, "--file-output=", 14) == 0) {
+            opts.file_output = (arg + 14);
+        } else if (std::strncmp(arg, "--binary-encoding=", 18) == 0) {
+            opts.binary_encoding = (arg + 18);
+        } else if (std::strncmp(arg, "--binary-bloom=", 15) == 0) {
+            opts.binary_bloom = (arg + 15);
         }
     }
 
@@ -89,6 +143,22 @@ inline TestOptions parse_test_options(int argc, char** argv) {
     if (color_set) {
         setenv("TS_STORE_COLOR", opts.color ? "1" : "0", 1);
     }
+    if (!opts.persist_cpus.empty())  setenv("TS_STORE_PERSIST_CPUS", opts.persist_cpus.c_str(), 1);
+    if (!opts.persist_sched.empty()) setenv("TS_STORE_PERSIST_SCHED", opts.persist_sched.c_str(), 1);
+    if (!opts.persist_prio.empty())  setenv("TS_STORE_PERSIST_PRIO", opts.persist_prio.c_str(), 1);
+    if (!opts.persist_nice.empty())  setenv("TS_STORE_PERSIST_NICE", opts.persist_nice.c_str(), 1);
+    if (!opts.io_cpus.empty())       setenv("TS_STORE_IO_CPUS", opts.io_cpus.c_str(), 1);
+    if (!opts.io_sched.empty())      setenv("TS_STORE_IO_SCHED", opts.io_sched.c_str(), 1);
+    if (!opts.io_prio.empty())       setenv("TS_STORE_IO_PRIO", opts.io_prio.c_str(), 1);
+    if (!opts.io_nice.empty())       setenv("TS_STORE_IO_NICE", opts.io_nice.c_str(), 1);
+    if (opts.persist_adaptive)       setenv("TS_STORE_PERSIST_ADAPTIVE", "1", 1);
+    if (!opts.persist_batch_min.empty()) setenv("TS_STORE_PERSIST_BATCH_MIN", opts.persist_batch_min.c_str(), 1);
+    if (!opts.persist_batch_max.empty()) setenv("TS_STORE_PERSIST_BATCH_MAX", opts.persist_batch_max.c_str(), 1);
+    if (!opts.segment_bytes.empty())     setenv("TS_STORE_SEGMENT_BYTES", opts.segment_bytes.c_str(), 1);
+    if (!opts.retain_segments.empty())   setenv("TS_STORE_RETAIN_SEGMENTS", opts.retain_segments.c_str(), 1);
+    if (!opts.file_output.empty())       setenv("TS_STORE_FILE_OUTPUT", opts.file_output.c_str(), 1);
+    if (!opts.binary_encoding.empty())   setenv("TS_STORE_BINARY_ENCODING", opts.binary_encoding.c_str(), 1);
+    if (!opts.binary_bloom.empty())      setenv("TS_STORE_BINARY_BLOOM", opts.binary_bloom.c_str(), 1);
 
     // Apply test-size profile if specified (smoke for quick/SSD-safe ~100 records, full for high intensity)
     if (opts.test_size == "smoke") {
@@ -0,0 +1,314 @@
+#pragma once
+
+// ArrowIpcEventSink.hpp
+// IEventSink that writes <base>.arrow, an Arrow IPC file (Feather v2): one record batch per
+// write_batch, columns transposed straight from the PersistedEvent rows. pyarrow / polars /
+// DuckDB / R arrow can memory-map the file and use the columns in place, with no parsing.
+//
+// Columns (non-nullable, same names as the CSV transcoder):
+//   event_id, thread_id, per_thread_event_id, flags_raw   uint64
+//   category, payload                                     utf8
+//   timestamp_us                                          uint64 (µs since the store's epoch base)
+//   ints                                                  fixed_size_list<int64>[int_count]  (if int_count > 0)
+//   dbls                                                  fixed_size_list<double>[dbl_count] (if dbl_count > 0)
+// Missing metrics are stored as 0, extra ones dropped. Every buffer starts on a 64-byte file
+// offset. utf8 offsets are int32, so a batch whose strings exceed 2 GiB is split.
+//
+// The footer is written by finalize(); until then everything after the 8-byte magic is a valid
+// Arrow IPC stream, which stream readers can still load after a crash.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "ArrowIpcFormat.hpp"
+#include "EventSink.hpp"
+#include "PersistCommon.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+struct ArrowIpcEventSinkStats {
+    size_t rows_written = 0;
+    size_t record_batches = 0;
+    size_t truncated = 0;            // rows with more metrics than int_count / dbl_count
+    uint64_t bytes_written = 0;
+};
+
+class ArrowIpcEventSink : public IEventSink {
+public:
+    ArrowIpcEventSink(std::string_view base_name,
+                      size_t int_count,
+                      size_t dbl_count,
+                      PersistMode mode = PersistMode::All)
+        : int_count_(int_count),
+          dbl_count_(dbl_count),
+          mode_(mode)
+    {
+        if (int_count_ > 0x7FFFFFFF || dbl_count_ > 0x7FFFFFFF) {
+            throw std::runtime_error("ArrowIpcEventSink: metric count exceeds the int32 list size");
+        }
+        for (const char* column : {"event_id", "thread_id", "per_thread_event_id", "flags_raw"}) {
+            fields_.push_back(field(column, ArrowTypeId::Int));
+        }
+        fields_.push_back(field("category", ArrowTypeId::Utf8));
+        fields_.push_back(field("payload", ArrowTypeId::Utf8));
+        fields_.push_back(field("timestamp_us", ArrowTypeId::Int));
+        if (int_count_ > 0) {
+            ArrowField item = field("item", ArrowTypeId::Int);
+            item.is_signed = true;
+            fields_.push_back(list_field("ints", int_count_, std::move(item)));
+        }
+        if (dbl_count_ > 0) {
+            fields_.push_back(list_field("dbls", dbl_count_, field("item", ArrowTypeId::FloatingPoint)));
+        }
+
+        file_path_ = std::string(base_name) + ".arrow";
+        fd_ = ::open(file_path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            throw std::runtime_error("ArrowIpcEventSink: failed to open " + file_path_);
+        }
+        try {
+            std::string head(8, '\0');
+            std::memcpy(head.data(), kArrowIpcMagic, sizeof(kArrowIpcMagic));
+            write_bytes(head);
+            write_message(arrow_schema_message(fields_), {});
+        } catch (...) {
+            ::close(fd_);
+            fd_ = -1;
+            throw;
+        }
+    }
+
+    ~ArrowIpcEventSink() override {
+        try { finalize(); } catch (...) {}
+    }
+
+    ArrowIpcEventSink(const ArrowIpcEventSink&) = delete;
+    ArrowIpcEventSink& operator=(const ArrowIpcEventSink&) = delete;
+
+    void write_batch(std::span<const PersistedEvent> batch) override {
+        if (fd_ < 0) return;
+
+        rows_.clear();
+        for (const auto& e : batch) {
+            if (mode_ == PersistMode::KeeperOnly) {
+                if ((e.flags & KEEPER_BIT) == 0) continue;
+            } else if (mode_ == PersistMode::DatabaseOnly) {
+                continue;
+            }
+            rows_.push_back(&e);
+        }
+
+        // Cut where either string column would overflow its int32 offsets.
+        constexpr size_t kMaxStringBytes = std::numeric_limits<int32_t>::max();
+        size_t begin = 0;
+        while (begin < rows_.size()) {
+            size_t end = begin;
+            size_t cat_bytes = 0;
+            size_t pay_bytes = 0;
+            while (end < rows_.size()) {
+                const PersistedEvent& e = *rows_[end];
+                if (end > begin && (cat_bytes + e.category.size() > kMaxStringBytes ||
+                                    pay_bytes + e.payload.size() > kMaxStringBytes)) {
+                    break;
+                }
+                cat_bytes += e.category.size();
+                pay_bytes += e.payload.size();
+                ++end;
+            }
+            if (cat_bytes > kMaxStringBytes || pay_bytes > kMaxStringBytes) {
+                throw std::runtime_error("ArrowIpcEventSink: string exceeds 2 GiB");
+            }
+            write_record_batch(std::span(rows_).subspan(begin, end - begin), cat_bytes, pay_bytes);
+            begin = end;
+        }
+    }
+
+    // Every batch is written by write_batch; nothing is buffered in the sink.
+    void flush() override {}
+
+    void sync() override {
+        if (fd_ >= 0 && ::fdatasync(fd_) != 0) {
+            throw std::runtime_error("ArrowIpcEventSink: fdatasync failed on " + file_path_);
+        }
+    }
+
+    // End-of-stream marker, footer, trailing magic; closes the file.
+    void finalize() override {
+        if (fd_ < 0) return;
+        const int fd = fd_;
+        try {
+            std::string tail(8, '\0');
+            std::memcpy(tail.data(), &kArrowIpcContinuation, 4);
+            const std::string footer = arrow_footer(fields_, blocks_);
+            tail += footer;
+            const auto footer_len = static_cast<int32_t>(footer.size());
+            tail.append(reinterpret_cast<const char*>(&footer_len), 4);
+            tail.append(kArrowIpcMagic, sizeof(kArrowIpcMagic));
+            write_bytes(tail);
+        } catch (...) {
+            fd_ = -1;
+            ::close(fd);
+            throw;
+        }
+        fd_ = -1;
+        if (::close(fd) != 0) {
+            throw std::runtime_error("ArrowIpcEventSink: close failed on " + file_path_);
+        }
+    }
+
+    std::string_view name() const override { return "ArrowIpcEventSink"; }
+
+    const std::string& file_path() const { return file_path_; }
+    const ArrowIpcEventSinkStats& stats() const { return stats_; }
+
+private:
+    static ArrowField field(std::string column, ArrowTypeId type) {
+        ArrowField f;
+        f.name = std::move(column);
+        f.type = type;
+        return f;
+    }
+
+    static ArrowField list_field(std::string column, size_t size, ArrowField item) {
+        ArrowField f = field(std::move(column), ArrowTypeId::FixedSizeList);
+        f.list_size = static_cast<int32_t>(size);
+        f.children.push_back(std::move(item));
+        return f;
+    }
+
+    static size_t padded(size_t n) { return (n + kArrowIpcAlignment - 1) & ~(kArrowIpcAlignment - 1); }
+
+    void write_bytes(std::string_view bytes) {
+        size_t done = 0;
+        while (done < bytes.size()) {
+            const ssize_t n = ::write(fd_, bytes.data() + done, bytes.size() - done);
+            if (n < 0) throw std::runtime_error("ArrowIpcEventSink: write failed on " + file_path_);
+            done += static_cast<size_t>(n);
+        }
+        offset_ += bytes.size();
+        stats_.bytes_written += bytes.size();
+    }
+
+    // Continuation marker + length + metadata, padded so the body starts 64-byte aligned; then the
+    // body. Returns the footer block for it.
+    ArrowBlock write_message(const std::string& metadata, std::string_view body) {
+        const size_t start = offset_;
+        std::string head(8, '\0');
+        head += metadata;
+        head.resize(padded(start + head.size()) - start, '\0');
+        const auto meta_len = static_cast<int32_t>(head.size() - 8);
+        std::memcpy(head.data(), &kArrowIpcContinuation, 4);
+        std::memcpy(head.data() + 4, &meta_len, 4);
+        write_bytes(head);
+        write_bytes(body);
+        return ArrowBlock{static_cast<int64_t>(start), static_cast<int32_t>(head.size()), 0,
+                          static_cast<int64_t>(body.size())};
+    }
+
+    void write_record_batch(std::span<const PersistedEvent* const> rows, size_t cat_bytes, size_t pay_bytes) {
+        const size_t n = rows.size();
+        nodes_.clear();
+        buffers_.clear();
+        size_t body_len = 0;
+        // Node for a column plus its (empty) validity buffer and `sizes` data buffers.
+        auto column = [&](size_t length, std::initializer_list<size_t> sizes) {
+            nodes_.push_back({static_cast<int64_t>(length), 0});
+            buffers_.push_back({static_cast<int64_t>(body_len), 0});
+            for (size_t s : sizes) {
+                buffers_.push_back({static_cast<int64_t>(body_len), static_cast<int64_t>(s)});
+                body_len += padded(s);
+            }
+        };
+        for (int i = 0; i < 4; ++i) column(n, {n * 8});
+        column(n, {(n + 1) * 4, cat_bytes});
+        column(n, {(n + 1) * 4, pay_bytes});
+        column(n, {n * 8});
+        if (int_count_ > 0) {
+            column(n, {});
+            column(n * int_count_, {n * int_count_ * 8});
+        }
+        if (dbl_count_ > 0) {
+            column(n, {});
+            column(n * dbl_count_, {n * dbl_count_ * 8});
+        }
+
+        body_.assign(body_len, '\0');
+        auto at = [&](size_t buffer) { return body_.data() + buffers_[buffer].offset; };
+        char* ids = at(1);
+        char* threads = at(3);
+        char* per_thread = at(5);
+        char* flags = at(7);
+        char* cat_off = at(9);
+        char* cat_data = at(10);
+        char* pay_off = at(12);
+        char* pay_data = at(13);
+        char* ts = at(15);
+        char* ints = int_count_ > 0 ? at(18) : nullptr;
+        char* dbls = dbl_count_ > 0 ? at(int_count_ > 0 ? 21 : 18) : nullptr;
+
+        int32_t cat_pos = 0;
+        int32_t pay_pos = 0;
+        std::memcpy(cat_off, &cat_pos, 4);
+        std::memcpy(pay_off, &pay_pos, 4);
+        for (size_t r = 0; r < n; ++r) {
+            const PersistedEvent& e = *rows[r];
+            const uint64_t id = e.event_id;
+            const uint64_t thread = e.thread_id;
+            const uint64_t ptid = e.per_thread_event_id;
+            std::memcpy(ids + r * 8, &id, 8);
+            std::memcpy(threads + r * 8, &thread, 8);
+            std::memcpy(per_thread + r * 8, &ptid, 8);
+            std::memcpy(flags + r * 8, &e.flags, 8);
+            std::memcpy(ts + r * 8, &e.timestamp_us, 8);
+
+            std::memcpy(cat_data + cat_pos, e.category.data(), e.category.size());
+            cat_pos += static_cast<int32_t>(e.category.size());
+            std::memcpy(cat_off + (r + 1) * 4, &cat_pos, 4);
+            std::memcpy(pay_data + pay_pos, e.payload.data(), e.payload.size());
+            pay_pos += static_cast<int32_t>(e.payload.size());
+            std::memcpy(pay_off + (r + 1) * 4, &pay_pos, 4);
+
+            const size_t ic = std::min(e.int_metrics.size(), int_count_);
+            const size_t dc = std::min(e.dbl_metrics.size(), dbl_count_);
+            if (ic != 0) std::memcpy(ints + r * int_count_ * 8, e.int_metrics.data(), ic * 8);
+            if (dc != 0) std::memcpy(dbls + r * dbl_count_ * 8, e.dbl_metrics.data(), dc * 8);
+            if (ic != e.int_metrics.size() || dc != e.dbl_metrics.size()) ++stats_.truncated;
+        }
+
+        const std::string metadata = arrow_record_batch_message(static_cast<int64_t>(n), nodes_, buffers_,
+                                                                static_cast<int64_t>(body_len));
+        blocks_.push_back(write_message(metadata, body_));
+        stats_.rows_written += n;
+        ++stats_.record_batches;
+    }
+
+    size_t int_count_;
+    size_t dbl_count_;
+    PersistMode mode_;
+    std::vector<ArrowField> fields_;
+    std::string file_path_;
+    int fd_ = -1;
+    uint64_t offset_ = 0;
+    std::vector<ArrowBlock> blocks_;
+    ArrowIpcEventSinkStats stats_{};
+
+    // Reused per batch.
+    std::vector<const PersistedEvent*> rows_;
+    std::vector<ArrowFieldNode> nodes_;
+    std::vector<ArrowBufferRef> buffers_;
+    std::string body_;
+};
+
+} // namespace jac::ts_store::inline_v001
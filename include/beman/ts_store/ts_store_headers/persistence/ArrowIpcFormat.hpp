@@ -0,0 +1,277 @@
+#pragma once
+
+// ArrowIpcFormat.hpp
+// Just enough of the Apache Arrow IPC file format (columnar spec, metadata version V5) to write
+// record batches without libarrow: a minimal FlatBuffers builder plus the Schema, RecordBatch and
+// Footer tables ArrowIpcEventSink needs.
+//
+// File layout:
+//   "ARROW1\0\0"
+//   Schema message
+//   RecordBatch message ...        each: 0xFFFFFFFF, int32 metadata length, Message flatbuffer
+//                                  (padded), then the body (buffers, each padded to 64 bytes)
+//   0xFFFFFFFF 0x00000000          end-of-stream marker
+//   Footer flatbuffer              schema again + (offset, metadata length, body length) per batch
+//   int32 footer length, "ARROW1"
+//
+// Only the types the event schema uses are modelled (Int, FloatingPoint, Utf8, FixedSizeList),
+// all columns non-nullable, so every validity buffer is empty. Little-endian hosts only, like the
+// binary log format.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace jac::ts_store::inline_v001 {
+
+inline constexpr char kArrowIpcMagic[6] = {'A', 'R', 'R', 'O', 'W', '1'};
+inline constexpr size_t kArrowIpcAlignment = 64;      // body buffers and message starts
+inline constexpr uint32_t kArrowIpcContinuation = 0xFFFFFFFFu;
+
+enum class ArrowTypeId : uint8_t { Int = 2, FloatingPoint = 3, Utf8 = 5, FixedSizeList = 16 };
+
+// One schema column. FixedSizeList columns carry their element type as the single child.
+struct ArrowField {
+    std::string name;
+    ArrowTypeId type = ArrowTypeId::Int;
+    int32_t bit_width = 64;          // Int
+    bool is_signed = false;          // Int
+    int32_t list_size = 0;           // FixedSizeList
+    std::vector<ArrowField> children;
+};
+
+// Flatbuffer structs (fixed layout, stored inline in vectors).
+struct ArrowFieldNode {
+    int64_t length;
+    int64_t null_count;
+};
+
+struct ArrowBufferRef {
+    int64_t offset;                  // from the start of the message body
+    int64_t length;
+};
+
+struct ArrowBlock {
+    int64_t offset;                  // file offset of the message's continuation marker
+    int32_t metadata_length;         // marker + length prefix + padded flatbuffer
+    int32_t padding;
+    int64_t body_length;
+};
+
+static_assert(sizeof(ArrowFieldNode) == 16 && sizeof(ArrowBufferRef) == 16 && sizeof(ArrowBlock) == 24);
+
+namespace detail {
+    // Back-to-front FlatBuffers builder, as in the reference implementation: children are written
+    // before their parents, so every offset points towards the end of the buffer. A Ref is an
+    // object's distance from the end. No vtable sharing; scalars are always stored.
+    class FlatBufferBuilder {
+    public:
+        using Ref = uint32_t;
+
+        Ref string(std::string_view s) {
+            align(s.size() + 1, 4);
+            const char nul = '\0';
+            prepend(&nul, 1);
+            prepend(s.data(), s.size());
+            prepend_scalar(static_cast<uint32_t>(s.size()));
+            return size();
+        }
+
+        template <class T>
+        Ref struct_vector(std::span<const T> items) {
+            const size_t bytes = items.size_bytes();
+            align(bytes, 4);
+            align(bytes, alignof(T));
+            prepend(items.data(), bytes);
+            prepend_scalar(static_cast<uint32_t>(items.size()));
+            return size();
+        }
+
+        Ref offset_vector(std::span<const Ref> refs) {
+            align(refs.size() * 4, 4);
+            for (size_t i = refs.size(); i-- > 0;) prepend_offset(refs[i]);
+            prepend_scalar(static_cast<uint32_t>(refs.size()));
+            return size();
+        }
+
+        void start_table() {
+            fields_.clear();
+            table_start_ = size();
+        }
+
+        template <class T>
+        void add_scalar(uint16_t field, T value) {
+            align(sizeof(T), sizeof(T));
+            prepend_scalar(value);
+            fields_.emplace_back(field, size());
+        }
+
+        void add_offset(uint16_t field, Ref ref) {
+            align(4, 4);
+            prepend_offset(ref);
+            fields_.emplace_back(field, size());
+        }
+
+        Ref end_table() {
+            align(4, 4);
+            prepend_scalar(int32_t{0});            // soffset to the vtable, patched below
+            const Ref table = size();
+
+            uint16_t slots = 0;
+            for (const auto& f : fields_) slots = std::max<uint16_t>(slots, static_cast<uint16_t>(f.first + 1));
+            std::vector<uint16_t> vtable(2 + size_t{slots}, 0);
+            vtable[0] = static_cast<uint16_t>(vtable.size() * 2);
+            vtable[1] = static_cast<uint16_t>(table - table_start_);
+            for (const auto& [id, at] : fields_) vtable[2 + size_t{id}] = static_cast<uint16_t>(table - at);
+            prepend(vtable.data(), vtable.size() * 2);
+
+            const auto soffset = static_cast<int32_t>(size() - table);
+            std::memcpy(buf_.data() + (buf_.size() - table), &soffset, sizeof(soffset));
+            return table;
+        }
+
+        // Root offset in front; returns the finished buffer.
+        std::string finish(Ref root) {
+            align(4, max_align_);
+            prepend_offset(root);
+            return std::string(reinterpret_cast<const char*>(buf_.data() + head_), size());
+        }
+
+    private:
+        Ref size() const { return static_cast<Ref>(buf_.size() - head_); }
+
+        void prepend(const void* src, size_t n) {
+            if (head_ < n) {
+                const size_t used = size();
+                std::vector<uint8_t> grown(std::max<size_t>(2 * buf_.size(), used + n + 256));
+                std::memcpy(grown.data() + grown.size() - used, buf_.data() + head_, used);
+                head_ = grown.size() - used;
+                buf_ = std::move(grown);
+            }
+            head_ -= n;
+            if (n != 0) std::memcpy(buf_.data() + head_, src, n);
+        }
+
+        template <class T>
+        void prepend_scalar(T v) { prepend(&v, sizeof(v)); }
+
+        // uoffset: distance from the field itself to the target.
+        void prepend_offset(Ref target) {
+            prepend_scalar(static_cast<uint32_t>(size() + 4 - target));
+        }
+
+        // Pad so that `n` more bytes end on an `alignment` boundary.
+        void align(size_t n, size_t alignment) {
+            max_align_ = std::max(max_align_, alignment);
+            static constexpr uint8_t zeros[8] = {};
+            prepend(zeros, (alignment - (size() + n) % alignment) % alignment);
+        }
+
+        std::vector<uint8_t> buf_;
+        size_t head_ = 0;
+        size_t max_align_ = 1;
+        Ref table_start_ = 0;
+        std::vector<std::pair<uint16_t, Ref>> fields_;
+    };
+
+    // Message.header union / MetadataVersion values from Message.fbs / Schema.fbs.
+    inline constexpr uint8_t kArrowHeaderSchema = 1;
+    inline constexpr uint8_t kArrowHeaderRecordBatch = 3;
+    inline constexpr int16_t kArrowMetadataV5 = 4;
+
+    inline FlatBufferBuilder::Ref arrow_field(FlatBufferBuilder& fb, const ArrowField& f) {
+        std::vector<FlatBufferBuilder::Ref> children;
+        for (const ArrowField& c : f.children) children.push_back(arrow_field(fb, c));
+        const auto children_ref = fb.offset_vector(children);
+        const auto name_ref = fb.string(f.name);
+
+        fb.start_table();
+        switch (f.type) {
+        case ArrowTypeId::Int:
+            fb.add_scalar<int32_t>(0, f.bit_width);
+            fb.add_scalar<uint8_t>(1, f.is_signed ? 1 : 0);
+            break;
+        case ArrowTypeId::FloatingPoint:
+            fb.add_scalar<int16_t>(0, 2);          // Precision::DOUBLE
+            break;
+        case ArrowTypeId::FixedSizeList:
+            fb.add_scalar<int32_t>(0, f.list_size);
+            break;
+        case ArrowTypeId::Utf8:
+            break;
+        }
+        const auto type_ref = fb.end_table();
+
+        fb.start_table();
+        fb.add_offset(0, name_ref);
+        fb.add_scalar<uint8_t>(1, 0);              // nullable = false
+        fb.add_scalar<uint8_t>(2, static_cast<uint8_t>(f.type));
+        fb.add_offset(3, type_ref);
+        fb.add_offset(5, children_ref);
+        return fb.end_table();
+    }
+
+    inline FlatBufferBuilder::Ref arrow_schema(FlatBufferBuilder& fb, std::span<const ArrowField> fields) {
+        std::vector<FlatBufferBuilder::Ref> refs;
+        for (const ArrowField& f : fields) refs.push_back(arrow_field(fb, f));
+        const auto fields_ref = fb.offset_vector(refs);
+        fb.start_table();
+        fb.add_scalar<int16_t>(0, 0);              // Endianness::Little
+        fb.add_offset(1, fields_ref);
+        return fb.end_table();
+    }
+
+    inline std::string arrow_message(FlatBufferBuilder& fb, uint8_t header_type,
+                                     FlatBufferBuilder::Ref header, int64_t body_length) {
+        fb.start_table();
+        fb.add_scalar<int16_t>(0, kArrowMetadataV5);
+        fb.add_scalar<uint8_t>(1, header_type);
+        fb.add_offset(2, header);
+        fb.add_scalar<int64_t>(3, body_length);
+        return fb.finish(fb.end_table());
+    }
+}
+
+// Schema message flatbuffer.
+inline std::string arrow_schema_message(std::span<const ArrowField> fields) {
+    detail::FlatBufferBuilder fb;
+    const auto schema = detail::arrow_schema(fb, fields);
+    return detail::arrow_message(fb, detail::kArrowHeaderSchema, schema, 0);
+}
+
+// RecordBatch message flatbuffer: nodes and buffers in schema pre-order.
+inline std::string arrow_record_batch_message(int64_t length,
+                                              std::span<const ArrowFieldNode> nodes,
+                                              std::span<const ArrowBufferRef> buffers,
+                                              int64_t body_length) {
+    detail::FlatBufferBuilder fb;
+    const auto buffers_ref = fb.struct_vector(buffers);
+    const auto nodes_ref = fb.struct_vector(nodes);
+    fb.start_table();
+    fb.add_scalar<int64_t>(0, length);
+    fb.add_offset(1, nodes_ref);
+    fb.add_offset(2, buffers_ref);
+    return detail::arrow_message(fb, detail::kArrowHeaderRecordBatch, fb.end_table(), body_length);
+}
+
+// Footer flatbuffer (not wrapped in a Message).
+inline std::string arrow_footer(std::span<const ArrowField> fields, std::span<const ArrowBlock> batches) {
+    detail::FlatBufferBuilder fb;
+    const auto batches_ref = fb.struct_vector(batches);
+    const auto dictionaries_ref = fb.struct_vector(std::span<const ArrowBlock>{});
+    const auto schema = detail::arrow_schema(fb, fields);
+    fb.start_table();
+    fb.add_scalar<int16_t>(0, detail::kArrowMetadataV5);
+    fb.add_offset(1, schema);
+    fb.add_offset(2, dictionaries_ref);
+    fb.add_offset(3, batches_ref);
+    return fb.finish(fb.end_table());
+}
+
+} // namespace jac::ts_store::inline_v001
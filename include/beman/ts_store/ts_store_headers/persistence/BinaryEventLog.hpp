@@ -4,6 +4,41 @@
 // Blazing-fast binary persistence for ts_store (non-debug path).
 // Uses length-prefixed records for maximum speed and safety.
 // This is the "production" writer. jText remains the debug/human-readable path.
+//
+// Format v2 (BinaryLogFormat.hpp): after the // text header come a magic/version header and a
+// schema block, then records grouped into blocks, each with a header carrying record count,
+// byte size, CRC32C and id/timestamp ranges. A block closes when it reaches block_bytes, at the
+// end of every sink batch (end_block) and on flush/sync/finalize, so synced data is always framed.
+//
+// Seek index (BinaryLogIndex.hpp): every closed block adds an entry (offset, id/time range, flag
+// OR); finalize() appends them as a footer so readers can seek without decoding the file.
+//
+// Compression (BinaryCompression / TS_STORE_BINARY_COMPRESSION): each closed block is compressed
+// on the calling (writer) thread and stored compressed when that saves space; readers decode it
+// transparently. The mmap path compresses the block in place over its raw records.
+//
+// Record encoding (BinaryRecordEncoding / TS_STORE_BINARY_ENCODING): Compact re-encodes each closed
+// block with per-field deltas, varints, XOR-coded doubles and a block dictionary for categories and
+// payloads (CompactRecords.hpp) before any compression; records are still appended in the fixed
+// v1 layout, so the hot path is unchanged.
+//
+// Bloom filters (BinaryBloomFilters / TS_STORE_BINARY_BLOOM): each closed block also gets a filter
+// over its categories (and payload words), built from the raw records on the writer thread and
+// written with the index footer (BinaryLogBloom.hpp), so readers skip blocks that cannot hold a
+// given category or word.
+//
+// Output path (FileOutputBackend): Mmap (default) encodes straight into a fixed-size mapped window
+// that slides along the file (SlidingMmapWindow.hpp: extents fallocated and the next window
+// prefaulted in the background, written windows synced and released), so the cost per event does
+// not grow with the file.
+// Pwritev / IoUring encode into PipelinedFileWriter buffers that a dedicated I/O thread writes
+// (io_uring: registered buffers, batched submissions, fsync linked behind the writes). Direct
+// stages blocks the same way but hands them to a DirectFileWriter (O_DIRECT, aligned and
+// double-buffered, final page padded), keeping the log out of the page cache.
+//
+// Live commit (LiveBinaryLog.hpp): after every batch the mmap path stores the end of the last
+// complete block in the file header, so LiveBinaryLogReader can follow the file from another
+// process while it grows.
 
 #include <string>
 #include <string_view>
@@ -19,15 +54,26 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <cerrno>
+#include <memory>
 #include <stdexcept>
 
+#include "BinaryLogBloom.hpp"
+#include "BinaryLogFormat.hpp"
+#include "BinaryLogIndex.hpp"
+#include "BlockCompression.hpp"
+#include "CompactRecords.hpp"
+#include "DirectFileWriter.hpp"
+#include "LiveBinaryLog.hpp"
 #include "PersistCommon.hpp"
+#include "PipelinedFileWriter.hpp"
+#include "SlidingMmapWindow.hpp"
 
 namespace jac::ts_store::inline_v001 {
 
 namespace detail {
     // Helper (binary has no jText dep) to emit the required // header at file start.
-    inline size_t write_binary_file_header(int fd, std::string_view full_path) {
+    inline std::string binary_file_header(std::string_view full_path,
+                                          std::string_view purpose = "Binary Data File") {
         auto now = std::chrono::system_clock::now();
         auto today = std::chrono::floor<std::chrono::days>(now);
         std::string date_str = std::format("{:%Y-%m-%d}", today);
@@ -35,20 +81,61 @@ namespace detail {
         std::string h;
         h += std::format("//File:    {}\n", full_path);
         h += std::format("//Date:    {}\n", date_str);
-        h += "//Purpose: Binary Data File\n";
+        h += std::format("//Purpose: {}\n", purpose);
         h += "//\n";
+        return h;
+    }
+
+    // binary_file_header with the closing "//" line padded so the v2 preamble that follows starts
+    // 8-byte aligned (its live commit fields are updated with atomic stores, LiveBinaryLog.hpp).
+    inline std::string binary_log_text_header(std::string_view full_path) {
+        std::string h = binary_file_header(full_path);
+        h.insert(h.size() - 1, (8 - h.size() % 8) % 8, ' ');
+        return h;
+    }
+
+    inline size_t write_binary_file_header(int fd, std::string_view full_path) {
+        const std::string h = binary_log_text_header(full_path);
         const ssize_t written = ::write(fd, h.data(), h.size());
         if (written < 0 || static_cast<size_t>(written) != h.size()) {
             throw std::runtime_error("BinaryEventLog: header write failed");
         }
         return h.size();
     }
+
+    // File header + schema block that follow the text header in a v2 log.
+    inline std::string binary_log_preamble(size_t int_count, size_t dbl_count, size_t block_bytes) {
+        const auto now_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        const BinaryLogFileHeader fh = make_binary_log_file_header(static_cast<uint32_t>(block_bytes),
+                                                                   static_cast<uint64_t>(now_us));
+        const BinaryLogSchema schema = make_binary_log_schema(int_count, dbl_count);
+        std::string out(sizeof(fh) + sizeof(schema), '\0');
+        std::memcpy(out.data(), &fh, sizeof(fh));
+        std::memcpy(out.data() + sizeof(fh), &schema, sizeof(schema));
+        return out;
+    }
 }
 
+inline constexpr size_t kDefaultBinaryBlockBytes = 1 << 20;
+// Largest encoded record: length prefix, five u64s, four u16 counts, 64 KiB category and payload,
+// 65535 ints and doubles.
+inline constexpr size_t kMaxBinaryRecordBytes = sizeof(uint32_t) + 5 * sizeof(uint64_t) + 4 * sizeof(uint16_t) +
+                                                2 * 65535 + 65535 * (sizeof(int64_t) + sizeof(double));
+
 struct BinaryEventLogStats {
     size_t rows_written = 0;
     size_t bytes_written = 0;
     size_t flushes = 0;
+    size_t syncs = 0;
+    size_t blocks = 0;
+    size_t compressed_blocks = 0;
+    size_t compact_blocks = 0;       // blocks stored with the compact record encoding
+    size_t block_raw_bytes = 0;      // v1 record bytes closed into blocks
+    size_t block_stored_bytes = 0;   // what those blocks occupy on disk (without headers)
+    size_t window_slides = 0;        // mmap: window moves / those that waited for the next window
+    size_t window_stalls = 0;
+    size_t bloom_bytes = 0;          // Bloom filter section written by finalize()
 };
 
 class BinaryEventLog {
@@ -57,14 +144,45 @@ public:
                    size_t int_count,
                    size_t dbl_count,
                    PersistMode mode = PersistMode::All,
-                   size_t internal_buffer_size = 64 * 1024 * 1024)
+                   size_t internal_buffer_size = 64 * 1024 * 1024,
+                   FileOutputBackend output = FileOutputBackend::Default,
+                   BinaryCompression compression = BinaryCompression::Default,
+                   size_t block_bytes = kDefaultBinaryBlockBytes,
+                   BinaryRecordEncoding encoding = BinaryRecordEncoding::Default,
+                   BinaryBloomFilters bloom = BinaryBloomFilters::Default)
         : mode_(mode),
           int_count_(int_count),
           dbl_count_(dbl_count),
-          buffer_size_(internal_buffer_size)
+          buffer_size_(internal_buffer_size),
+          block_bytes_(block_bytes == 0 ? kDefaultBinaryBlockBytes : block_bytes),
+          codec_(resolve_block_codec(compression)),
+          compact_(resolve_compact_records(encoding)),
+          bloom_(resolve_bloom_keys(bloom))
     {
+        const std::string preamble = detail::binary_log_preamble(int_count_, dbl_count_, block_bytes_);
         file_path_ = std::string(base_name) + ".bin";
 
+        output = resolve_file_output_backend(output);
+        if (output == FileOutputBackend::Pwritev || output == FileOutputBackend::IoUring ||
+            output == FileOutputBackend::Direct) {
+            if (output == FileOutputBackend::Direct) {
+                direct_ = std::make_unique<DirectFileWriter>(file_path_);
+                output_ = output;
+            } else {
+                PipelinedIoOptions io_opts;
+                io_opts.backend = output;
+                pipe_ = std::make_unique<PipelinedFileWriter>(file_path_, std::make_shared<PipelinedIo>(io_opts));
+                output_ = pipe_->io()->backend();
+            }
+            const std::string h = detail::binary_log_text_header(file_path_);
+            header_offset_ = h.size();
+            stream_write(h.data(), h.size());
+            stream_write(preamble.data(), preamble.size());
+            write_pos_ = h.size() + preamble.size();
+            block_buf_.reserve(block_bytes_ + sizeof(BinaryBlockHeader));
+            return;
+        }
+
         fd_ = ::open(file_path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
         if (fd_ < 0) {
             throw std::runtime_error("BinaryEventLog: failed to open " + file_path_);
@@ -72,24 +190,28 @@ public:
 
         // Write standardized // header comments first (per requirement for ALL persist files)
         size_t header_size = detail::write_binary_file_header(fd_, file_path_);
-
-        // Pre-allocate (mmap covers header prefix + data area)
-        size_t initial_map = buffer_size_ + header_size + 4096;
-        ::posix_fallocate(fd_, 0, static_cast<off_t>(initial_map));
-
-        mapped_ = static_cast<char*>(::mmap(nullptr, initial_map, PROT_READ | PROT_WRITE,
-                                            MAP_SHARED, fd_, 0));
-        if (mapped_ == MAP_FAILED) {
+        header_offset_ = header_size;
+        if (::write(fd_, preamble.data(), preamble.size()) != static_cast<ssize_t>(preamble.size())) {
             ::close(fd_);
-            throw std::runtime_error("BinaryEventLog: mmap failed");
+            throw std::runtime_error("BinaryEventLog: header write failed");
         }
+        header_size += preamble.size();
 
+        // internal_buffer_size = window size; it must hold an open block plus one record twice over.
+        try {
+            window_ = std::make_unique<SlidingMmapWindow>(
+                fd_, buffer_size_, sizeof(BinaryBlockHeader) + block_bytes_ + kMaxBinaryRecordBytes);
+        } catch (...) {
+            ::close(fd_);
+            throw;
+        }
         write_pos_ = header_size;
-        file_size_ = initial_map;
+        live_.open(file_path_, header_offset_);
+        publish_commit();
     }
 
     ~BinaryEventLog() {
-        finalize();
+        try { finalize(); } catch (...) {}   // call finalize() to see the error
     }
 
     void append_event(size_t event_id,
@@ -103,7 +225,6 @@ public:
                       const std::vector<double>& dbls)
     {
         if (mode_ == PersistMode::KeeperOnly) {
-            constexpr uint64_t KEEPER_BIT = 1ULL << 1;
             if ((raw_flags & KEEPER_BIT) == 0) return;
         } else if (mode_ == PersistMode::DatabaseOnly) {
             return;
@@ -117,71 +238,139 @@ public:
 
         size_t needed = sizeof(uint32_t) + record_size;
 
-        if (write_pos_ + needed > file_size_) {
-            size_t new_size = file_size_ * 2;
-            if (::ftruncate(fd_, static_cast<off_t>(new_size)) != 0) {
-                throw std::runtime_error("BinaryEventLog: ftruncate failed");
-            }
-            ::munmap(mapped_, file_size_);
-            mapped_ = static_cast<char*>(::mmap(nullptr, new_size, PROT_READ | PROT_WRITE,
-                                                MAP_SHARED, fd_, 0));
-            if (mapped_ == MAP_FAILED) {
-                throw std::runtime_error("BinaryEventLog: remap failed");
-            }
-            file_size_ = new_size;
+        if (streamed()) {
+            // Stage into the block; close_block() hands header + records to the output stream.
+            const size_t at = block_buf_.size();
+            block_buf_.resize(at + needed);
+            encode_record(block_buf_.data() + at, record_size, event_id, thread_id, per_thread_event_id,
+                          raw_flags, category, payload, timestamp_us, ints, dbls);
+            note_block_record(event_id, raw_flags, timestamp_us);
+            stats_.rows_written++;
+            stats_.bytes_written += needed;
+            if (block_buf_.size() >= block_bytes_) close_block();
+            return;
         }
 
-        // Write length + data directly into mapped memory (very fast)
-        uint32_t len = static_cast<uint32_t>(record_size);
-        std::memcpy(mapped_ + write_pos_, &len, sizeof(len));
-        write_pos_ += sizeof(len);
-
-        auto w64 = [&](uint64_t v) { std::memcpy(mapped_ + write_pos_, &v, sizeof(v)); write_pos_ += sizeof(v); };
-
-        w64(event_id);
-        w64(thread_id);
-        w64(per_thread_event_id);
-        w64(raw_flags);
-        w64(timestamp_us);
-
-        uint16_t cl = static_cast<uint16_t>(category.size());
-        std::memcpy(mapped_ + write_pos_, &cl, sizeof(cl)); write_pos_ += sizeof(cl);
-        if (!category.empty()) { std::memcpy(mapped_ + write_pos_, category.data(), cl); write_pos_ += cl; }
+        const size_t open_cost = block_open_ ? 0 : sizeof(BinaryBlockHeader);
+        window_->ensure(block_open_ ? block_start_ : write_pos_, write_pos_ + open_cost + needed);
 
-        uint16_t pl = static_cast<uint16_t>(payload.size());
-        std::memcpy(mapped_ + write_pos_, &pl, sizeof(pl)); write_pos_ += sizeof(pl);
-        if (!payload.empty()) { std::memcpy(mapped_ + write_pos_, payload.data(), pl); write_pos_ += pl; }
-
-        uint16_t ic = static_cast<uint16_t>(ints.size());
-        std::memcpy(mapped_ + write_pos_, &ic, sizeof(ic)); write_pos_ += sizeof(ic);
-        if (!ints.empty()) { std::memcpy(mapped_ + write_pos_, ints.data(), ints.size()*sizeof(int64_t)); write_pos_ += ints.size()*sizeof(int64_t); }
+        if (!block_open_) {   // header slot; filled in by close_block()
+            block_start_ = write_pos_;
+            write_pos_ += sizeof(BinaryBlockHeader);
+            block_open_ = true;
+        }
 
-        uint16_t dc = static_cast<uint16_t>(dbls.size());
-        std::memcpy(mapped_ + write_pos_, &dc, sizeof(dc)); write_pos_ += sizeof(dc);
-        if (!dbls.empty()) { std::memcpy(mapped_ + write_pos_, dbls.data(), dbls.size()*sizeof(double)); write_pos_ += dbls.size()*sizeof(double); }
+        // Write length + data directly into mapped memory (very fast)
+        encode_record(window_->at(write_pos_), record_size, event_id, thread_id, per_thread_event_id,
+                      raw_flags, category, payload, timestamp_us, ints, dbls);
+        write_pos_ += needed;
+        note_block_record(event_id, raw_flags, timestamp_us);
 
         stats_.rows_written++;
         stats_.bytes_written += sizeof(uint32_t) + record_size;
+        if (write_pos_ - block_start_ - sizeof(BinaryBlockHeader) >= block_bytes_) close_block();
+    }
+
+    // Close the open block (no-op when empty). BinaryEventSink calls this after every batch, which
+    // also publishes the new committed length to live readers (mmap output).
+    void end_block() {
+        close_block();
+        if (!streamed()) publish_commit();
     }
 
     void flush() {
-        if (mapped_ && write_pos_ > 0) {
-            ::msync(mapped_, write_pos_, MS_ASYNC);
+        close_block();
+        if (streamed()) {
+            // queue for the I/O thread, like MS_ASYNC does not wait
+            if (pipe_) pipe_->hand_off();
+            else direct_->hand_off();
+            stats_.flushes++;
+            return;
+        }
+        if (window_) {
+            window_->flush(write_pos_, false);
+            publish_commit();
             stats_.flushes++;
         }
     }
 
+    // Durable flush: write back the current window and wait for the whole file (plus size metadata).
+    void sync() {
+        close_block();
+        if (streamed()) {
+            if (pipe_) pipe_->sync();
+            else direct_->sync();
+            publish_commit();   // written by the I/O thread: only now safe to announce
+            stats_.syncs++;
+            return;
+        }
+        if (window_) {
+            window_->flush(write_pos_, true);
+            publish_commit();
+        }
+        if (fd_ >= 0) {
+            ::fdatasync(fd_);
+            stats_.syncs++;
+        }
+    }
+
     void finalize() {
         if (finalized_) return;
-        if (mapped_) {
-            ::msync(mapped_, write_pos_, MS_SYNC);
-            ::munmap(mapped_, file_size_);
-            mapped_ = nullptr;
+        if (!footer_written_) {
+            close_block();
+            if (window_) {   // unmap before the footer is written and the file is cut to length
+                window_->close(write_pos_);
+                const SlidingMmapWindowStats ws = window_->stats();
+                stats_.window_slides = ws.slides;
+                stats_.window_stalls = ws.stalls;
+                if (ws.slides != 0) {
+                    persist_report("mmap_window=" + std::to_string(window_->window_bytes()) +
+                                   " slides=" + std::to_string(ws.slides) +
+                                   " stalls=" + std::to_string(ws.stalls));
+                }
+                window_.reset();
+            }
+            blocks_end_ = write_pos_;
+            write_index_footer();
+            footer_written_ = true;   // a retry after a failed ftruncate below only truncates again
+            if (codec_ != BlockCodec::None || compact_) {
+                persist_report("binary_codec=" + std::string(block_codec_name(codec_)) +
+                               " encoding=" + std::string(compact_ ? "compact" : "raw") +
+                               " blocks=" + std::to_string(stats_.blocks) +
+                               " compressed_blocks=" + std::to_string(stats_.compressed_blocks) +
+                               " compact_blocks=" + std::to_string(stats_.compact_blocks) +
+                               " block_raw_bytes=" + std::to_string(stats_.block_raw_bytes) +
+                               " block_stored_bytes=" + std::to_string(stats_.block_stored_bytes));
+            }
+            if (stats_.bloom_bytes != 0) {
+                persist_report("binary_bloom=" + std::string((bloom_.keys() & kBloomKeyTokens) != 0 ? "tokens" : "category") +
+                               " filters=" + std::to_string(index_.size()) +
+                               " bloom_bytes=" + std::to_string(stats_.bloom_bytes));
+            }
+        }
+        if (pipe_) {
+            finalized_ = true;
+            pipe_->close();
+            publish_commit(blocks_end_, true);
+            live_.close();
+            return;
+        }
+        if (direct_) {
+            finalized_ = true;
+            direct_->close();
+            const DirectFileWriterStats ds = direct_->stats();
+            persist_report("direct_io=" + std::string(direct_->direct() ? "1" : "0") +
+                           " writes=" + std::to_string(ds.writes) +
+                           " padded_writes=" + std::to_string(ds.padded_writes) +
+                           " encoder_stalls=" + std::to_string(ds.encoder_stalls));
+            return;
         }
         if (fd_ >= 0) {
             if (::ftruncate(fd_, static_cast<off_t>(write_pos_)) != 0) {
                 throw std::runtime_error("BinaryEventLog: finalize ftruncate failed");
             }
+            publish_commit(blocks_end_, true);
+            live_.close();
             ::close(fd_);
             fd_ = -1;
         }
@@ -190,19 +379,217 @@ public:
 
     [[nodiscard]] const BinaryEventLogStats& stats() const { return stats_; }
     [[nodiscard]] const std::string& file_path() const { return file_path_; }
+    // Effective output path (after TS_STORE_FILE_OUTPUT and io_uring fallback).
+    [[nodiscard]] FileOutputBackend output_backend() const { return output_; }
+    [[nodiscard]] size_t block_bytes() const { return block_bytes_; }
+    // File length once finalized: header + closed blocks + the open block so far.
+    [[nodiscard]] size_t bytes_on_disk() const { return write_pos_; }
+    // Effective block codec (after TS_STORE_BINARY_COMPRESSION and library availability).
+    [[nodiscard]] BlockCodec compression() const { return codec_; }
+    // Effective record encoding (after TS_STORE_BINARY_ENCODING).
+    [[nodiscard]] bool compact_records() const { return compact_; }
+    // Bloom filter keys being built (kBloomKeyCategory | kBloomKeyTokens; 0 = none).
+    [[nodiscard]] uint16_t bloom_keys() const { return bloom_.keys(); }
+    // Seek index entries of the blocks closed so far (written as the footer by finalize()).
+    [[nodiscard]] const std::vector<BinaryIndexEntry>& index_entries() const { return index_; }
+    // Commits published to live readers (LiveBinaryLogReader); 0 for Direct output.
+    [[nodiscard]] size_t live_commits() const { return live_.commits(); }
 
 private:
+    // Bloom filters + entries + footer after the last block (BinaryLogIndex.hpp). Mmap: written
+    // with pwrite once the window is closed, so a large index never has to fit the window.
+    void write_index_footer() {
+        if (!streamed() && fd_ < 0) return;
+        std::string bloom;
+        if (bloom_.enabled() && bloom_.filter_count() == index_.size()) {
+            bloom = bloom_.section();
+            if (bloom.size() > UINT32_MAX) {   // footer field is 32-bit: readers will scan every block
+                persist_report("binary_bloom=skipped bytes=" + std::to_string(bloom.size()));
+                bloom.clear();
+            }
+        }
+        const BinaryIndexFooter f = make_index_footer(index_, write_pos_ + bloom.size(),
+                                                      static_cast<uint32_t>(bloom.size()));
+        const size_t entries_bytes = index_.size() * sizeof(BinaryIndexEntry);
+        stats_.bloom_bytes = bloom.size();
+        if (streamed()) {
+            if (!bloom.empty()) stream_write(bloom.data(), bloom.size());
+            if (entries_bytes != 0) stream_write(index_.data(), entries_bytes);
+            stream_write(&f, sizeof(f));
+        } else {
+            std::string tail = std::move(bloom);
+            const size_t at = tail.size();
+            tail.resize(at + entries_bytes + sizeof(f));
+            if (entries_bytes != 0) std::memcpy(tail.data() + at, index_.data(), entries_bytes);
+            std::memcpy(tail.data() + at + entries_bytes, &f, sizeof(f));
+            for (size_t done = 0; done < tail.size();) {
+                const ssize_t n = ::pwrite(fd_, tail.data() + done, tail.size() - done,
+                                           static_cast<off_t>(write_pos_ + done));
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) throw std::runtime_error("BinaryEventLog: index footer write failed");
+                done += static_cast<size_t>(n);
+            }
+        }
+        write_pos_ += stats_.bloom_bytes + entries_bytes + sizeof(f);
+    }
+
+    // Live commit marker (LiveBinaryLog.hpp). Mmap: records are in the page cache as soon as they
+    // are encoded, so every closed batch is announced. Pwritev / IoUring: only after sync(), once
+    // the I/O thread has written them. Direct bypasses the page cache and never announces; live
+    // readers fall back to validating blocks by CRC.
+    void publish_commit() { publish_commit(write_pos_, false); }
+
+    void publish_commit(size_t committed, bool closed) {
+        if (direct_) return;
+        if (!live_.is_open() && !live_.open(file_path_, header_offset_)) return;
+        live_.publish(committed, closed);
+    }
+
+    // Pwritev / IoUring / Direct: records are staged in block_buf_ and streamed block by block.
+    [[nodiscard]] bool streamed() const { return pipe_ || direct_; }
+
+    void stream_write(const void* data, size_t n) {
+        if (pipe_) pipe_->write(data, n);
+        else direct_->write(data, n);
+    }
+
+    void note_block_record(size_t event_id, uint64_t raw_flags, uint64_t timestamp_us) {
+        if (block_.record_count == 0) {
+            block_.first_event_id = event_id;
+            block_.min_timestamp_us = block_.max_timestamp_us = timestamp_us;
+            block_min_id_ = block_max_id_ = event_id;
+        }
+        if (event_id < block_min_id_) block_min_id_ = event_id;
+        if (event_id > block_max_id_) block_max_id_ = event_id;
+        ++block_.record_count;
+        block_.last_event_id = event_id;
+        if (timestamp_us < block_.min_timestamp_us) block_.min_timestamp_us = timestamp_us;
+        if (timestamp_us > block_.max_timestamp_us) block_.max_timestamp_us = timestamp_us;
+        block_.flags_or |= raw_flags;
+    }
+
+    // Fill in and emit the header of the open block. Mmap: the header slot precedes the records
+    // in the mapping and is written last. Pipelined: header + staged records go out together.
+    void close_block() {
+        if (block_.record_count == 0) return;
+
+        BinaryBlockHeader h = block_;
+        h.magic = kBinaryBlockMagic;
+        h.codec = static_cast<uint16_t>(BlockCodec::None);
+
+        char* raw = streamed() ? block_buf_.data() : window_->at(block_start_ + sizeof(BinaryBlockHeader));
+        const size_t raw_size = streamed() ? block_buf_.size() : write_pos_ - block_start_ - sizeof(BinaryBlockHeader);
+        if (bloom_.enabled()) {   // before the raw records are overwritten
+            bloom_.add_records(raw, raw_size);
+            bloom_.end_block();
+        }
+        const char* stored = raw;
+        size_t stored_size = raw_size;
+        if (compact_ && compact_encode_records(raw, raw_size, compacted_)) {
+            h.codec = kBlockCompactRecords | kBlockStringDictionary;
+            stored = compacted_.data();
+            stored_size = compacted_.size();
+            stats_.compact_blocks++;
+        }
+        h.raw_bytes = static_cast<uint32_t>(stored_size);   // codec input
+        if (codec_ != BlockCodec::None && compress_block(codec_, stored, stored_size, packed_)) {
+            h.codec = static_cast<uint16_t>(h.codec | static_cast<uint16_t>(codec_));
+            stored = packed_.data();
+            stored_size = packed_.size();
+            stats_.compressed_blocks++;
+        }
+        h.stored_bytes = static_cast<uint32_t>(stored_size);
+        h.crc32c = crc32c(stored, stored_size);
+        seal_block_header(h);
+        index_.push_back(make_index_entry(streamed() ? write_pos_ : block_start_, h, block_min_id_, block_max_id_));
+
+        if (streamed()) {
+            stream_write(&h, sizeof(h));
+            stream_write(stored, stored_size);
+            write_pos_ += sizeof(h) + stored_size;
+            block_buf_.clear();
+        } else {
+            if (stored != raw) {   // compact / compressed: overwrite the raw records, give back the tail
+                std::memcpy(raw, stored, stored_size);
+                write_pos_ = block_start_ + sizeof(BinaryBlockHeader) + stored_size;
+            }
+            std::memcpy(window_->at(block_start_), &h, sizeof(h));
+            block_open_ = false;
+        }
+        stats_.bytes_written += sizeof(h);
+        stats_.blocks++;
+        stats_.block_raw_bytes += raw_size;
+        stats_.block_stored_bytes += stored_size;
+        block_ = BinaryBlockHeader{};
+    }
+
+    static void encode_record(char* dst, size_t record_size,
+                              size_t event_id, size_t thread_id, size_t per_thread_event_id,
+                              uint64_t raw_flags, std::string_view category, std::string_view payload,
+                              uint64_t timestamp_us,
+                              const std::vector<int64_t>& ints, const std::vector<double>& dbls)
+    {
+        uint32_t len = static_cast<uint32_t>(record_size);
+        std::memcpy(dst, &len, sizeof(len));
+        dst += sizeof(len);
+
+        auto w64 = [&](uint64_t v) { std::memcpy(dst, &v, sizeof(v)); dst += sizeof(v); };
+
+        w64(event_id);
+        w64(thread_id);
+        w64(per_thread_event_id);
+        w64(raw_flags);
+        w64(timestamp_us);
+
+        uint16_t cl = static_cast<uint16_t>(category.size());
+        std::memcpy(dst, &cl, sizeof(cl)); dst += sizeof(cl);
+        if (!category.empty()) { std::memcpy(dst, category.data(), cl); dst += cl; }
+
+        uint16_t pl = static_cast<uint16_t>(payload.size());
+        std::memcpy(dst, &pl, sizeof(pl)); dst += sizeof(pl);
+        if (!payload.empty()) { std::memcpy(dst, payload.data(), pl); dst += pl; }
+
+        uint16_t ic = static_cast<uint16_t>(ints.size());
+        std::memcpy(dst, &ic, sizeof(ic)); dst += sizeof(ic);
+        if (!ints.empty()) { std::memcpy(dst, ints.data(), ints.size()*sizeof(int64_t)); dst += ints.size()*sizeof(int64_t); }
+
+        uint16_t dc = static_cast<uint16_t>(dbls.size());
+        std::memcpy(dst, &dc, sizeof(dc)); dst += sizeof(dc);
+        if (!dbls.empty()) { std::memcpy(dst, dbls.data(), dbls.size()*sizeof(double)); }
+    }
+
     int fd_ = -1;
-    char* mapped_ = nullptr;
+    std::unique_ptr<SlidingMmapWindow> window_;   // mmap output path
     size_t write_pos_ = 0;
-    size_t file_size_ = 0;
+    size_t header_offset_ = 0;      // BinaryLogFileHeader (after the text header)
+    BinaryLogCommitPublisher live_;
 
     std::string file_path_;
     PersistMode mode_;
-    [[maybe_unused]] size_t int_count_ = 0;
-    [[maybe_unused]] size_t dbl_count_ = 0;
+    size_t int_count_ = 0;
+    size_t dbl_count_ = 0;
     size_t buffer_size_;
+    size_t block_bytes_;
     bool finalized_ = false;
+    bool footer_written_ = false;
+    size_t blocks_end_ = 0;         // finalize: where the index footer starts
+
+    BinaryBlockHeader block_{};     // running stats of the open block
+    uint64_t block_min_id_ = 0;     // exact id range of the open block (index entry)
+    uint64_t block_max_id_ = 0;
+    std::vector<BinaryIndexEntry> index_;
+    bool block_open_ = false;       // mmap: header slot reserved at block_start_
+    size_t block_start_ = 0;
+    std::vector<char> block_buf_;   // streamed: staged records of the open block
+    BlockCodec codec_ = BlockCodec::None;
+    std::vector<char> packed_;      // compression output, reused across blocks
+    bool compact_ = false;
+    std::vector<char> compacted_;   // compact encoding output, reused across blocks
+    BinaryBloomBuilder bloom_;      // per-block filters (written by finalize)
+
+    FileOutputBackend output_ = FileOutputBackend::Mmap;
+    std::unique_ptr<PipelinedFileWriter> pipe_;   // set for Pwritev / IoUring
+    std::unique_ptr<DirectFileWriter> direct_;    // set for Direct
 
     BinaryEventLogStats stats_;
 };
@@ -2,10 +2,12 @@
 
 #include "jText.h"
 #include "JTextSplitEventLog.hpp"
+#include "ParallelBinaryLogScan.hpp"
 #include "PersistCommon.hpp"
 
 #include <cstring>
 #include <stdexcept>
+#include <vector>
 
 namespace jac::ts_store::inline_v001 {
 
@@ -17,7 +19,111 @@ BinaryEventLogReader::BinaryEventLogReader(std::string_view filepath)
         throw std::runtime_error("BinaryEventLogReader: failed to open " + std::string(filepath));
     }
     skip_leading_file_header();
+    read_preamble();
     data_start_ = file_.tellg();
+
+    file_.seekg(0, std::ios::end);
+    data_end_ = file_.tellg();
+    if (version_ == kBinaryLogVersion && data_end_ >= static_cast<std::streamoff>(sizeof(BinaryIndexFooter))) {
+        char tail[sizeof(BinaryIndexFooter)];
+        file_.seekg(data_end_ - static_cast<std::streamoff>(sizeof(tail)));
+        file_.read(tail, sizeof(tail));
+        BinaryIndexFooter f{};
+        if (file_.gcount() == static_cast<std::streamsize>(sizeof(tail)) &&
+            parse_index_footer(tail, static_cast<uint64_t>(data_end_), f) &&
+            static_cast<std::streamoff>(index_data_end(f)) >= static_cast<std::streamoff>(data_start_)) {
+            data_end_ = static_cast<std::streamoff>(index_data_end(f));
+        }
+    }
+    file_.clear();
+    file_.seekg(data_start_);
+}
+
+const BinaryLogIndex& BinaryEventLogReader::index() {
+    if (index_) return *index_;
+    if (version_ != kBinaryLogVersion) {
+        index_.emplace();
+        return *index_;
+    }
+    const std::streampos resume = file_.tellg();
+    file_.clear();
+    file_.seekg(0, std::ios::end);
+    const std::streamoff file_size = file_.tellg();
+
+    // Footer present: entries sit between the block data (and any Bloom filters) and the footer.
+    if (file_size - data_end_ > static_cast<std::streamoff>(sizeof(BinaryIndexFooter))) {
+        BinaryIndexFooter f{};
+        char tail[sizeof(BinaryIndexFooter)];
+        file_.seekg(file_size - static_cast<std::streamoff>(sizeof(tail)));
+        file_.read(tail, sizeof(tail));
+        std::memcpy(&f, tail, sizeof(f));
+        std::vector<BinaryIndexEntry> entries(f.entry_count);
+        file_.seekg(static_cast<std::streamoff>(f.index_offset));
+        file_.read(reinterpret_cast<char*>(entries.data()),
+                   static_cast<std::streamsize>(entries.size() * sizeof(BinaryIndexEntry)));
+        if (file_ && crc32c(entries.data(), entries.size() * sizeof(BinaryIndexEntry)) == f.entries_crc) {
+            index_.emplace(std::move(entries), true);
+        }
+    }
+    // No (usable) footer: hop over the block headers.
+    if (!index_) {
+        std::vector<BinaryIndexEntry> entries;
+        std::streamoff pos = data_start_;
+        BinaryBlockHeader h{};
+        char raw[sizeof(BinaryBlockHeader)];
+        file_.clear();
+        while (pos + static_cast<std::streamoff>(sizeof(raw)) <= data_end_) {
+            file_.seekg(pos);
+            file_.read(raw, sizeof(raw));
+            if (!file_ || !parse_block_header(raw, static_cast<size_t>(data_end_ - pos), h)) break;
+            entries.push_back(index_entry_from_header(static_cast<uint64_t>(pos), h));
+            pos += static_cast<std::streamoff>(sizeof(h) + h.stored_bytes);
+        }
+        index_.emplace(std::move(entries), false);
+    }
+    file_.clear();
+    file_.seekg(resume);
+    return *index_;
+}
+
+bool BinaryEventLogReader::seek_to_block(size_t block) {
+    block_.clear();
+    block_pos_ = 0;
+    if (block == BinaryLogIndex::npos) {
+        eof_reached_ = true;
+        return false;
+    }
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(index_->entries()[block].block_offset));
+    eof_reached_ = false;
+    return true;
+}
+
+bool BinaryEventLogReader::seek_to_event(uint64_t event_id) {
+    return seek_to_block(index().find_event(event_id));
+}
+
+bool BinaryEventLogReader::seek_to_time(uint64_t timestamp_us) {
+    return seek_to_block(index().find_time(timestamp_us));
+}
+
+void BinaryEventLogReader::read_preamble() {
+    const std::streampos at = file_.tellg();
+    char buf[sizeof(BinaryLogFileHeader) + sizeof(BinaryLogSchema)];
+    file_.read(buf, sizeof(buf));
+    BinaryLogFileHeader header{};
+    if (file_.gcount() == static_cast<std::streamsize>(sizeof(buf)) &&
+        parse_binary_log_preamble(buf, sizeof(buf), header, schema_)) {
+        version_ = kBinaryLogVersion;
+        return;
+    }
+    if (has_binary_log_magic(buf, static_cast<size_t>(file_.gcount()))) {
+        throw std::runtime_error("BinaryEventLogReader: unsupported or corrupt header in " + filepath_);
+    }
+    // v1: records start right after the text header
+    schema_ = BinaryLogSchema{};
+    file_.clear();
+    file_.seekg(at);
 }
 
 void BinaryEventLogReader::skip_leading_file_header() {
@@ -43,7 +149,10 @@ void BinaryEventLogReader::skip_leading_file_header() {
 }
 
 bool BinaryEventLogReader::next(BinaryRecord& out_record) {
-    return read_next_record(out_record);
+    while (read_next_record(out_record)) {
+        if (flag_mask_ == 0 || (out_record.raw_flags & flag_mask_) != 0) return true;
+    }
+    return false;
 }
 
 void BinaryEventLogReader::rewind() {
@@ -51,11 +160,77 @@ void BinaryEventLogReader::rewind() {
     file_.seekg(data_start_);
     records_read_ = 0;
     eof_reached_ = false;
+    block_.clear();
+    block_pos_ = 0;
+}
+
+bool BinaryEventLogReader::load_next_block() {
+    BinaryBlockHeader h{};
+    for (;;) {
+        if (file_.tellg() >= data_end_) return false;   // clean end (index footer follows)
+        file_.read(reinterpret_cast<char*>(&h), sizeof(h));
+        if (file_.gcount() != static_cast<std::streamsize>(sizeof(h))) return false;   // clean end
+        if (h.magic != kBinaryBlockMagic || h.header_crc16 != detail::block_header_crc16(h)) {
+            ++corrupt_blocks_;
+            return false;
+        }
+        if (flag_mask_ == 0 || (h.flags_or & flag_mask_) != 0) break;
+        file_.seekg(static_cast<std::streamoff>(h.stored_bytes), std::ios::cur);   // no match in this block
+        ++skipped_blocks_;
+    }
+    if (!block_codec_available(block_codec_of(h))) {
+        ++corrupt_blocks_;
+        return false;
+    }
+    const bool as_is = block_codec_of(h) == BlockCodec::None && !block_has_compact_records(h);
+    std::vector<char>& stored = as_is ? block_ : packed_;
+    stored.resize(h.stored_bytes);
+    file_.read(stored.data(), h.stored_bytes);
+    if (file_.gcount() != static_cast<std::streamsize>(h.stored_bytes) ||
+        !verify_block_payload(h, stored.data())) {
+        ++corrupt_blocks_;   // torn tail or bit rot
+        return false;
+    }
+    if (as_is) {
+        if (h.raw_bytes != h.stored_bytes) {
+            ++corrupt_blocks_;
+            return false;
+        }
+    } else {
+        const char* records = nullptr;
+        size_t n = 0;   // decoded into block_
+        if (!block_records(h, packed_.data(), block_, scratch_, records, n)) {
+            ++corrupt_blocks_;
+            return false;
+        }
+    }
+    block_pos_ = 0;
+    return true;
 }
 
 bool BinaryEventLogReader::read_next_record(BinaryRecord& out) {
     if (eof_reached_) return false;
 
+    if (version_ == kBinaryLogVersion) {
+        while (block_pos_ + sizeof(uint32_t) > block_.size()) {
+            if (!load_next_block()) {
+                eof_reached_ = true;
+                return false;
+            }
+        }
+        uint32_t record_len = 0;
+        std::memcpy(&record_len, block_.data() + block_pos_, sizeof(record_len));
+        block_pos_ += sizeof(record_len);
+        if (record_len > block_.size() - block_pos_ ||
+            !parse_record(block_.data() + block_pos_, record_len, out)) {
+            eof_reached_ = true;
+            return false;
+        }
+        block_pos_ += record_len;
+        records_read_++;
+        return true;
+    }
+
     uint32_t record_len = 0;
     file_.read(reinterpret_cast<char*>(&record_len), sizeof(record_len));
 
@@ -64,14 +239,23 @@ bool BinaryEventLogReader::read_next_record(BinaryRecord& out) {
         return false;
     }
 
-    std::vector<char> buffer(record_len);
-    file_.read(buffer.data(), record_len);
+    block_.resize(record_len);   // v1: reused as the record buffer
+    file_.read(block_.data(), record_len);
 
-    if (file_.fail()) {
+    if (file_.fail() || !parse_record(block_.data(), record_len, out)) {
         eof_reached_ = true;
         return false;
     }
 
+    records_read_++;
+    return true;
+}
+
+// One record body (after the u32 length). False when the inner lengths overrun len.
+bool BinaryEventLogReader::parse_record(const char* buffer, size_t len, BinaryRecord& out) {
+    constexpr size_t kFixed = 5 * sizeof(uint64_t) + 4 * sizeof(uint16_t);
+    if (len < kFixed) return false;
+
     size_t pos = 0;
     auto read_u64 = [&](uint64_t& dst) {
         std::memcpy(&dst, &buffer[pos], sizeof(uint64_t));
@@ -91,16 +275,19 @@ bool BinaryEventLogReader::read_next_record(BinaryRecord& out) {
 
     uint16_t cat_len = 0;
     read_u16(cat_len);
+    if (pos + cat_len + sizeof(uint16_t) > len) return false;
     out.category.assign(&buffer[pos], cat_len);
     pos += cat_len;
 
     uint16_t pay_len = 0;
     read_u16(pay_len);
+    if (pos + pay_len + sizeof(uint16_t) > len) return false;
     out.payload.assign(&buffer[pos], pay_len);
     pos += pay_len;
 
     uint16_t i_count = 0;
     read_u16(i_count);
+    if (pos + i_count * sizeof(int64_t) + sizeof(uint16_t) > len) return false;
     out.int_metrics.resize(i_count);
     if (i_count > 0) {
         std::memcpy(out.int_metrics.data(), &buffer[pos], i_count * sizeof(int64_t));
@@ -109,39 +296,41 @@ bool BinaryEventLogReader::read_next_record(BinaryRecord& out) {
 
     uint16_t d_count = 0;
     read_u16(d_count);
+    if (pos + d_count * sizeof(double) > len) return false;
     out.dbl_metrics.resize(d_count);
     if (d_count > 0) {
         std::memcpy(out.dbl_metrics.data(), &buffer[pos], d_count * sizeof(double));
     }
-
-    records_read_++;
     return true;
 }
 
-void BinaryEventLogReader::convert_to_jtext(std::string_view output_base_name,
-                                            size_t int_count,
-                                            size_t dbl_count) const
+ParallelScanResult BinaryEventLogReader::convert_to_jtext(std::string_view output_base_name,
+                                                          size_t int_count,
+                                                          size_t dbl_count,
+                                                          const ParallelScanOptions& options) const
 {
     JTextSplitEventLog jtext_log(output_base_name, int_count, dbl_count, PersistMode::All);
 
-    BinaryEventLogReader reader(filepath_);  // re-open for fresh iteration
-    BinaryRecord rec;
-
-    while (reader.next(rec)) {
-        jtext_log.append_event(
-            rec.event_id,
-            rec.thread_id,
-            rec.per_thread_event_id,
-            rec.raw_flags,
-            rec.category,
-            rec.payload,
-            rec.timestamp_us,
-            rec.int_metrics,
-            rec.dbl_metrics
-        );
-    }
+    // Blocks are checked, decoded and formatted on all cores; parallel_transform hands each block's
+    // text to the (single) jText writer in file order.
+    const MappedBinaryLog log(filepath_);
+    const ParallelScanResult result = parallel_transform<JTextSplitEventLog::FormattedRows>(log,
+        [int_count, dbl_count](JTextSplitEventLog::FormattedRows& rows, const BinaryRecordView& rec) {
+            thread_local std::vector<int64_t> ints;
+            thread_local std::vector<double> dbls;
+            ints.resize(rec.int_count);
+            dbls.resize(rec.dbl_count);
+            for (size_t i = 0; i < ints.size(); ++i) ints[i] = rec.int_metric(i);
+            for (size_t i = 0; i < dbls.size(); ++i) dbls[i] = rec.dbl_metric(i);
+            JTextSplitEventLog::format_event(rows, int_count, dbl_count, rec.event_id, rec.thread_id,
+                                             rec.per_thread_event_id, rec.raw_flags, rec.category, rec.payload,
+                                             rec.timestamp_us, ints, dbls);
+        },
+        [&jtext_log](const JTextSplitEventLog::FormattedRows& rows) { jtext_log.append_formatted(rows); },
+        options);
 
     jtext_log.finalize();
+    return result;
 }
 
 } // namespace jac::ts_store::inline_v001
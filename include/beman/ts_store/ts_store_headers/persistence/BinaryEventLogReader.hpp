@@ -3,6 +3,13 @@
 // BinaryEventLogReader.hpp
 // Reader for the fast binary format produced by BinaryEventLog.
 // Also provides conversion helpers to jText for inspection.
+// Reads v2 logs block by block (each block's CRC32C is checked before its records are returned;
+// a bad block ends iteration; compressed blocks are inflated after the check) and falls back to
+// v1 bare records when the magic is absent.
+// v2 logs can be positioned through the sparse seek index (BinaryLogIndex.hpp): seek_to_event /
+// seek_to_time jump to the block holding the target (binary search, no decoding of earlier
+// blocks), and set_flag_filter skips whole blocks whose flag OR misses the mask.
+// For bulk scans prefer MappedBinaryLogReader (zero-copy views, no per-record allocation).
 
 #include <string>
 #include <string_view>
@@ -13,6 +20,11 @@
 #include <functional>
 
 #include "jText.h"
+#include "BinaryLogFormat.hpp"
+#include "BinaryLogIndex.hpp"
+#include "BlockCompression.hpp"
+#include "CompactRecords.hpp"
+#include "ParallelBinaryLogScan.hpp"
 
 namespace jac::ts_store::inline_v001 {
 
@@ -38,26 +50,67 @@ public:
     // Rewind to beginning
     void rewind();
 
+    // v2: position at the start of the block that holds event_id / the first block that may hold
+    // timestamps >= timestamp_us; next() continues from there (the block's earlier records
+    // included). False (and nothing more to read) when no block qualifies or for v1 logs.
+    bool seek_to_event(uint64_t event_id);
+    bool seek_to_time(uint64_t timestamp_us);
+
+    // Only return records with (raw_flags & mask) != 0; blocks whose flag OR misses the mask are
+    // skipped without reading their payload. 0 turns the filter off.
+    void set_flag_filter(uint64_t mask) { flag_mask_ = mask; }
+    [[nodiscard]] size_t skipped_blocks() const { return skipped_blocks_; }
+
+    // Seek index: footer entries, or rebuilt from block headers when the log has no footer.
+    const BinaryLogIndex& index();
+
     // Total records seen so far (approximate until end)
     [[nodiscard]] size_t records_read() const { return records_read_; }
 
+    // 2 for block-framed logs, 1 for legacy bare-record logs.
+    [[nodiscard]] uint16_t version() const { return version_; }
+    // v2 schema block (zeroed for v1).
+    [[nodiscard]] const BinaryLogSchema& schema() const { return schema_; }
+    // v2: blocks rejected (bad header or CRC); iteration stops at the first one.
+    [[nodiscard]] size_t corrupt_blocks() const { return corrupt_blocks_; }
+
     // Convert the entire binary log to jText files (for debugging/inspection)
     // This creates three jText files with the same naming convention as JTextSplitEventLog.
+    // Decodes and formats on all cores (parallel_transform), written in file order; corrupt blocks
+    // are skipped. options: thread count and filter (options.ordered is implied).
     // Only available when the library was built with TS_STORE_ENABLE_JTEXT_PERSIST=ON.
-    void convert_to_jtext(std::string_view output_base_name,
-                          size_t int_count,
-                          size_t dbl_count) const;
+    ParallelScanResult convert_to_jtext(std::string_view output_base_name,
+                                        size_t int_count,
+                                        size_t dbl_count,
+                                        const ParallelScanOptions& options = {}) const;
 
 private:
     bool read_next_record(BinaryRecord& out);
+    bool load_next_block();
+    bool seek_to_block(size_t block);
+    static bool parse_record(const char* p, size_t len, BinaryRecord& out);
 
     void skip_leading_file_header();
+    void read_preamble();
 
     std::ifstream file_;
     std::string filepath_;
     size_t records_read_ = 0;
     bool eof_reached_ = false;
     std::streampos data_start_ = 0;
+
+    uint16_t version_ = 1;
+    BinaryLogSchema schema_{};
+    std::vector<char> block_;       // v2: records of the current block
+    std::vector<char> packed_;      // v2: stored bytes of a compressed / compact block
+    std::vector<char> scratch_;     // v2: codec output of a compressed compact block
+    size_t block_pos_ = 0;
+    size_t corrupt_blocks_ = 0;
+
+    std::streamoff data_end_ = 0;   // v2: end of the block data (index footer), else file size
+    std::optional<BinaryLogIndex> index_;
+    uint64_t flag_mask_ = 0;
+    size_t skipped_blocks_ = 0;
 };
 
 } // namespace jac::ts_store::inline_v001
@@ -2,11 +2,15 @@
 
 // BinaryEventSink.hpp
 // Adapter that turns BinaryEventLog into an IEventSink for use with DoubleBufferedWriter.
+// Writes through SegmentedBinaryLog, so TS_STORE_SEGMENT_BYTES / _SECONDS (or an explicit
+// SegmentPolicy) switch it to rolling segments; otherwise it is a single <base>.bin.
 
 #include "EventSink.hpp"
 #include "BinaryEventLog.hpp"
+#include "SegmentedBinaryLog.hpp"
 
 #include <memory>
+#include <optional>
 
 namespace jac::ts_store::inline_v001 {
 
@@ -16,8 +20,12 @@ public:
                     size_t int_count,
                     size_t dbl_count,
                     PersistMode mode = PersistMode::All,
-                    size_t internal_buffer_size = 64 * 1024 * 1024)
-        : impl_(std::make_unique<BinaryEventLog>(base_name, int_count, dbl_count, mode, internal_buffer_size))
+                    size_t internal_buffer_size = 64 * 1024 * 1024,
+                    FileOutputBackend output = FileOutputBackend::Default,
+                    BinaryCompression compression = BinaryCompression::Default,
+                    std::optional<SegmentPolicy> segments = std::nullopt)
+        : impl_(std::make_unique<SegmentedBinaryLog>(base_name, int_count, dbl_count, mode,
+                                                     internal_buffer_size, output, compression, segments))
     {}
 
     void write_batch(std::span<const PersistedEvent> batch) override {
@@ -39,12 +47,17 @@ public:
                 dbls
             );
         }
+        impl_->end_block();   // one v2 block per drained batch (split further at block_bytes); may rotate
     }
 
     void flush() override {
         if (impl_) impl_->flush();
     }
 
+    void sync() override {
+        if (impl_) impl_->sync();
+    }
+
     void finalize() override {
         if (impl_) {
             impl_->finalize();
@@ -55,7 +68,7 @@ public:
     std::string_view name() const override { return "BinaryEventSink"; }
 
 private:
-    std::unique_ptr<BinaryEventLog> impl_;
+    std::unique_ptr<SegmentedBinaryLog> impl_;
 };
 
 } // namespace jac::ts_store::inline_v001
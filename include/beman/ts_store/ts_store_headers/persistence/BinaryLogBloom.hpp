@@ -0,0 +1,324 @@
+#pragma once
+
+// BinaryLogBloom.hpp
+// Per-block Bloom filters of a v2 binary log (BinaryBloomFilters / TS_STORE_BINARY_BLOOM).
+// BinaryEventLog builds one filter per closed block and writes them on finalize, between the
+// block data and the seek index entries:
+//
+//   ... last block | BinaryBloomHeader | u64 first_word[N + 1] | u64 words | BinaryIndexEntry x N | footer
+//
+// BinaryIndexFooter::bloom_bytes gives the size of the section (0 = none), so the block data ends
+// at index_offset - bloom_bytes. Filter i belongs to index entry i and covers words
+// [first_word[i], first_word[i + 1]). A reader that finds no filters, or a section that does not
+// check out, simply reads every block.
+//
+// Keys: the category of each record (kBloomKeyCategory) and the words of its payload
+// (kBloomKeyTokens). A word is a maximal run of ASCII letters, digits, '_' and non-ASCII bytes;
+// matching is exact (case-sensitive). Each distinct key of a block is set once.
+//
+// Layout: blocked Bloom filter, kBloomBitsPerKey bits per distinct key rounded up to 512-bit
+// buckets. A key picks one bucket and sets kBloomHashCount bits inside it, so a probe touches one
+// cache line. About 1% false positives; never a false negative.
+//
+// The writer decodes the raw records when a block closes (like the compact encoding), so the hot
+// path is unchanged. Filters are kept in memory until finalize: on payload-heavy logs roughly
+// 1.3 bytes per distinct word per block, which segment rotation keeps bounded.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BinaryLogFormat.hpp"
+#include "PersistCommon.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+inline constexpr uint32_t kBinaryBloomMagic = 0x46425354u;   // "TSBF"
+// BinaryBloomHeader::keys bits.
+inline constexpr uint16_t kBloomKeyCategory = 0x0001;
+inline constexpr uint16_t kBloomKeyTokens = 0x0002;
+inline constexpr size_t kBloomBitsPerKey = 10;
+inline constexpr uint16_t kBloomHashCount = 7;
+inline constexpr size_t kBloomBucketWords = 8;   // 512 bits
+
+struct BinaryBloomHeader {
+    uint32_t magic;
+    uint32_t filter_count;     // one per index entry, in index order
+    uint64_t word_count;       // filter words after the directory
+    uint16_t hash_count;       // bits set per key, inside one bucket
+    uint16_t keys;             // kBloomKeyCategory | kBloomKeyTokens
+    uint32_t data_crc;         // CRC32C of the directory and the words
+    uint32_t reserved;
+    uint32_t header_crc;       // CRC32C of the bytes above
+};
+
+static_assert(sizeof(BinaryBloomHeader) == 32);
+
+// BinaryBloomFilters::Default -> TS_STORE_BINARY_BLOOM (none|category|tokens), else None.
+// Returns the key bits to build (0 = no filters).
+inline uint16_t resolve_bloom_keys(BinaryBloomFilters requested) {
+    if (requested == BinaryBloomFilters::Default) {
+        const char* env = std::getenv("TS_STORE_BINARY_BLOOM");
+        const std::string_view v = env != nullptr ? env : "";
+        requested = v == "category" ? BinaryBloomFilters::Category
+                  : v == "tokens"   ? BinaryBloomFilters::Tokens
+                                    : BinaryBloomFilters::None;
+    }
+    switch (requested) {
+        case BinaryBloomFilters::Category: return kBloomKeyCategory;
+        case BinaryBloomFilters::Tokens:   return kBloomKeyCategory | kBloomKeyTokens;
+        default:                           return 0;
+    }
+}
+
+namespace detail {
+    inline constexpr uint64_t kBloomCategorySeed = 0x243F6A8885A308D3ull;
+    inline constexpr uint64_t kBloomTokenSeed = 0x13198A2E03707344ull;
+
+    inline uint64_t bloom_mix(uint64_t x) {   // MurmurHash3 fmix64
+        x ^= x >> 33;
+        x *= 0xFF51AFD7ED558CCDull;
+        x ^= x >> 33;
+        x *= 0xC4CEB9FE1A85EC53ull;
+        x ^= x >> 33;
+        return x;
+    }
+
+    // Stable across runs and platforms: the filters are on disk.
+    inline uint64_t bloom_hash(std::string_view s, uint64_t seed) {
+        uint64_t h = seed ^ (s.size() * 0x9E3779B97F4A7C15ull);
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= s.size(); i += sizeof(uint64_t)) {
+            uint64_t w = 0;
+            std::memcpy(&w, s.data() + i, sizeof(w));
+            h = bloom_mix(h ^ w);
+        }
+        uint64_t tail = 0;
+        if (i < s.size()) std::memcpy(&tail, s.data() + i, s.size() - i);
+        return bloom_mix(h ^ tail ^ (uint64_t{0xFF} << 56));
+    }
+
+    inline bool is_token_byte(unsigned char c) {
+        return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') || c == '_' || c >= 0x80;
+    }
+
+    template <typename Fn>
+    void for_each_token(std::string_view text, Fn&& fn) {
+        size_t i = 0;
+        while (i < text.size()) {
+            while (i < text.size() && !is_token_byte(static_cast<unsigned char>(text[i]))) ++i;
+            const size_t start = i;
+            while (i < text.size() && is_token_byte(static_cast<unsigned char>(text[i]))) ++i;
+            if (i != start) fn(text.substr(start, i - start));
+        }
+    }
+
+    // True when `token` occurs in `text` as a whole word.
+    inline bool text_has_token(std::string_view text, std::string_view token) {
+        for (size_t at = text.find(token); at != std::string_view::npos; at = text.find(token, at + 1)) {
+            const size_t end = at + token.size();
+            if ((at == 0 || !is_token_byte(static_cast<unsigned char>(text[at - 1]))) &&
+                (end == text.size() || !is_token_byte(static_cast<unsigned char>(text[end])))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Bucket from the high half, bit positions from the low half (double hashing).
+    inline size_t bloom_bucket(uint64_t h, size_t buckets) {
+        return static_cast<size_t>(((h >> 32) * buckets) >> 32);
+    }
+
+    inline void bloom_set(uint64_t* bucket, uint64_t h, uint16_t hashes) {
+        const uint32_t h1 = static_cast<uint32_t>(h);
+        const uint32_t h2 = static_cast<uint32_t>(h >> 17) | 1u;
+        for (uint32_t i = 0; i < hashes; ++i) {
+            const uint32_t bit = (h1 + i * h2) & 511u;
+            bucket[bit >> 6] |= uint64_t{1} << (bit & 63u);
+        }
+    }
+
+    inline bool bloom_test(const uint64_t* bucket, uint64_t h, uint16_t hashes) {
+        const uint32_t h1 = static_cast<uint32_t>(h);
+        const uint32_t h2 = static_cast<uint32_t>(h >> 17) | 1u;
+        for (uint32_t i = 0; i < hashes; ++i) {
+            const uint32_t bit = (h1 + i * h2) & 511u;
+            if ((bucket[bit >> 6] & (uint64_t{1} << (bit & 63u))) == 0) return false;
+        }
+        return true;
+    }
+}
+
+// Writer side: collects the keys of the open block, end_block() turns them into its filter.
+class BinaryBloomBuilder {
+public:
+    explicit BinaryBloomBuilder(uint16_t keys = 0) : keys_(keys) {}
+
+    [[nodiscard]] bool enabled() const { return keys_ != 0; }
+    [[nodiscard]] uint16_t keys() const { return keys_; }
+
+    void add(std::string_view category, std::string_view payload) {
+        if ((keys_ & kBloomKeyCategory) != 0) pending_.push_back(detail::bloom_hash(category, detail::kBloomCategorySeed));
+        if ((keys_ & kBloomKeyTokens) != 0) {
+            detail::for_each_token(payload, [this](std::string_view t) {
+                pending_.push_back(detail::bloom_hash(t, detail::kBloomTokenSeed));
+            });
+        }
+    }
+
+    // Keys of `n` bytes of v1 records (u32 length + body, as BinaryEventLog encodes them).
+    void add_records(const char* p, size_t n) {
+        constexpr size_t fixed = 5 * sizeof(uint64_t);
+        const char* const end = p + n;
+        while (static_cast<size_t>(end - p) >= sizeof(uint32_t)) {
+            uint32_t len = 0;
+            std::memcpy(&len, p, sizeof(len));
+            const char* body = p + sizeof(len);
+            if (len > static_cast<size_t>(end - body) || len < fixed + 2 * sizeof(uint16_t)) return;
+            const char* const body_end = body + len;
+            uint16_t cl = 0, pl = 0;
+            std::memcpy(&cl, body + fixed, sizeof(cl));
+            const char* cat = body + fixed + sizeof(cl);
+            if (static_cast<size_t>(body_end - cat) < size_t{cl} + sizeof(pl)) return;
+            std::memcpy(&pl, cat + cl, sizeof(pl));
+            const char* pay = cat + cl + sizeof(pl);
+            if (static_cast<size_t>(body_end - pay) < pl) return;
+            add(std::string_view(cat, cl), std::string_view(pay, pl));
+            p = body_end;
+        }
+    }
+
+    // Close the filter of the current block; called once per index entry.
+    void end_block() {
+        std::sort(pending_.begin(), pending_.end());
+        pending_.erase(std::unique(pending_.begin(), pending_.end()), pending_.end());
+        const size_t bits = pending_.size() * kBloomBitsPerKey;
+        const size_t buckets = pending_.empty() ? 0 : std::max<size_t>(1, (bits + 511) / 512);
+        const size_t first = words_.size();
+        words_.resize(first + buckets * kBloomBucketWords, 0);
+        for (const uint64_t h : pending_) {
+            detail::bloom_set(words_.data() + first + detail::bloom_bucket(h, buckets) * kBloomBucketWords, h,
+                              kBloomHashCount);
+        }
+        first_word_.push_back(words_.size());
+        pending_.clear();
+    }
+
+    [[nodiscard]] size_t filter_count() const { return first_word_.size() - 1; }
+
+    [[nodiscard]] size_t section_bytes() const {
+        return sizeof(BinaryBloomHeader) + (first_word_.size() + words_.size()) * sizeof(uint64_t);
+    }
+
+    // The footer section (BinaryBloomHeader, directory, words).
+    [[nodiscard]] std::string section() const {
+        std::string out(section_bytes(), '\0');
+        const size_t dir_bytes = first_word_.size() * sizeof(uint64_t);
+        char* const data = out.data() + sizeof(BinaryBloomHeader);
+        std::memcpy(data, first_word_.data(), dir_bytes);
+        if (!words_.empty()) std::memcpy(data + dir_bytes, words_.data(), words_.size() * sizeof(uint64_t));
+
+        BinaryBloomHeader h{};
+        h.magic = kBinaryBloomMagic;
+        h.filter_count = static_cast<uint32_t>(filter_count());
+        h.word_count = words_.size();
+        h.hash_count = kBloomHashCount;
+        h.keys = keys_;
+        h.data_crc = crc32c(data, out.size() - sizeof(h));
+        h.header_crc = detail::crc_without_last_u32(h);
+        std::memcpy(out.data(), &h, sizeof(h));
+        return out;
+    }
+
+private:
+    uint16_t keys_ = 0;
+    std::vector<uint64_t> pending_;          // key hashes of the open block
+    std::vector<uint64_t> words_;            // closed filters, back to back
+    std::vector<uint64_t> first_word_{0};    // directory
+};
+
+// Read side: the filters of one log (MappedBinaryLog::bloom_filters()). Empty = no pruning.
+class BinaryBloomIndex {
+public:
+    BinaryBloomIndex() = default;
+
+    // `bytes` at p: the section located by the index footer. Empty when it does not check out
+    // or does not hold exactly `blocks` filters.
+    static BinaryBloomIndex parse(const char* p, size_t bytes, size_t blocks) {
+        BinaryBloomIndex out;
+        BinaryBloomHeader h{};
+        if (bytes < sizeof(h)) return out;
+        std::memcpy(&h, p, sizeof(h));
+        if (h.magic != kBinaryBloomMagic || h.header_crc != detail::crc_without_last_u32(h) ||
+            h.filter_count != blocks || h.hash_count == 0) {
+            return out;
+        }
+        const size_t dir_words = size_t{h.filter_count} + 1;
+        if ((bytes - sizeof(h)) / sizeof(uint64_t) < dir_words ||
+            bytes - sizeof(h) - dir_words * sizeof(uint64_t) != h.word_count * sizeof(uint64_t) ||
+            crc32c(p + sizeof(h), bytes - sizeof(h)) != h.data_crc) {
+            return out;
+        }
+        std::vector<uint64_t> first_word(dir_words);
+        std::memcpy(first_word.data(), p + sizeof(h), dir_words * sizeof(uint64_t));
+        for (size_t i = 0; i + 1 < dir_words; ++i) {
+            if (first_word[i] > first_word[i + 1] || (first_word[i + 1] - first_word[i]) % kBloomBucketWords != 0) {
+                return out;
+            }
+        }
+        if (first_word.front() != 0 || first_word.back() != h.word_count) return out;
+        out.words_.resize(static_cast<size_t>(h.word_count));
+        if (!out.words_.empty()) {
+            std::memcpy(out.words_.data(), p + sizeof(h) + dir_words * sizeof(uint64_t),
+                        out.words_.size() * sizeof(uint64_t));
+        }
+        out.first_word_ = std::move(first_word);
+        out.keys_ = h.keys;
+        out.hash_count_ = h.hash_count;
+        return out;
+    }
+
+    [[nodiscard]] bool empty() const { return first_word_.empty(); }
+    [[nodiscard]] size_t size() const { return empty() ? 0 : first_word_.size() - 1; }
+    [[nodiscard]] uint16_t keys() const { return keys_; }
+    // Filter words of all blocks.
+    [[nodiscard]] size_t bytes() const { return words_.size() * sizeof(uint64_t); }
+
+    // False only when block `block` holds no record with this category.
+    [[nodiscard]] bool may_contain_category(size_t block, std::string_view category) const {
+        if ((keys_ & kBloomKeyCategory) == 0 || block >= size()) return true;
+        return probe(block, detail::bloom_hash(category, detail::kBloomCategorySeed));
+    }
+
+    // False only when some word of `text` appears in no payload of block `block`.
+    [[nodiscard]] bool may_contain_tokens(size_t block, std::string_view text) const {
+        if ((keys_ & kBloomKeyTokens) == 0 || block >= size()) return true;
+        bool all = true;
+        detail::for_each_token(text, [&](std::string_view t) {
+            if (all && !probe(block, detail::bloom_hash(t, detail::kBloomTokenSeed))) all = false;
+        });
+        return all;
+    }
+
+private:
+    [[nodiscard]] bool probe(size_t block, uint64_t h) const {
+        const size_t first = static_cast<size_t>(first_word_[block]);
+        const size_t buckets = (static_cast<size_t>(first_word_[block + 1]) - first) / kBloomBucketWords;
+        if (buckets == 0) return false;   // block without keys
+        return detail::bloom_test(words_.data() + first + detail::bloom_bucket(h, buckets) * kBloomBucketWords, h,
+                                  hash_count_);
+    }
+
+    uint16_t keys_ = 0;
+    uint16_t hash_count_ = 0;
+    std::vector<uint64_t> first_word_;
+    std::vector<uint64_t> words_;
+};
+
+} // namespace jac::ts_store::inline_v001
@@ -0,0 +1,199 @@
+#pragma once
+
+// BinaryLogFormat.hpp
+// On-disk layout of the binary event log, version 2.
+//
+//   "//File: ... //\n"        text header lines (kept: every persist file starts with them)
+//   BinaryLogFileHeader       64 bytes: magic "TSBINLOG", version, sizes, header CRC
+//   BinaryLogSchema           64 bytes: metric counts and record field widths
+//   { BinaryBlockHeader       64 bytes: count, stored/raw bytes, CRC32C, id/ts ranges, flag OR
+//     record bytes }*         v1 record encoding (u32 length + body), back to back; compressed
+//                             as a whole when codec != None (BlockCompression.hpp), or the
+//                             compact encoding of those records (CompactRecords.hpp)
+//   [ Bloom filters ]         optional per-block filters, written on finalize (BinaryLogBloom.hpp)
+//   [ BinaryIndexEntry x N,   seek index, written on finalize (BinaryLogIndex.hpp)
+//     BinaryIndexFooter ]
+//
+// All integers little-endian. A block header is written only after all of its records (the
+// mmap writer fills a reserved slot last), so a crash leaves at most one torn block at the end;
+// readers stop at the first block whose magic, size or CRC does not check out. Files without the
+// magic after the text header are v1 (bare length-prefixed records) and are still read.
+//
+// Live commit (LiveBinaryLog.hpp): the text header is padded so BinaryLogFileHeader starts 8-byte
+// aligned. While the file is written, the writer stores committed_bytes (end of the last complete
+// block) and then bumps commit_seq in place after each batch, so another process can follow the
+// file without scanning past what is complete. These fields are not covered by header_crc.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "Crc32c.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+inline constexpr char kBinaryLogMagic[8] = {'T', 'S', 'B', 'I', 'N', 'L', 'O', 'G'};
+inline constexpr uint16_t kBinaryLogVersion = 2;
+inline constexpr uint32_t kBinaryBlockMagic = 0x4B425354u;   // "TSBK"
+// BinaryLogFileHeader::commit_seq bit set once the writer has finalized the file.
+inline constexpr uint32_t kBinaryLogClosed = 0x80000000u;
+
+// Stored in the low byte of BinaryBlockHeader::codec; see BlockCompression.hpp.
+enum class BlockCodec : uint16_t { None = 0, Lz = 1, Zlib = 2, Zstd = 3 };
+
+// BinaryBlockHeader::codec bits above the BlockCodec: the payload (after the codec) is the compact
+// record encoding of CompactRecords.hpp, not v1 records; with kBlockStringDictionary its
+// categories and payloads are coded through a block string dictionary.
+inline constexpr uint16_t kBlockCodecMask = 0x00FF;
+inline constexpr uint16_t kBlockCompactRecords = 0x0100;
+inline constexpr uint16_t kBlockStringDictionary = 0x0200;
+
+struct BinaryLogFileHeader {
+    char     magic[8];
+    uint16_t version;
+    uint16_t header_bytes;     // sizeof(BinaryLogFileHeader)
+    uint16_t schema_bytes;     // sizeof(BinaryLogSchema), follows this header
+    uint16_t block_header_bytes;
+    uint32_t block_target_bytes;   // writer's block size goal (informational)
+    uint32_t commit_seq;           // live: bumped after each commit; futex word; kBinaryLogClosed
+    uint64_t created_unix_us;
+    uint64_t committed_bytes;      // live: file bytes holding complete blocks (0 = not published)
+    uint64_t reserved[2];
+    uint32_t live_reserved;        // live: 0; ignored (older writers kept a reader count here)
+    uint32_t header_crc;       // CRC32C of the bytes above, live fields zeroed
+};
+
+struct BinaryLogSchema {
+    uint16_t int_count;        // int64 metrics per record, as configured
+    uint16_t dbl_count;        // double metrics per record
+    uint8_t  id_bytes;         // event_id / thread_id / per_thread_event_id width (8)
+    uint8_t  flags_bytes;      // 8
+    uint8_t  timestamp_bytes;  // 8, microseconds
+    uint8_t  length_bytes;     // width of string length / metric count fields (2)
+    uint8_t  record_len_bytes; // width of the per-record length prefix (4)
+    uint8_t  int_bytes;        // 8
+    uint8_t  dbl_bytes;        // 8
+    uint8_t  reserved0;
+    uint16_t max_category_bytes;   // longest category the format can hold
+    uint16_t max_payload_bytes;
+    uint8_t  reserved[44];
+    uint32_t schema_crc;
+};
+
+struct BinaryBlockHeader {
+    uint32_t magic;
+    uint32_t record_count;
+    uint32_t stored_bytes;     // bytes after this header
+    uint32_t raw_bytes;        // payload bytes once decoded (== stored_bytes for BlockCodec::None)
+    uint32_t crc32c;           // CRC32C of the stored bytes
+    uint16_t codec;            // BlockCodec | kBlockCompactRecords | kBlockStringDictionary
+    uint16_t header_crc16;     // low 16 bits of CRC32C over the header with this field zeroed
+    uint64_t first_event_id;
+    uint64_t last_event_id;
+    uint64_t min_timestamp_us;
+    uint64_t max_timestamp_us;
+    uint64_t flags_or;         // OR of every record's flags (skip blocks by flag mask)
+};
+
+static_assert(sizeof(BinaryLogFileHeader) == 64);
+static_assert(sizeof(BinaryLogSchema) == 64);
+static_assert(sizeof(BinaryBlockHeader) == 64);
+
+namespace detail {
+    template <typename T>
+    uint32_t crc_without_last_u32(const T& h) {
+        return crc32c(&h, sizeof(T) - sizeof(uint32_t));
+    }
+
+    // The live fields change while the file is written, so the CRC is taken with them zeroed.
+    inline uint32_t binary_log_header_crc(BinaryLogFileHeader h) {
+        h.commit_seq = 0;
+        h.committed_bytes = 0;
+        h.live_reserved = 0;
+        return crc_without_last_u32(h);
+    }
+
+    inline uint16_t block_header_crc16(BinaryBlockHeader h) {
+        h.header_crc16 = 0;
+        return static_cast<uint16_t>(crc32c(&h, sizeof(h)) & 0xFFFFu);
+    }
+}
+
+inline BinaryLogFileHeader make_binary_log_file_header(uint32_t block_target_bytes, uint64_t created_unix_us) {
+    BinaryLogFileHeader h{};
+    std::memcpy(h.magic, kBinaryLogMagic, sizeof(h.magic));
+    h.version = kBinaryLogVersion;
+    h.header_bytes = sizeof(BinaryLogFileHeader);
+    h.schema_bytes = sizeof(BinaryLogSchema);
+    h.block_header_bytes = sizeof(BinaryBlockHeader);
+    h.block_target_bytes = block_target_bytes;
+    h.created_unix_us = created_unix_us;
+    h.header_crc = detail::binary_log_header_crc(h);
+    return h;
+}
+
+inline BinaryLogSchema make_binary_log_schema(size_t int_count, size_t dbl_count) {
+    BinaryLogSchema s{};
+    s.int_count = static_cast<uint16_t>(int_count);
+    s.dbl_count = static_cast<uint16_t>(dbl_count);
+    s.id_bytes = 8;
+    s.flags_bytes = 8;
+    s.timestamp_bytes = 8;
+    s.length_bytes = 2;
+    s.record_len_bytes = 4;
+    s.int_bytes = 8;
+    s.dbl_bytes = 8;
+    s.max_category_bytes = 0xFFFF;
+    s.max_payload_bytes = 0xFFFF;
+    s.schema_crc = detail::crc_without_last_u32(s);
+    return s;
+}
+
+inline void seal_block_header(BinaryBlockHeader& h) {
+    h.header_crc16 = detail::block_header_crc16(h);
+}
+
+// True when the magic, version and both CRCs match (bytes: at least header + schema).
+inline bool parse_binary_log_preamble(const char* p, size_t avail,
+                                      BinaryLogFileHeader& header, BinaryLogSchema& schema) {
+    if (avail < sizeof(BinaryLogFileHeader) + sizeof(BinaryLogSchema)) return false;
+    std::memcpy(&header, p, sizeof(header));
+    if (std::memcmp(header.magic, kBinaryLogMagic, sizeof(header.magic)) != 0) return false;
+    if (header.version != kBinaryLogVersion || header.header_bytes != sizeof(BinaryLogFileHeader) ||
+        header.schema_bytes != sizeof(BinaryLogSchema) ||
+        header.block_header_bytes != sizeof(BinaryBlockHeader)) return false;
+    if (header.header_crc != detail::binary_log_header_crc(header)) return false;
+    std::memcpy(&schema, p + sizeof(header), sizeof(schema));
+    return schema.schema_crc == detail::crc_without_last_u32(schema);
+}
+
+inline bool has_binary_log_magic(const char* p, size_t avail) {
+    return avail >= sizeof(kBinaryLogMagic) && std::memcmp(p, kBinaryLogMagic, sizeof(kBinaryLogMagic)) == 0;
+}
+
+// Header-only checks (magic, header CRC, sizes within `avail` bytes after the header).
+inline bool parse_block_header(const char* p, size_t avail, BinaryBlockHeader& h) {
+    if (avail < sizeof(BinaryBlockHeader)) return false;
+    std::memcpy(&h, p, sizeof(h));
+    if (h.magic != kBinaryBlockMagic || h.header_crc16 != detail::block_header_crc16(h)) return false;
+    return h.stored_bytes <= avail - sizeof(BinaryBlockHeader);
+}
+
+inline BlockCodec block_codec_of(const BinaryBlockHeader& h) {
+    return static_cast<BlockCodec>(h.codec & kBlockCodecMask);
+}
+
+inline bool block_has_compact_records(const BinaryBlockHeader& h) {
+    return (h.codec & kBlockCompactRecords) != 0;
+}
+
+inline bool block_has_string_dictionary(const BinaryBlockHeader& h) {
+    return (h.codec & kBlockStringDictionary) != 0;
+}
+
+inline bool verify_block_payload(const BinaryBlockHeader& h, const char* payload) {
+    return crc32c(payload, h.stored_bytes) == h.crc32c;
+}
+
+} // namespace jac::ts_store::inline_v001
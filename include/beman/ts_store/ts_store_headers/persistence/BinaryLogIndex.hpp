@@ -0,0 +1,170 @@
+#pragma once
+
+// BinaryLogIndex.hpp
+// Sparse seek index of a v2 binary log: one entry per block (file offset, id range, time range,
+// flag OR, record count). BinaryEventLog appends it as a footer when the log is finalized:
+//
+//   ... last block | [Bloom filters] | BinaryIndexEntry x N | BinaryIndexFooter (32 bytes, at EOF)
+//
+// The footer holds the entry count, where the entries start and CRC32Cs of both, so a reader
+// finds it with one read at (size - 32). When the writer built per-block Bloom filters
+// (BinaryLogBloom.hpp), bloom_bytes says how much of the space before the entries they take.
+// A log without a valid footer (crashed writer, torn tail) still gets an index: readers rebuild
+// it by hopping over the block headers. Those carry first/last ids instead of min/max, so
+// rebuilt id ranges are widened to reach the neighbouring blocks; a seek may then land one block
+// early. Footer entries are exact.
+//
+// Lookups are O(log n): binary search over the running maximum of max id / max timestamp, then
+// a short forward walk (bounded by the suffix minimum of min id) for out-of-order blocks.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "BinaryLogFormat.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+inline constexpr uint32_t kBinaryIndexMagic = 0x58495354u;   // "TSIX"
+
+struct BinaryIndexEntry {
+    uint64_t block_offset;     // file offset of the BinaryBlockHeader
+    uint64_t min_event_id;
+    uint64_t max_event_id;
+    uint64_t min_timestamp_us;
+    uint64_t max_timestamp_us;
+    uint64_t flags_or;
+    uint32_t record_count;
+    uint32_t reserved;
+};
+
+struct BinaryIndexFooter {
+    uint32_t magic;
+    uint32_t entry_count;
+    uint64_t index_offset;     // first BinaryIndexEntry
+    uint32_t entries_crc;      // CRC32C of the entry array
+    uint32_t bloom_bytes;      // Bloom filter section right before the entries (0 = none)
+    uint32_t reserved1;
+    uint32_t footer_crc;       // CRC32C of the bytes above
+};
+
+static_assert(sizeof(BinaryIndexEntry) == 56);
+static_assert(sizeof(BinaryIndexFooter) == 32);
+
+inline BinaryIndexEntry make_index_entry(uint64_t block_offset, const BinaryBlockHeader& h,
+                                         uint64_t min_event_id, uint64_t max_event_id) {
+    BinaryIndexEntry e{};
+    e.block_offset = block_offset;
+    e.min_event_id = min_event_id;
+    e.max_event_id = max_event_id;
+    e.min_timestamp_us = h.min_timestamp_us;
+    e.max_timestamp_us = h.max_timestamp_us;
+    e.flags_or = h.flags_or;
+    e.record_count = h.record_count;
+    return e;
+}
+
+// Entry rebuilt from a block header alone (no footer).
+inline BinaryIndexEntry index_entry_from_header(uint64_t block_offset, const BinaryBlockHeader& h) {
+    return make_index_entry(block_offset, h, std::min(h.first_event_id, h.last_event_id),
+                            std::max(h.first_event_id, h.last_event_id));
+}
+
+inline BinaryIndexFooter make_index_footer(const std::vector<BinaryIndexEntry>& entries, uint64_t index_offset,
+                                           uint32_t bloom_bytes = 0) {
+    BinaryIndexFooter f{};
+    f.magic = kBinaryIndexMagic;
+    f.entry_count = static_cast<uint32_t>(entries.size());
+    f.index_offset = index_offset;
+    f.entries_crc = crc32c(entries.data(), entries.size() * sizeof(BinaryIndexEntry));
+    f.bloom_bytes = bloom_bytes;
+    f.footer_crc = detail::crc_without_last_u32(f);
+    return f;
+}
+
+// `tail` = the last sizeof(BinaryIndexFooter) bytes of a file of `file_size` bytes. True when
+// the footer checks out and its entry array exactly fills the space before it.
+inline bool parse_index_footer(const char* tail, uint64_t file_size, BinaryIndexFooter& f) {
+    std::memcpy(&f, tail, sizeof(f));
+    if (f.magic != kBinaryIndexMagic || f.footer_crc != detail::crc_without_last_u32(f)) return false;
+    const uint64_t entries_bytes = uint64_t{f.entry_count} * sizeof(BinaryIndexEntry);
+    return f.bloom_bytes <= f.index_offset && f.index_offset + entries_bytes + sizeof(BinaryIndexFooter) == file_size;
+}
+
+// End of the block data of a finalized log: the Bloom filters, else the entries, start there.
+inline uint64_t index_data_end(const BinaryIndexFooter& f) {
+    return f.index_offset - f.bloom_bytes;
+}
+
+class BinaryLogIndex {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    BinaryLogIndex() = default;
+    BinaryLogIndex(std::vector<BinaryIndexEntry> entries, bool from_footer)
+        : entries_(std::move(entries)), from_footer_(from_footer)
+    {
+        const size_t n = entries_.size();
+        if (!from_footer_) {   // first/last ids only: cover the gaps between neighbours (and past the ends)
+            const std::vector<BinaryIndexEntry> seen = entries_;
+            for (size_t i = 0; i < n; ++i) {
+                entries_[i].min_event_id = i == 0 ? 0 : std::min(seen[i].min_event_id, seen[i - 1].max_event_id);
+                entries_[i].max_event_id = i + 1 == n ? UINT64_MAX : std::max(seen[i].max_event_id, seen[i + 1].min_event_id);
+            }
+        }
+        run_max_id_.resize(n);
+        run_max_ts_.resize(n);
+        suf_min_id_.resize(n);
+        suf_min_ts_.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            run_max_id_[i] = i == 0 ? entries_[i].max_event_id : std::max(run_max_id_[i - 1], entries_[i].max_event_id);
+            run_max_ts_[i] = i == 0 ? entries_[i].max_timestamp_us : std::max(run_max_ts_[i - 1], entries_[i].max_timestamp_us);
+        }
+        for (size_t i = n; i-- > 0;) {
+            suf_min_id_[i] = i + 1 == n ? entries_[i].min_event_id : std::min(suf_min_id_[i + 1], entries_[i].min_event_id);
+            suf_min_ts_[i] = i + 1 == n ? entries_[i].min_timestamp_us : std::min(suf_min_ts_[i + 1], entries_[i].min_timestamp_us);
+        }
+    }
+
+    [[nodiscard]] const std::vector<BinaryIndexEntry>& entries() const { return entries_; }
+    [[nodiscard]] size_t size() const { return entries_.size(); }
+    [[nodiscard]] bool empty() const { return entries_.empty(); }
+    // False when rebuilt from block headers (approximate id ranges, see above).
+    [[nodiscard]] bool from_footer() const { return from_footer_; }
+
+    // First block (in file order) whose id range holds `event_id`, or npos.
+    [[nodiscard]] size_t find_event(uint64_t event_id) const {
+        size_t i = static_cast<size_t>(std::lower_bound(run_max_id_.begin(), run_max_id_.end(), event_id) -
+                                       run_max_id_.begin());
+        for (; i < entries_.size() && suf_min_id_[i] <= event_id; ++i) {
+            if (entries_[i].min_event_id <= event_id && event_id <= entries_[i].max_event_id) return i;
+        }
+        return npos;
+    }
+
+    // First block that may hold a record with timestamp >= ts_us, or npos when none can.
+    [[nodiscard]] size_t find_time(uint64_t ts_us) const {
+        const auto it = std::lower_bound(run_max_ts_.begin(), run_max_ts_.end(), ts_us);
+        return it == run_max_ts_.end() ? npos : static_cast<size_t>(it - run_max_ts_.begin());
+    }
+
+    // Blocks whose time range overlaps [from_us, to_us], in file order.
+    [[nodiscard]] std::vector<size_t> blocks_in_time_range(uint64_t from_us, uint64_t to_us) const {
+        std::vector<size_t> out;
+        for (size_t i = find_time(from_us); i < entries_.size() && suf_min_ts_[i] <= to_us; ++i) {
+            if (entries_[i].min_timestamp_us <= to_us && entries_[i].max_timestamp_us >= from_us) out.push_back(i);
+        }
+        return out;
+    }
+
+private:
+    std::vector<BinaryIndexEntry> entries_;
+    bool from_footer_ = false;
+    std::vector<uint64_t> run_max_id_, run_max_ts_;   // prefix max -> binary search
+    std::vector<uint64_t> suf_min_id_, suf_min_ts_;   // suffix min -> where to stop walking
+};
+
+} // namespace jac::ts_store::inline_v001
@@ -0,0 +1,211 @@
+#pragma once
+
+// BinaryLogMerge.hpp
+// K-way merge / compaction of many binary logs into one time- (or id-) ordered, indexed log
+// (library side of ts_binlog_merge).
+//
+// Every input is read by its own streaming BinaryEventLogReader (one block in memory at a time);
+// a binary heap over the readers' current records picks the next one to write, so memory is
+// O(inputs x (block + reorder_window)) however large the inputs are. Within one log, records from
+// different writer threads may be slightly out of key order; each input therefore feeds a small
+// min-heap of reorder_window records first. A record that arrives after a larger key from the
+// same input was already written is still written and counted as late.
+//
+// Duplicates (same event_id at the same merge key, e.g. the same segment picked up twice or an
+// overlap between rotated files) are written once: the first input in argument order wins.
+// keep_flags uses the readers' block flag filter, so blocks without a matching event are skipped
+// unread; drop_flags removes individual events. The output is an ordinary BinaryEventLog
+// (compression / encoding / block size as configured) and finalize() writes its seek index.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "BinaryEventLog.hpp"
+#include "BinaryEventLogReader.hpp"
+#include "PersistCommon.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+enum class MergeKey { Timestamp, EventId };
+
+struct BinaryLogMergeOptions {
+    MergeKey key = MergeKey::Timestamp;
+    bool dedupe = true;                 // write each (key, event_id) once
+    uint64_t keep_flags = 0;            // only events with (raw_flags & keep_flags) != 0 (0 = all)
+    uint64_t drop_flags = 0;            // skip events with (raw_flags & drop_flags) != 0
+    size_t reorder_window = 1024;       // records buffered per input to absorb thread interleaving
+    BinaryCompression compression = BinaryCompression::Default;
+    BinaryRecordEncoding encoding = BinaryRecordEncoding::Default;
+    size_t block_bytes = kDefaultBinaryBlockBytes;
+};
+
+struct BinaryLogMergeStats {
+    std::string output_path;
+    size_t inputs = 0;
+    size_t records_read = 0;
+    size_t records_written = 0;
+    size_t duplicates = 0;
+    size_t dropped = 0;              // drop_flags
+    size_t late_records = 0;         // out of key order beyond reorder_window (written as read)
+    size_t skipped_blocks = 0;       // keep_flags: input blocks never read
+    size_t corrupt_blocks = 0;       // input blocks that ended a reader early
+    size_t blocks_written = 0;
+    uint64_t bytes_in = 0;
+    uint64_t bytes_out = 0;
+    std::chrono::microseconds elapsed{0};
+};
+
+namespace detail {
+    // One input: its reader and the reorder heap (front = smallest key).
+    struct MergeCursor {
+        std::unique_ptr<BinaryEventLogReader> reader;
+        std::vector<BinaryRecord> window;
+        bool emitted = false;
+        uint64_t last_key = 0;
+    };
+
+    inline std::pair<uint64_t, uint64_t> merge_key(const BinaryRecord& r, MergeKey key) {
+        return key == MergeKey::Timestamp ? std::pair{r.timestamp_us, r.event_id}
+                                          : std::pair{r.event_id, r.timestamp_us};
+    }
+}
+
+// Merge `inputs` into `output_base` + ".bin" (the BinaryEventLog naming). Throws when an input is
+// unreadable or the output would overwrite an input.
+inline BinaryLogMergeStats merge_binary_logs(const std::vector<std::string>& inputs,
+                                             std::string_view output_base,
+                                             const BinaryLogMergeOptions& options = {}) {
+    const auto t0 = std::chrono::steady_clock::now();
+    if (inputs.empty()) {
+        throw std::runtime_error("merge_binary_logs: no input logs");
+    }
+    const std::filesystem::path out_path = std::string(output_base) + ".bin";
+    BinaryLogMergeStats stats;
+    stats.inputs = inputs.size();
+    for (const std::string& in : inputs) {
+        std::error_code ec;
+        if (std::filesystem::equivalent(in, out_path, ec)) {
+            throw std::runtime_error("merge_binary_logs: output would overwrite input " + in);
+        }
+        stats.bytes_in += std::filesystem::file_size(in, ec);
+    }
+
+    const MergeKey key = options.key;
+    const size_t window = std::max<size_t>(options.reorder_window, 1);
+    // Min-heaps: std heap algorithms keep the largest in front, so compare with >.
+    auto record_after = [key](const BinaryRecord& a, const BinaryRecord& b) {
+        return detail::merge_key(a, key) > detail::merge_key(b, key);
+    };
+
+    std::vector<detail::MergeCursor> cursors(inputs.size());
+    size_t int_count = 0;
+    size_t dbl_count = 0;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        detail::MergeCursor& c = cursors[i];
+        c.reader = std::make_unique<BinaryEventLogReader>(inputs[i]);
+        c.reader->set_flag_filter(options.keep_flags);
+        int_count = std::max<size_t>(int_count, c.reader->schema().int_count);
+        dbl_count = std::max<size_t>(dbl_count, c.reader->schema().dbl_count);
+        c.window.reserve(window);
+        while (c.window.size() < window) {
+            c.window.emplace_back();
+            if (!c.reader->next(c.window.back())) {
+                c.window.pop_back();
+                break;
+            }
+            std::push_heap(c.window.begin(), c.window.end(), record_after);
+            ++stats.records_read;
+        }
+    }
+
+    // Heap of input indexes by their smallest buffered record; ties go to the earlier input.
+    auto cursor_after = [&](size_t a, size_t b) {
+        const auto ka = detail::merge_key(cursors[a].window.front(), key);
+        const auto kb = detail::merge_key(cursors[b].window.front(), key);
+        return ka != kb ? ka > kb : a > b;
+    };
+    std::vector<size_t> heap;
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        if (!cursors[i].window.empty()) heap.push_back(i);
+    }
+    std::make_heap(heap.begin(), heap.end(), cursor_after);
+
+    BinaryEventLog out(output_base, int_count, dbl_count, PersistMode::All, 64 * 1024 * 1024,
+                       FileOutputBackend::Default, options.compression, options.block_bytes, options.encoding);
+
+    // Event ids already written at the current primary key value (duplicates sort together).
+    uint64_t run_key = 0;
+    std::vector<uint64_t> run_ids;
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), cursor_after);
+        const size_t ci = heap.back();
+        detail::MergeCursor& c = cursors[ci];
+        std::pop_heap(c.window.begin(), c.window.end(), record_after);
+        BinaryRecord& r = c.window.back();
+
+        const uint64_t primary = detail::merge_key(r, key).first;
+        if (c.emitted && primary < c.last_key) ++stats.late_records;
+        c.emitted = true;
+        c.last_key = std::max(c.last_key, primary);
+
+        bool write = true;
+        if (options.drop_flags != 0 && (r.raw_flags & options.drop_flags) != 0) {
+            ++stats.dropped;
+            write = false;
+        } else if (options.dedupe) {
+            if (run_ids.empty() || primary != run_key) {
+                run_key = primary;
+                run_ids.clear();
+            }
+            if (std::find(run_ids.begin(), run_ids.end(), r.event_id) != run_ids.end()) {
+                ++stats.duplicates;
+                write = false;
+            } else {
+                run_ids.push_back(r.event_id);
+            }
+        }
+        if (write) {
+            out.append_event(r.event_id, r.thread_id, r.per_thread_event_id, r.raw_flags, r.category,
+                             r.payload, r.timestamp_us, r.int_metrics, r.dbl_metrics);
+            ++stats.records_written;
+        }
+
+        // Refill into the slot just consumed (reuses its string / vector capacity).
+        if (c.reader->next(r)) {
+            std::push_heap(c.window.begin(), c.window.end(), record_after);
+            ++stats.records_read;
+        } else {
+            c.window.pop_back();
+        }
+        if (c.window.empty()) {
+            heap.pop_back();
+        } else {
+            std::push_heap(heap.begin(), heap.end(), cursor_after);
+        }
+    }
+
+    out.finalize();
+    for (const detail::MergeCursor& c : cursors) {
+        stats.skipped_blocks += c.reader->skipped_blocks();
+        stats.corrupt_blocks += c.reader->corrupt_blocks();
+    }
+    stats.output_path = out.file_path();
+    stats.blocks_written = out.stats().blocks;
+    std::error_code ec;
+    stats.bytes_out = std::filesystem::file_size(out_path, ec);
+    stats.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0);
+    return stats;
+}
+
+} // namespace jac::ts_store::inline_v001
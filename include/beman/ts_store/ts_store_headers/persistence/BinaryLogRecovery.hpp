@@ -0,0 +1,385 @@
+#pragma once
+
+// BinaryLogRecovery.hpp
+// Read side of BinaryEventLog used for crash recovery (recover_from_binary_log, StoreRecovery.hpp).
+//
+// MappedBinaryLog maps a .bin file read-only and validates it. v2 logs (BinaryLogFormat.hpp) are
+// walked block by block: header checks first, then each block's CRC32C and record framing, on
+// several threads when asked. v1 logs (no magic) are validated through the length prefixes.
+// A log cut short by a crash ends in a torn block/record or in the zero-filled tail of the
+// preallocated mapping; scan() stops at the first thing that does not check out and reports how
+// many bytes it dropped. A finalized v2 log ends in a seek index footer (BinaryLogIndex.hpp,
+// optionally preceded by Bloom filters), which bounds the block data and is not counted as
+// dropped. Compressed and compact v2 blocks are decoded during the scan into buffers owned by
+// the BinaryLogScan; raw blocks are used in place. Decoding (BinaryRecordView) is zero-copy and
+// independent per record, so the caller can fan the valid records out across threads.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "BinaryLogBloom.hpp"
+#include "BinaryLogFormat.hpp"
+#include "BinaryLogIndex.hpp"
+#include "BlockCompression.hpp"
+#include "CompactRecords.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+// One record, pointing into the mapping (or a decoded block). Records are packed back to back, so
+// metric arrays are not 8-byte aligned: use the getters.
+struct BinaryRecordView {
+    uint64_t event_id = 0;
+    uint64_t thread_id = 0;
+    uint64_t per_thread_event_id = 0;
+    uint64_t raw_flags = 0;
+    uint64_t timestamp_us = 0;
+    std::string_view category;
+    std::string_view payload;
+    uint16_t int_count = 0;
+    uint16_t dbl_count = 0;
+    const char* ints = nullptr;
+    const char* dbls = nullptr;
+
+    [[nodiscard]] int64_t int_metric(size_t i) const {
+        int64_t v = 0;
+        std::memcpy(&v, ints + i * sizeof(int64_t), sizeof(v));
+        return v;
+    }
+    [[nodiscard]] double dbl_metric(size_t i) const {
+        double v = 0;
+        std::memcpy(&v, dbls + i * sizeof(double), sizeof(v));
+        return v;
+    }
+};
+
+struct BinaryLogScan {
+    // Length prefix of each valid record: into the mapping, or into `decoded` for compressed
+    // blocks. Valid while both the MappedBinaryLog and this scan are alive.
+    std::vector<const char*> records;
+    std::vector<std::vector<char>> decoded;   // decompressed v2 blocks
+    std::vector<size_t> block_offsets;   // v2: file offset of each valid block header
+    uint16_t version = 1;
+    size_t data_begin = 0;         // first record (v1) / block (v2) byte
+    size_t valid_end = 0;          // one past the last valid record
+    size_t dropped_bytes = 0;      // torn record/block and/or preallocated tail after valid_end
+    size_t index_bytes = 0;        // v2: seek index footer (entries + footer), when present
+    uint64_t max_event_id = 0;
+    uint64_t max_timestamp_us = 0;
+};
+
+class MappedBinaryLog {
+public:
+    // Fixed part of a v1 record body: 5 x u64 + 4 x u16 length/count fields.
+    static constexpr size_t kMinRecordBody = 5 * sizeof(uint64_t) + 4 * sizeof(uint16_t);
+
+    explicit MappedBinaryLog(std::string_view path) : path_(path) {
+        fd_ = ::open(path_.c_str(), O_RDONLY);
+        if (fd_ < 0) {
+            throw std::runtime_error("MappedBinaryLog: failed to open " + path_);
+        }
+        struct stat st{};
+        if (::fstat(fd_, &st) != 0) {
+            ::close(fd_);
+            throw std::runtime_error("MappedBinaryLog: fstat failed for " + path_);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ == 0) return;
+
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd_);
+            throw std::runtime_error("MappedBinaryLog: mmap failed for " + path_);
+        }
+        data_ = static_cast<const char*>(p);
+        // Whole-file sequential read: let the kernel read ahead aggressively.
+        ::madvise(p, size_, MADV_SEQUENTIAL);
+        ::madvise(p, size_, MADV_WILLNEED);
+    }
+
+    ~MappedBinaryLog() {
+        if (data_ != nullptr) ::munmap(const_cast<char*>(data_), size_);
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    MappedBinaryLog(const MappedBinaryLog&) = delete;
+    MappedBinaryLog& operator=(const MappedBinaryLog&) = delete;
+
+    [[nodiscard]] size_t size() const { return size_; }
+    [[nodiscard]] const std::string& path() const { return path_; }
+    [[nodiscard]] const char* data() const { return data_; }
+
+    // 2 when a valid v2 preamble follows the text header, else 1.
+    [[nodiscard]] uint16_t version() const {
+        BinaryLogFileHeader h{};
+        BinaryLogSchema s{};
+        const size_t pos = text_header_end();
+        return parse_binary_log_preamble(data_ + pos, size_ - pos, h, s) ? kBinaryLogVersion : 1;
+    }
+
+    // v2 schema block (zeroed for v1 logs).
+    [[nodiscard]] BinaryLogSchema schema() const {
+        BinaryLogFileHeader h{};
+        BinaryLogSchema s{};
+        const size_t pos = text_header_end();
+        if (!parse_binary_log_preamble(data_ + pos, size_ - pos, h, s)) s = BinaryLogSchema{};
+        return s;
+    }
+
+    // First record (v1) or block (v2) byte.
+    [[nodiscard]] size_t data_begin() const {
+        const size_t pos = text_header_end();
+        return version() == kBinaryLogVersion
+            ? pos + sizeof(BinaryLogFileHeader) + sizeof(BinaryLogSchema) : pos;
+    }
+
+    // Skip the leading "//..." header lines (same rule as BinaryEventLogReader).
+    [[nodiscard]] size_t text_header_end() const {
+        size_t pos = 0;
+        while (pos + 1 < size_ && data_[pos] == '/' && data_[pos + 1] == '/') {
+            const void* nl = std::memchr(data_ + pos, '\n', size_ - pos);
+            if (nl == nullptr) return size_;
+            pos = static_cast<size_t>(static_cast<const char*>(nl) - data_) + 1;
+        }
+        return pos;
+    }
+
+    // v2: the seek index footer, when the log was finalized (false for crashed / v1 logs).
+    [[nodiscard]] bool index_footer(BinaryIndexFooter& f) const {
+        if (size_ < sizeof(BinaryIndexFooter) || version() != kBinaryLogVersion) return false;
+        return parse_index_footer(data_ + size_ - sizeof(f), size_, f) && index_data_end(f) >= data_begin();
+    }
+
+    // End of the block data: where the footer's Bloom filters / entries start, else the file size.
+    [[nodiscard]] size_t data_end() const {
+        BinaryIndexFooter f{};
+        return index_footer(f) ? static_cast<size_t>(index_data_end(f)) : size_;
+    }
+
+    // Per-block Bloom filters of a finalized v2 log, in index order (BinaryLogBloom.hpp). Empty
+    // when the writer built none or the section does not check out.
+    [[nodiscard]] BinaryBloomIndex bloom_filters() const {
+        BinaryIndexFooter f{};
+        if (!index_footer(f) || f.bloom_bytes == 0) return {};
+        return BinaryBloomIndex::parse(data_ + index_data_end(f), f.bloom_bytes, f.entry_count);
+    }
+
+    // Seek index: the footer entries (CRC checked), or rebuilt from the block headers when the
+    // footer is missing or damaged. Empty for v1 logs.
+    [[nodiscard]] BinaryLogIndex index() const {
+        if (version() != kBinaryLogVersion) return {};
+        BinaryIndexFooter f{};
+        if (index_footer(f)) {
+            std::vector<BinaryIndexEntry> entries(f.entry_count);
+            std::memcpy(entries.data(), data_ + f.index_offset, entries.size() * sizeof(BinaryIndexEntry));
+            if (crc32c(entries.data(), entries.size() * sizeof(BinaryIndexEntry)) == f.entries_crc) {
+                return BinaryLogIndex(std::move(entries), true);
+            }
+        }
+        std::vector<BinaryIndexEntry> entries;
+        const size_t end = data_end();
+        BinaryBlockHeader h{};
+        for (size_t pos = data_begin(); parse_block_header(data_ + pos, end - pos, h);
+             pos += sizeof(BinaryBlockHeader) + h.stored_bytes) {
+            entries.push_back(index_entry_from_header(pos, h));
+        }
+        return BinaryLogIndex(std::move(entries), false);
+    }
+
+    // Validate front to back; stops at the first inconsistent block (v2) or record (v1).
+    // threads > 1 spreads v2 CRC and record checks over that many threads.
+    [[nodiscard]] BinaryLogScan scan(size_t threads = 1) const {
+        BinaryLogScan s;
+        s.version = version();
+        s.data_begin = data_begin();
+        size_t end = size_;
+        if (s.version == kBinaryLogVersion) {
+            end = data_end();
+            s.index_bytes = size_ - end;
+            scan_blocks(s, end, threads);
+        } else {
+            s.valid_end = static_cast<size_t>(scan_records(data_ + s.data_begin, data_ + size_, s, nullptr) - data_);
+        }
+        s.dropped_bytes = end - s.valid_end;
+        return s;
+    }
+
+    // Decode a validated record (an entry of BinaryLogScan::records).
+    [[nodiscard]] static BinaryRecordView record(const char* at) {
+        uint32_t len = 0;
+        std::memcpy(&len, at, sizeof(len));
+        BinaryRecordView v;
+        if (!decode(at + sizeof(uint32_t), len, len, v)) {
+            throw std::runtime_error("MappedBinaryLog: corrupt record");
+        }
+        return v;
+    }
+
+    // event_id of a validated record, without decoding the rest.
+    [[nodiscard]] static uint64_t event_id_of(const char* at) {
+        uint64_t id = 0;
+        std::memcpy(&id, at + sizeof(uint32_t), sizeof(id));
+        return id;
+    }
+
+    // Body of `len` bytes at p, with `avail` bytes mapped after p. True when every inner length
+    // stays inside the body and they add up to exactly len.
+    static bool decode(const char* p, uint32_t len, size_t avail, BinaryRecordView& v) {
+        if (len < kMinRecordBody || len > avail) return false;
+        const char* const end = p + len;
+
+        auto u64 = [&p](uint64_t& dst) { std::memcpy(&dst, p, sizeof(dst)); p += sizeof(dst); };
+        auto u16 = [&p, end](uint16_t& dst) {
+            if (static_cast<size_t>(end - p) < sizeof(dst)) return false;
+            std::memcpy(&dst, p, sizeof(dst));
+            p += sizeof(dst);
+            return true;
+        };
+        auto take = [&p, end](size_t n) -> const char* {
+            if (static_cast<size_t>(end - p) < n) return nullptr;
+            const char* at = p;
+            p += n;
+            return at;
+        };
+
+        u64(v.event_id);
+        u64(v.thread_id);
+        u64(v.per_thread_event_id);
+        u64(v.raw_flags);
+        u64(v.timestamp_us);
+
+        uint16_t cl = 0, pl = 0;
+        if (!u16(cl)) return false;
+        const char* cat = take(cl);
+        if (cat == nullptr || !u16(pl)) return false;
+        const char* pay = take(pl);
+        if (pay == nullptr || !u16(v.int_count)) return false;
+        v.ints = take(size_t{v.int_count} * sizeof(int64_t));
+        if (v.ints == nullptr || !u16(v.dbl_count)) return false;
+        v.dbls = take(size_t{v.dbl_count} * sizeof(double));
+        if (v.dbls == nullptr || p != end) return false;
+
+        v.category = std::string_view(cat, cl);
+        v.payload = std::string_view(pay, pl);
+        return true;
+    }
+
+private:
+    // Records back to back in [pos, end); appends them and returns where validation stopped.
+    // With `expected` set, the range must hold exactly that many records and nothing else
+    // (nullptr otherwise).
+    static const char* scan_records(const char* pos, const char* end, BinaryLogScan& s, const uint32_t* expected) {
+        BinaryRecordView v;
+        uint32_t n = 0;
+        while (static_cast<size_t>(end - pos) >= sizeof(uint32_t)) {
+            uint32_t len = 0;
+            std::memcpy(&len, pos, sizeof(len));
+            if (!decode(pos + sizeof(uint32_t), len, static_cast<size_t>(end - pos) - sizeof(uint32_t), v)) break;
+            s.records.push_back(pos);
+            if (v.event_id > s.max_event_id) s.max_event_id = v.event_id;
+            if (v.timestamp_us > s.max_timestamp_us) s.max_timestamp_us = v.timestamp_us;
+            pos += sizeof(uint32_t) + len;
+            ++n;
+        }
+        if (expected != nullptr && (n != *expected || pos != end)) return nullptr;
+        return pos;
+    }
+
+    void scan_blocks(BinaryLogScan& s, size_t end, size_t threads) const {
+        // 1. Walk the header chain (cheap, sequential).
+        std::vector<BinaryBlockHeader> headers;
+        size_t pos = s.data_begin;
+        BinaryBlockHeader h{};
+        while (parse_block_header(data_ + pos, end - pos, h) &&
+               block_codec_available(block_codec_of(h)) &&
+               (block_codec_of(h) != BlockCodec::None || h.raw_bytes == h.stored_bytes)) {
+            s.block_offsets.push_back(pos);
+            headers.push_back(h);
+            pos += sizeof(BinaryBlockHeader) + h.stored_bytes;
+        }
+
+        // 2. CRC, decompression and record framing per block, independent -> parallel.
+        const size_t nblocks = headers.size();
+        std::vector<BinaryLogScan> parts(nblocks);
+        std::vector<char> ok(nblocks, 0);
+        auto check = [&](size_t b) {
+            const BinaryBlockHeader& bh = headers[b];
+            const char* body = data_ + s.block_offsets[b] + sizeof(BinaryBlockHeader);
+            if (!verify_block_payload(bh, body)) return;
+            std::vector<char> raw, scratch;
+            const char* records = nullptr;
+            size_t len = 0;
+            if (!block_records(bh, body, raw, scratch, records, len)) return;
+            if (records == raw.data()) parts[b].decoded.push_back(std::move(raw));   // moving keeps the address
+            body = records;
+            ok[b] = scan_records(body, body + len, parts[b], &bh.record_count) != nullptr;
+        };
+        threads = std::max<size_t>(1, std::min(threads, nblocks));
+        if (threads == 1) {
+            for (size_t b = 0; b < nblocks; ++b) check(b);
+        } else {
+            std::vector<std::thread> pool;
+            for (size_t t = 0; t < threads; ++t) {
+                pool.emplace_back([&, t] { for (size_t b = t; b < nblocks; b += threads) check(b); });
+            }
+            for (auto& th : pool) th.join();
+        }
+
+        // 3. Keep the valid prefix.
+        size_t good = 0;
+        while (good < nblocks && ok[good]) ++good;
+        s.block_offsets.resize(good);
+        s.valid_end = good == 0 ? s.data_begin
+                                : s.block_offsets[good - 1] + sizeof(BinaryBlockHeader) + headers[good - 1].stored_bytes;
+        for (size_t b = 0; b < good; ++b) {
+            s.records.insert(s.records.end(), parts[b].records.begin(), parts[b].records.end());
+            for (auto& d : parts[b].decoded) s.decoded.push_back(std::move(d));   // buffers keep their address
+            if (parts[b].max_event_id > s.max_event_id) s.max_event_id = parts[b].max_event_id;
+            if (parts[b].max_timestamp_us > s.max_timestamp_us) s.max_timestamp_us = parts[b].max_timestamp_us;
+        }
+    }
+
+    std::string path_;
+    int fd_ = -1;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+struct RecoveryOptions {
+    // Load at most this many of the most recent valid records (0 = as many as the store holds).
+    size_t max_events = 0;
+    // Decoder threads (0 = std::thread::hardware_concurrency()).
+    size_t threads = 0;
+    // Shift the store's timestamp epoch so events saved after recovery continue after the
+    // newest recovered timestamp instead of restarting near zero.
+    bool continue_timestamps = true;
+    // Rows kept free for new events: records with event_id >= capacity - headroom are skipped.
+    size_t headroom = 0;
+};
+
+struct RecoveryResult {
+    size_t records_valid = 0;     // records that passed validation
+    size_t loaded = 0;            // placed into the store
+    size_t skipped_window = 0;    // older than the max_events window
+    size_t skipped_range = 0;     // event_id >= store capacity
+    size_t dropped_bytes = 0;     // torn / preallocated tail after the last valid record
+    size_t next_id = 0;           // the store's next_id_ after recovery
+    size_t capacity_left = 0;     // rows still free for save_event (0 = the store is full)
+    size_t threads = 0;
+    std::chrono::microseconds elapsed{0};
+};
+
+} // namespace jac::ts_store::inline_v001
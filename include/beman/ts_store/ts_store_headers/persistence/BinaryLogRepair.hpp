@@ -0,0 +1,356 @@
+#pragma once
+
+// BinaryLogRepair.hpp
+// Offline integrity check and crash repair of a binary log (library side of ts_binlog_repair).
+//
+// A writer that dies before finalize() leaves the file at its preallocated size: complete
+// blocks, then possibly one torn block, then zeros up to the end of the last mmap window, and no
+// index footer. check_binary_log() walks the block header chain (cheap hops, sequential) and then
+// validates every block in parallel. It checks the CRC32C, expands compressed / compact blocks and
+// requires that the record framing decodes to exactly the header's record count. The report gives
+// the last consistent offset and what lies after it. repair_binary_log() cuts the file there and,
+// for v2, appends a rebuilt index footer (exact id ranges), so the result reads like a finalized
+// log and is marked closed for live readers. The rebuilt footer carries no Bloom filters
+// (BinaryLogBloom.hpp); readers of a repaired log simply read every block.
+//
+// Salvage (v2 only): blocks after a damaged one are found again by their magic and kept only if
+// they validate in full; repair moves them down to close the gap. v1 logs have no framing to
+// resync on and are cut at the last decodable record.
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "BinaryLogFormat.hpp"
+#include "BinaryLogIndex.hpp"
+#include "BinaryLogRecovery.hpp"
+#include "BlockCompression.hpp"
+#include "CompactRecords.hpp"
+#include "LiveBinaryLog.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+struct BinaryLogCheckOptions {
+    size_t threads = 0;          // block validation threads (0 = hardware_concurrency)
+    bool salvage = false;        // v2: look for intact blocks after the first damaged one
+};
+
+struct BinaryLogCheckReport {
+    std::string path;
+    uint16_t version = 1;
+    size_t file_bytes = 0;
+    size_t data_begin = 0;       // first block (v2) / record (v1)
+    size_t data_end = 0;         // end of the block data when finalized, else file_bytes
+    bool finalized = false;      // valid index footer present
+    bool damaged_preamble = false;   // v2 magic but the header / schema CRC fails: not repairable
+    uint64_t committed_bytes = 0;    // live commit marker left by the writer (0 = none)
+    size_t blocks_valid = 0;     // v2: consecutive valid blocks from the start
+    size_t records_valid = 0;
+    uint64_t max_event_id = 0;
+    uint64_t max_timestamp_us = 0;
+    size_t consistent_end = 0;   // one past the last valid block / record
+    size_t tail_bytes = 0;       // data_end - consistent_end
+    bool tail_zero = false;      // the whole tail is zeros (preallocated, never written)
+    std::string first_error;     // why validation stopped early; empty when it reached data_end
+    size_t first_error_offset = 0;
+    size_t salvage_blocks = 0;   // intact blocks found after the damage (salvage)
+    size_t salvage_records = 0;
+    size_t salvage_bytes = 0;
+    size_t threads = 0;
+    std::chrono::microseconds elapsed{0};
+
+    // Nothing to cut; a v2 log may still lack its footer.
+    [[nodiscard]] bool consistent() const { return tail_bytes == 0; }
+    [[nodiscard]] bool needs_repair() const {
+        return damaged_preamble || tail_bytes != 0 || (version == kBinaryLogVersion && !finalized);
+    }
+};
+
+struct BinaryLogRepairResult {
+    BinaryLogCheckReport check;
+    bool changed = false;
+    size_t size_before = 0;
+    size_t size_after = 0;
+    size_t blocks_kept = 0;      // valid prefix + salvaged
+    size_t records_kept = 0;
+    size_t dropped_bytes = 0;    // tail bytes not kept (salvaged blocks excluded)
+    bool index_written = false;
+};
+
+namespace detail {
+    struct CheckedBlock {
+        size_t offset = 0;
+        BinaryBlockHeader header{};
+        uint64_t min_event_id = 0;
+        uint64_t max_event_id = 0;
+        uint64_t max_timestamp_us = 0;
+        bool ok = false;
+    };
+
+    // CRC, codec, and record framing of one block; fills the id / time ranges.
+    inline bool validate_block(const char* body, CheckedBlock& b, std::vector<char>& raw, std::vector<char>& scratch) {
+        const BinaryBlockHeader& h = b.header;
+        if (!block_codec_available(block_codec_of(h)) ||
+            (block_codec_of(h) == BlockCodec::None && h.raw_bytes != h.stored_bytes) ||
+            !verify_block_payload(h, body)) return false;
+        const char* records = nullptr;
+        size_t len = 0;
+        if (!block_records(h, body, raw, scratch, records, len)) return false;
+        const char* p = records;
+        const char* const end = records + len;
+        uint32_t n = 0;
+        BinaryRecordView v;
+        b.min_event_id = UINT64_MAX;
+        while (static_cast<size_t>(end - p) >= sizeof(uint32_t)) {
+            uint32_t rl = 0;
+            std::memcpy(&rl, p, sizeof(rl));
+            if (!MappedBinaryLog::decode(p + sizeof(rl), rl, static_cast<size_t>(end - p) - sizeof(rl), v)) return false;
+            b.min_event_id = std::min(b.min_event_id, v.event_id);
+            b.max_event_id = std::max(b.max_event_id, v.event_id);
+            b.max_timestamp_us = std::max(b.max_timestamp_us, v.timestamp_us);
+            p += sizeof(rl) + rl;
+            ++n;
+        }
+        return p == end && n == h.record_count && n != 0;
+    }
+
+    inline bool all_zero(const char* p, size_t n) {
+        static constexpr char zeros[4096] = {};
+        for (size_t at = 0; at < n; at += sizeof(zeros)) {
+            if (std::memcmp(p + at, zeros, std::min(sizeof(zeros), n - at)) != 0) return false;
+        }
+        return true;
+    }
+
+    struct CheckState {
+        BinaryLogCheckReport report;
+        std::vector<CheckedBlock> blocks;      // valid prefix
+        std::vector<CheckedBlock> salvaged;    // intact blocks after the damage
+        size_t header_offset = 0;              // BinaryLogFileHeader (v2)
+    };
+
+    inline CheckState check_mapped(const MappedBinaryLog& log, const BinaryLogCheckOptions& options) {
+        const auto start = std::chrono::steady_clock::now();
+        CheckState st;
+        BinaryLogCheckReport& r = st.report;
+        r.path = log.path();
+        r.file_bytes = log.size();
+        r.threads = options.threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : options.threads;
+        if (log.size() == 0) {
+            r.first_error = "empty file";
+            r.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+            return st;
+        }
+        const char* const data = log.data();
+        r.version = log.version();
+        r.data_begin = log.data_begin();
+        r.data_end = log.data_end();
+        st.header_offset = log.text_header_end();
+
+        if (r.version != kBinaryLogVersion &&
+            has_binary_log_magic(data + st.header_offset, log.size() - st.header_offset)) {
+            r.damaged_preamble = true;   // not v1: do not cut it as if it were
+            r.first_error = "damaged v2 file header or schema";
+            r.first_error_offset = st.header_offset;
+            r.consistent_end = r.data_end = log.size();
+        } else if (r.version != kBinaryLogVersion) {   // v1: the record scan is the check
+            const BinaryLogScan s = log.scan(1);
+            r.records_valid = s.records.size();
+            r.max_event_id = s.max_event_id;
+            r.max_timestamp_us = s.max_timestamp_us;
+            r.consistent_end = s.valid_end;
+        } else {
+            BinaryIndexFooter f{};
+            r.finalized = log.index_footer(f);
+            BinaryLogFileHeader fh{};
+            std::memcpy(&fh, data + st.header_offset, sizeof(fh));
+            r.committed_bytes = fh.committed_bytes;
+
+            // 1. Header chain (sequential, touches only the headers).
+            size_t pos = r.data_begin;
+            CheckedBlock b;
+            while (parse_block_header(data + pos, r.data_end - pos, b.header)) {
+                b.offset = pos;
+                st.blocks.push_back(b);
+                pos += sizeof(BinaryBlockHeader) + b.header.stored_bytes;
+            }
+            if (pos < r.data_end) {
+                r.first_error = r.data_end - pos < sizeof(BinaryBlockHeader) ? "truncated block header"
+                                                                             : "bad block header";
+                r.first_error_offset = pos;
+            }
+
+            // 2. Payloads in parallel.
+            const size_t nblocks = st.blocks.size();
+            const size_t threads = std::max<size_t>(1, std::min(r.threads, nblocks));
+            auto check = [&](size_t t) {
+                std::vector<char> raw, scratch;
+                for (size_t i = t; i < nblocks; i += threads) {
+                    CheckedBlock& cb = st.blocks[i];
+                    cb.ok = validate_block(data + cb.offset + sizeof(BinaryBlockHeader), cb, raw, scratch);
+                }
+            };
+            if (threads == 1) {
+                check(0);
+            } else {
+                std::vector<std::thread> pool;
+                for (size_t t = 0; t < threads; ++t) pool.emplace_back(check, t);
+                for (auto& th : pool) th.join();
+            }
+
+            // 3. Valid prefix.
+            size_t good = 0;
+            while (good < nblocks && st.blocks[good].ok) ++good;
+            if (good < nblocks) {
+                r.first_error = "block payload failed CRC or record framing";
+                r.first_error_offset = st.blocks[good].offset;
+            }
+            st.blocks.resize(good);
+            r.blocks_valid = good;
+            for (const CheckedBlock& cb : st.blocks) {
+                r.records_valid += cb.header.record_count;
+                r.max_event_id = std::max(r.max_event_id, cb.max_event_id);
+                r.max_timestamp_us = std::max(r.max_timestamp_us, cb.max_timestamp_us);
+            }
+            r.consistent_end = good == 0 ? r.data_begin
+                                         : st.blocks.back().offset + sizeof(BinaryBlockHeader) + st.blocks.back().header.stored_bytes;
+
+            // 4. Salvage: resync on the block magic after the damage.
+            if (options.salvage && r.consistent_end < r.data_end) {
+                char magic[sizeof(kBinaryBlockMagic)];
+                std::memcpy(magic, &kBinaryBlockMagic, sizeof(magic));
+                std::vector<char> raw, scratch;
+                size_t at = r.consistent_end + 1;
+                while (at < r.data_end) {
+                    const void* hit = ::memmem(data + at, r.data_end - at, magic, sizeof(magic));
+                    if (hit == nullptr) break;
+                    const size_t cand = static_cast<size_t>(static_cast<const char*>(hit) - data);
+                    CheckedBlock sb;
+                    sb.offset = cand;
+                    if (parse_block_header(data + cand, r.data_end - cand, sb.header) &&
+                        validate_block(data + cand + sizeof(BinaryBlockHeader), sb, raw, scratch)) {
+                        sb.ok = true;
+                        st.salvaged.push_back(sb);
+                        r.salvage_records += sb.header.record_count;
+                        r.salvage_bytes += sizeof(BinaryBlockHeader) + sb.header.stored_bytes;
+                        at = cand + sizeof(BinaryBlockHeader) + sb.header.stored_bytes;
+                    } else {
+                        at = cand + 1;
+                    }
+                }
+                r.salvage_blocks = st.salvaged.size();
+            }
+        }
+        r.tail_bytes = r.data_end - r.consistent_end;
+        r.tail_zero = r.tail_bytes != 0 && all_zero(data + r.consistent_end, r.tail_bytes);
+        if (r.tail_zero && r.first_error.empty()) r.first_error = "zero-filled tail";
+        r.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        return st;
+    }
+
+    inline void pwrite_all(int fd, const void* p, size_t n, size_t offset) {
+        const char* c = static_cast<const char*>(p);
+        for (size_t done = 0; done < n;) {
+            const ssize_t w = ::pwrite(fd, c + done, n - done, static_cast<off_t>(offset + done));
+            if (w < 0 && errno == EINTR) continue;
+            if (w <= 0) throw std::runtime_error("repair_binary_log: write failed");
+            done += static_cast<size_t>(w);
+        }
+    }
+}
+
+// Validate without modifying the file.
+inline BinaryLogCheckReport check_binary_log(std::string_view path, BinaryLogCheckOptions options = {}) {
+    MappedBinaryLog log(path);
+    return detail::check_mapped(log, options).report;
+}
+
+// Cut the log at its last consistent offset (keeping salvaged blocks when asked) and, for v2,
+// rewrite the index footer. A finalized, consistent log is left untouched.
+inline BinaryLogRepairResult repair_binary_log(std::string_view path, BinaryLogCheckOptions options = {}) {
+    BinaryLogRepairResult res;
+    std::vector<detail::CheckedBlock> keep;
+    size_t header_offset = 0;
+    {
+        MappedBinaryLog log(path);
+        detail::CheckState st = detail::check_mapped(log, options);
+        res.check = std::move(st.report);
+        keep = std::move(st.blocks);
+        keep.insert(keep.end(), st.salvaged.begin(), st.salvaged.end());
+        header_offset = st.header_offset;
+    }
+    const BinaryLogCheckReport& r = res.check;
+    res.size_before = res.size_after = r.file_bytes;
+    res.blocks_kept = keep.size();
+    res.records_kept = r.records_valid + r.salvage_records;
+    if (r.damaged_preamble) {
+        throw std::runtime_error("repair_binary_log: " + r.first_error + " in " + r.path);
+    }
+    if (!r.needs_repair() || r.file_bytes == 0) return res;
+
+    const std::string p(path);
+    const int fd = ::open(p.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("repair_binary_log: cannot open " + p + " for writing");
+    }
+    size_t end = r.consistent_end;
+    try {
+        if (r.version == kBinaryLogVersion) {
+            // Move salvaged blocks down behind the valid prefix.
+            for (size_t i = r.blocks_valid; i < keep.size(); ++i) {
+                detail::CheckedBlock& b = keep[i];
+                const size_t n = sizeof(BinaryBlockHeader) + b.header.stored_bytes;
+                if (b.offset != end) {
+                    std::vector<char> buf(n);
+                    if (::pread(fd, buf.data(), n, static_cast<off_t>(b.offset)) != static_cast<ssize_t>(n)) {
+                        throw std::runtime_error("repair_binary_log: read failed");
+                    }
+                    detail::pwrite_all(fd, buf.data(), n, end);
+                }
+                b.offset = end;
+                end += n;
+            }
+            std::vector<BinaryIndexEntry> index;
+            index.reserve(keep.size());
+            for (const detail::CheckedBlock& b : keep) {
+                index.push_back(make_index_entry(b.offset, b.header, b.min_event_id, b.max_event_id));
+            }
+            const BinaryIndexFooter f = make_index_footer(index, end);
+            if (!index.empty()) detail::pwrite_all(fd, index.data(), index.size() * sizeof(BinaryIndexEntry), end);
+            detail::pwrite_all(fd, &f, sizeof(f), end + index.size() * sizeof(BinaryIndexEntry));
+            res.index_written = true;
+            res.size_after = end + index.size() * sizeof(BinaryIndexEntry) + sizeof(f);
+        } else {
+            res.size_after = end;
+        }
+        if (::ftruncate(fd, static_cast<off_t>(res.size_after)) != 0 || ::fdatasync(fd) != 0) {
+            throw std::runtime_error("repair_binary_log: truncate failed for " + p);
+        }
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+    if (r.version == kBinaryLogVersion) {   // a live reader of the crashed log sees it closed
+        BinaryLogCommitPublisher live;
+        if (live.open(p, header_offset)) live.publish(end, true);
+    }
+    res.changed = true;
+    res.dropped_bytes = r.tail_bytes - r.salvage_bytes;
+    return res;
+}
+
+} // namespace jac::ts_store::inline_v001
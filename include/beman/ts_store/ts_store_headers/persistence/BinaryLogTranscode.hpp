@@ -0,0 +1,246 @@
+#pragma once
+
+// BinaryLogTranscode.hpp
+// Parallel conversion of a binary log into inspectable formats (library side of
+// ts_binlog_transcode; jText output is BinaryEventLogReader::convert_to_jtext).
+//
+// CSV: blocks are checked, decoded and formatted into text on all cores (parallel_transform);
+// the formatted blocks are written in file order, so the output matches a sequential conversion.
+//
+// Sink (e.g. SqlEventSink): workers build PersistedEvent rows per block and queue them, in file
+// order, to one dedicated writer thread. That thread merges queued blocks into batches of
+// batch_rows and calls IEventSink::write_batch (one transaction per batch for SQLite). The queue
+// holds at most queue_blocks blocks: when the sink is the bottleneck the decoders wait
+// (writer_wait reports how long) instead of buffering the log in memory.
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <format>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "BinaryLogRecovery.hpp"
+#include "EventSink.hpp"
+#include "ParallelBinaryLogScan.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+struct TranscodeOptions {
+    size_t threads = 0;              // decode / format threads (0 = hardware_concurrency)
+    BinaryScanFilter filter{};       // blocks pruned from the index, then records tested
+    size_t batch_rows = 100'000;     // sink: rows per write_batch
+    size_t queue_blocks = 0;         // sink: decoded blocks waiting for the writer (0 = 2 x threads)
+};
+
+struct TranscodeResult {
+    ParallelScanResult scan{};       // records_matched = rows converted
+    uint64_t bytes_out = 0;          // CSV: bytes written
+    size_t batches = 0;              // sink: write_batch calls
+    std::chrono::microseconds writer_wait{0};   // sink: decoders blocked on a full queue
+    std::chrono::microseconds elapsed{0};
+};
+
+namespace detail {
+    inline void append_csv_field(std::string& out, std::string_view s) {
+        if (s.find_first_of(",\"\r\n") == std::string_view::npos) {
+            out += s;
+            return;
+        }
+        out += '"';
+        for (char c : s) {
+            if (c == '"') out += '"';
+            out += c;
+        }
+        out += '"';
+    }
+
+    inline void write_all(int fd, const std::string& s, const std::string& path) {
+        size_t done = 0;
+        while (done < s.size()) {
+            const ssize_t n = ::write(fd, s.data() + done, s.size() - done);
+            if (n < 0) throw std::runtime_error("transcode: write failed on " + path);
+            done += static_cast<size_t>(n);
+        }
+    }
+}
+
+// Header line: id, thread, per-thread id, flags, category, payload, timestamp, int0.., dbl0..
+inline void append_csv_header(std::string& out, size_t int_count, size_t dbl_count) {
+    out += "event_id,thread_id,per_thread_event_id,flags_raw,category,payload,timestamp_us";
+    for (size_t i = 0; i < int_count; ++i) std::format_to(std::back_inserter(out), ",int{}", i);
+    for (size_t i = 0; i < dbl_count; ++i) std::format_to(std::back_inserter(out), ",dbl{}", i);
+    out += '\n';
+}
+
+// One RFC 4180 row. Metrics beyond int_count / dbl_count are dropped, missing ones left empty;
+// doubles use the shortest round-trip form.
+inline void append_csv_row(std::string& out, const BinaryRecordView& r, size_t int_count, size_t dbl_count) {
+    auto it = std::back_inserter(out);
+    std::format_to(it, "{},{},{},{},", r.event_id, r.thread_id, r.per_thread_event_id, r.raw_flags);
+    detail::append_csv_field(out, r.category);
+    out += ',';
+    detail::append_csv_field(out, r.payload);
+    std::format_to(it, ",{}", r.timestamp_us);
+    for (size_t i = 0; i < int_count; ++i) {
+        out += ',';
+        if (i < r.int_count) std::format_to(it, "{}", r.int_metric(i));
+    }
+    for (size_t i = 0; i < dbl_count; ++i) {
+        out += ',';
+        if (i < r.dbl_count) std::format_to(it, "{}", r.dbl_metric(i));
+    }
+    out += '\n';
+}
+
+// Write the log as CSV to csv_path (truncated). int_count / dbl_count: metric columns; pass the
+// schema counts for v2 logs.
+inline TranscodeResult transcode_binary_log_to_csv(const MappedBinaryLog& log,
+                                                   const std::string& csv_path,
+                                                   size_t int_count,
+                                                   size_t dbl_count,
+                                                   const TranscodeOptions& options = {}) {
+    const auto t0 = std::chrono::steady_clock::now();
+    const int fd = ::open(csv_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) throw std::runtime_error("transcode: cannot create " + csv_path);
+
+    TranscodeResult result;
+    try {
+        std::string header;
+        append_csv_header(header, int_count, dbl_count);
+        detail::write_all(fd, header, csv_path);
+        result.bytes_out = header.size();
+
+        ParallelScanOptions scan;
+        scan.threads = options.threads;
+        scan.filter = options.filter;
+        result.scan = parallel_transform<std::string>(log,
+            [int_count, dbl_count](std::string& text, const BinaryRecordView& r) {
+                append_csv_row(text, r, int_count, dbl_count);
+            },
+            [&](const std::string& text) {
+                detail::write_all(fd, text, csv_path);
+                result.bytes_out += text.size();
+            },
+            scan);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    if (::close(fd) != 0) throw std::runtime_error("transcode: close failed on " + csv_path);
+    result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0);
+    return result;
+}
+
+// Feed every record to sink in file order from one writer thread, then sink.flush(). The caller
+// owns the sink and calls finalize().
+inline TranscodeResult transcode_binary_log_to_sink(const MappedBinaryLog& log,
+                                                    IEventSink& sink,
+                                                    const TranscodeOptions& options = {}) {
+    const auto t0 = std::chrono::steady_clock::now();
+    TranscodeResult result;
+
+    const size_t threads = options.threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : options.threads;
+    const size_t depth = options.queue_blocks == 0 ? 2 * threads : options.queue_blocks;
+    const size_t batch_rows = std::max<size_t>(options.batch_rows, 1);
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<std::vector<PersistedEvent>> queue;
+    bool done = false;
+    std::exception_ptr sink_error;
+
+    std::thread writer([&] {
+        std::vector<PersistedEvent> batch;
+        for (;;) {
+            {
+                std::unique_lock lk(mtx);
+                cv.wait(lk, [&] { return !queue.empty() || done; });
+                if (queue.empty()) return;
+                while (!queue.empty() && batch.size() < batch_rows) {
+                    std::vector<PersistedEvent>& block = queue.front();
+                    batch.insert(batch.end(), std::make_move_iterator(block.begin()),
+                                 std::make_move_iterator(block.end()));
+                    queue.pop_front();
+                }
+            }
+            cv.notify_all();
+            try {
+                sink.write_batch(batch);
+            } catch (...) {
+                std::lock_guard lk(mtx);
+                sink_error = std::current_exception();
+                queue.clear();
+                cv.notify_all();
+                return;
+            }
+            ++result.batches;
+            batch.clear();
+        }
+    });
+
+    auto stop_writer = [&] {
+        {
+            std::lock_guard lk(mtx);
+            done = true;
+        }
+        cv.notify_all();
+        writer.join();
+    };
+
+    ParallelScanOptions scan;
+    scan.threads = threads;
+    scan.filter = options.filter;
+    try {
+        result.scan = parallel_transform<std::vector<PersistedEvent>>(log,
+            [](std::vector<PersistedEvent>& rows, const BinaryRecordView& r) {
+                PersistedEvent& e = rows.emplace_back();
+                e.event_id = static_cast<size_t>(r.event_id);
+                e.thread_id = static_cast<size_t>(r.thread_id);
+                e.per_thread_event_id = static_cast<size_t>(r.per_thread_event_id);
+                e.flags = r.raw_flags;
+                e.category.assign(r.category);
+                e.payload.assign(r.payload);
+                e.timestamp_us = r.timestamp_us;
+                e.int_metrics.resize(r.int_count);
+                e.dbl_metrics.resize(r.dbl_count);
+                for (size_t i = 0; i < r.int_count; ++i) e.int_metrics[i] = r.int_metric(i);
+                for (size_t i = 0; i < r.dbl_count; ++i) e.dbl_metrics[i] = r.dbl_metric(i);
+            },
+            [&](std::vector<PersistedEvent>& rows) {
+                const auto wait_start = std::chrono::steady_clock::now();
+                std::unique_lock lk(mtx);
+                cv.wait(lk, [&] { return queue.size() < depth || sink_error; });
+                result.writer_wait += std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - wait_start);
+                if (sink_error) std::rethrow_exception(sink_error);
+                queue.push_back(std::move(rows));
+                lk.unlock();
+                cv.notify_all();
+            },
+            scan);
+    } catch (...) {
+        stop_writer();
+        throw;
+    }
+    stop_writer();
+    if (sink_error) std::rethrow_exception(sink_error);
+    sink.flush();
+    result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0);
+    return result;
+}
+
+} // namespace jac::ts_store::inline_v001
@@ -0,0 +1,266 @@
+#pragma once
+
+// BlockCompression.hpp
+// Codecs for v2 binary log blocks (BinaryBlockHeader::codec).
+//   Lz   — self-contained LZ77 in the LZ4 block layout (token / literals / 16-bit offset /
+//          match length), greedy with a 4-byte hash table; always available, ~GB/s decode
+//   Zlib — system zlib at level 1, when CMake found it (TS_STORE_HAVE_ZLIB)
+//   Zstd — system zstd at level 1, when CMake found it (TS_STORE_HAVE_ZSTD)
+// compress_block() returns false when the codec is unavailable or the block does not shrink;
+// the writer then stores the block raw (BlockCodec::None). Decoders check every length against
+// both buffers, so a corrupt block fails instead of overrunning.
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "BinaryLogFormat.hpp"
+#include "PersistCommon.hpp"
+
+#if defined(TS_STORE_HAVE_ZLIB)
+#include <zlib.h>
+#endif
+#if defined(TS_STORE_HAVE_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace jac::ts_store::inline_v001 {
+
+namespace detail {
+    inline constexpr size_t kLzMinMatch = 4;
+    inline constexpr size_t kLzLastLiterals = 5;    // block ends with at least this many literals
+    inline constexpr size_t kLzMatchLimit = 12;     // no match may start in the last 12 bytes
+    inline constexpr size_t kLzMaxOffset = 65535;
+    inline constexpr unsigned kLzHashBits = 14;
+
+    inline uint32_t lz_read32(const char* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+    inline uint32_t lz_hash(uint32_t v) { return (v * 2654435761u) >> (32 - kLzHashBits); }
+
+    // Worst case for incompressible input.
+    inline size_t lz_bound(size_t n) { return n + n / 255 + 16; }
+
+    // Returns compressed size, or 0 if it would not fit in cap.
+    inline size_t lz_compress(const char* src, size_t n, char* dst, size_t cap) {
+        std::vector<uint32_t> table(size_t{1} << kLzHashBits, 0);
+        size_t ip = 0, anchor = 0, op = 0;
+
+        auto put_len = [&](size_t len) {   // 255-run extension after a nibble of 15
+            for (; len >= 255; len -= 255) dst[op++] = static_cast<char>(255);
+            dst[op++] = static_cast<char>(len);
+        };
+        auto emit = [&](size_t lit_len, size_t offset, size_t match_len) -> bool {
+            const size_t worst = 1 + lit_len / 255 + 1 + lit_len + 2 + match_len / 255 + 1;
+            if (op + worst > cap) return false;
+            const size_t ml = match_len - kLzMinMatch;
+            const auto token = static_cast<unsigned char>(((lit_len >= 15 ? 15 : lit_len) << 4) |
+                                                          (ml >= 15 ? 15 : ml));
+            dst[op++] = static_cast<char>(token);
+            if (lit_len >= 15) put_len(lit_len - 15);
+            std::memcpy(dst + op, src + anchor, lit_len);
+            op += lit_len;
+            const auto off = static_cast<uint16_t>(offset);
+            std::memcpy(dst + op, &off, 2);
+            op += 2;
+            if (ml >= 15) put_len(ml - 15);
+            return true;
+        };
+
+        if (n > kLzMatchLimit) {
+            const size_t limit = n - kLzMatchLimit;
+            const size_t match_end = n - kLzLastLiterals;
+            while (ip < limit) {
+                const uint32_t seq = lz_read32(src + ip);
+                const uint32_t h = lz_hash(seq);
+                const size_t ref = table[h];
+                table[h] = static_cast<uint32_t>(ip);
+                if (ref < ip && ip - ref <= kLzMaxOffset && lz_read32(src + ref) == seq) {
+                    size_t len = kLzMinMatch;
+                    bool ended = false;
+                    while (!ended && ip + len + 8 <= match_end) {   // 8 bytes per step
+                        uint64_t a, b;
+                        std::memcpy(&a, src + ip + len, 8);
+                        std::memcpy(&b, src + ref + len, 8);
+                        if (a != b) {
+                            len += static_cast<size_t>(std::countr_zero(a ^ b)) / 8;
+                            ended = true;
+                        } else {
+                            len += 8;
+                        }
+                    }
+                    while (!ended && ip + len < match_end && src[ref + len] == src[ip + len]) ++len;
+                    if (!emit(ip - anchor, ip - ref, len)) return 0;
+                    ip += len;
+                    anchor = ip;
+                    if (ip - 2 < limit) table[lz_hash(lz_read32(src + ip - 2))] = static_cast<uint32_t>(ip - 2);
+                } else {
+                    ip += 1 + ((ip - anchor) >> 6);   // skip faster through incompressible runs
+                }
+            }
+        }
+
+        const size_t lit_len = n - anchor;   // last sequence: literals only
+        if (op + 1 + lit_len / 255 + 1 + lit_len > cap) return 0;
+        dst[op++] = static_cast<char>((lit_len >= 15 ? 15 : lit_len) << 4);
+        if (lit_len >= 15) put_len(lit_len - 15);
+        std::memcpy(dst + op, src + anchor, lit_len);
+        return op + lit_len;
+    }
+
+    // True when src decodes to exactly out_n bytes.
+    inline bool lz_decompress(const char* src, size_t n, char* dst, size_t out_n) {
+        size_t ip = 0, op = 0;
+        auto get_len = [&](size_t& len) -> bool {
+            unsigned char b = 0;
+            do {
+                if (ip >= n) return false;
+                b = static_cast<unsigned char>(src[ip++]);
+                len += b;
+            } while (b == 255);
+            return true;
+        };
+        while (ip < n) {
+            const auto token = static_cast<unsigned char>(src[ip++]);
+            size_t lit = token >> 4;
+            if (lit == 15 && !get_len(lit)) return false;
+            if (lit > n - ip || lit > out_n - op) return false;
+            std::memcpy(dst + op, src + ip, lit);
+            ip += lit;
+            op += lit;
+            if (ip == n) break;   // last sequence has no match
+
+            if (n - ip < 2) return false;
+            uint16_t off = 0;
+            std::memcpy(&off, src + ip, 2);
+            ip += 2;
+            size_t ml = token & 15u;
+            if (ml == 15 && !get_len(ml)) return false;
+            ml += kLzMinMatch;
+            if (off == 0 || off > op || ml > out_n - op) return false;
+
+            const char* from = dst + op - off;
+            if (off >= ml) {
+                std::memcpy(dst + op, from, ml);
+            } else {
+                for (size_t i = 0; i < ml; ++i) dst[op + i] = from[i];   // overlapping run
+            }
+            op += ml;
+        }
+        return op == out_n;
+    }
+}
+
+inline bool block_codec_available(BlockCodec codec) {
+    switch (codec) {
+        case BlockCodec::None:
+        case BlockCodec::Lz:   return true;
+#if defined(TS_STORE_HAVE_ZLIB)
+        case BlockCodec::Zlib: return true;
+#endif
+#if defined(TS_STORE_HAVE_ZSTD)
+        case BlockCodec::Zstd: return true;
+#endif
+        default:               return false;
+    }
+}
+
+inline std::string_view block_codec_name(BlockCodec codec) {
+    switch (codec) {
+        case BlockCodec::None: return "none";
+        case BlockCodec::Lz:   return "lz";
+        case BlockCodec::Zlib: return "zlib";
+        case BlockCodec::Zstd: return "zstd";
+    }
+    return "unknown";
+}
+
+// BinaryCompression::Default -> TS_STORE_BINARY_COMPRESSION (none|lz|zlib|zstd), else None.
+// A codec this build lacks falls back to Lz.
+inline BlockCodec resolve_block_codec(BinaryCompression requested) {
+    if (requested == BinaryCompression::Default) {
+        requested = BinaryCompression::None;
+        if (const char* env = std::getenv("TS_STORE_BINARY_COMPRESSION")) {
+            const std::string_view v(env);
+            if (v == "lz" || v == "lz4") requested = BinaryCompression::Lz;
+            else if (v == "zlib")        requested = BinaryCompression::Zlib;
+            else if (v == "zstd")        requested = BinaryCompression::Zstd;
+        }
+    }
+    BlockCodec codec = BlockCodec::None;
+    switch (requested) {
+        case BinaryCompression::Lz:   codec = BlockCodec::Lz; break;
+        case BinaryCompression::Zlib: codec = BlockCodec::Zlib; break;
+        case BinaryCompression::Zstd: codec = BlockCodec::Zstd; break;
+        default:                      codec = BlockCodec::None; break;
+    }
+    return block_codec_available(codec) ? codec : BlockCodec::Lz;
+}
+
+// Compress n bytes into out (resized to the compressed size). False = store the block raw.
+inline bool compress_block(BlockCodec codec, const char* src, size_t n, std::vector<char>& out) {
+    switch (codec) {
+        case BlockCodec::Lz: {
+            out.resize(detail::lz_bound(n));
+            const size_t c = detail::lz_compress(src, n, out.data(), n > 16 ? n - 16 : 0);
+            if (c == 0) return false;
+            out.resize(c);
+            return true;
+        }
+#if defined(TS_STORE_HAVE_ZLIB)
+        case BlockCodec::Zlib: {
+            uLongf len = compressBound(static_cast<uLong>(n));
+            out.resize(len);
+            if (compress2(reinterpret_cast<Bytef*>(out.data()), &len,
+                          reinterpret_cast<const Bytef*>(src), static_cast<uLong>(n), Z_BEST_SPEED) != Z_OK) {
+                return false;
+            }
+            out.resize(len);
+            return len < n;
+        }
+#endif
+#if defined(TS_STORE_HAVE_ZSTD)
+        case BlockCodec::Zstd: {
+            out.resize(ZSTD_compressBound(n));
+            const size_t c = ZSTD_compress(out.data(), out.size(), src, n, 1);
+            if (ZSTD_isError(c)) return false;
+            out.resize(c);
+            return c < n;
+        }
+#endif
+        default:
+            return false;
+    }
+}
+
+// Decode a stored block into exactly raw_n bytes at dst.
+inline bool decompress_block(BlockCodec codec, const char* src, size_t n, char* dst, size_t raw_n) {
+    switch (codec) {
+        case BlockCodec::None:
+            if (n != raw_n) return false;
+            std::memcpy(dst, src, n);
+            return true;
+        case BlockCodec::Lz:
+            return detail::lz_decompress(src, n, dst, raw_n);
+#if defined(TS_STORE_HAVE_ZLIB)
+        case BlockCodec::Zlib: {
+            uLongf len = static_cast<uLongf>(raw_n);
+            return uncompress(reinterpret_cast<Bytef*>(dst), &len,
+                              reinterpret_cast<const Bytef*>(src), static_cast<uLong>(n)) == Z_OK &&
+                   len == raw_n;
+        }
+#endif
+#if defined(TS_STORE_HAVE_ZSTD)
+        case BlockCodec::Zstd: {
+            const size_t d = ZSTD_decompress(dst, raw_n, src, n);
+            return !ZSTD_isError(d) && d == raw_n;
+        }
+#endif
+        default:
+            return false;
+    }
+}
+
+} // namespace jac::ts_store::inline_v001
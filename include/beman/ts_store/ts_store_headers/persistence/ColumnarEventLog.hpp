@@ -0,0 +1,359 @@
+#pragma once
+
+// ColumnarEventLog.hpp
+// Columnar log writer (layout in ColumnarFormat.hpp). Events are transposed into per-column
+// buffers as they arrive; every group_rows events (and on sync / finalize) the buffers are
+// encoded into one page per column, each compressed on its own, the page statistics are taken,
+// and the whole row group is appended with a single write. finalize() adds the row group index.
+// Query the file with ColumnarLogReader.
+//
+// flush() keeps the open group buffered (written groups go straight to the file, so there is
+// nothing else to push). sync() has to cut it: a synced event must be on disk, and a row group is
+// only readable once complete. Syncing every batch (DurabilityLevel::FsyncPerBatch) therefore
+// bounds groups by the batch size; stats().short_groups counts groups cut that way.
+//
+// Compression: BinaryCompression::Default uses TS_STORE_BINARY_COMPRESSION when set, else Lz;
+// encoded pages are small enough that a fast codec is nearly free.
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "BinaryEventLog.hpp"
+#include "BlockCompression.hpp"
+#include "ColumnarFormat.hpp"
+#include "PersistCommon.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+struct ColumnarEventLogStats {
+    size_t rows_written = 0;
+    size_t row_groups = 0;
+    size_t truncated = 0;          // events with more metrics than the schema (extras dropped)
+    uint64_t raw_bytes = 0;        // encoded pages before compression
+    uint64_t stored_bytes = 0;     // page bytes on disk
+    size_t syncs = 0;
+    size_t short_groups = 0;       // cut by sync() before reaching group_rows
+};
+
+class ColumnarEventLog {
+public:
+    ColumnarEventLog(std::string_view base_name,
+                     size_t int_count,
+                     size_t dbl_count,
+                     PersistMode mode = PersistMode::All,
+                     BinaryCompression compression = BinaryCompression::Default,
+                     size_t group_rows = kDefaultColumnarGroupRows)
+        : schema_{int_count, dbl_count},
+          mode_(mode),
+          codec_(compression == BinaryCompression::Default && std::getenv("TS_STORE_BINARY_COMPRESSION") == nullptr
+                     ? BlockCodec::Lz
+                     : resolve_block_codec(compression)),
+          group_rows_(std::clamp<size_t>(group_rows, 1, max_group_rows(schema_)))
+    {
+        if (int_count > 0xFFFF || dbl_count > 0xFFFF) {
+            throw std::runtime_error("ColumnarEventLog: metric count exceeds 65535");
+        }
+        const size_t columns = schema_.column_count();
+        numeric_.resize(columns);
+        present_.resize(columns);
+        nulls_.assign(columns, 0);
+
+        file_path_ = std::string(base_name) + ".tscol";
+        fd_ = ::open(file_path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            throw std::runtime_error("ColumnarEventLog: failed to open " + file_path_);
+        }
+        const auto now_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        const ColumnarFileHeader h = make_columnar_file_header(schema_, static_cast<uint32_t>(group_rows_),
+                                                               static_cast<uint64_t>(now_us));
+        std::string head = detail::binary_file_header(file_path_, "Columnar Data File");
+        head.append(reinterpret_cast<const char*>(&h), sizeof(h));
+        try {
+            write_all(head.data(), head.size());
+        } catch (...) {
+            ::close(fd_);
+            fd_ = -1;
+            throw;
+        }
+    }
+
+    ~ColumnarEventLog() {
+        try { finalize(); } catch (...) {}
+    }
+
+    ColumnarEventLog(const ColumnarEventLog&) = delete;
+    ColumnarEventLog& operator=(const ColumnarEventLog&) = delete;
+
+    void append_event(size_t event_id,
+                      size_t thread_id,
+                      size_t per_thread_event_id,
+                      uint64_t raw_flags,
+                      std::string_view category,
+                      std::string_view payload,
+                      uint64_t timestamp_us,
+                      std::span<const int64_t> ints,
+                      std::span<const double> dbls)
+    {
+        if (fd_ < 0) return;
+        if (mode_ == PersistMode::KeeperOnly) {
+            if ((raw_flags & KEEPER_BIT) == 0) return;
+        } else if (mode_ == PersistMode::DatabaseOnly) {
+            return;
+        }
+
+        numeric_[ColumnarSchema::kEventId].push_back(event_id);
+        numeric_[ColumnarSchema::kThreadId].push_back(thread_id);
+        numeric_[ColumnarSchema::kPerThreadEventId].push_back(per_thread_event_id);
+        numeric_[ColumnarSchema::kFlags].push_back(raw_flags);
+        numeric_[ColumnarSchema::kTimestamp].push_back(timestamp_us);
+        categories_.append(category);
+        category_ends_.push_back(static_cast<uint32_t>(categories_.size()));
+        payloads_.append(payload);
+        payload_ends_.push_back(static_cast<uint32_t>(payloads_.size()));
+
+        for (size_t i = 0; i < schema_.int_count; ++i) {
+            add_metric(schema_.int_column(i), i < ints.size(), i < ints.size() ? static_cast<uint64_t>(ints[i]) : 0);
+        }
+        for (size_t i = 0; i < schema_.dbl_count; ++i) {
+            add_metric(schema_.dbl_column(i), i < dbls.size(), i < dbls.size() ? std::bit_cast<uint64_t>(dbls[i]) : 0);
+        }
+        if (ints.size() > schema_.int_count || dbls.size() > schema_.dbl_count) ++stats_.truncated;
+
+        ++rows_;
+        // Page offsets are u32: close a group early rather than let its strings outgrow them.
+        if (rows_ >= group_rows_ || categories_.size() + payloads_.size() > kMaxGroupStringBytes) {
+            end_group();
+        }
+    }
+
+    // Write the buffered rows as a row group (no-op when empty).
+    void end_group() {
+        if (rows_ == 0 || fd_ < 0) return;
+        const size_t columns = schema_.column_count();
+        const size_t headers = sizeof(ColumnarRowGroupHeader) + columns * sizeof(ColumnarPageHeader);
+        group_.assign(headers, '\0');
+        std::vector<ColumnarPageHeader> pages(columns);
+
+        for (size_t c = 0; c < columns; ++c) {
+            ColumnarPageHeader& ph = pages[c];
+            ph.column = static_cast<uint16_t>(c);
+            const ColumnType type = schema_.type(c);
+            ColumnEncoding encoding{};
+            if (type == ColumnType::String) {
+                encoding = c == ColumnarSchema::kCategory ? encode_string_page(categories_, category_ends_, page_)
+                                                          : encode_string_page(payloads_, payload_ends_, page_);
+            } else {
+                const bool has_nulls = nulls_[c] != 0;
+                encoding = encode_numeric_page(type, numeric_[c],
+                                               has_nulls ? std::span<const uint8_t>(present_[c]) : std::span<const uint8_t>{},
+                                               page_);
+                ph.null_count = static_cast<uint32_t>(nulls_[c]);
+                page_stats(type, c, ph);
+            }
+            ph.encoding = static_cast<uint16_t>(encoding);
+            ph.raw_bytes = static_cast<uint32_t>(page_.size());
+
+            const char* stored = page_.data();
+            size_t stored_n = page_.size();
+            ph.codec = static_cast<uint16_t>(BlockCodec::None);
+            if (codec_ != BlockCodec::None && compress_block(codec_, page_.data(), page_.size(), compressed_)) {
+                stored = compressed_.data();
+                stored_n = compressed_.size();
+                ph.codec = static_cast<uint16_t>(codec_);
+            }
+            ph.offset = static_cast<uint32_t>(group_.size());
+            ph.stored_bytes = static_cast<uint32_t>(stored_n);
+            ph.crc32c = crc32c(stored, stored_n);
+            group_.insert(group_.end(), stored, stored + stored_n);
+            stats_.raw_bytes += page_.size();
+            stats_.stored_bytes += stored_n;
+        }
+
+        ColumnarRowGroupHeader gh{};
+        gh.magic = kColumnarGroupMagic;
+        gh.row_count = static_cast<uint32_t>(rows_);
+        gh.column_count = static_cast<uint16_t>(columns);
+        gh.group_bytes = group_.size();
+        const ColumnarPageHeader& ids = pages[ColumnarSchema::kEventId];
+        const ColumnarPageHeader& ts = pages[ColumnarSchema::kTimestamp];
+        gh.min_event_id = ids.min;
+        gh.max_event_id = ids.max;
+        gh.min_timestamp_us = ts.min;
+        gh.max_timestamp_us = ts.max;
+        gh.flags_or = pages[ColumnarSchema::kFlags].bits_or;
+        gh.header_crc = detail::columnar_group_crc(gh, pages.data());
+        std::memcpy(group_.data(), &gh, sizeof(gh));
+        std::memcpy(group_.data() + sizeof(gh), pages.data(), columns * sizeof(ColumnarPageHeader));
+
+        ColumnarIndexEntry e{};
+        e.offset = file_end_;
+        e.row_count = gh.row_count;
+        e.group_bytes = gh.group_bytes;
+        e.min_event_id = gh.min_event_id;
+        e.max_event_id = gh.max_event_id;
+        e.min_timestamp_us = gh.min_timestamp_us;
+        e.max_timestamp_us = gh.max_timestamp_us;
+        e.flags_or = gh.flags_or;
+        write_all(group_.data(), group_.size());
+        index_.push_back(e);
+
+        stats_.rows_written += rows_;
+        ++stats_.row_groups;
+        rows_ = 0;
+        for (size_t c = 0; c < columns; ++c) {
+            numeric_[c].clear();
+            present_[c].clear();
+            nulls_[c] = 0;
+        }
+        categories_.clear();
+        category_ends_.clear();
+        payloads_.clear();
+        payload_ends_.clear();
+    }
+
+    // Row groups already cut are in the page cache; the open one stays buffered until it fills.
+    void flush() {}
+
+    // Cuts the open group (short when rows_ < group_rows) and makes every written group durable.
+    void sync() {
+        if (rows_ != 0 && rows_ < group_rows_) ++stats_.short_groups;
+        end_group();
+        if (fd_ >= 0 && ::fdatasync(fd_) != 0) {
+            throw std::runtime_error("ColumnarEventLog: fdatasync failed for " + file_path_);
+        }
+        stats_.syncs++;
+    }
+
+    // Last row group, then the index and footer; closes the file.
+    void finalize() {
+        if (fd_ < 0) return;
+        try {
+            end_group();
+            ColumnarFooter f{};
+            std::memcpy(f.magic, kColumnarFooterMagic, sizeof(f.magic));
+            f.group_count = index_.size();
+            f.row_count = stats_.rows_written;
+            f.index_crc = crc32c(index_.data(), index_.size() * sizeof(ColumnarIndexEntry));
+            f.footer_crc = detail::crc_without_last_u32(f);
+            write_all(index_.data(), index_.size() * sizeof(ColumnarIndexEntry));
+            write_all(&f, sizeof(f));
+        } catch (...) {
+            ::close(fd_);
+            fd_ = -1;
+            throw;
+        }
+        const int rc = ::close(fd_);
+        fd_ = -1;
+        if (rc != 0) {
+            throw std::runtime_error("ColumnarEventLog: close failed for " + file_path_);
+        }
+    }
+
+    [[nodiscard]] const ColumnarEventLogStats& stats() const { return stats_; }
+    [[nodiscard]] const std::string& file_path() const { return file_path_; }
+    [[nodiscard]] const ColumnarSchema& schema() const { return schema_; }
+    [[nodiscard]] BlockCodec codec() const { return codec_; }
+
+private:
+    static constexpr size_t kMaxGroupStringBytes = 1024ull * 1024 * 1024;
+
+    // Page offsets and sizes are u32. Worst case per row: 10 bytes per numeric value plus a bitmap
+    // byte, and two 10-byte varints per string column (length or code, dictionary entry). String
+    // bytes get two kMaxGroupStringBytes: the cap is checked after the row that crosses it.
+    static size_t max_group_rows(const ColumnarSchema& schema) {
+        const size_t columns = schema.column_count();
+        const size_t per_row = 11 * (columns - 2) + 2 * 20;
+        const size_t fixed = 2 * kMaxGroupStringBytes + sizeof(ColumnarRowGroupHeader) +
+                             columns * sizeof(ColumnarPageHeader);
+        return (std::numeric_limits<uint32_t>::max() - fixed) / per_row;
+    }
+
+    void add_metric(size_t column, bool has, uint64_t bits) {
+        numeric_[column].push_back(bits);
+        if (!has) {
+            if (nulls_[column] == 0) present_[column].assign(rows_, 1);   // first null of the group
+            ++nulls_[column];
+        }
+        if (nulls_[column] != 0) present_[column].push_back(has ? 1 : 0);
+    }
+
+    // min / max / OR over the present values, in the column's type.
+    void page_stats(ColumnType type, size_t column, ColumnarPageHeader& ph) const {
+        const std::vector<uint64_t>& v = numeric_[column];
+        const std::vector<uint8_t>& present = present_[column];
+        bool any = false;
+        for (size_t r = 0; r < v.size(); ++r) {
+            if (!present.empty() && present[r] == 0) continue;
+            const uint64_t x = v[r];
+            ph.bits_or |= x;
+            if (type == ColumnType::F64 && std::isnan(std::bit_cast<double>(x))) continue;
+            if (!any) {
+                ph.min = ph.max = x;
+                any = true;
+            } else if (type == ColumnType::U64) {
+                ph.min = std::min(ph.min, x);
+                ph.max = std::max(ph.max, x);
+            } else if (type == ColumnType::I64) {
+                if (static_cast<int64_t>(x) < static_cast<int64_t>(ph.min)) ph.min = x;
+                if (static_cast<int64_t>(x) > static_cast<int64_t>(ph.max)) ph.max = x;
+            } else {
+                if (std::bit_cast<double>(x) < std::bit_cast<double>(ph.min)) ph.min = x;
+                if (std::bit_cast<double>(x) > std::bit_cast<double>(ph.max)) ph.max = x;
+            }
+        }
+    }
+
+    void write_all(const void* data, size_t n) {
+        const char* p = static_cast<const char*>(data);
+        size_t done = 0;
+        while (done < n) {
+            const ssize_t w = ::write(fd_, p + done, n - done);
+            if (w < 0) throw std::runtime_error("ColumnarEventLog: write failed for " + file_path_);
+            done += static_cast<size_t>(w);
+        }
+        file_end_ += n;
+    }
+
+    ColumnarSchema schema_;
+    PersistMode mode_;
+    BlockCodec codec_;
+    size_t group_rows_;
+    std::string file_path_;
+    int fd_ = -1;
+    uint64_t file_end_ = 0;
+    std::vector<ColumnarIndexEntry> index_;
+    ColumnarEventLogStats stats_;
+
+    // Current row group, one buffer per column.
+    size_t rows_ = 0;
+    std::vector<std::vector<uint64_t>> numeric_;     // bit patterns (unused for string columns)
+    std::vector<std::vector<uint8_t>> present_;      // per row, only once the column has a null
+    std::vector<size_t> nulls_;
+    std::string categories_;
+    std::vector<uint32_t> category_ends_;
+    std::string payloads_;
+    std::vector<uint32_t> payload_ends_;
+
+    // Scratch.
+    std::vector<char> page_;
+    std::vector<char> compressed_;
+    std::vector<char> group_;
+};
+
+} // namespace jac::ts_store::inline_v001
@@ -0,0 +1,71 @@
+#pragma once
+
+// ColumnarEventSink.hpp
+// Adapter that turns ColumnarEventLog into an IEventSink for use with DoubleBufferedWriter.
+// Writes <base>.tscol; query it with ColumnarLogReader. Row groups are cut every group_rows
+// events, not per batch, so small drains still make full-size pages and flush() leaves the group
+// in progress open. sync() closes it, because DoubleBufferedWriter reports synced events as
+// durable: under FsyncPerBatch (and GroupCommit with frequent waiters) groups are as small as the
+// drained batches. Prefer None / PeriodicFsync, or large batches, for full-size row groups.
+
+#include "EventSink.hpp"
+#include "ColumnarEventLog.hpp"
+
+#include <memory>
+
+namespace jac::ts_store::inline_v001 {
+
+class ColumnarEventSink : public IEventSink {
+public:
+    ColumnarEventSink(std::string_view base_name,
+                      size_t int_count,
+                      size_t dbl_count,
+                      PersistMode mode = PersistMode::All,
+                      BinaryCompression compression = BinaryCompression::Default,
+                      size_t group_rows = kDefaultColumnarGroupRows)
+        : impl_(std::make_unique<ColumnarEventLog>(base_name, int_count, dbl_count, mode, compression, group_rows))
+    {}
+
+    void write_batch(std::span<const PersistedEvent> batch) override {
+        if (!impl_) return;
+
+        for (const auto& e : batch) {
+            impl_->append_event(
+                e.event_id,
+                e.thread_id,
+                e.per_thread_event_id,
+                e.flags,
+                e.category,
+                e.payload,
+                e.timestamp_us,
+                e.int_metrics,
+                e.dbl_metrics
+            );
+        }
+    }
+
+    void flush() override {
+        if (impl_) impl_->flush();
+    }
+
+    void sync() override {
+        if (impl_) impl_->sync();
+    }
+
+    void finalize() override {
+        if (impl_) {
+            impl_->finalize();
+            impl_.reset();
+        }
+    }
+
+    std::string_view name() const override { return "ColumnarEventSink"; }
+
+    // Path of the file being written (empty after finalize).
+    [[nodiscard]] std::string file_path() const { return impl_ ? impl_->file_path() : std::string{}; }
+
+private:
+    std::unique_ptr<ColumnarEventLog> impl_;
+};
+
+} // namespace jac::ts_store::inline_v001
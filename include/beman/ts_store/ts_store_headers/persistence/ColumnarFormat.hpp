@@ -0,0 +1,331 @@
+#pragma once
+
+// ColumnarFormat.hpp
+// On-disk layout of the columnar event log (<base>.tscol), the read-optimized sibling of the
+// binary block log: rows are cut into row groups, and every column of a row group is one
+// compressed page with its own min / max / null statistics, so a query reads only the columns it
+// asks for, in the row groups whose statistics can match.
+//
+//   "//File: ... //\n"        text header lines (every persist file starts with them)
+//   ColumnarFileHeader        64 bytes: magic "TSCOLUMN", metric counts, header CRC
+//   { ColumnarRowGroupHeader  64 bytes: row count, size, id / time ranges, flag OR, CRC
+//     ColumnarPageHeader x C  64 bytes each, in column order: encoding, codec, sizes, CRC, stats
+//     page bytes x C }*       stored (optionally compressed) page of each column
+//   [ ColumnarIndexEntry x G, ColumnarFooter ]   row group index, written on finalize
+//
+// Columns (ColumnarSchema): event_id, thread_id, per_thread_event_id, flags, timestamp_us (u64),
+// category, payload (string), int0.. (i64), dbl0.. (f64). A page is encoded, then compressed as a
+// whole with a BlockCodec (BlockCompression.hpp; kept raw when that does not shrink it):
+//   u64 / i64   DeltaVarint: varint(zigzag(v - prev)) per value (ids and timestamps -> ~1 byte)
+//   f64         Xor: XOR with the previous value, byte-aligned as in CompactRecords.hpp
+//   string      Dictionary: varint(n) + n x (varint(len) + bytes), then varint(code) per row,
+//               when the page repeats its strings; otherwise Plain: varint(len) + bytes per row
+// Metric pages with null_count > 0 (an event carried fewer metrics than the schema) start with a
+// validity bitmap of (rows + 7) / 8 bytes, and only present values follow.
+//
+// The row group header CRC covers the header and its page headers; each page has its own CRC.
+// A row group is written only once complete, so a crash leaves at most one torn group at the end;
+// without the footer, readers walk the groups from the start and stop at the first bad one.
+// All integers little-endian.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "CompactRecords.hpp"
+#include "Crc32c.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+inline constexpr char kColumnarMagic[8] = {'T', 'S', 'C', 'O', 'L', 'U', 'M', 'N'};
+inline constexpr char kColumnarFooterMagic[8] = {'T', 'S', 'C', 'O', 'L', 'I', 'D', 'X'};
+inline constexpr uint16_t kColumnarVersion = 1;
+inline constexpr uint32_t kColumnarGroupMagic = 0x47435354u;   // "TSCG"
+inline constexpr size_t kDefaultColumnarGroupRows = 64 * 1024;
+
+enum class ColumnType : uint8_t { U64 = 1, I64 = 2, F64 = 3, String = 4 };
+enum class ColumnEncoding : uint16_t { Plain = 0, DeltaVarint = 1, Xor = 2, Dictionary = 3 };
+
+struct ColumnarFileHeader {
+    char     magic[8];
+    uint16_t version;
+    uint16_t header_bytes;         // sizeof(ColumnarFileHeader)
+    uint16_t int_count;
+    uint16_t dbl_count;
+    uint32_t group_rows;           // writer's rows per row group (the last group may be shorter)
+    uint32_t reserved0;
+    uint64_t created_unix_us;
+    uint8_t  reserved[28];
+    uint32_t header_crc;           // CRC32C of the bytes above
+};
+
+struct ColumnarRowGroupHeader {
+    uint32_t magic;                // kColumnarGroupMagic
+    uint32_t row_count;
+    uint16_t column_count;
+    uint16_t reserved0;
+    uint32_t header_crc;           // CRC32C of this header (field zeroed) + the page headers
+    uint64_t group_bytes;          // headers + pages
+    uint64_t min_event_id;
+    uint64_t max_event_id;
+    uint64_t min_timestamp_us;
+    uint64_t max_timestamp_us;
+    uint64_t flags_or;
+};
+
+struct ColumnarPageHeader {
+    uint16_t column;
+    uint16_t encoding;             // ColumnEncoding
+    uint16_t codec;                // BlockCodec of the stored bytes
+    uint16_t reserved0;
+    uint32_t offset;               // stored bytes, from the start of the row group
+    uint32_t stored_bytes;
+    uint32_t raw_bytes;            // encoded page before compression
+    uint32_t crc32c;               // of the stored bytes
+    uint32_t null_count;
+    uint32_t reserved1;
+    uint64_t min;                  // bit pattern in the column's type; 0 for strings
+    uint64_t max;
+    uint64_t bits_or;              // OR of the present values (flags: prune by mask)
+    uint64_t reserved2;
+};
+
+struct ColumnarIndexEntry {
+    uint64_t offset;               // file offset of the row group header
+    uint32_t row_count;
+    uint32_t reserved0;
+    uint64_t group_bytes;
+    uint64_t min_event_id;
+    uint64_t max_event_id;
+    uint64_t min_timestamp_us;
+    uint64_t max_timestamp_us;
+    uint64_t flags_or;
+};
+
+struct ColumnarFooter {
+    char     magic[8];             // kColumnarFooterMagic
+    uint64_t group_count;          // ColumnarIndexEntry records just before this footer
+    uint64_t row_count;
+    uint32_t index_crc;            // CRC32C of the index entries
+    uint32_t footer_crc;           // CRC32C of the bytes above
+};
+
+static_assert(sizeof(ColumnarFileHeader) == 64);
+static_assert(sizeof(ColumnarRowGroupHeader) == 64);
+static_assert(sizeof(ColumnarPageHeader) == 64);
+static_assert(sizeof(ColumnarIndexEntry) == 64);
+static_assert(sizeof(ColumnarFooter) == 32);
+
+// Column numbering of a file with int_count / dbl_count metrics.
+struct ColumnarSchema {
+    static constexpr size_t kEventId = 0;
+    static constexpr size_t kThreadId = 1;
+    static constexpr size_t kPerThreadEventId = 2;
+    static constexpr size_t kFlags = 3;
+    static constexpr size_t kTimestamp = 4;
+    static constexpr size_t kCategory = 5;
+    static constexpr size_t kPayload = 6;
+    static constexpr size_t kFirstMetric = 7;
+
+    size_t int_count = 0;
+    size_t dbl_count = 0;
+
+    [[nodiscard]] size_t column_count() const { return kFirstMetric + int_count + dbl_count; }
+    [[nodiscard]] size_t int_column(size_t i) const { return kFirstMetric + i; }
+    [[nodiscard]] size_t dbl_column(size_t i) const { return kFirstMetric + int_count + i; }
+    [[nodiscard]] bool is_metric(size_t column) const { return column >= kFirstMetric; }
+
+    [[nodiscard]] ColumnType type(size_t column) const {
+        if (column == kCategory || column == kPayload) return ColumnType::String;
+        if (column < kFirstMetric) return ColumnType::U64;
+        return column < kFirstMetric + int_count ? ColumnType::I64 : ColumnType::F64;
+    }
+
+    [[nodiscard]] std::string name(size_t column) const {
+        static constexpr std::string_view fixed[] = {"event_id", "thread_id", "per_thread_event_id", "flags",
+                                                     "timestamp_us", "category", "payload"};
+        if (column < kFirstMetric) return std::string(fixed[column]);
+        if (column < kFirstMetric + int_count) return "int" + std::to_string(column - kFirstMetric);
+        return "dbl" + std::to_string(column - kFirstMetric - int_count);
+    }
+
+    // Column of `name` ("timestamp_us", "int3", "dbl0", ...), if the file has it.
+    [[nodiscard]] std::optional<size_t> find(std::string_view column_name) const {
+        for (size_t c = 0; c < column_count(); ++c) {
+            if (name(c) == column_name) return c;
+        }
+        return std::nullopt;
+    }
+};
+
+namespace detail {
+    inline uint32_t columnar_group_crc(ColumnarRowGroupHeader h, const ColumnarPageHeader* pages) {
+        h.header_crc = 0;
+        return crc32c(crc32c(&h, sizeof(h)), pages, size_t{h.column_count} * sizeof(ColumnarPageHeader));
+    }
+
+    inline void put_validity(std::vector<char>& out, std::span<const uint8_t> present) {
+        const size_t at = out.size();
+        out.resize(at + (present.size() + 7) / 8, '\0');
+        for (size_t r = 0; r < present.size(); ++r) {
+            if (present[r] != 0) out[at + r / 8] = static_cast<char>(out[at + r / 8] | (1 << (r % 8)));
+        }
+    }
+}
+
+inline ColumnarFileHeader make_columnar_file_header(const ColumnarSchema& schema, uint32_t group_rows,
+                                                    uint64_t created_unix_us) {
+    ColumnarFileHeader h{};
+    std::memcpy(h.magic, kColumnarMagic, sizeof(h.magic));
+    h.version = kColumnarVersion;
+    h.header_bytes = sizeof(ColumnarFileHeader);
+    h.int_count = static_cast<uint16_t>(schema.int_count);
+    h.dbl_count = static_cast<uint16_t>(schema.dbl_count);
+    h.group_rows = group_rows;
+    h.created_unix_us = created_unix_us;
+    h.header_crc = detail::crc_without_last_u32(h);
+    return h;
+}
+
+inline bool parse_columnar_file_header(const char* p, size_t avail, ColumnarFileHeader& h) {
+    if (avail < sizeof(h)) return false;
+    std::memcpy(&h, p, sizeof(h));
+    return std::memcmp(h.magic, kColumnarMagic, sizeof(h.magic)) == 0 && h.version == kColumnarVersion &&
+           h.header_bytes == sizeof(h) && h.header_crc == detail::crc_without_last_u32(h);
+}
+
+// Numeric page: `values` holds one bit pattern per row (ignored where present[r] == 0); `present`
+// is empty when every row has a value. Returns the encoding used.
+inline ColumnEncoding encode_numeric_page(ColumnType type, std::span<const uint64_t> values,
+                                          std::span<const uint8_t> present, std::vector<char>& out) {
+    out.clear();
+    if (!present.empty()) detail::put_validity(out, present);
+    uint64_t prev = 0;
+    for (size_t r = 0; r < values.size(); ++r) {
+        if (!present.empty() && present[r] == 0) continue;
+        const uint64_t v = values[r];
+        if (type != ColumnType::F64) {
+            detail::put_varint(out, detail::zigzag(v - prev));
+        } else {
+            detail::put_xor_double(out, v ^ prev);
+        }
+        prev = v;
+    }
+    return type == ColumnType::F64 ? ColumnEncoding::Xor : ColumnEncoding::DeltaVarint;
+}
+
+// Inverse of encode_numeric_page for `rows` rows. `valid` is left empty when null_count == 0;
+// null rows read as 0. False on a malformed page.
+inline bool decode_numeric_page(ColumnEncoding encoding, const char* p, size_t n, size_t rows, size_t null_count,
+                                std::vector<uint64_t>& values, std::vector<uint8_t>& valid) {
+    const char* end = p + n;
+    values.assign(rows, 0);
+    valid.clear();
+    if (null_count != 0) {
+        const size_t bitmap = (rows + 7) / 8;
+        if (bitmap > n) return false;
+        valid.resize(rows);
+        for (size_t r = 0; r < rows; ++r) valid[r] = static_cast<uint8_t>((p[r / 8] >> (r % 8)) & 1);
+        p += bitmap;
+    }
+    uint64_t prev = 0;
+    for (size_t r = 0; r < rows; ++r) {
+        if (!valid.empty() && valid[r] == 0) continue;
+        if (encoding == ColumnEncoding::DeltaVarint) {
+            uint64_t z = 0;
+            if (!detail::get_varint(p, end, z)) return false;
+            prev += detail::unzigzag(z);
+        } else if (encoding == ColumnEncoding::Xor) {
+            uint64_t x = 0;
+            if (!detail::get_xor_double(p, end, x)) return false;
+            prev ^= x;
+        } else {
+            return false;
+        }
+        values[r] = prev;
+    }
+    return p == end;
+}
+
+// String page from `rows` strings (row r is data[ends[r-1], ends[r])). Dictionary layout when the
+// page repeats its strings enough to pay for the dictionary.
+inline ColumnEncoding encode_string_page(std::string_view data, std::span<const uint32_t> ends,
+                                         std::vector<char>& out) {
+    out.clear();
+    std::unordered_map<std::string_view, uint32_t> codes;
+    std::vector<uint32_t> row_codes(ends.size());
+    std::vector<std::string_view> dictionary;
+    size_t begin = 0;
+    for (size_t r = 0; r < ends.size(); ++r) {
+        const std::string_view s = data.substr(begin, ends[r] - begin);
+        begin = ends[r];
+        const auto [it, inserted] = codes.try_emplace(s, static_cast<uint32_t>(dictionary.size()));
+        if (inserted) dictionary.push_back(s);
+        row_codes[r] = it->second;
+        if (dictionary.size() * 2 > ends.size() + 16) break;   // mostly distinct: not worth it
+    }
+    if (dictionary.size() * 2 <= ends.size() + 16) {
+        detail::put_varint(out, dictionary.size());
+        for (const std::string_view s : dictionary) {
+            detail::put_varint(out, s.size());
+            out.insert(out.end(), s.begin(), s.end());
+        }
+        for (const uint32_t c : row_codes) detail::put_varint(out, c);
+        return ColumnEncoding::Dictionary;
+    }
+    begin = 0;
+    for (const uint32_t e : ends) {
+        detail::put_varint(out, e - begin);
+        out.insert(out.end(), data.begin() + static_cast<std::ptrdiff_t>(begin), data.begin() + e);
+        begin = e;
+    }
+    return ColumnEncoding::Plain;
+}
+
+// Inverse of encode_string_page: views into [p, p + n), which must outlive them. Dictionary
+// pages also fill `codes` (per row) and `dictionary`; Plain pages leave both empty.
+inline bool decode_string_page(ColumnEncoding encoding, const char* p, size_t n, size_t rows,
+                               std::vector<std::string_view>& strings, std::vector<uint32_t>& codes,
+                               std::vector<std::string_view>& dictionary) {
+    const char* end = p + n;
+    strings.resize(rows);
+    codes.clear();
+    dictionary.clear();
+    auto get_string = [&](std::string_view& s) {
+        uint64_t len = 0;
+        if (!detail::get_varint(p, end, len) || len > static_cast<uint64_t>(end - p)) return false;
+        s = std::string_view(p, static_cast<size_t>(len));
+        p += len;
+        return true;
+    };
+    if (encoding == ColumnEncoding::Plain) {
+        for (size_t r = 0; r < rows; ++r) {
+            if (!get_string(strings[r])) return false;
+        }
+        return p == end;
+    }
+    if (encoding != ColumnEncoding::Dictionary) return false;
+    uint64_t entries = 0;
+    if (!detail::get_varint(p, end, entries) || entries > n) return false;
+    dictionary.resize(static_cast<size_t>(entries));
+    for (std::string_view& s : dictionary) {
+        if (!get_string(s)) return false;
+    }
+    codes.resize(rows);
+    for (size_t r = 0; r < rows; ++r) {
+        uint64_t c = 0;
+        if (!detail::get_varint(p, end, c) || c >= entries) return false;
+        codes[r] = static_cast<uint32_t>(c);
+        strings[r] = dictionary[codes[r]];
+    }
+    return p == end;
+}
+
+} // namespace jac::ts_store::inline_v001
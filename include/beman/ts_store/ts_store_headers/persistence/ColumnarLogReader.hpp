@@ -0,0 +1,459 @@
+#pragma once
+
+// ColumnarLogReader.hpp
+// Query reader for columnar logs (ColumnarEventLog). The file is mapped read-only; the row group
+// index comes from the footer, or, for a file whose writer never finalized, from walking the row
+// groups up to the first torn one.
+//
+// scan(query, on_batch) works in three steps per row group:
+//   1. index statistics (id / time range, flag OR) drop groups that cannot match, unread;
+//   2. page statistics (min / max / nulls of thread_id and every ranged metric) drop more,
+//      reading only the group's page headers;
+//   3. the predicate columns are decoded and tested row by row; only if a row matches are the
+//      remaining requested columns decoded. on_batch gets the group's decoded columns plus the
+//      selection (matching row numbers).
+// Pages are CRC-checked before decoding; a group with a bad page is skipped and counted.
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "BlockCompression.hpp"
+#include "ColumnarFormat.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+// Inclusive range on a numeric column, compared as double. Null values never match.
+struct ColumnarRange {
+    std::string column;                        // "int2", "dbl0", "thread_id", ...
+    double min = -std::numeric_limits<double>::infinity();
+    double max = std::numeric_limits<double>::infinity();
+};
+
+struct ColumnarQuery {
+    std::vector<std::string> columns;          // decoded for on_batch; empty = all
+    uint64_t flag_mask = 0;                    // rows with (flags & mask) != 0; 0 = any
+    uint64_t from_timestamp_us = 0;            // inclusive time range
+    uint64_t to_timestamp_us = UINT64_MAX;
+    uint64_t from_event_id = 0;                // inclusive id range
+    uint64_t to_event_id = UINT64_MAX;
+    std::optional<uint64_t> thread_id;
+    std::optional<std::string> category;       // exact match
+    std::vector<ColumnarRange> ranges;         // all must hold
+};
+
+struct ColumnarScanStats {
+    size_t groups_total = 0;
+    size_t groups_pruned_by_index = 0;         // step 1
+    size_t groups_pruned_by_pages = 0;         // step 2
+    size_t groups_without_match = 0;           // decoded predicate columns, no row matched
+    size_t corrupt_groups = 0;
+    size_t pages_decoded = 0;
+    uint64_t bytes_decoded = 0;                // stored page bytes read
+    uint64_t rows_scanned = 0;                 // rows of the groups that reached step 3
+    uint64_t rows_matched = 0;
+    std::chrono::microseconds elapsed{0};
+};
+
+// One decoded page. Numeric values are kept as bit patterns: read them with u64 / i64 / f64
+// (or number) according to the column type.
+struct ColumnarColumn {
+    ColumnType type = ColumnType::U64;
+    bool decoded = false;
+    std::vector<uint64_t> values;              // numeric: one per row
+    std::vector<uint8_t> valid;                // per row; empty when the page has no nulls
+    std::vector<std::string_view> strings;     // string: one per row
+    std::vector<uint32_t> codes;               // string, dictionary page: per row code
+    std::vector<std::string_view> dictionary;  // string, dictionary page: distinct values
+    std::vector<char> raw;                     // decompressed page (backs the string views)
+
+    [[nodiscard]] bool is_valid(size_t row) const { return valid.empty() || valid[row] != 0; }
+    [[nodiscard]] uint64_t u64(size_t row) const { return values[row]; }
+    [[nodiscard]] int64_t i64(size_t row) const { return static_cast<int64_t>(values[row]); }
+    [[nodiscard]] double f64(size_t row) const { return std::bit_cast<double>(values[row]); }
+    [[nodiscard]] double number(size_t row) const {
+        switch (type) {
+            case ColumnType::I64: return static_cast<double>(i64(row));
+            case ColumnType::F64: return f64(row);
+            default:              return static_cast<double>(u64(row));
+        }
+    }
+};
+
+// The decoded columns of one row group and the rows that matched the query.
+class ColumnarBatch {
+public:
+    [[nodiscard]] size_t row_count() const { return rows_; }
+    [[nodiscard]] const std::vector<uint32_t>& selection() const { return selection_; }
+    [[nodiscard]] const ColumnarSchema& schema() const { return *schema_; }
+
+    // Throws for a column the query did not decode.
+    [[nodiscard]] const ColumnarColumn& column(size_t c) const {
+        if (c >= columns_.size() || !columns_[c].decoded) {
+            throw std::runtime_error("ColumnarBatch: column " + schema_->name(c) + " not decoded");
+        }
+        return columns_[c];
+    }
+    [[nodiscard]] const ColumnarColumn& column(std::string_view name) const {
+        const std::optional<size_t> c = schema_->find(name);
+        if (!c) throw std::runtime_error("ColumnarBatch: no column " + std::string(name));
+        return column(*c);
+    }
+
+private:
+    friend class ColumnarLogReader;
+
+    const ColumnarSchema* schema_ = nullptr;
+    size_t rows_ = 0;
+    std::vector<uint32_t> selection_;
+    std::vector<ColumnarColumn> columns_;
+};
+
+class ColumnarLogReader {
+public:
+    explicit ColumnarLogReader(std::string_view path) : path_(path) {
+        const int fd = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("ColumnarLogReader: cannot open " + path_);
+        }
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("ColumnarLogReader: cannot stat " + path_);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        void* p = size_ == 0 ? MAP_FAILED : ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            throw std::runtime_error("ColumnarLogReader: cannot map " + path_);
+        }
+        data_ = static_cast<const char*>(p);
+
+        size_t pos = 0;   // skip the // text header
+        while (pos + 1 < size_ && data_[pos] == '/' && data_[pos + 1] == '/') {
+            const void* nl = std::memchr(data_ + pos, '\n', size_ - pos);
+            if (nl == nullptr) break;
+            pos = static_cast<size_t>(static_cast<const char*>(nl) - data_) + 1;
+        }
+        ColumnarFileHeader h{};
+        if (!parse_columnar_file_header(data_ + pos, size_ - pos, h)) {
+            ::munmap(const_cast<char*>(data_), size_);
+            throw std::runtime_error("ColumnarLogReader: not a columnar log: " + path_);
+        }
+        schema_ = ColumnarSchema{h.int_count, h.dbl_count};
+        data_offset_ = pos + sizeof(h);
+        if (!load_index()) walk_groups();
+        for (const ColumnarIndexEntry& e : index_) rows_ += e.row_count;
+    }
+
+    ~ColumnarLogReader() {
+        if (data_ != nullptr) ::munmap(const_cast<char*>(data_), size_);
+    }
+
+    ColumnarLogReader(const ColumnarLogReader&) = delete;
+    ColumnarLogReader& operator=(const ColumnarLogReader&) = delete;
+
+    [[nodiscard]] const ColumnarSchema& schema() const { return schema_; }
+    [[nodiscard]] const std::vector<ColumnarIndexEntry>& row_groups() const { return index_; }
+    [[nodiscard]] uint64_t row_count() const { return rows_; }
+    // False when the file has no valid footer (the writer did not finalize it).
+    [[nodiscard]] bool finalized() const { return finalized_; }
+    [[nodiscard]] const std::string& path() const { return path_; }
+
+    [[nodiscard]] uint64_t max_timestamp_us() const {
+        uint64_t m = 0;
+        for (const ColumnarIndexEntry& e : index_) m = std::max(m, e.max_timestamp_us);
+        return m;
+    }
+
+    // Run `query`; on_batch(const ColumnarBatch&) is called for every row group with a match, in
+    // file order. Throws for an unknown or non-numeric column name.
+    template <class OnBatch>
+    ColumnarScanStats scan(const ColumnarQuery& query, OnBatch&& on_batch) const {
+        const auto t0 = std::chrono::steady_clock::now();
+        ColumnarScanStats stats;
+        stats.groups_total = index_.size();
+
+        struct Range {
+            size_t column;
+            double min, max;
+        };
+        std::vector<Range> ranges;
+        for (const ColumnarRange& r : query.ranges) {
+            const std::optional<size_t> c = schema_.find(r.column);
+            if (!c || schema_.type(*c) == ColumnType::String) {
+                throw std::runtime_error("ColumnarLogReader: no numeric column " + r.column);
+            }
+            ranges.push_back({*c, r.min, r.max});
+        }
+        std::vector<uint8_t> wanted(schema_.column_count(), query.columns.empty() ? 1 : 0);
+        for (const std::string& name : query.columns) {
+            const std::optional<size_t> c = schema_.find(name);
+            if (!c) throw std::runtime_error("ColumnarLogReader: no column " + name);
+            wanted[*c] = 1;
+        }
+        const bool by_time = query.from_timestamp_us != 0 || query.to_timestamp_us != UINT64_MAX;
+        const bool by_id = query.from_event_id != 0 || query.to_event_id != UINT64_MAX;
+        std::vector<size_t> predicate_columns;
+        if (by_id) predicate_columns.push_back(ColumnarSchema::kEventId);
+        if (query.thread_id) predicate_columns.push_back(ColumnarSchema::kThreadId);
+        if (query.flag_mask != 0) predicate_columns.push_back(ColumnarSchema::kFlags);
+        if (by_time) predicate_columns.push_back(ColumnarSchema::kTimestamp);
+        if (query.category) predicate_columns.push_back(ColumnarSchema::kCategory);
+        for (const Range& r : ranges) predicate_columns.push_back(r.column);
+
+        ColumnarBatch batch;
+        batch.schema_ = &schema_;
+        batch.columns_.resize(schema_.column_count());
+        std::vector<uint8_t> keep;
+
+        for (const ColumnarIndexEntry& e : index_) {
+            if ((query.flag_mask != 0 && (e.flags_or & query.flag_mask) == 0) ||
+                e.max_timestamp_us < query.from_timestamp_us || e.min_timestamp_us > query.to_timestamp_us ||
+                e.max_event_id < query.from_event_id || e.min_event_id > query.to_event_id) {
+                ++stats.groups_pruned_by_index;
+                continue;
+            }
+            const char* group = data_ + e.offset;
+            auto page = [&](size_t c) {
+                ColumnarPageHeader ph;
+                std::memcpy(&ph, group + sizeof(ColumnarRowGroupHeader) + c * sizeof(ph), sizeof(ph));
+                return ph;
+            };
+
+            bool may_match = true;
+            if (query.thread_id) {
+                const ColumnarPageHeader ph = page(ColumnarSchema::kThreadId);
+                may_match = *query.thread_id >= ph.min && *query.thread_id <= ph.max;
+            }
+            for (const Range& r : ranges) {
+                if (!may_match) break;
+                may_match = page_may_match(page(r.column), e.row_count, r.column, r.min, r.max);
+            }
+            if (!may_match) {
+                ++stats.groups_pruned_by_pages;
+                continue;
+            }
+
+            for (ColumnarColumn& col : batch.columns_) col.decoded = false;
+            batch.rows_ = e.row_count;
+            stats.rows_scanned += e.row_count;
+            bool ok = true;
+            for (size_t c : predicate_columns) {
+                if (!(ok = decode(group, e, page(c), c, batch.columns_[c], stats))) break;
+            }
+            if (!ok) {
+                ++stats.corrupt_groups;
+                continue;
+            }
+
+            keep.assign(e.row_count, 1);
+            const auto& cols = batch.columns_;
+            if (by_id) {
+                const ColumnarColumn& ids = cols[ColumnarSchema::kEventId];
+                for (size_t r = 0; r < e.row_count; ++r) {
+                    keep[r] &= static_cast<uint8_t>(ids.values[r] >= query.from_event_id &&
+                                                    ids.values[r] <= query.to_event_id);
+                }
+            }
+            if (query.thread_id) {
+                const ColumnarColumn& threads = cols[ColumnarSchema::kThreadId];
+                for (size_t r = 0; r < e.row_count; ++r) keep[r] &= static_cast<uint8_t>(threads.values[r] == *query.thread_id);
+            }
+            if (query.flag_mask != 0) {
+                const ColumnarColumn& flags = cols[ColumnarSchema::kFlags];
+                for (size_t r = 0; r < e.row_count; ++r) {
+                    keep[r] &= static_cast<uint8_t>((flags.values[r] & query.flag_mask) != 0);
+                }
+            }
+            if (by_time) {
+                const ColumnarColumn& ts = cols[ColumnarSchema::kTimestamp];
+                for (size_t r = 0; r < e.row_count; ++r) {
+                    keep[r] &= static_cast<uint8_t>(ts.values[r] >= query.from_timestamp_us &&
+                                                    ts.values[r] <= query.to_timestamp_us);
+                }
+            }
+            if (query.category) {
+                const ColumnarColumn& cat = cols[ColumnarSchema::kCategory];
+                if (!cat.codes.empty()) {   // compare codes, not strings
+                    const auto it = std::find(cat.dictionary.begin(), cat.dictionary.end(), *query.category);
+                    const auto code = static_cast<uint32_t>(it - cat.dictionary.begin());
+                    for (size_t r = 0; r < e.row_count; ++r) keep[r] &= static_cast<uint8_t>(cat.codes[r] == code);
+                } else {
+                    for (size_t r = 0; r < e.row_count; ++r) keep[r] &= static_cast<uint8_t>(cat.strings[r] == *query.category);
+                }
+            }
+            for (const Range& rg : ranges) {
+                const ColumnarColumn& m = cols[rg.column];
+                for (size_t r = 0; r < e.row_count; ++r) {
+                    const double v = m.number(r);
+                    keep[r] &= static_cast<uint8_t>(m.is_valid(r) && v >= rg.min && v <= rg.max);
+                }
+            }
+
+            batch.selection_.clear();
+            for (size_t r = 0; r < e.row_count; ++r) {
+                if (keep[r] != 0) batch.selection_.push_back(static_cast<uint32_t>(r));
+            }
+            if (batch.selection_.empty()) {
+                ++stats.groups_without_match;
+                continue;
+            }
+            for (size_t c = 0; c < wanted.size() && ok; ++c) {
+                if (wanted[c] != 0 && !batch.columns_[c].decoded) {
+                    ok = decode(group, e, page(c), c, batch.columns_[c], stats);
+                }
+            }
+            if (!ok) {
+                ++stats.corrupt_groups;
+                continue;
+            }
+            stats.rows_matched += batch.selection_.size();
+            on_batch(static_cast<const ColumnarBatch&>(batch));
+        }
+        stats.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0);
+        return stats;
+    }
+
+private:
+    bool group_ok(size_t at, ColumnarRowGroupHeader& gh) const {
+        if (at > size_ || size_ - at < sizeof(gh)) return false;
+        std::memcpy(&gh, data_ + at, sizeof(gh));
+        const size_t headers = sizeof(gh) + size_t{gh.column_count} * sizeof(ColumnarPageHeader);
+        if (gh.magic != kColumnarGroupMagic || gh.column_count != schema_.column_count() ||
+            gh.group_bytes < headers || gh.group_bytes > size_ - at) {
+            return false;
+        }
+        std::vector<ColumnarPageHeader> pages(gh.column_count);
+        std::memcpy(pages.data(), data_ + at + sizeof(gh), pages.size() * sizeof(ColumnarPageHeader));
+        return detail::columnar_group_crc(gh, pages.data()) == gh.header_crc;
+    }
+
+    bool load_index() {
+        ColumnarFooter f{};
+        if (size_ < data_offset_ + sizeof(f)) return false;
+        std::memcpy(&f, data_ + size_ - sizeof(f), sizeof(f));
+        if (std::memcmp(f.magic, kColumnarFooterMagic, sizeof(f.magic)) != 0 ||
+            f.footer_crc != detail::crc_without_last_u32(f) ||
+            f.group_count > (size_ - data_offset_ - sizeof(f)) / sizeof(ColumnarIndexEntry)) {
+            return false;
+        }
+        const char* entries = data_ + size_ - sizeof(f) - f.group_count * sizeof(ColumnarIndexEntry);
+        if (crc32c(entries, f.group_count * sizeof(ColumnarIndexEntry)) != f.index_crc) return false;
+        index_.resize(f.group_count);
+        std::memcpy(index_.data(), entries, index_.size() * sizeof(ColumnarIndexEntry));
+        for (const ColumnarIndexEntry& e : index_) {
+            ColumnarRowGroupHeader gh{};
+            if (!group_ok(e.offset, gh)) {
+                index_.clear();
+                return false;
+            }
+        }
+        finalized_ = true;
+        return true;
+    }
+
+    // Every page of the group at `at` passes its CRC.
+    bool pages_ok(size_t at, const ColumnarRowGroupHeader& gh) const {
+        for (size_t c = 0; c < gh.column_count; ++c) {
+            ColumnarPageHeader ph;
+            std::memcpy(&ph, data_ + at + sizeof(gh) + c * sizeof(ph), sizeof(ph));
+            if (ph.offset > gh.group_bytes || ph.stored_bytes > gh.group_bytes - ph.offset ||
+                crc32c(data_ + at + ph.offset, ph.stored_bytes) != ph.crc32c) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // No footer: rebuild the index from the row group headers. The headers of a group cut short
+    // by a crash can be intact while its pages are not (a preallocated, zero-filled tail keeps
+    // group_bytes in range), so the pages are checked too.
+    void walk_groups() {
+        size_t at = data_offset_;
+        ColumnarRowGroupHeader gh{};
+        while (group_ok(at, gh) && pages_ok(at, gh)) {
+            ColumnarIndexEntry e{};
+            e.offset = at;
+            e.row_count = gh.row_count;
+            e.group_bytes = gh.group_bytes;
+            e.min_event_id = gh.min_event_id;
+            e.max_event_id = gh.max_event_id;
+            e.min_timestamp_us = gh.min_timestamp_us;
+            e.max_timestamp_us = gh.max_timestamp_us;
+            e.flags_or = gh.flags_or;
+            index_.push_back(e);
+            at += gh.group_bytes;
+        }
+    }
+
+    bool page_may_match(const ColumnarPageHeader& ph, size_t rows, size_t column, double lo, double hi) const {
+        if (ph.null_count >= rows) return false;   // all null
+        double mn = 0;
+        double mx = 0;
+        switch (schema_.type(column)) {
+            case ColumnType::I64:
+                mn = static_cast<double>(static_cast<int64_t>(ph.min));
+                mx = static_cast<double>(static_cast<int64_t>(ph.max));
+                break;
+            case ColumnType::F64:
+                mn = std::bit_cast<double>(ph.min);
+                mx = std::bit_cast<double>(ph.max);
+                break;
+            default:
+                mn = static_cast<double>(ph.min);
+                mx = static_cast<double>(ph.max);
+                break;
+        }
+        return mx >= lo && mn <= hi;
+    }
+
+    bool decode(const char* group, const ColumnarIndexEntry& e, const ColumnarPageHeader& ph, size_t column,
+                ColumnarColumn& col, ColumnarScanStats& stats) const {
+        if (ph.column != column || ph.offset > e.group_bytes || ph.stored_bytes > e.group_bytes - ph.offset) {
+            return false;
+        }
+        const size_t rows = e.row_count;
+        const char* stored = group + ph.offset;
+        if (crc32c(stored, ph.stored_bytes) != ph.crc32c) return false;
+        col.type = schema_.type(ph.column);
+        col.raw.resize(ph.raw_bytes);
+        if (!decompress_block(static_cast<BlockCodec>(ph.codec), stored, ph.stored_bytes, col.raw.data(), ph.raw_bytes)) {
+            return false;
+        }
+        const auto encoding = static_cast<ColumnEncoding>(ph.encoding);
+        const bool ok = col.type == ColumnType::String
+            ? decode_string_page(encoding, col.raw.data(), col.raw.size(), rows, col.strings, col.codes, col.dictionary)
+            : decode_numeric_page(encoding, col.raw.data(), col.raw.size(), rows, ph.null_count, col.values, col.valid);
+        col.decoded = ok;
+        ++stats.pages_decoded;
+        stats.bytes_decoded += ph.stored_bytes;
+        return ok;
+    }
+
+    std::string path_;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    size_t data_offset_ = 0;
+    ColumnarSchema schema_;
+    std::vector<ColumnarIndexEntry> index_;
+    uint64_t rows_ = 0;
+    bool finalized_ = false;
+};
+
+} // namespace jac::ts_store::inline_v001
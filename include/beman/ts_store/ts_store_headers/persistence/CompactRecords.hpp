@@ -0,0 +1,424 @@
+#pragma once
+
+// CompactRecords.hpp
+// Compact record encoding for v2 binary log blocks (kBlockCompactRecords, plus
+// kBlockStringDictionary, in BinaryBlockHeader::codec). The writer still encodes v1 records on
+// the hot path. When a block closes, it re-encodes them here (before any BlockCodec compression). Readers expand blocks back
+// to v1 records, so BinaryRecordView and every decode path stay unchanged.
+//
+// Every field is coded against the previous record of the same block, so blocks decode
+// independently (seek, parallel scan):
+//   event_id             varint(zigzag(id - (prev_id + 1)))        sequential ids -> 1 byte
+//   thread_id, flags     varint(thread_id << 8 | flags & 0x7F | big << 7), where big = flags > 0x7F
+//                        or thread_id >= 2^56; if big, then varint(flags) + varint(thread_id >> 56)
+//   per_thread_event_id  varint(zigzag(ptid - prev_ptid))
+//   timestamp_us         varint(zigzag(ts - prev_ts))
+//   category, payload    block string dictionary (kBlockStringDictionary): varint(code + 1) for a
+//                        string seen earlier in the block, else varint(0) + varint(len) + bytes,
+//                        which also adds the string to the dictionary (up to
+//                        kCompactDictMaxEntries strings of at most kCompactDictMaxBytes)
+//                        Older blocks without the flag: category varint(0) = same as the previous
+//                        record, else varint(len + 1) + bytes; payload varint(len) + bytes
+//   int / dbl counts     varint each
+//   int metrics          varint(zigzag(v - prev[i]))
+//   double metrics       XOR with prev[i] (Gorilla), byte-aligned: control byte
+//                        (trailing zero bytes << 4 | meaningful bytes), then the meaningful
+//                        bytes; 0 = unchanged. Byte granularity gives up a little of
+//                        bit-level Gorilla's ratio, but avoids a bit reader on the decode path.
+// The dictionary lives in the block, not the segment, so every block still decodes on its own;
+// a small vocabulary costs its bytes once per block (~1 MiB of records).
+// The stream starts with the u32 size of the v1 records it expands to. Block raw_bytes /
+// stored_bytes describe the compact stream, like any other codec layer.
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "BinaryLogFormat.hpp"
+#include "BlockCompression.hpp"
+#include "PersistCommon.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+// BinaryRecordEncoding::Default -> TS_STORE_BINARY_ENCODING (raw|compact), else Raw.
+inline bool resolve_compact_records(BinaryRecordEncoding requested) {
+    if (requested == BinaryRecordEncoding::Default) {
+        const char* env = std::getenv("TS_STORE_BINARY_ENCODING");
+        return env != nullptr && std::string_view(env) == "compact";
+    }
+    return requested == BinaryRecordEncoding::Compact;
+}
+
+namespace detail {
+    inline constexpr size_t kV1FixedBytes = 5 * sizeof(uint64_t) + 4 * sizeof(uint16_t);
+    inline constexpr size_t kCompactMaxMetrics = 0xFFFF;
+    inline constexpr size_t kCompactDictMaxEntries = 4096;
+    inline constexpr size_t kCompactDictMaxBytes = 1024;
+
+    // Encoder and decoder apply the same rule, so the dictionary itself is never stored.
+    inline bool dictionary_admits(size_t entries, size_t len) {
+        return entries < kCompactDictMaxEntries && len <= kCompactDictMaxBytes;
+    }
+
+    inline uint64_t zigzag(uint64_t delta) {
+        const auto s = static_cast<int64_t>(delta);
+        return (delta << 1) ^ static_cast<uint64_t>(s >> 63);
+    }
+    inline uint64_t unzigzag(uint64_t z) { return (z >> 1) ^ (~(z & 1) + 1); }
+
+    inline void put_varint(std::vector<char>& out, uint64_t v) {
+        char buf[10];
+        size_t n = 0;
+        while (v >= 0x80) {
+            buf[n++] = static_cast<char>((v & 0x7F) | 0x80);
+            v >>= 7;
+        }
+        buf[n++] = static_cast<char>(v);
+        out.insert(out.end(), buf, buf + n);
+    }
+
+    // False on a truncated or over-long varint.
+    inline bool get_varint(const char*& p, const char* end, uint64_t& v) {
+        if (p != end && static_cast<unsigned char>(*p) < 0x80) {   // 1-byte fast path
+            v = static_cast<unsigned char>(*p++);
+            return true;
+        }
+        v = 0;
+        for (unsigned shift = 0; shift < 64 && p != end; shift += 7) {
+            const auto b = static_cast<unsigned char>(*p++);
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (b < 0x80) return true;
+        }
+        return false;
+    }
+
+    // Byte-aligned XOR of a double with its predecessor: control byte (trailing zero bytes << 4 |
+    // meaningful bytes), then the meaningful bytes, low first; a lone 0 when nothing changed.
+    inline void put_xor_double(std::vector<char>& out, uint64_t x) {
+        if (x == 0) {
+            out.push_back(0);
+            return;
+        }
+        const auto tz = static_cast<unsigned>(std::countr_zero(x)) / 8;
+        const auto lz = static_cast<unsigned>(std::countl_zero(x)) / 8;
+        const unsigned meaningful = 8 - tz - lz;
+        out.push_back(static_cast<char>((tz << 4) | meaningful));
+        const uint64_t bytes = x >> (tz * 8);
+        char b[8];
+        std::memcpy(b, &bytes, sizeof(b));
+        out.insert(out.end(), b, b + meaningful);
+    }
+
+    // False on a truncated value or a control byte that spans more than 8 bytes.
+    inline bool get_xor_double(const char*& p, const char* end, uint64_t& x) {
+        if (p == end) return false;
+        const auto ctrl = static_cast<unsigned char>(*p++);
+        x = 0;
+        if (ctrl == 0) return true;
+        const unsigned tz = ctrl >> 4, meaningful = ctrl & 0x0F;
+        if (meaningful == 0 || tz + meaningful > 8 || meaningful > static_cast<size_t>(end - p)) return false;
+        std::memcpy(&x, p, meaningful);   // little-endian low bytes
+        p += meaningful;
+        x <<= tz * 8;
+        return true;
+    }
+
+    inline uint64_t load_u64(const char* p) { uint64_t v; std::memcpy(&v, p, sizeof(v)); return v; }
+    inline uint16_t load_u16(const char* p) { uint16_t v; std::memcpy(&v, p, sizeof(v)); return v; }
+
+    struct CompactState {
+        uint64_t id = 0, ptid = 0, ts = 0;
+        const char* category = nullptr;
+        size_t category_len = 0;
+        std::vector<uint64_t> ints, dbls;   // previous values (bit patterns for doubles)
+
+        void reset() {
+            id = ptid = ts = 0;
+            category = nullptr;
+            category_len = 0;
+            ints.clear();
+            dbls.clear();
+        }
+    };
+}
+
+// v1 record bytes of one block -> compact stream in `out`. False when the records do not parse
+// or the result would not be smaller (the writer then keeps the block as is). `dictionary`
+// selects the string dictionary layout (kBlockStringDictionary).
+inline bool compact_encode_records(const char* raw, size_t n, std::vector<char>& out, bool dictionary = true) {
+    std::unordered_map<std::string_view, uint32_t> dict;   // string -> code, views into raw
+    auto put_string = [&](const char* str, size_t len) {
+        const std::string_view sv(str, len);
+        if (const auto it = dict.find(sv); it != dict.end()) {
+            detail::put_varint(out, uint64_t{it->second} + 1);
+            return;
+        }
+        detail::put_varint(out, 0);
+        detail::put_varint(out, len);
+        out.insert(out.end(), str, str + len);
+        if (detail::dictionary_admits(dict.size(), len)) {
+            const auto code = static_cast<uint32_t>(dict.size());
+            dict.emplace(sv, code);
+        }
+    };
+
+    out.clear();
+    out.resize(sizeof(uint32_t));
+    const auto raw_n = static_cast<uint32_t>(n);
+    std::memcpy(out.data(), &raw_n, sizeof(raw_n));
+
+    detail::CompactState prev;
+    const char* p = raw;
+    const char* const end = raw + n;
+    while (p != end) {
+        uint32_t len = 0;
+        if (static_cast<size_t>(end - p) < sizeof(len) + detail::kV1FixedBytes) return false;
+        std::memcpy(&len, p, sizeof(len));
+        const char* r = p + sizeof(len);
+        if (len < detail::kV1FixedBytes || len > static_cast<size_t>(end - r)) return false;
+        const char* const rend = r + len;
+
+        const uint64_t id = detail::load_u64(r), thread = detail::load_u64(r + 8), ptid = detail::load_u64(r + 16),
+                       flags = detail::load_u64(r + 24), ts = detail::load_u64(r + 32);
+        r += 40;
+        detail::put_varint(out, detail::zigzag(id - (prev.id + 1)));
+        const bool big = flags > 0x7F || (thread >> 56) != 0;
+        detail::put_varint(out, (thread << 8) | (flags & 0x7F) | (big ? 0x80u : 0u));
+        if (big) {
+            detail::put_varint(out, flags);
+            detail::put_varint(out, thread >> 56);   // bits the packed varint shifted out
+        }
+        detail::put_varint(out, detail::zigzag(ptid - prev.ptid));
+        detail::put_varint(out, detail::zigzag(ts - prev.ts));
+        prev.id = id;
+        prev.ptid = ptid;
+        prev.ts = ts;
+
+        const size_t cl = detail::load_u16(r);
+        r += 2;
+        if (cl > static_cast<size_t>(rend - r)) return false;
+        if (dictionary) {
+            put_string(r, cl);
+        } else if (prev.category != nullptr && cl == prev.category_len && std::memcmp(r, prev.category, cl) == 0) {
+            detail::put_varint(out, 0);
+        } else {
+            detail::put_varint(out, cl + 1);
+            out.insert(out.end(), r, r + cl);
+        }
+        prev.category = r;
+        prev.category_len = cl;
+        r += cl;
+
+        if (static_cast<size_t>(rend - r) < 2) return false;
+        const size_t pl = detail::load_u16(r);
+        r += 2;
+        if (pl > static_cast<size_t>(rend - r)) return false;
+        if (dictionary) {
+            put_string(r, pl);
+        } else {
+            detail::put_varint(out, pl);
+            out.insert(out.end(), r, r + pl);
+        }
+        r += pl;
+
+        if (static_cast<size_t>(rend - r) < 2) return false;
+        const size_t ic = detail::load_u16(r);
+        r += 2;
+        if (ic * 8 + 2 > static_cast<size_t>(rend - r)) return false;
+        const size_t dc = detail::load_u16(r + ic * 8);
+        if (ic * 8 + 2 + dc * 8 != static_cast<size_t>(rend - r)) return false;
+        detail::put_varint(out, ic);
+        detail::put_varint(out, dc);
+        if (prev.ints.size() < ic) prev.ints.resize(ic, 0);
+        for (size_t i = 0; i < ic; ++i, r += 8) {
+            const uint64_t v = detail::load_u64(r);
+            detail::put_varint(out, detail::zigzag(v - prev.ints[i]));
+            prev.ints[i] = v;
+        }
+        r += 2;
+        if (prev.dbls.size() < dc) prev.dbls.resize(dc, 0);
+        for (size_t i = 0; i < dc; ++i, r += 8) {
+            const uint64_t v = detail::load_u64(r);
+            detail::put_xor_double(out, v ^ prev.dbls[i]);
+            prev.dbls[i] = v;
+        }
+        p = rend;
+        if (out.size() >= n) return false;   // not worth it
+    }
+    return true;
+}
+
+// Compact stream (n bytes, `count` records) -> exactly raw_n bytes of v1 records at dst.
+inline bool compact_decode_records(const char* src, size_t n, uint32_t count, char* dst, size_t raw_n,
+                                   bool dictionary = true) {
+    const char* p = src;
+    const char* const end = src + n;
+    std::vector<std::pair<const char*, size_t>> dict;   // code -> literal in src
+    auto get_string = [&](const char*& str, size_t& len) -> bool {
+        uint64_t code = 0;
+        if (!detail::get_varint(p, end, code)) return false;
+        if (code != 0) {
+            if (code > dict.size()) return false;
+            str = dict[static_cast<size_t>(code - 1)].first;
+            len = dict[static_cast<size_t>(code - 1)].second;
+            return true;
+        }
+        uint64_t l = 0;
+        if (!detail::get_varint(p, end, l) || l > 0xFFFF || l > static_cast<size_t>(end - p)) return false;
+        str = p;
+        len = static_cast<size_t>(l);
+        p += len;
+        if (detail::dictionary_admits(dict.size(), len)) dict.emplace_back(str, len);
+        return true;
+    };
+
+    size_t op = 0;
+    detail::CompactState prev;
+    uint64_t v = 0;
+
+    for (uint32_t k = 0; k < count; ++k) {
+        if (!detail::get_varint(p, end, v)) return false;
+        const uint64_t id = prev.id + 1 + detail::unzigzag(v);
+        uint64_t packed = 0;
+        if (!detail::get_varint(p, end, packed)) return false;
+        uint64_t thread = packed >> 8;
+        uint64_t flags = packed & 0x7F;
+        if ((packed & 0x80) != 0) {
+            uint64_t high = 0;
+            if (!detail::get_varint(p, end, flags) || !detail::get_varint(p, end, high) || high > 0xFF) return false;
+            thread |= high << 56;
+        }
+        if (!detail::get_varint(p, end, v)) return false;
+        const uint64_t ptid = prev.ptid + detail::unzigzag(v);
+        if (!detail::get_varint(p, end, v)) return false;
+        const uint64_t ts = prev.ts + detail::unzigzag(v);
+        prev.id = id;
+        prev.ptid = ptid;
+        prev.ts = ts;
+
+        const char* cat = prev.category;
+        size_t cl = prev.category_len;
+        const char* payload = nullptr;
+        size_t pl = 0;
+        if (dictionary) {
+            if (!get_string(cat, cl) || !get_string(payload, pl)) return false;
+        } else {
+            uint64_t tag = 0;
+            if (!detail::get_varint(p, end, tag)) return false;
+            if (tag != 0) {
+                cl = static_cast<size_t>(tag - 1);
+                if (cl > 0xFFFF || cl > static_cast<size_t>(end - p)) return false;
+                cat = p;
+                p += cl;
+            } else if (cat == nullptr && k != 0) {
+                return false;
+            }
+            uint64_t len = 0;
+            if (!detail::get_varint(p, end, len) || len > 0xFFFF || len > static_cast<size_t>(end - p)) return false;
+            payload = p;
+            pl = static_cast<size_t>(len);
+            p += pl;
+        }
+        uint64_t ic = 0, dc = 0;
+        if (!detail::get_varint(p, end, ic) || !detail::get_varint(p, end, dc) ||
+            ic > detail::kCompactMaxMetrics || dc > detail::kCompactMaxMetrics) return false;
+
+        const size_t body = detail::kV1FixedBytes + cl + pl +
+                            static_cast<size_t>(ic + dc) * 8;
+        if (sizeof(uint32_t) + body > raw_n - op) return false;
+        char* w = dst + op;
+        const auto len = static_cast<uint32_t>(body);
+        std::memcpy(w, &len, 4);
+        std::memcpy(w + 4, &id, 8);
+        std::memcpy(w + 12, &thread, 8);
+        std::memcpy(w + 20, &ptid, 8);
+        std::memcpy(w + 28, &flags, 8);
+        std::memcpy(w + 36, &ts, 8);
+        w += 44;
+        const auto cl16 = static_cast<uint16_t>(cl);
+        std::memcpy(w, &cl16, 2);
+        if (cl != 0) std::memcpy(w + 2, cat, cl);
+        prev.category = w + 2;   // the copy in dst stays put
+        prev.category_len = cl;
+        w += 2 + cl;
+        const auto pl16 = static_cast<uint16_t>(pl);
+        std::memcpy(w, &pl16, 2);
+        if (pl != 0) std::memcpy(w + 2, payload, pl);
+        w += 2 + pl;
+
+        const auto ic16 = static_cast<uint16_t>(ic);
+        std::memcpy(w, &ic16, 2);
+        w += 2;
+        if (prev.ints.size() < ic) prev.ints.resize(static_cast<size_t>(ic), 0);
+        for (size_t i = 0; i < ic; ++i, w += 8) {
+            if (!detail::get_varint(p, end, v)) return false;
+            const uint64_t x = prev.ints[i] + detail::unzigzag(v);
+            prev.ints[i] = x;
+            std::memcpy(w, &x, 8);
+        }
+        const auto dc16 = static_cast<uint16_t>(dc);
+        std::memcpy(w, &dc16, 2);
+        w += 2;
+        if (prev.dbls.size() < dc) prev.dbls.resize(static_cast<size_t>(dc), 0);
+        for (size_t i = 0; i < dc; ++i, w += 8) {
+            uint64_t x = 0;
+            if (!detail::get_xor_double(p, end, x)) return false;
+            const uint64_t bits = prev.dbls[i] ^ x;
+            prev.dbls[i] = bits;
+            std::memcpy(w, &bits, 8);
+        }
+        op += sizeof(uint32_t) + body;
+    }
+    return p == end && op == raw_n;
+}
+
+// v1 records of a block whose stored bytes passed the CRC. A raw, uncompressed block is returned
+// in place. Otherwise the records are decoded into `out`; a compressed compact block goes
+// through `scratch` first. False when the codec is unavailable or the payload does not decode.
+inline bool block_records(const BinaryBlockHeader& h, const char* stored, std::vector<char>& out,
+                          std::vector<char>& scratch, const char*& records, size_t& records_n) {
+    const BlockCodec codec = block_codec_of(h);
+    const bool compact = block_has_compact_records(h);
+    if (!block_codec_available(codec)) return false;
+    const char* payload = stored;
+    size_t payload_n = h.stored_bytes;
+    if (codec != BlockCodec::None) {
+        std::vector<char>& dest = compact ? scratch : out;
+        dest.resize(h.raw_bytes);
+        if (!decompress_block(codec, stored, h.stored_bytes, dest.data(), dest.size())) return false;
+        payload = dest.data();
+        payload_n = dest.size();
+    } else if (h.raw_bytes != h.stored_bytes) {
+        return false;
+    }
+    if (!compact) {
+        records = payload;
+        records_n = payload_n;
+        return true;
+    }
+    uint32_t v1_n = 0;
+    if (payload_n < sizeof(v1_n)) return false;
+    std::memcpy(&v1_n, payload, sizeof(v1_n));
+    // Largest expansion the stream can describe: per record the fixed fields plus two dictionary
+    // strings, plus 8 bytes per metric, each of which takes at least one stream byte. A damaged
+    // size must not allocate gigabytes before the decoder rejects it.
+    const size_t max_v1 = static_cast<size_t>(h.record_count) * (sizeof(uint32_t) + detail::kV1FixedBytes + 2 * 0xFFFF) +
+                          8 * payload_n;
+    if (v1_n > max_v1) return false;
+    out.resize(v1_n);
+    if (!compact_decode_records(payload + sizeof(v1_n), payload_n - sizeof(v1_n), h.record_count, out.data(), out.size(),
+                                block_has_string_dictionary(h))) {
+        return false;
+    }
+    records = out.data();
+    records_n = out.size();
+    return true;
+}
+
+} // namespace jac::ts_store::inline_v001
@@ -0,0 +1,151 @@
+#pragma once
+
+// Crc32c.hpp
+// CRC32C (Castagnoli), as used by the v2 binary log block framing.
+// x86-64: SSE4.2 crc32 instruction, three independent 8-byte streams per step to hide the
+// 3-cycle instruction latency, selected at runtime (cpuid) so the library still runs on CPUs
+// without SSE4.2. AArch64 with +crc: the __crc32c* intrinsics. Elsewhere: slice-by-1 table.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <nmmintrin.h>
+#define TS_STORE_CRC32C_X86 1
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define TS_STORE_CRC32C_ARM 1
+#endif
+
+namespace jac::ts_store::inline_v001 {
+
+namespace detail {
+    inline constexpr uint32_t kCrc32cPoly = 0x82F63B78u;   // reflected Castagnoli
+
+    inline constexpr std::array<uint32_t, 256> kCrc32cTable = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1u) ? (c >> 1) ^ kCrc32cPoly : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    inline uint32_t crc32c_sw(uint32_t crc, const unsigned char* p, size_t n) {
+        for (size_t i = 0; i < n; ++i) crc = kCrc32cTable[(crc ^ p[i]) & 0xFFu] ^ (crc >> 8);
+        return crc;
+    }
+
+    // Register after feeding `len` zero bytes (GF(2) multiply by x^(8*len)); combines streams:
+    // reg(A + B) == crc32c_shift(reg(A), |B|) ^ reg_from_zero(B).
+    inline uint32_t crc32c_shift(uint32_t crc, size_t len) {
+        // Multiply by x^(8*len) mod P using square-and-multiply over 32x32 bit matrices.
+        auto gf2_times = [](const uint32_t* mat, uint32_t vec) {
+            uint32_t sum = 0;
+            for (int i = 0; vec != 0; ++i, vec >>= 1) if (vec & 1u) sum ^= mat[i];
+            return sum;
+        };
+        auto gf2_square = [&](uint32_t* sq, const uint32_t* mat) {
+            for (int n = 0; n < 32; ++n) sq[n] = gf2_times(mat, mat[n]);
+        };
+        uint32_t even[32], odd[32];
+        odd[0] = kCrc32cPoly;
+        for (int n = 1; n < 32; ++n) odd[n] = 1u << (n - 1);
+        gf2_square(even, odd);   // 2 zero bits
+        gf2_square(odd, even);   // 4 zero bits
+        do {
+            gf2_square(even, odd);
+            if (len & 1u) crc = gf2_times(even, crc);
+            len >>= 1;
+            if (len == 0) break;
+            gf2_square(odd, even);
+            if (len & 1u) crc = gf2_times(odd, crc);
+            len >>= 1;
+        } while (len != 0);
+        return crc;
+    }
+
+#if defined(TS_STORE_CRC32C_X86)
+    inline constexpr size_t kCrc32cStride = 4096;   // bytes per stream per round
+
+    // crc32c_shift(x, kCrc32cStride) as four byte lookups (the shift is linear in x).
+    inline const std::array<std::array<uint32_t, 256>, 4>& crc32c_stride_tables() {
+        static const auto tables = [] {
+            std::array<std::array<uint32_t, 256>, 4> t{};
+            for (uint32_t k = 0; k < 4; ++k)
+                for (uint32_t b = 0; b < 256; ++b) t[k][b] = crc32c_shift(b << (8 * k), kCrc32cStride);
+            return t;
+        }();
+        return tables;
+    }
+
+    inline uint32_t crc32c_shift_stride(uint32_t crc) {
+        const auto& t = crc32c_stride_tables();
+        return t[0][crc & 0xFFu] ^ t[1][(crc >> 8) & 0xFFu] ^ t[2][(crc >> 16) & 0xFFu] ^ t[3][crc >> 24];
+    }
+
+    __attribute__((target("sse4.2")))
+    inline uint32_t crc32c_hw(uint32_t crc, const unsigned char* p, size_t n) {
+        constexpr size_t kStride = kCrc32cStride;
+        uint64_t c0 = crc;
+        while (n >= 3 * kStride) {
+            uint64_t c1 = 0, c2 = 0;
+            for (size_t i = 0; i < kStride; i += 8) {
+                uint64_t a, b, c;
+                std::memcpy(&a, p + i, 8);
+                std::memcpy(&b, p + kStride + i, 8);
+                std::memcpy(&c, p + 2 * kStride + i, 8);
+                c0 = _mm_crc32_u64(c0, a);
+                c1 = _mm_crc32_u64(c1, b);
+                c2 = _mm_crc32_u64(c2, c);
+            }
+            uint32_t r = crc32c_shift_stride(static_cast<uint32_t>(c0)) ^ static_cast<uint32_t>(c1);
+            r = crc32c_shift_stride(r) ^ static_cast<uint32_t>(c2);
+            c0 = r;
+            p += 3 * kStride;
+            n -= 3 * kStride;
+        }
+        for (; n >= 8; p += 8, n -= 8) {
+            uint64_t v;
+            std::memcpy(&v, p, 8);
+            c0 = _mm_crc32_u64(c0, v);
+        }
+        auto c = static_cast<uint32_t>(c0);
+        for (; n > 0; ++p, --n) c = _mm_crc32_u8(c, *p);
+        return c;
+    }
+
+    inline bool crc32c_hw_available() {
+        static const bool ok = __builtin_cpu_supports("sse4.2");
+        return ok;
+    }
+#elif defined(TS_STORE_CRC32C_ARM)
+    inline uint32_t crc32c_hw(uint32_t crc, const unsigned char* p, size_t n) {
+        for (; n >= 8; p += 8, n -= 8) {
+            uint64_t v;
+            std::memcpy(&v, p, 8);
+            crc = __crc32cd(crc, v);
+        }
+        for (; n > 0; ++p, --n) crc = __crc32cb(crc, *p);
+        return crc;
+    }
+    inline bool crc32c_hw_available() { return true; }
+#endif
+}
+
+// Continue a CRC32C: crc32c(crc32c(0, a), b) == crc32c(0, a + b).
+inline uint32_t crc32c(uint32_t crc, const void* data, size_t n) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+#if defined(TS_STORE_CRC32C_X86) || defined(TS_STORE_CRC32C_ARM)
+    if (detail::crc32c_hw_available()) return ~detail::crc32c_hw(crc, p, n);
+#endif
+    return ~detail::crc32c_sw(crc, p, n);
+}
+
+inline uint32_t crc32c(const void* data, size_t n) { return crc32c(0, data, n); }
+
+} // namespace jac::ts_store::inline_v001
@@ -0,0 +1,301 @@
+#pragma once
+
+// DirectFileWriter.hpp
+// O_DIRECT output for BinaryEventLog (FileOutputBackend::Direct): bytes bypass the page cache,
+// so a long run neither evicts the application's working set nor builds up dirty pages for a
+// writeback storm.
+//
+// The encoder fills one of a small pool of aligned buffers (two by default: double buffering)
+// while a dedicated I/O thread pwrite()s the previous one. Every write starts at an aligned file
+// offset and covers whole aligned pages:
+//   full buffer  — written as is; the next buffer starts right after it
+//   hand_off()   — the partial buffer goes out padded with zeros to the next page. The unfinished
+//                  tail page is copied to the front of a fresh buffer and rewritten, with more
+//                  data, by the next write
+//   close()      — pads and writes the final block, waits, then truncates the file to its
+//                  logical length (readers find the index footer at EOF)
+// A crash between hand-offs therefore leaves a zero-filled tail, like the mmap path.
+//
+// Filesystems that refuse O_DIRECT (tmpfs, some overlays) get the same aligned writes through the
+// page cache; direct() reports which one happened.
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace jac::ts_store::inline_v001 {
+
+struct DirectFileWriterOptions {
+    size_t buffer_bytes = 1 << 20;   // rounded up to a multiple of alignment
+    size_t buffer_count = 2;         // at least 2
+    size_t alignment = 4096;         // offset / length / memory alignment of every write
+};
+
+struct DirectFileWriterStats {
+    size_t bytes_written = 0;        // including padding and rewritten tail pages
+    size_t writes = 0;
+    size_t padded_writes = 0;        // partial buffers written on hand_off / close
+    size_t syncs = 0;
+    size_t encoder_stalls = 0;       // times the encoder waited for a free buffer
+};
+
+class DirectFileWriter {
+public:
+    explicit DirectFileWriter(std::string_view path, DirectFileWriterOptions options = {})
+        : path_(path),
+          align_(std::max<size_t>(options.alignment, 512)),
+          buffer_bytes_((std::max<size_t>(options.buffer_bytes, align_) + align_ - 1) / align_ * align_)
+    {
+        fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | O_DIRECT, 0644);
+        if (fd_ < 0 && errno == EINVAL) {
+            fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            direct_ = false;
+        }
+        if (fd_ < 0) {
+            throw std::runtime_error("DirectFileWriter: failed to open " + path_);
+        }
+        const size_t count = std::max<size_t>(options.buffer_count, 2);
+        for (size_t b = 0; b < count; ++b) {
+            char* p = static_cast<char*>(std::aligned_alloc(align_, buffer_bytes_));
+            if (p == nullptr) {
+                release_buffers();
+                ::close(fd_);
+                throw std::runtime_error("DirectFileWriter: aligned buffer allocation failed");
+            }
+            buffers_.push_back(p);
+            free_.push_back(b);
+        }
+        thread_ = std::thread([this] { worker_loop(); });
+    }
+
+    ~DirectFileWriter() {
+        try { close(); } catch (...) {}
+        stop_thread();
+        release_buffers();
+    }
+
+    DirectFileWriter(const DirectFileWriter&) = delete;
+    DirectFileWriter& operator=(const DirectFileWriter&) = delete;
+
+    // ---- Encoder side (one thread) ----
+
+    void write(const void* data, size_t n) {
+        const char* p = static_cast<const char*>(data);
+        while (n > 0) {
+            if (fill_ == kNone) fill_ = acquire();
+            const size_t chunk = std::min(n, buffer_bytes_ - used_);
+            std::memcpy(buffers_[fill_] + used_, p, chunk);
+            used_ += chunk;
+            logical_ += chunk;
+            p += chunk;
+            n -= chunk;
+            if (used_ == buffer_bytes_) {
+                enqueue({fill_, fill_offset_, used_, false});
+                fill_offset_ += used_;
+                fill_ = kNone;
+                used_ = 0;
+            }
+        }
+    }
+
+    void write(std::string_view bytes) { write(bytes.data(), bytes.size()); }
+
+    // Queue everything appended so far for the I/O thread; does not wait.
+    void hand_off() {
+        if (fill_ == kNone || used_ == 0) return;
+        const size_t whole = used_ / align_ * align_;
+        if (whole == used_) {
+            enqueue({fill_, fill_offset_, used_, false});
+            fill_offset_ += used_;
+            fill_ = kNone;
+            used_ = 0;
+            return;
+        }
+        const size_t tail = used_ - whole;
+        const size_t next = acquire();
+        std::memcpy(buffers_[next], buffers_[fill_] + whole, tail);
+        std::memset(buffers_[fill_] + used_, 0, whole + align_ - used_);
+        enqueue({fill_, fill_offset_, whole + align_, true});
+        fill_ = next;
+        fill_offset_ += whole;
+        used_ = tail;
+    }
+
+    // Hand off and wait until every byte appended so far reached the device.
+    void drain() {
+        hand_off();
+        std::unique_lock lock(mutex_);
+        done_cv_.wait(lock, [this] { return in_flight_ == 0; });
+        throw_if_failed();
+    }
+
+    // Durable up to the last appended byte (O_DIRECT skips the cache, fdatasync flushes the device
+    // cache and size metadata).
+    void sync() {
+        hand_off();
+        enqueue({kSyncJob, 0, 0, false});
+        drain();
+    }
+
+    void close() {
+        if (fd_ < 0) return;
+        try {
+            drain();
+        } catch (...) {
+            ::close(fd_);
+            fd_ = -1;
+            throw;
+        }
+        const int rc = ::ftruncate(fd_, static_cast<off_t>(logical_));   // drop the last page's padding
+        ::close(fd_);
+        fd_ = -1;
+        if (rc != 0) {
+            throw std::runtime_error("DirectFileWriter: ftruncate failed for " + path_);
+        }
+    }
+
+    [[nodiscard]] bool is_open() const { return fd_ >= 0; }
+    [[nodiscard]] bool direct() const { return direct_; }
+    [[nodiscard]] const std::string& path() const { return path_; }
+    [[nodiscard]] uint64_t size() const { return logical_; }
+    [[nodiscard]] size_t buffer_bytes() const { return buffer_bytes_; }
+
+    [[nodiscard]] DirectFileWriterStats stats() {
+        std::lock_guard lock(mutex_);
+        return stats_;
+    }
+
+private:
+    static constexpr size_t kNone = static_cast<size_t>(-1);
+    static constexpr size_t kSyncJob = static_cast<size_t>(-1);
+
+    struct Job {
+        size_t buffer;       // pool index, or kSyncJob
+        uint64_t offset;     // aligned
+        size_t length;       // multiple of the alignment
+        bool padded;
+    };
+
+    size_t acquire() {
+        std::unique_lock lock(mutex_);
+        throw_if_failed();
+        if (free_.empty()) {
+            ++stats_.encoder_stalls;
+            done_cv_.wait(lock, [this] { return !free_.empty(); });
+        }
+        const size_t b = free_.back();
+        free_.pop_back();
+        return b;
+    }
+
+    void enqueue(Job job) {
+        {
+            std::lock_guard lock(mutex_);
+            ++in_flight_;
+            jobs_.push_back(job);
+        }
+        work_cv_.notify_one();
+    }
+
+    // Caller holds mutex_.
+    void throw_if_failed() const {
+        if (io_errno_ != 0) {
+            throw std::runtime_error("DirectFileWriter: write failed for " + path_ + ": " + std::strerror(io_errno_));
+        }
+    }
+
+    void worker_loop() {
+        std::unique_lock lock(mutex_);
+        for (;;) {
+            work_cv_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+            if (jobs_.empty()) return;   // stop_ and nothing left
+            const Job job = jobs_.front();
+            jobs_.pop_front();
+            lock.unlock();
+
+            int err = 0;
+            if (job.buffer == kSyncJob) {
+                if (::fdatasync(fd_) != 0) err = errno;
+            } else {
+                size_t done = 0;
+                while (done < job.length) {
+                    const ssize_t n = ::pwrite(fd_, buffers_[job.buffer] + done, job.length - done,
+                                               static_cast<off_t>(job.offset + done));
+                    if (n < 0 && errno == EINTR) continue;
+                    if (n <= 0) {
+                        err = n < 0 ? errno : EIO;
+                        break;
+                    }
+                    done += static_cast<size_t>(n);
+                }
+            }
+
+            lock.lock();
+            if (job.buffer == kSyncJob) {
+                ++stats_.syncs;
+            } else {
+                stats_.bytes_written += job.length;
+                ++stats_.writes;
+                if (job.padded) ++stats_.padded_writes;
+                free_.push_back(job.buffer);
+            }
+            if (err != 0 && io_errno_ == 0) io_errno_ = err;
+            --in_flight_;
+            done_cv_.notify_all();
+        }
+    }
+
+    void stop_thread() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        work_cv_.notify_one();
+        if (thread_.joinable()) thread_.join();
+    }
+
+    void release_buffers() {
+        for (char* p : buffers_) std::free(p);
+        buffers_.clear();
+    }
+
+    std::string path_;
+    size_t align_;
+    size_t buffer_bytes_;
+    int fd_ = -1;
+    bool direct_ = true;
+    std::vector<char*> buffers_;
+
+    // Encoder-owned.
+    size_t fill_ = kNone;
+    size_t used_ = 0;
+    uint64_t fill_offset_ = 0;   // file offset of buffers_[fill_][0], always aligned
+    uint64_t logical_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    std::vector<size_t> free_;
+    std::deque<Job> jobs_;
+    size_t in_flight_ = 0;
+    int io_errno_ = 0;
+    bool stop_ = false;
+    DirectFileWriterStats stats_;
+    std::thread thread_;
+};
+
+} // namespace jac::ts_store::inline_v001
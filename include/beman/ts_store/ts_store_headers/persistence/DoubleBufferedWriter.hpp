@@ -7,32 +7,132 @@
 //
 // Supports any sink: JTextEventSink, BinaryEventSink, future SQL sinks, etc.
 // "Plug and play" design as requested.
+//
+// Durability: DurabilityPolicy picks when the worker calls IEventSink::sync(). The writer keeps a
+// durable watermark — every event_id below durable_watermark() is durable at the chosen level —
+// and wait_durable(id) blocks a producer until its own record is covered, so callers that need
+// one record on disk do not have to force fsync on every batch.
+//
+// Placement: DoubleBufferedWriterOptions::placement (or TS_STORE_PERSIST_CPUS / _SCHED / _PRIO /
+// _NICE) pins the worker and sets its scheduling; effective_placement() reports what was granted.
+//
+// Adaptive batching: with AdaptiveBatchPolicy enabled (or TS_STORE_PERSIST_ADAPTIVE=1) the worker
+// times every IEventSink::write_batch and watches how many batches piled up between drains, then
+// moves batch_size toward "one write_batch takes target_write_time" within [min_batch, max_batch].
+// A backlog (producers outrunning the sink) at least doubles the batch so write calls get larger.
 
+#include "DurableWatermark.hpp"
 #include "EventSink.hpp"
+#include "PersistCommon.hpp"
+#include "ThreadPlacement.hpp"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdlib>
 #include <memory>
+#include <future>
 #include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
 #include <thread>
 #include <vector>
 
 namespace jac::ts_store::inline_v001 {
 
+struct DurabilityPolicy {
+    DurabilityLevel level = DurabilityLevel::None;
+    // PeriodicFsync: upper bound between fsyncs while unsynced events exist.
+    std::chrono::milliseconds interval{100};
+    // GroupCommit: also fsync after this many unsynced batches (0 = only when a waiter asks).
+    size_t group_commit_batches = 0;
+};
+
+struct AdaptiveBatchPolicy {
+    bool enabled = false;
+    size_t min_batch = 1'000;
+    size_t max_batch = 200'000;
+    // Aim for one sink write_batch call taking about this long.
+    std::chrono::microseconds target_write_time{20'000};
+
+    // TS_STORE_PERSIST_ADAPTIVE=1 [+ TS_STORE_PERSIST_BATCH_MIN / _BATCH_MAX / _BATCH_TARGET_US].
+    static AdaptiveBatchPolicy from_env() {
+        AdaptiveBatchPolicy p;
+        const char* on = std::getenv("TS_STORE_PERSIST_ADAPTIVE");
+        p.enabled = on != nullptr && on[0] != '\0' && on[0] != '0';
+        if (const char* v = std::getenv("TS_STORE_PERSIST_BATCH_MIN")) p.min_batch = std::strtoull(v, nullptr, 10);
+        if (const char* v = std::getenv("TS_STORE_PERSIST_BATCH_MAX")) p.max_batch = std::strtoull(v, nullptr, 10);
+        if (const char* v = std::getenv("TS_STORE_PERSIST_BATCH_TARGET_US")) {
+            p.target_write_time = std::chrono::microseconds(std::strtoll(v, nullptr, 10));
+        }
+        return p;
+    }
+};
+
+// Batch sizing history; reported as one "[persist] batch_..." line at shutdown.
+struct BatchSizingStats {
+    size_t initial = 0;
+    size_t current = 0;
+    size_t smallest = 0;
+    size_t largest = 0;
+    size_t adjustments = 0;
+    size_t batches = 0;          // write_batch calls
+    size_t backlogs = 0;         // drains that found more than ~1.5 batches waiting
+    std::chrono::microseconds sink_time{0};
+};
+
+struct DoubleBufferedWriterOptions {
+    DurabilityPolicy durability{};
+    // Watermark base: the first global event_id this writer will see (ids are dense from here,
+    // as handed out by ts_store::save_event).
+    size_t first_event_id = 0;
+    // Optional shared marker (ShardedPersistenceWriter passes one to every shard);
+    // when null the writer creates its own starting at first_event_id.
+    std::shared_ptr<DurableWatermark> watermark;
+    // Worker CPU set / scheduling; unset = ThreadPlacement::from_env("TS_STORE_PERSIST").
+    std::optional<ThreadPlacement> placement;
+    // Online batch sizing; unset = AdaptiveBatchPolicy::from_env().
+    std::optional<AdaptiveBatchPolicy> adaptive;
+};
+
 class DoubleBufferedWriter {
 public:
     explicit DoubleBufferedWriter(std::unique_ptr<IEventSink> sink,
-                                  size_t batch_size = 10'000)
+                                  size_t batch_size = 10'000,
+                                  DoubleBufferedWriterOptions options = {})
         : sink_(std::move(sink)),
-          batch_size_(batch_size)
+          batch_size_(batch_size),
+          durability_(options.durability),
+          adaptive_(options.adaptive ? *options.adaptive : AdaptiveBatchPolicy::from_env()),
+          watermark_(options.watermark ? std::move(options.watermark)
+                                       : std::make_shared<DurableWatermark>(options.first_event_id))
     {
         if (!sink_) {
             throw std::invalid_argument("DoubleBufferedWriter requires a non-null sink");
         }
-        active_buffer_.reserve(batch_size_);
-        drain_buffer_.reserve(batch_size_);
+        watermark_->open_writer();
+        if (adaptive_.enabled) {
+            adaptive_.min_batch = std::max<size_t>(adaptive_.min_batch, 1);
+            adaptive_.max_batch = std::max(adaptive_.max_batch, adaptive_.min_batch);
+            batch_size_.store(std::clamp(batch_size, adaptive_.min_batch, adaptive_.max_batch));
+        }
+        const size_t initial = batch_size_.load();
+        sizing_.initial = sizing_.current = sizing_.smallest = sizing_.largest = initial;
+        active_buffer_.reserve(initial);
+        drain_buffer_.reserve(initial);
 
-        worker_ = std::thread([this] { worker_loop(); });
+        const ThreadPlacement placement = options.placement ? *options.placement
+                                                            : ThreadPlacement::from_env("TS_STORE_PERSIST");
+        std::promise<void> placed;
+        auto placed_future = placed.get_future();
+        worker_ = std::thread([this, placement, &placed] {
+            placement_ = apply_thread_placement(placement);
+            placed.set_value();
+            worker_loop();
+        });
+        placed_future.wait();   // effective_placement() is valid once the constructor returns
     }
 
     ~DoubleBufferedWriter() {
@@ -47,7 +147,7 @@ public:
         std::lock_guard<std::mutex> lock(buffer_mutex_);
         active_buffer_.push_back(std::move(event));
 
-        if (active_buffer_.size() >= batch_size_) {
+        if (active_buffer_.size() >= batch_size_.load(std::memory_order_relaxed)) {
             swap_and_signal();
         }
     }
@@ -70,7 +170,51 @@ public:
         stop();
     }
 
-    [[nodiscard]] size_t get_batch_size() const { return batch_size_; }
+    // True once event_id is durable at the configured DurabilityLevel.
+    [[nodiscard]] bool is_durable(size_t event_id) const {
+        return watermark_->is_durable(event_id);
+    }
+
+    // Every event_id below this value is durable (the "persisted up to" marker).
+    [[nodiscard]] size_t durable_watermark() const {
+        return watermark_->value();
+    }
+
+    // Block until event_id is durable. Pushes the partial active batch to the worker and, for
+    // GroupCommit, requests one shared fsync. Returns false if the writer stopped first
+    // (e.g. the id was never submitted).
+    bool wait_durable(size_t event_id) {
+        return watermark_->wait_until(event_id, std::chrono::steady_clock::time_point::max(),
+                                      [this] { request_durable(); });
+    }
+
+    template <typename Rep, typename Period>
+    bool wait_durable_for(size_t event_id, std::chrono::duration<Rep, Period> timeout) {
+        return watermark_->wait_until(event_id, std::chrono::steady_clock::now() + timeout,
+                                      [this] { request_durable(); });
+    }
+
+    // Push the partial active batch to the worker and (GroupCommit) ask for a shared fsync.
+    void request_durable() {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        if (!active_buffer_.empty()) {
+            swap_and_signal();
+        }
+        if (durability_.level == DurabilityLevel::GroupCommit) {
+            sync_requested_.store(true, std::memory_order_relaxed);
+        }
+        cv_.notify_one();
+    }
+
+    [[nodiscard]] const std::shared_ptr<DurableWatermark>& watermark() const { return watermark_; }
+
+    [[nodiscard]] size_t get_batch_size() const { return batch_size_.load(std::memory_order_relaxed); }
+    [[nodiscard]] const AdaptiveBatchPolicy& adaptive_policy() const { return adaptive_; }
+    // Owned by the worker; read it after finalize().
+    [[nodiscard]] const BatchSizingStats& batch_sizing() const { return sizing_; }
+    [[nodiscard]] const DurabilityPolicy& durability() const { return durability_; }
+    [[nodiscard]] size_t sync_count() const { return syncs_.load(std::memory_order_relaxed); }
+    [[nodiscard]] const EffectivePlacement& effective_placement() const { return placement_; }
 
 private:
     void swap_and_signal() {
@@ -85,37 +229,87 @@ private:
     }
 
     void worker_loop() {
+        auto last_sync = std::chrono::steady_clock::now();
+        size_t batches_since_sync = 0;
+        std::vector<DurableIdRun> unsynced;     // written, not yet published to the watermark
+
         while (true) {
             std::unique_lock<std::mutex> lock(buffer_mutex_);
 
-            cv_.wait(lock, [this] {
+            auto ready = [this] {
                 return !drain_buffer_.empty() ||
                        pending_flush_.load(std::memory_order_relaxed) ||
+                       sync_requested_.load(std::memory_order_relaxed) ||
                        stop_requested_.load(std::memory_order_relaxed);
-            });
+            };
+            if (durability_.level == DurabilityLevel::PeriodicFsync && !unsynced.empty()) {
+                cv_.wait_until(lock, last_sync + durability_.interval, ready);
+            } else {
+                cv_.wait(lock, ready);
+            }
 
             // Take ownership of the drain buffer
             std::vector<PersistedEvent> batch;
             batch.swap(drain_buffer_);
 
             bool do_flush = pending_flush_.exchange(false, std::memory_order_relaxed);
+            bool sync_req = sync_requested_.exchange(false, std::memory_order_relaxed);
             bool should_stop = stop_requested_.load(std::memory_order_relaxed);
 
             lock.unlock();
 
             if (!batch.empty()) {
+                const auto t0 = std::chrono::steady_clock::now();
                 sink_->write_batch(batch);
+                const auto took = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - t0);
+                DurableWatermark::append_runs(unsynced, batch);
+                ++batches_since_sync;
+                tune_batch_size(batch.size(), took);
             }
 
             if (do_flush || should_stop) {
                 sink_->flush();
             }
 
+            const auto now = std::chrono::steady_clock::now();
+            bool do_sync = false;
+            switch (durability_.level) {
+                case DurabilityLevel::None:
+                    watermark_->publish(unsynced);   // hand-off to the sink is the only guarantee
+                    break;
+                case DurabilityLevel::PeriodicFsync:
+                    do_sync = !unsynced.empty() && now - last_sync >= durability_.interval;
+                    break;
+                case DurabilityLevel::FsyncPerBatch:
+                    do_sync = !unsynced.empty();
+                    break;
+                case DurabilityLevel::GroupCommit:
+                    do_sync = !unsynced.empty() &&
+                              (sync_req || watermark_->has_waiters_beyond_mark() ||
+                               (durability_.group_commit_batches > 0 &&
+                                batches_since_sync >= durability_.group_commit_batches));
+                    break;
+            }
+            if (should_stop && durability_.level != DurabilityLevel::None) {
+                do_sync = true;
+            }
+
+            if (do_sync) {
+                sink_->sync();
+                syncs_.fetch_add(1, std::memory_order_relaxed);
+                watermark_->publish(unsynced);
+                last_sync = now;
+                batches_since_sync = 0;
+            }
+
             if (should_stop) {
                 sink_->finalize();
                 break;
             }
         }
+
+        watermark_->close_writer();
     }
 
     void stop() {
@@ -133,10 +327,55 @@ private:
         if (worker_.joinable()) {
             worker_.join();
         }
+        persist_report(describe_placement("worker", placement_));
+        persist_report("batch_adaptive=" + std::string(adaptive_.enabled ? "1" : "0") +
+                       " batch_initial=" + std::to_string(sizing_.initial) +
+                       " batch_final=" + std::to_string(sizing_.current) +
+                       " batch_min_seen=" + std::to_string(sizing_.smallest) +
+                       " batch_max_seen=" + std::to_string(sizing_.largest) +
+                       " batch_adjustments=" + std::to_string(sizing_.adjustments) +
+                       " batch_calls=" + std::to_string(sizing_.batches) +
+                       " batch_backlogs=" + std::to_string(sizing_.backlogs) +
+                       " sink_us_total=" + std::to_string(sizing_.sink_time.count()));
+    }
+
+    // Worker thread: one drained batch of n events spent `took` in the sink.
+    void tune_batch_size(size_t n, std::chrono::microseconds took) {
+        ++sizing_.batches;
+        sizing_.sink_time += took;
+
+        const size_t current = batch_size_.load(std::memory_order_relaxed);
+        const bool backlog = n > current + current / 2;   // producers filled more than one batch meanwhile
+        if (backlog) ++sizing_.backlogs;
+        if (!adaptive_.enabled) return;
+
+        // Per-event sink cost (EWMA) -> the batch that makes one write_batch ~ target_write_time.
+        const double per_event = static_cast<double>(took.count()) / static_cast<double>(n);
+        per_event_us_ = per_event_us_ <= 0.0 ? per_event : 0.75 * per_event_us_ + 0.25 * per_event;
+
+        size_t wanted = per_event_us_ > 0.0
+            ? static_cast<size_t>(static_cast<double>(adaptive_.target_write_time.count()) / per_event_us_)
+            : current * 2;   // below timer resolution: larger calls are free
+        if (backlog) wanted = std::max(wanted, current * 2);
+        wanted = std::clamp((3 * current + wanted) / 4, adaptive_.min_batch, adaptive_.max_batch);
+
+        // Ignore jitter within ~10% so write sizes stay stable.
+        if (wanted * 10 < current * 9 || wanted * 10 > current * 11 ||
+            (wanted != current && (wanted == adaptive_.min_batch || wanted == adaptive_.max_batch))) {
+            batch_size_.store(wanted, std::memory_order_relaxed);
+            sizing_.current = wanted;
+            sizing_.smallest = std::min(sizing_.smallest, wanted);
+            sizing_.largest = std::max(sizing_.largest, wanted);
+            ++sizing_.adjustments;
+        }
     }
 
     std::unique_ptr<IEventSink> sink_;
-    size_t batch_size_;
+    std::atomic<size_t> batch_size_;
+    DurabilityPolicy durability_;
+    AdaptiveBatchPolicy adaptive_;
+    BatchSizingStats sizing_;       // worker-owned
+    double per_event_us_ = 0.0;     // worker-owned EWMA of sink cost per event
 
     std::vector<PersistedEvent> active_buffer_;
     std::vector<PersistedEvent> drain_buffer_;
@@ -148,6 +387,11 @@ private:
     std::atomic<bool> stop_requested_{false};
     std::atomic<bool> stopped_{false};
     std::atomic<bool> pending_flush_{false};
+    std::atomic<bool> sync_requested_{false};
+
+    std::shared_ptr<DurableWatermark> watermark_;
+    std::atomic<size_t> syncs_{0};
+    EffectivePlacement placement_;
 };
 
 } // namespace jac::ts_store::inline_v001
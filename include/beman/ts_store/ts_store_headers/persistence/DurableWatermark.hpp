@@ -0,0 +1,183 @@
+#pragma once
+
+// DurableWatermark.hpp
+// "Persisted up to event_id X" marker shared by one or more background writers.
+// Writers publish the ids they have made durable; the watermark advances over the dense id
+// sequence handed out by ts_store::save_event and wakes anybody blocked in wait_until().
+// A ShardedPersistenceWriter hands one instance to all of its shards so the marker stays
+// global even though each shard only sees a subset of ids. Ids below the base (events saved
+// before the writer attached) never reach a writer: they are not durable and waits on them fail.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace jac::ts_store::inline_v001 {
+
+// Half-open run [first, last) of event ids.
+struct DurableIdRun {
+    size_t first = 0;
+    size_t last = 0;
+    friend bool operator>(const DurableIdRun& a, const DurableIdRun& b) { return a.first > b.first; }
+};
+
+class DurableWatermark {
+public:
+    explicit DurableWatermark(size_t first_event_id = 0)
+        : base_(first_event_id), next_(first_event_id)
+    {}
+
+    DurableWatermark(const DurableWatermark&) = delete;
+    DurableWatermark& operator=(const DurableWatermark&) = delete;
+
+    [[nodiscard]] bool is_durable(size_t event_id) const {
+        return event_id >= base_.load(std::memory_order_acquire) &&
+               event_id < next_.load(std::memory_order_acquire);
+    }
+
+    // Every event_id in [base(), value()) is durable.
+    [[nodiscard]] size_t value() const { return next_.load(std::memory_order_acquire); }
+    [[nodiscard]] size_t base() const { return base_.load(std::memory_order_acquire); }
+
+    // Raise the base to the first id the writers will see (ts_store::attach_persistence passes
+    // its next id). Never lowers it: a recovered base stays where it is.
+    void rebase(size_t first_event_id) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (first_event_id <= next_.load(std::memory_order_relaxed)) return;
+            base_.store(first_event_id, std::memory_order_release);
+            next_.store(advance(first_event_id), std::memory_order_release);
+        }
+        cv_.notify_all();
+    }
+
+    // Fold runs of newly durable ids into the marker (any order, any thread). Clears runs.
+    // Runs above a gap wait in a min-heap, so a lagging shard costs O(log N) per run instead of
+    // re-copying the whole backlog on every call.
+    void publish(std::vector<DurableIdRun>& runs) {
+        if (runs.empty()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            size_t next = next_.load(std::memory_order_relaxed);
+            for (const DurableIdRun& r : runs) {
+                if (r.first <= next) {
+                    next = std::max(next, r.last);      // extends the mark (or a duplicate)
+                } else {
+                    ahead_.push(r);
+                }
+            }
+            next_.store(advance(next), std::memory_order_release);
+        }
+        runs.clear();
+        cv_.notify_all();
+    }
+
+    // Append the ids of one drained batch to runs, merging adjacent ids. A batch holding a dense
+    // id range (the single-writer case) costs one run however large it is.
+    template <typename Batch>
+    static void append_runs(std::vector<DurableIdRun>& runs, const Batch& batch) {
+        if (batch.empty()) return;
+        size_t lo = batch.front().event_id;
+        size_t hi = lo;
+        for (const auto& e : batch) {
+            lo = std::min(lo, e.event_id);
+            hi = std::max(hi, e.event_id);
+        }
+        if (hi - lo + 1 == batch.size()) {       // ids are unique, so this is exactly [lo, hi]
+            add_run(runs, lo, hi + 1);
+            return;
+        }
+        for (const auto& e : batch) add_run(runs, e.event_id, e.event_id + 1);
+    }
+
+    // Waiter bookkeeping used by writers to decide whether a GroupCommit fsync is wanted.
+    void note_wanted(size_t event_id) {
+        size_t wanted = wanted_.load(std::memory_order_relaxed);
+        while (wanted < event_id + 1 &&
+               !wanted_.compare_exchange_weak(wanted, event_id + 1, std::memory_order_relaxed)) {}
+    }
+
+    [[nodiscard]] bool has_waiters_beyond_mark() const {
+        return waiters_.load(std::memory_order_relaxed) > 0 &&
+               next_.load(std::memory_order_relaxed) < wanted_.load(std::memory_order_relaxed);
+    }
+
+    // Writers register on start and close on stop; once every writer closed, waiters give up.
+    void open_writer() { open_writers_.fetch_add(1, std::memory_order_relaxed); }
+
+    void close_writer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            open_writers_.fetch_sub(1, std::memory_order_release);
+        }
+        cv_.notify_all();
+    }
+
+    [[nodiscard]] bool closed() const { return open_writers_.load(std::memory_order_acquire) == 0; }
+
+    // Block until event_id is durable, every writer closed, or the deadline passes.
+    // nudge() is called on a short cadence: the id may belong to an event that a producer has
+    // not submitted yet, so the writers must be re-asked rather than woken once.
+    template <typename Nudge>
+    bool wait_until(size_t event_id, std::chrono::steady_clock::time_point deadline, Nudge&& nudge) {
+        constexpr auto kRetry = std::chrono::milliseconds(5);
+
+        waiters_.fetch_add(1, std::memory_order_relaxed);
+        struct WaiterGuard {
+            std::atomic<size_t>& n;
+            ~WaiterGuard() { n.fetch_sub(1, std::memory_order_relaxed); }
+        } guard{waiters_};
+
+        if (event_id < base()) return false;      // saved before the writer attached
+        note_wanted(event_id);
+        while (!is_durable(event_id)) {
+            if (closed()) return is_durable(event_id);
+
+            nudge();
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            const auto wake = std::min(deadline, std::chrono::steady_clock::now() + kRetry);
+            cv_.wait_until(lock, wake, [&] { return is_durable(event_id) || closed(); });
+            if (std::chrono::steady_clock::now() >= deadline) return is_durable(event_id);
+        }
+        return true;
+    }
+
+private:
+    // Pop the contiguous prefix of ahead_ onto next (mutex_ held): an earlier id may still be
+    // in flight, so runs past a gap stay queued.
+    size_t advance(size_t next) {
+        while (!ahead_.empty() && ahead_.top().first <= next) {
+            next = std::max(next, ahead_.top().last);
+            ahead_.pop();
+        }
+        return next;
+    }
+
+    static void add_run(std::vector<DurableIdRun>& runs, size_t first, size_t last) {
+        if (!runs.empty() && runs.back().last == first) {
+            runs.back().last = last;
+        } else {
+            runs.push_back({first, last});
+        }
+    }
+
+    std::atomic<size_t> base_{0};
+    std::atomic<size_t> next_{0};
+    std::atomic<size_t> wanted_{0};
+    std::atomic<size_t> waiters_{0};
+    std::atomic<size_t> open_writers_{0};
+    // Durable runs above a gap, lowest first on top (guarded by mutex_).
+    std::priority_queue<DurableIdRun, std::vector<DurableIdRun>, std::greater<>> ahead_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+} // namespace jac::ts_store::inline_v001
@@ -43,6 +43,10 @@ public:
     /// Flush any internal buffers to durable storage.
     virtual void flush() = 0;
 
+    /// Make everything written so far durable (flush + fsync/fdatasync).
+    /// Sinks without a file handle of their own can keep the default (plain flush).
+    virtual void sync() { flush(); }
+
     /// Finalize (close files, etc.). Called on shutdown.
     virtual void finalize() = 0;
 
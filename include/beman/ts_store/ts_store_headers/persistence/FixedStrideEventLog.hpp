@@ -0,0 +1,237 @@
+#pragma once
+
+// FixedStrideEventLog.hpp
+// Fixed-stride binary log writer (layout in FixedStrideFormat.hpp). Every event goes to the slot
+// of its id, so the file is an on-disk image of select(id): FixedStrideLogReader::get() finds a
+// record without any index, and ids that were never persisted cost no disk space (sparse holes).
+//
+// The file is mapped MAP_SHARED from offset 0. When an id lands past the mapping, the file is
+// extended with ftruncate (sparse, no blocks allocated) and the mapping grown with mremap; growth
+// is geometric, so remaps stay rare. finalize() cuts the file back to the end of the highest slot
+// written. Records arriving out of id order are fine; a second record for the same id overwrites
+// the slot (counted in stats).
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "BinaryEventLog.hpp"
+#include "FixedStrideFormat.hpp"
+#include "PersistCommon.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+inline constexpr size_t kFixedStrideGrowBytes = 64 * 1024 * 1024;
+
+struct FixedStrideEventLogStats {
+    size_t rows_written = 0;
+    size_t overwrites = 0;       // slot already held a record
+    size_t out_of_range = 0;     // event_id below first_event_id: dropped
+    size_t truncated = 0;        // strings cut / metrics dropped to fit the slot
+    size_t remaps = 0;
+    size_t flushes = 0;
+    size_t syncs = 0;
+};
+
+class FixedStrideEventLog {
+public:
+    FixedStrideEventLog(std::string_view base_name,
+                        FixedStrideLayout layout,
+                        PersistMode mode = PersistMode::All,
+                        uint64_t first_event_id = 0)
+        : layout_(layout),
+          slot_bytes_(layout.slot_bytes()),
+          mode_(mode),
+          first_event_id_(first_event_id)
+    {
+        if (layout_.int_count > 0xFFFF || layout_.dbl_count > 0xFFFF ||
+            layout_.max_category_bytes > 0xFFFF || layout_.max_payload_bytes > 0xFFFF) {
+            throw std::runtime_error("FixedStrideEventLog: layout field exceeds 65535");
+        }
+        file_path_ = std::string(base_name) + ".slots";
+        fd_ = ::open(file_path_.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            throw std::runtime_error("FixedStrideEventLog: failed to open " + file_path_);
+        }
+
+        const std::string text = detail::binary_file_header(file_path_, "Fixed-Stride Binary Data File");
+        const auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        data_offset_ = (text.size() + sizeof(FixedStrideFileHeader) + page - 1) / page * page;
+        const auto now_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        const FixedStrideFileHeader h = make_fixed_stride_header(layout_, data_offset_, first_event_id_,
+                                                                 static_cast<uint64_t>(now_us));
+        std::string head(data_offset_, '\0');
+        std::memcpy(head.data(), text.data(), text.size());
+        std::memcpy(head.data() + text.size(), &h, sizeof(h));
+        if (::pwrite(fd_, head.data(), head.size(), 0) != static_cast<ssize_t>(head.size())) {
+            ::close(fd_);
+            throw std::runtime_error("FixedStrideEventLog: header write failed");
+        }
+        file_end_ = data_offset_;
+        try {
+            reserve(data_offset_ + kFixedStrideGrowBytes);
+        } catch (...) {
+            ::close(fd_);
+            throw;
+        }
+    }
+
+    ~FixedStrideEventLog() {
+        try { finalize(); } catch (...) {}
+    }
+
+    FixedStrideEventLog(const FixedStrideEventLog&) = delete;
+    FixedStrideEventLog& operator=(const FixedStrideEventLog&) = delete;
+
+    void append_event(size_t event_id,
+                      size_t thread_id,
+                      size_t per_thread_event_id,
+                      uint64_t raw_flags,
+                      std::string_view category,
+                      std::string_view payload,
+                      uint64_t timestamp_us,
+                      const std::vector<int64_t>& ints,
+                      const std::vector<double>& dbls)
+    {
+        if (mode_ == PersistMode::KeeperOnly) {
+            if ((raw_flags & KEEPER_BIT) == 0) return;
+        } else if (mode_ == PersistMode::DatabaseOnly) {
+            return;
+        }
+        if (event_id < first_event_id_) {
+            ++stats_.out_of_range;
+            return;
+        }
+
+        const size_t index = event_id - first_event_id_;
+        const size_t at = data_offset_ + index * slot_bytes_;
+        reserve(at + slot_bytes_);
+        char* slot = map_ + at;
+
+        FixedSlotHeader h{};
+        std::memcpy(&h.state, slot, sizeof(h.state));
+        if (h.state == kFixedSlotWritten) ++stats_.overwrites;
+
+        const size_t cl = std::min(category.size(), layout_.max_category_bytes);
+        const size_t pl = std::min(payload.size(), layout_.max_payload_bytes);
+        const size_t ic = std::min(ints.size(), layout_.int_count);
+        const size_t dc = std::min(dbls.size(), layout_.dbl_count);
+        if (cl != category.size() || pl != payload.size() || ic != ints.size() || dc != dbls.size()) {
+            ++stats_.truncated;
+        }
+
+        h.state = 0;   // set last
+        h.event_id = event_id;
+        h.thread_id = thread_id;
+        h.per_thread_event_id = per_thread_event_id;
+        h.flags = raw_flags;
+        h.timestamp_us = timestamp_us;
+        h.category_len = static_cast<uint16_t>(cl);
+        h.payload_len = static_cast<uint16_t>(pl);
+        h.int_count = static_cast<uint16_t>(ic);
+        h.dbl_count = static_cast<uint16_t>(dc);
+        std::memcpy(slot, &h, sizeof(h));
+
+        // Unused metric slots are zeroed so the CRC does not depend on an earlier record.
+        std::memset(slot + layout_.ints_offset(), 0, layout_.category_offset() - layout_.ints_offset());
+        if (ic != 0) std::memcpy(slot + layout_.ints_offset(), ints.data(), ic * sizeof(int64_t));
+        if (dc != 0) std::memcpy(slot + layout_.dbls_offset(), dbls.data(), dc * sizeof(double));
+        if (cl != 0) std::memcpy(slot + layout_.category_offset(), category.data(), cl);
+        if (pl != 0) std::memcpy(slot + layout_.payload_offset(), payload.data(), pl);
+
+        const uint32_t crc = fixed_slot_crc(slot, layout_);
+        std::memcpy(slot + offsetof(FixedSlotHeader, crc32c), &crc, sizeof(crc));
+        std::memcpy(slot + offsetof(FixedSlotHeader, state), &kFixedSlotWritten, sizeof(uint32_t));
+
+        if (at + slot_bytes_ > file_end_) file_end_ = at + slot_bytes_;
+        stats_.rows_written++;
+    }
+
+    void flush() {
+        if (map_ == nullptr) return;
+        ::msync(map_, file_end_, MS_ASYNC);
+        stats_.flushes++;
+    }
+
+    // Durable: write back every dirty slot page and the file size.
+    void sync() {
+        if (map_ == nullptr) return;
+        if (::msync(map_, file_end_, MS_SYNC) != 0 || ::fdatasync(fd_) != 0) {
+            throw std::runtime_error("FixedStrideEventLog: sync failed for " + file_path_);
+        }
+        stats_.syncs++;
+    }
+
+    void finalize() {
+        if (finalized_) return;
+        finalized_ = true;
+        if (map_ != nullptr) {
+            ::msync(map_, file_end_, MS_SYNC);
+            ::munmap(map_, mapped_);
+            map_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            const int rc = ::ftruncate(fd_, static_cast<off_t>(file_end_));   // drop the growth reserve
+            ::close(fd_);
+            fd_ = -1;
+            if (rc != 0) {
+                throw std::runtime_error("FixedStrideEventLog: finalize ftruncate failed");
+            }
+        }
+    }
+
+    [[nodiscard]] const FixedStrideEventLogStats& stats() const { return stats_; }
+    [[nodiscard]] const std::string& file_path() const { return file_path_; }
+    [[nodiscard]] const FixedStrideLayout& layout() const { return layout_; }
+    [[nodiscard]] size_t slot_bytes() const { return slot_bytes_; }
+    [[nodiscard]] uint64_t first_event_id() const { return first_event_id_; }
+    // Logical file length: through the highest slot written so far.
+    [[nodiscard]] size_t bytes_on_disk() const { return file_end_; }
+
+private:
+    // Map at least [0, end); the file grows sparse, the mapping by mremap.
+    void reserve(size_t end) {
+        if (end <= mapped_) return;
+        const auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        size_t want = std::max({end, mapped_ * 2, data_offset_ + kFixedStrideGrowBytes});
+        want = (want + page - 1) / page * page;
+        if (::ftruncate(fd_, static_cast<off_t>(want)) != 0) {
+            throw std::runtime_error("FixedStrideEventLog: cannot extend " + file_path_);
+        }
+        void* p = map_ == nullptr
+            ? ::mmap(nullptr, want, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0)
+            : ::mremap(map_, mapped_, want, MREMAP_MAYMOVE);
+        if (p == MAP_FAILED) {
+            throw std::runtime_error("FixedStrideEventLog: mmap failed for " + file_path_);
+        }
+        if (map_ != nullptr) stats_.remaps++;
+        map_ = static_cast<char*>(p);
+        mapped_ = want;
+    }
+
+    FixedStrideLayout layout_;
+    size_t slot_bytes_;
+    PersistMode mode_;
+    uint64_t first_event_id_;
+    std::string file_path_;
+    int fd_ = -1;
+    char* map_ = nullptr;
+    size_t mapped_ = 0;
+    size_t data_offset_ = 0;
+    size_t file_end_ = 0;
+    bool finalized_ = false;
+    FixedStrideEventLogStats stats_;
+};
+
+} // namespace jac::ts_store::inline_v001
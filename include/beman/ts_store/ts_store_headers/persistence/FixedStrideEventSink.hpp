@@ -0,0 +1,63 @@
+#pragma once
+
+// FixedStrideEventSink.hpp
+// Adapter that turns FixedStrideEventLog into an IEventSink for use with DoubleBufferedWriter.
+// Writes <base>.slots; read it back by id with FixedStrideLogReader.
+
+#include "EventSink.hpp"
+#include "FixedStrideEventLog.hpp"
+
+#include <memory>
+
+namespace jac::ts_store::inline_v001 {
+
+class FixedStrideEventSink : public IEventSink {
+public:
+    // layout: FixedStrideLayout::for_config<Config>() matches the store's row bounds.
+    FixedStrideEventSink(std::string_view base_name,
+                         FixedStrideLayout layout,
+                         PersistMode mode = PersistMode::All,
+                         uint64_t first_event_id = 0)
+        : impl_(std::make_unique<FixedStrideEventLog>(base_name, layout, mode, first_event_id))
+    {}
+
+    void write_batch(std::span<const PersistedEvent> batch) override {
+        if (!impl_) return;
+
+        for (const auto& e : batch) {
+            impl_->append_event(
+                e.event_id,
+                e.thread_id,
+                e.per_thread_event_id,
+                e.flags,
+                e.category,
+                e.payload,
+                e.timestamp_us,
+                e.int_metrics,
+                e.dbl_metrics
+            );
+        }
+    }
+
+    void flush() override {
+        if (impl_) impl_->flush();
+    }
+
+    void sync() override {
+        if (impl_) impl_->sync();
+    }
+
+    void finalize() override {
+        if (impl_) {
+            impl_->finalize();
+            impl_.reset();
+        }
+    }
+
+    std::string_view name() const override { return "FixedStrideEventSink"; }
+
+private:
+    std::unique_ptr<FixedStrideEventLog> impl_;
+};
+
+} // namespace jac::ts_store::inline_v001
@@ -0,0 +1,129 @@
+#pragma once
+
+// FixedStrideFormat.hpp
+// On-disk layout of the fixed-stride binary log (<base>.slots): one fixed-size slot per event id,
+// so the slot of any id is found by arithmetic alone.
+//
+//   "//File: ... //\n"        text header lines (every persist file starts with them)
+//   FixedStrideFileHeader     64 bytes: magic "TSFIXSLT", slot geometry, first id, header CRC
+//   zero padding              up to data_offset (page-aligned)
+//   slot[i]                   at data_offset + i * slot_bytes, for event_id = first_event_id + i
+//
+// Slot (all widths from FixedStrideLayout, slot_bytes a multiple of 8):
+//   FixedSlotHeader           56 bytes: state, CRC32C, ids, flags, timestamp, lengths / counts
+//   int64  ints[int_count]    fixed offsets, so a field is one load away from the slot pointer
+//   double dbls[dbl_count]
+//   char   category[max_category_bytes]
+//   char   payload[max_payload_bytes]
+// state is kFixedSlotWritten once the slot holds a record. Ids that were never persisted leave
+// their slots as zeros, which the writer never touches, so whole pages of them stay sparse-file
+// holes. The CRC covers the header after crc32c, the metric arrays and the used string bytes, so a
+// slot torn by a crash is detected (FixedStrideLogReader::verify).
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "Crc32c.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+inline constexpr char kFixedStrideMagic[8] = {'T', 'S', 'F', 'I', 'X', 'S', 'L', 'T'};
+inline constexpr uint16_t kFixedStrideVersion = 1;
+inline constexpr uint32_t kFixedSlotWritten = 0x544F4C53u;   // "SLOT"
+
+struct FixedStrideFileHeader {
+    char     magic[8];
+    uint16_t version;
+    uint16_t header_bytes;         // sizeof(FixedStrideFileHeader)
+    uint16_t int_count;            // metric slots per record
+    uint16_t dbl_count;
+    uint32_t slot_bytes;
+    uint16_t max_category_bytes;
+    uint16_t max_payload_bytes;
+    uint64_t data_offset;          // slot 0, page-aligned
+    uint64_t first_event_id;       // event id of slot 0
+    uint64_t created_unix_us;
+    uint8_t  reserved[12];
+    uint32_t header_crc;           // CRC32C of the bytes above
+};
+
+struct FixedSlotHeader {
+    uint32_t state;                // kFixedSlotWritten, or 0 for an id never persisted
+    uint32_t crc32c;
+    uint64_t event_id;
+    uint64_t thread_id;
+    uint64_t per_thread_event_id;
+    uint64_t flags;
+    uint64_t timestamp_us;
+    uint16_t category_len;
+    uint16_t payload_len;
+    uint16_t int_count;
+    uint16_t dbl_count;
+};
+
+static_assert(sizeof(FixedStrideFileHeader) == 64);
+static_assert(sizeof(FixedSlotHeader) == 56);
+
+// Widest record a slot holds. Strings beyond the maximum are cut, extra metrics dropped
+// (FixedStrideEventLogStats::truncated).
+struct FixedStrideLayout {
+    size_t int_count = 0;
+    size_t dbl_count = 0;
+    size_t max_category_bytes = 64;
+    size_t max_payload_bytes = 256;
+
+    // Exact bounds of a ts_store row: Config lengths are in code points, up to 4 UTF-8 bytes each.
+    template <typename Config>
+    static constexpr FixedStrideLayout for_config() {
+        return {Config::the_IntMetrics, Config::the_DblMetrics,
+                Config::max_category_length * 4, Config::max_payload_length * 4};
+    }
+
+    [[nodiscard]] constexpr size_t ints_offset() const { return sizeof(FixedSlotHeader); }
+    [[nodiscard]] constexpr size_t dbls_offset() const { return ints_offset() + int_count * sizeof(int64_t); }
+    [[nodiscard]] constexpr size_t category_offset() const { return dbls_offset() + dbl_count * sizeof(double); }
+    [[nodiscard]] constexpr size_t payload_offset() const { return category_offset() + max_category_bytes; }
+    [[nodiscard]] constexpr size_t slot_bytes() const { return (payload_offset() + max_payload_bytes + 7) / 8 * 8; }
+};
+
+inline FixedStrideFileHeader make_fixed_stride_header(const FixedStrideLayout& layout, uint64_t data_offset,
+                                                      uint64_t first_event_id, uint64_t created_unix_us) {
+    FixedStrideFileHeader h{};
+    std::memcpy(h.magic, kFixedStrideMagic, sizeof(h.magic));
+    h.version = kFixedStrideVersion;
+    h.header_bytes = sizeof(FixedStrideFileHeader);
+    h.int_count = static_cast<uint16_t>(layout.int_count);
+    h.dbl_count = static_cast<uint16_t>(layout.dbl_count);
+    h.slot_bytes = static_cast<uint32_t>(layout.slot_bytes());
+    h.max_category_bytes = static_cast<uint16_t>(layout.max_category_bytes);
+    h.max_payload_bytes = static_cast<uint16_t>(layout.max_payload_bytes);
+    h.data_offset = data_offset;
+    h.first_event_id = first_event_id;
+    h.created_unix_us = created_unix_us;
+    h.header_crc = crc32c(&h, sizeof(h) - sizeof(uint32_t));
+    return h;
+}
+
+// True when the magic, version, CRC and geometry check out.
+inline bool parse_fixed_stride_header(const char* p, size_t avail, FixedStrideFileHeader& h, FixedStrideLayout& layout) {
+    if (avail < sizeof(FixedStrideFileHeader)) return false;
+    std::memcpy(&h, p, sizeof(h));
+    if (std::memcmp(h.magic, kFixedStrideMagic, sizeof(h.magic)) != 0 || h.version != kFixedStrideVersion ||
+        h.header_bytes != sizeof(FixedStrideFileHeader) ||
+        h.header_crc != crc32c(&h, sizeof(h) - sizeof(uint32_t))) return false;
+    layout = {h.int_count, h.dbl_count, h.max_category_bytes, h.max_payload_bytes};
+    return layout.slot_bytes() == h.slot_bytes;
+}
+
+// CRC of a filled slot (FixedSlotHeader::crc32c).
+inline uint32_t fixed_slot_crc(const char* slot, const FixedStrideLayout& layout) {
+    FixedSlotHeader h;
+    std::memcpy(&h, slot, sizeof(h));
+    constexpr size_t skip = 2 * sizeof(uint32_t);   // state + crc
+    uint32_t c = crc32c(slot + skip, layout.category_offset() - skip);
+    c = crc32c(c, slot + layout.category_offset(), h.category_len);
+    return crc32c(c, slot + layout.payload_offset(), h.payload_len);
+}
+
+} // namespace jac::ts_store::inline_v001
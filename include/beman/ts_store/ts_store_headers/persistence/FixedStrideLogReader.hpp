@@ -0,0 +1,160 @@
+#pragma once
+
+// FixedStrideLogReader.hpp
+// Random access to a fixed-stride log (FixedStrideEventLog). The file is mapped read-only
+// (MADV_RANDOM); get(event_id) computes the slot address, checks its state word and returns a
+// BinaryRecordView into the mapping: no index, no search, no copy. Holes (ids never persisted)
+// and slots past the end report "absent". get() trusts a written slot; verify() also checks its
+// CRC, for post-mortem reads of a file whose writer crashed.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "BinaryLogRecovery.hpp"
+#include "FixedStrideFormat.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+class FixedStrideLogReader {
+public:
+    explicit FixedStrideLogReader(std::string_view path) : path_(path) {
+        const int fd = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("FixedStrideLogReader: cannot open " + path_);
+        }
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("FixedStrideLogReader: cannot stat " + path_);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        void* p = size_ == 0 ? MAP_FAILED : ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            throw std::runtime_error("FixedStrideLogReader: cannot map " + path_);
+        }
+        data_ = static_cast<const char*>(p);
+        ::madvise(const_cast<char*>(data_), size_, MADV_RANDOM);
+
+        size_t pos = 0;   // skip the // text header
+        while (pos + 1 < size_ && data_[pos] == '/' && data_[pos + 1] == '/') {
+            const void* nl = std::memchr(data_ + pos, '\n', size_ - pos);
+            if (nl == nullptr) break;
+            pos = static_cast<size_t>(static_cast<const char*>(nl) - data_) + 1;
+        }
+        FixedStrideFileHeader h{};
+        if (!parse_fixed_stride_header(data_ + pos, size_ - pos, h, layout_) || h.data_offset > size_ ||
+            h.data_offset < pos + sizeof(h)) {
+            ::munmap(const_cast<char*>(data_), size_);
+            throw std::runtime_error("FixedStrideLogReader: not a fixed-stride log: " + path_);
+        }
+        slots_ = data_ + h.data_offset;
+        slot_bytes_ = h.slot_bytes;
+        first_event_id_ = h.first_event_id;
+        slot_count_ = (size_ - h.data_offset) / slot_bytes_;
+    }
+
+    ~FixedStrideLogReader() {
+        if (data_ != nullptr) ::munmap(const_cast<char*>(data_), size_);
+    }
+
+    FixedStrideLogReader(const FixedStrideLogReader&) = delete;
+    FixedStrideLogReader& operator=(const FixedStrideLogReader&) = delete;
+
+    // Slot of event_id, or nullptr past either end.
+    [[nodiscard]] const char* slot(uint64_t event_id) const {
+        if (event_id < first_event_id_ || event_id - first_event_id_ >= slot_count_) return nullptr;
+        return slots_ + (event_id - first_event_id_) * slot_bytes_;
+    }
+
+    [[nodiscard]] bool contains(uint64_t event_id) const {
+        const char* s = slot(event_id);
+        return s != nullptr && state_of(s) == kFixedSlotWritten;
+    }
+
+    // False for holes and ids outside the file.
+    bool get(uint64_t event_id, BinaryRecordView& out) const {
+        const char* s = slot(event_id);
+        if (s == nullptr || state_of(s) != kFixedSlotWritten) return false;
+        FixedSlotHeader h;
+        std::memcpy(&h, s, sizeof(h));
+        if (h.category_len > layout_.max_category_bytes || h.payload_len > layout_.max_payload_bytes ||
+            h.int_count > layout_.int_count || h.dbl_count > layout_.dbl_count) return false;
+        out.event_id = h.event_id;
+        out.thread_id = h.thread_id;
+        out.per_thread_event_id = h.per_thread_event_id;
+        out.raw_flags = h.flags;
+        out.timestamp_us = h.timestamp_us;
+        out.category = std::string_view(s + layout_.category_offset(), h.category_len);
+        out.payload = std::string_view(s + layout_.payload_offset(), h.payload_len);
+        out.int_count = h.int_count;
+        out.dbl_count = h.dbl_count;
+        out.ints = s + layout_.ints_offset();
+        out.dbls = s + layout_.dbls_offset();
+        return true;
+    }
+
+    [[nodiscard]] std::optional<BinaryRecordView> get(uint64_t event_id) const {
+        BinaryRecordView v;
+        if (!get(event_id, v)) return std::nullopt;
+        return v;
+    }
+
+    // Written and intact (CRC match).
+    [[nodiscard]] bool verify(uint64_t event_id) const {
+        const char* s = slot(event_id);
+        if (s == nullptr || state_of(s) != kFixedSlotWritten) return false;
+        uint32_t crc = 0;
+        std::memcpy(&crc, s + offsetof(FixedSlotHeader, crc32c), sizeof(crc));
+        BinaryRecordView v;
+        return get(event_id, v) && crc == fixed_slot_crc(s, layout_);
+    }
+
+    // Every written slot in id order; returns how many were visited.
+    template <typename F>
+    size_t for_each(F&& f) const {
+        size_t n = 0;
+        BinaryRecordView v;
+        for (uint64_t i = 0; i < slot_count_; ++i) {
+            if (get(first_event_id_ + i, v)) {
+                f(v);
+                ++n;
+            }
+        }
+        return n;
+    }
+
+    [[nodiscard]] const std::string& path() const { return path_; }
+    [[nodiscard]] const FixedStrideLayout& layout() const { return layout_; }
+    [[nodiscard]] size_t slot_bytes() const { return slot_bytes_; }
+    [[nodiscard]] size_t slot_count() const { return slot_count_; }
+    [[nodiscard]] uint64_t first_event_id() const { return first_event_id_; }
+
+private:
+    static uint32_t state_of(const char* s) {
+        uint32_t v = 0;
+        std::memcpy(&v, s, sizeof(v));
+        return v;
+    }
+
+    std::string path_;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    const char* slots_ = nullptr;
+    size_t slot_bytes_ = 0;
+    size_t slot_count_ = 0;
+    uint64_t first_event_id_ = 0;
+    FixedStrideLayout layout_{};
+};
+
+} // namespace jac::ts_store::inline_v001
@@ -53,6 +53,11 @@ public:
         if (sql_sink_)  sql_sink_->flush();
     }
 
+    void sync() override {
+        if (file_sink_) file_sink_->sync();
+        if (sql_sink_)  sql_sink_->sync();
+    }
+
     void finalize() override {
         if (file_sink_) file_sink_->finalize();
         if (sql_sink_)  sql_sink_->finalize();
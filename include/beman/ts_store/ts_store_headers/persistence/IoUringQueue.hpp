@@ -0,0 +1,172 @@
+#pragma once
+
+// IoUringQueue.hpp
+// Minimal io_uring wrapper over the raw syscalls (no liburing dependency).
+// Only what the pipelined file output needs: one SQ/CQ pair, optional registered buffers,
+// batched submit-and-wait and completion reaping. try_create() returns nullptr when the
+// kernel (or a seccomp policy) refuses io_uring so callers can fall back to pwritev.
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace jac::ts_store::inline_v001 {
+
+class IoUringQueue {
+public:
+    static std::unique_ptr<IoUringQueue> try_create(unsigned entries) {
+        std::unique_ptr<IoUringQueue> q(new IoUringQueue());
+        return q->setup(entries) ? std::move(q) : nullptr;
+    }
+
+    ~IoUringQueue() {
+        if (sqes_ != nullptr) ::munmap(sqes_, sqes_size_);
+        if (cq_ptr_ != nullptr && cq_ptr_ != sq_ptr_) ::munmap(cq_ptr_, cq_size_);
+        if (sq_ptr_ != nullptr) ::munmap(sq_ptr_, sq_size_);
+        if (ring_fd_ >= 0) ::close(ring_fd_);
+    }
+
+    IoUringQueue(const IoUringQueue&) = delete;
+    IoUringQueue& operator=(const IoUringQueue&) = delete;
+
+    [[nodiscard]] unsigned capacity() const { return sq_entries_; }
+
+    // Pin buffers for IORING_OP_WRITE_FIXED. False (e.g. RLIMIT_MEMLOCK) means use plain writes.
+    bool register_buffers(std::span<const iovec> buffers) {
+        if (buffers.empty()) return false;
+        const long rc = ::syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_BUFFERS,
+                                  buffers.data(), static_cast<unsigned>(buffers.size()));
+        return rc == 0;
+    }
+
+    // Next free SQE (zeroed), or nullptr when pending() == capacity().
+    io_uring_sqe* next_sqe() {
+        if (pending_ >= sq_entries_) return nullptr;
+        const unsigned tail = sq_local_tail_++;
+        const unsigned idx = tail & *sq_mask_;
+        io_uring_sqe* sqe = &sqes_[idx];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sq_array_[idx] = idx;
+        ++pending_;
+        return sqe;
+    }
+
+    [[nodiscard]] unsigned pending() const { return pending_; }
+
+    // Publish queued SQEs and block until at least wait_nr completions are available.
+    // Returns 0 or -errno.
+    int submit_and_wait(unsigned wait_nr) {
+        std::atomic_ref<unsigned>(*sq_tail_).store(sq_local_tail_, std::memory_order_release);
+        unsigned to_submit = pending_;
+        while (true) {
+            const long rc = ::syscall(__NR_io_uring_enter, ring_fd_, to_submit, wait_nr,
+                                      IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (rc >= 0) {
+                pending_ -= static_cast<unsigned>(rc) < to_submit ? static_cast<unsigned>(rc) : to_submit;
+                to_submit = pending_;
+                if (to_submit == 0 || wait_nr == 0) return 0;
+                continue;   // short submit: push the rest
+            }
+            if (errno == EINTR) continue;
+            return -errno;
+        }
+    }
+
+    // Visit every available completion (user_data, res) and mark them consumed.
+    template <typename Fn>
+    unsigned reap(Fn&& fn) {
+        unsigned head = std::atomic_ref<unsigned>(*cq_head_).load(std::memory_order_relaxed);
+        const unsigned tail = std::atomic_ref<unsigned>(*cq_tail_).load(std::memory_order_acquire);
+        unsigned n = 0;
+        for (; head != tail; ++head, ++n) {
+            const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+            fn(cqe.user_data, cqe.res);
+        }
+        std::atomic_ref<unsigned>(*cq_head_).store(head, std::memory_order_release);
+        return n;
+    }
+
+private:
+    IoUringQueue() = default;
+
+    bool setup(unsigned entries) {
+        io_uring_params p{};
+        const long fd = ::syscall(__NR_io_uring_setup, entries, &p);
+        if (fd < 0) return false;
+        ring_fd_ = static_cast<int>(fd);
+
+        sq_size_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cq_size_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            if (cq_size_ > sq_size_) sq_size_ = cq_size_;
+            cq_size_ = sq_size_;
+        }
+
+        void* sq = ::mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          ring_fd_, IORING_OFF_SQ_RING);
+        if (sq == MAP_FAILED) return false;
+        sq_ptr_ = sq;
+
+        if (single_mmap) {
+            cq_ptr_ = sq_ptr_;
+        } else {
+            void* cq = ::mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                              ring_fd_, IORING_OFF_CQ_RING);
+            if (cq == MAP_FAILED) return false;
+            cq_ptr_ = cq;
+        }
+
+        sqes_size_ = p.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            ring_fd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) return false;
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        auto* sqb = static_cast<char*>(sq_ptr_);
+        auto* cqb = static_cast<char*>(cq_ptr_);
+        sq_tail_  = reinterpret_cast<unsigned*>(sqb + p.sq_off.tail);
+        sq_mask_  = reinterpret_cast<unsigned*>(sqb + p.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sqb + p.sq_off.array);
+        cq_head_  = reinterpret_cast<unsigned*>(cqb + p.cq_off.head);
+        cq_tail_  = reinterpret_cast<unsigned*>(cqb + p.cq_off.tail);
+        cq_mask_  = reinterpret_cast<unsigned*>(cqb + p.cq_off.ring_mask);
+        cqes_     = reinterpret_cast<io_uring_cqe*>(cqb + p.cq_off.cqes);
+
+        sq_entries_ = p.sq_entries;
+        sq_local_tail_ = *sq_tail_;
+        return true;
+    }
+
+    int ring_fd_ = -1;
+    void* sq_ptr_ = nullptr;
+    void* cq_ptr_ = nullptr;
+    size_t sq_size_ = 0;
+    size_t cq_size_ = 0;
+    size_t sqes_size_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_mask_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned* cq_mask_ = nullptr;
+    io_uring_cqe* cqes_ = nullptr;
+
+    unsigned sq_entries_ = 0;
+    unsigned sq_local_tail_ = 0;
+    unsigned pending_ = 0;
+};
+
+} // namespace jac::ts_store::inline_v001
@@ -15,8 +15,9 @@ public:
     JTextEventSink(std::string_view base_name,
                    size_t int_count,
                    size_t dbl_count,
-                   PersistMode mode = PersistMode::All)
-        : impl_(std::make_unique<JTextSplitEventLog>(base_name, int_count, dbl_count, mode))
+                   PersistMode mode = PersistMode::All,
+                   FileOutputBackend output = FileOutputBackend::Default)
+        : impl_(std::make_unique<JTextSplitEventLog>(base_name, int_count, dbl_count, mode, output))
     {}
 
     void write_batch(std::span<const PersistedEvent> batch) override {
@@ -45,6 +46,10 @@ public:
         if (impl_) impl_->flush();
     }
 
+    void sync() override {
+        if (impl_) impl_->sync();
+    }
+
     void finalize() override {
         if (impl_) impl_->finalize();
     }
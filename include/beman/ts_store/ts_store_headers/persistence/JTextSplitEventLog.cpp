@@ -2,20 +2,25 @@
 
 #include <filesystem>
 #include <format>
+#include <iterator>
 #include <fstream>
 #include <stdexcept>
 #include <chrono>
 
 #include "jText.h"
+#include "PipelinedFileWriter.hpp"
 
 namespace jac::ts_store::inline_v001 {
 
 namespace fs = std::filesystem;
 
 struct JTextSplitEventLog::Impl {
-    std::ofstream main_ofs;
-    std::ofstream ints_ofs;
-    std::ofstream floats_ofs;
+    // Formatting runs on the sink's worker thread; one shared I/O thread writes the three files
+    // (see PipelinedFileWriter.hpp), so batch N+1 is formatted while batch N is being written.
+    std::shared_ptr<PipelinedIo> io;
+    PipelinedOStream main_ofs;
+    PipelinedOStream ints_ofs;
+    PipelinedOStream floats_ofs;
 
     std::unique_ptr<JTextWriter> main_writer;
     std::unique_ptr<JTextWriter> ints_writer;
@@ -31,13 +36,20 @@ struct JTextSplitEventLog::Impl {
 
     JTextSplitEventLogStats stats;
     bool finalized = false;
+
+    void close_files() {
+        main_ofs.close();
+        ints_ofs.close();
+        floats_ofs.close();
+    }
 };
 
 JTextSplitEventLog::JTextSplitEventLog(
     std::string_view base_name,
     size_t int_count,
     size_t dbl_count,
-    PersistMode mode
+    PersistMode mode,
+    FileOutputBackend output
 )
     : impl_(std::make_unique<Impl>())
 {
@@ -50,15 +62,22 @@ JTextSplitEventLog::JTextSplitEventLog(
     i.int_count = int_count;
     i.dbl_count = dbl_count;
 
+    PipelinedIoOptions io_opts;
+    io_opts.backend = resolve_file_output_backend(output) == FileOutputBackend::IoUring
+                          ? FileOutputBackend::IoUring
+                          : FileOutputBackend::Pwritev;
+    io_opts.buffer_count = 6;   // two per file
+    i.io = std::make_shared<PipelinedIo>(io_opts);
+
     i.main_path = std::format("{}.jtext", base_name);
     i.ints_path = std::format("{}_Ints.jtext", base_name);
     i.floats_path = std::format("{}_Floats.jtext", base_name);
 
     // Open files ourselves first so we can prepend the required standardized // header comments.
     // Then attach JTextWriter to the open stream (its # header comes after our // block).
-    auto open_and_prep = [](std::ofstream& ofs, const std::string& path, std::string_view purpose,
-                             std::string_view related = {}) {
-        ofs.open(path, std::ios::out | std::ios::trunc);
+    auto open_and_prep = [&i](PipelinedOStream& ofs, const std::string& path, std::string_view purpose,
+                              std::string_view related = {}) {
+        ofs.open(path, i.io);
         if (!ofs.is_open()) {
             throw std::runtime_error("JTextSplitEventLog: failed to open " + path);
         }
@@ -162,6 +181,54 @@ void JTextSplitEventLog::append_event(
     }
 }
 
+void JTextSplitEventLog::format_event(
+    FormattedRows& out,
+    size_t int_count,
+    size_t dbl_count,
+    size_t event_id,
+    size_t thread_id,
+    size_t per_thread_event_id,
+    uint64_t raw_flags,
+    std::string_view category,
+    std::string_view payload,
+    uint64_t timestamp_us,
+    std::span<const int64_t> int_metrics,
+    std::span<const double> dbl_metrics
+) {
+    // Same bytes as JTextWriter::append_entry with level_sep '|' and no line-number padding.
+    std::format_to(std::back_inserter(out.main), "{}. #|# {}|{}|0x{:016x}|{}|{}|{}\n\n",
+                   event_id, thread_id, per_thread_event_id, raw_flags, category, payload, timestamp_us);
+    if (int_count > 0) {
+        std::format_to(std::back_inserter(out.ints), "{}. #|# {}", event_id, event_id);
+        for (auto v : int_metrics) std::format_to(std::back_inserter(out.ints), "|{}", v);
+        out.ints += "\n\n";
+    }
+    if (dbl_count > 0) {
+        std::format_to(std::back_inserter(out.floats), "{}. #|# {}", event_id, event_id);
+        for (auto v : dbl_metrics) std::format_to(std::back_inserter(out.floats), "|{:.10g}", v);
+        out.floats += "\n\n";
+    }
+    ++out.rows;
+}
+
+void JTextSplitEventLog::append_formatted(const FormattedRows& rows) {
+    auto& i = *impl_;
+    if (!i.main_writer || rows.rows == 0) return;
+    i.main_writer->flush();   // rows batched by append_event go first
+    i.main_ofs.write(rows.main.data(), static_cast<std::streamsize>(rows.main.size()));
+    i.stats.main_rows += rows.rows;
+    if (i.int_count > 0) {
+        i.ints_writer->flush();
+        i.ints_ofs.write(rows.ints.data(), static_cast<std::streamsize>(rows.ints.size()));
+        i.stats.ints_rows += rows.rows;
+    }
+    if (i.dbl_count > 0) {
+        i.floats_writer->flush();
+        i.floats_ofs.write(rows.floats.data(), static_cast<std::streamsize>(rows.floats.size()));
+        i.stats.floats_rows += rows.rows;
+    }
+}
+
 void JTextSplitEventLog::flush() {
     auto& i = *impl_;
     if (i.main_writer) i.main_writer->flush();
@@ -170,12 +237,23 @@ void JTextSplitEventLog::flush() {
     i.stats.batches_flushed++;
 }
 
+void JTextSplitEventLog::sync() {
+    flush();
+    auto& i = *impl_;
+    if (i.finalized) return;
+    i.main_ofs.sync_file();
+    if (i.int_count > 0) i.ints_ofs.sync_file();
+    if (i.dbl_count > 0) i.floats_ofs.sync_file();
+    i.stats.syncs++;
+}
+
 void JTextSplitEventLog::finalize() {
     auto& i = *impl_;
     if (i.finalized) return;
     if (i.main_writer) i.main_writer->finalize();
     if (i.ints_writer) i.ints_writer->finalize();
     if (i.floats_writer) i.floats_writer->finalize();
+    i.close_files();   // waits for the I/O thread: files are complete when finalize() returns
     i.finalized = true;
 }
 
@@ -186,6 +264,7 @@ const JTextSplitEventLogStats& JTextSplitEventLog::stats() const {
 const std::string& JTextSplitEventLog::main_file() const { return impl_->main_path; }
 const std::string& JTextSplitEventLog::ints_file() const { return impl_->ints_path; }
 const std::string& JTextSplitEventLog::floats_file() const { return impl_->floats_path; }
+FileOutputBackend JTextSplitEventLog::output_backend() const { return impl_->io->backend(); }
 
 void JTextSplitEventLog::write_sql_companions(
     std::string_view base_name,
@@ -11,6 +11,7 @@
 #include <vector>
 #include <cstdint>
 #include <memory>
+#include <span>
 
 #include "PersistCommon.hpp"
 
@@ -21,14 +22,32 @@ struct JTextSplitEventLogStats {
     size_t ints_rows = 0;
     size_t floats_rows = 0;
     size_t batches_flushed = 0;
+    size_t syncs = 0;
 };
 
 class JTextSplitEventLog {
 public:
+    // Rows already formatted as append_event writes them (entry line + blank separator per file),
+    // so callers can format on their own threads and hand the text over in order.
+    struct FormattedRows {
+        std::string main;
+        std::string ints;
+        std::string floats;
+        size_t rows = 0;
+
+        void clear() {
+            main.clear();
+            ints.clear();
+            floats.clear();
+            rows = 0;
+        }
+    };
+
     JTextSplitEventLog(std::string_view base_name,
                        size_t int_count,
                        size_t dbl_count,
-                       PersistMode mode = PersistMode::All);
+                       PersistMode mode = PersistMode::All,
+                       FileOutputBackend output = FileOutputBackend::Default);
 
     ~JTextSplitEventLog();
 
@@ -45,13 +64,35 @@ public:
                       const std::vector<int64_t>& int_metrics,
                       const std::vector<double>& dbl_metrics);
 
+    // Thread-safe (no log state): append one event's text to out. int_count / dbl_count are the
+    // log's configured counts (0 = no _Ints / _Floats row), as passed to the constructor.
+    static void format_event(FormattedRows& out,
+                             size_t int_count,
+                             size_t dbl_count,
+                             size_t event_id,
+                             size_t thread_id,
+                             size_t per_thread_event_id,
+                             uint64_t raw_flags,
+                             std::string_view category,
+                             std::string_view payload,
+                             uint64_t timestamp_us,
+                             std::span<const int64_t> int_metrics,
+                             std::span<const double> dbl_metrics);
+
+    // Write rows from format_event() after everything appended so far (no mode filtering).
+    void append_formatted(const FormattedRows& rows);
+
     void flush();
+    // flush() + fdatasync on all three files (durable up to the last appended event).
+    void sync();
     void finalize();
 
     [[nodiscard]] const JTextSplitEventLogStats& stats() const;
     [[nodiscard]] const std::string& main_file() const;
     [[nodiscard]] const std::string& ints_file() const;
     [[nodiscard]] const std::string& floats_file() const;
+    // Effective output path: Pwritev, or IoUring when requested and available.
+    [[nodiscard]] FileOutputBackend output_backend() const;
 
 private:
     struct Impl;
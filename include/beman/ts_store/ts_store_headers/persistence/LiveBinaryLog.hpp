@@ -0,0 +1,116 @@
+#pragma once
+
+// LiveBinaryLog.hpp
+// Live commit marker of a v2 binary log (BinaryLogFormat.hpp), shared by BinaryEventLog and
+// LiveBinaryLogReader. The writer maps the page(s) holding BinaryLogFileHeader MAP_SHARED and,
+// after each batch, stores committed_bytes (end of the last complete block, release) and then bumps
+// commit_seq. A reader in another process maps the same page; both see the same page-cache page,
+// so acquire-loading commit_seq and then committed_bytes bounds what it may decode without
+// scanning for torn blocks.
+//
+// Waiting: commit_seq doubles as a shared (not FUTEX_PRIVATE) futex word. Readers map the header
+// read-only and FUTEX_WAIT on it with a timeout of at most their poll interval; they never write
+// the file they follow, so a reader that crashes mid-wait leaves nothing behind. The writer issues
+// one FUTEX_WAKE per commit (a syscall per batch, not per event), which is cheap with no waiters.
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "BinaryLogFormat.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+namespace detail {
+    inline void futex_wake_all(uint32_t* word) {
+        ::syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+
+    // Sleeps while *word == expected, at most `timeout`. Spurious returns are fine for callers.
+    inline void futex_wait(uint32_t* word, uint32_t expected, std::chrono::nanoseconds timeout) {
+        const auto ns = timeout.count() < 0 ? 0 : timeout.count();
+        struct timespec ts{};
+        ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+        ts.tv_nsec = static_cast<long>(ns % 1000000000);
+        ::syscall(SYS_futex, word, FUTEX_WAIT, expected, &ts, nullptr, 0);
+    }
+
+    template <typename T>
+    T* live_field(char* map, size_t header_offset, size_t field_offset) {
+        return reinterpret_cast<T*>(map + header_offset + field_offset);
+    }
+}
+
+// Writer side: owns a small shared mapping of the file header.
+class BinaryLogCommitPublisher {
+public:
+    BinaryLogCommitPublisher() = default;
+    ~BinaryLogCommitPublisher() { close(); }
+
+    BinaryLogCommitPublisher(const BinaryLogCommitPublisher&) = delete;
+    BinaryLogCommitPublisher& operator=(const BinaryLogCommitPublisher&) = delete;
+
+    // Map the header at header_offset (8-byte aligned) of an existing file. False when the file
+    // cannot be mapped; the log is then simply not followable live.
+    bool open(const std::string& path, size_t header_offset) {
+        close();
+        if (header_offset % alignof(uint64_t) != 0) return false;
+        const int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+        if (fd < 0) return false;
+        const auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        const size_t bytes = (header_offset + sizeof(BinaryLogFileHeader) + page - 1) / page * page;
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        map_ = static_cast<char*>(p);
+        map_bytes_ = bytes;
+        seq_ = detail::live_field<uint32_t>(map_, header_offset, offsetof(BinaryLogFileHeader, commit_seq));
+        committed_ = detail::live_field<uint64_t>(map_, header_offset, offsetof(BinaryLogFileHeader, committed_bytes));
+        return true;
+    }
+
+    [[nodiscard]] bool is_open() const { return map_ != nullptr; }
+
+    // Everything before `committed_bytes` is complete blocks. closed: the writer is done.
+    void publish(uint64_t committed_bytes, bool closed = false) {
+        if (map_ == nullptr) return;
+        if (committed_bytes == last_bytes_ && !closed) return;
+        last_bytes_ = committed_bytes;
+        std::atomic_ref<uint64_t>(*committed_).store(committed_bytes, std::memory_order_release);
+        count_ = (count_ + 1) & ~kBinaryLogClosed;
+        std::atomic_ref<uint32_t>(*seq_).store(count_ | (closed ? kBinaryLogClosed : 0u),
+                                               std::memory_order_seq_cst);
+        ++commits_;
+        detail::futex_wake_all(seq_);
+    }
+
+    void close() {
+        if (map_ == nullptr) return;
+        ::munmap(map_, map_bytes_);
+        map_ = nullptr;
+    }
+
+    [[nodiscard]] size_t commits() const { return commits_; }
+
+private:
+    char* map_ = nullptr;
+    size_t map_bytes_ = 0;
+    uint32_t* seq_ = nullptr;
+    uint64_t* committed_ = nullptr;
+    uint32_t count_ = 0;
+    uint64_t last_bytes_ = 0;
+    size_t commits_ = 0;
+};
+
+} // namespace jac::ts_store::inline_v001
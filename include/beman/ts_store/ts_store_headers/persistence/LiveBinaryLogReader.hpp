@@ -0,0 +1,250 @@
+#pragma once
+
+// LiveBinaryLogReader.hpp
+// Follow a v2 binary log while BinaryEventLog is still appending to it, from the same or another
+// process. The reader maps the file read-only and, on poll(), decodes the blocks between where it
+// stopped and the committed length the writer last published in the file header
+// (LiveBinaryLog.hpp). It never reopens or rescans: the mapping grows with mremap and
+// decoding resumes at the next block. wait() sleeps on the header's commit_seq futex until the
+// writer publishes again, so a dashboard loop of wait() + poll() sees events within a batch
+// interval.
+//
+// Logs whose writer does not publish (Direct output, files written before the marker existed)
+// are followed by file size instead: blocks are taken only once their header and CRC check out,
+// and wait() degrades to sleeping poll_interval. Records are handed out as BinaryRecordView and
+// are valid only during the callback.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "BinaryLogFormat.hpp"
+#include "BinaryLogRecovery.hpp"
+#include "CompactRecords.hpp"
+#include "LiveBinaryLog.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+struct LiveReadOptions {
+    bool from_start = true;                                 // false: skip what is already committed
+    std::chrono::milliseconds poll_interval{100};           // longest single sleep in wait()
+};
+
+class LiveBinaryLogReader {
+public:
+    explicit LiveBinaryLogReader(std::string_view path, LiveReadOptions options = {})
+        : path_(path), options_(options)
+    {
+        fd_ = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) {
+            throw std::runtime_error("LiveBinaryLogReader: cannot open " + path_);
+        }
+        if (!remap(file_size()) || !parse_preamble()) {
+            release();
+            throw std::runtime_error("LiveBinaryLogReader: not a v2 binary log: " + path_);
+        }
+        map_header();
+        if (!options_.from_start) {   // skip to the end of what is committed now
+            const uint64_t end = limit();
+            BinaryBlockHeader h{};
+            while (pos_ < end && parse_block_header(data_ + pos_, end - pos_, h)) {
+                pos_ += sizeof(BinaryBlockHeader) + h.stored_bytes;
+            }
+        }
+    }
+
+    ~LiveBinaryLogReader() { release(); }
+
+    LiveBinaryLogReader(const LiveBinaryLogReader&) = delete;
+    LiveBinaryLogReader& operator=(const LiveBinaryLogReader&) = delete;
+
+    // Deliver every record of the blocks committed since the last call to f(const BinaryRecordView&).
+    // Returns the number of records delivered; 0 when nothing new is complete.
+    template <typename F>
+    size_t poll(F&& f) {
+        const uint64_t end = limit();
+        if (!published_) polled_size_ = static_cast<size_t>(end);
+        if (end > mapped_ && !remap(static_cast<size_t>(end))) return 0;
+        size_t n = 0;
+        BinaryBlockHeader h{};
+        while (!broken_ && pos_ < end) {
+            if (!parse_block_header(data_ + pos_, end - pos_, h) || !verify_block_payload(h, data_ + pos_ + sizeof(h))) {
+                // Unpublished logs: the next block may simply not be finished yet.
+                if (published_) {
+                    ++corrupt_blocks_;
+                    broken_ = true;
+                }
+                break;
+            }
+            const char* records = nullptr;
+            size_t records_n = 0;
+            if (!block_records(h, data_ + pos_ + sizeof(h), decoded_, scratch_, records, records_n)) {
+                ++corrupt_blocks_;
+                broken_ = true;
+                break;
+            }
+            for (size_t at = 0; at + sizeof(uint32_t) <= records_n;) {
+                uint32_t len = 0;
+                std::memcpy(&len, records + at, sizeof(len));
+                BinaryRecordView v;
+                if (!MappedBinaryLog::decode(records + at + sizeof(len), len, records_n - at - sizeof(len), v)) break;
+                f(static_cast<const BinaryRecordView&>(v));
+                at += sizeof(len) + len;
+                ++n;
+            }
+            pos_ += sizeof(BinaryBlockHeader) + h.stored_bytes;
+            ++blocks_read_;
+        }
+        records_read_ += n;
+        return n;
+    }
+
+    // Block until the writer publishes a new commit, the log is closed, or timeout passes.
+    // True when there may be something new for poll().
+    bool wait(std::chrono::milliseconds timeout) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (;;) {
+            const uint64_t end = limit();
+            if (published_ ? closed() || end > pos_ : end != polled_size_) return true;
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) return false;
+            const auto slice = std::min<std::chrono::nanoseconds>(deadline - now, options_.poll_interval);
+            if (seq_ == nullptr || !published_) {   // follow by file size: the file has to grow
+                std::this_thread::sleep_for(slice);
+                continue;
+            }
+            const uint32_t seen = std::atomic_ref<uint32_t>(*seq_).load(std::memory_order_acquire);
+            if (limit() <= pos_ && !closed()) detail::futex_wait(seq_, seen, slice);
+        }
+    }
+
+    // poll() + wait() until the writer closes the log or nothing is committed for idle_timeout.
+    template <typename F>
+    size_t follow(F&& f, std::chrono::milliseconds idle_timeout) {
+        size_t n = 0;
+        for (;;) {
+            n += poll(f);
+            if (broken_ || (closed() && pos_ >= limit())) return n;
+            if (!wait(idle_timeout)) return n;
+        }
+    }
+
+    // The writer finalized the log (published logs only).
+    [[nodiscard]] bool closed() const {
+        return seq_ != nullptr &&
+               (std::atomic_ref<uint32_t>(*seq_).load(std::memory_order_acquire) & kBinaryLogClosed) != 0;
+    }
+    // The writer announces commits; false means follow-by-file-size.
+    [[nodiscard]] bool published() const { return published_; }
+    [[nodiscard]] uint64_t committed_bytes() const { return limit(); }
+    [[nodiscard]] size_t position() const { return pos_; }
+    [[nodiscard]] size_t records_read() const { return records_read_; }
+    [[nodiscard]] size_t blocks_read() const { return blocks_read_; }
+    [[nodiscard]] size_t corrupt_blocks() const { return corrupt_blocks_; }
+    [[nodiscard]] const BinaryLogSchema& schema() const { return schema_; }
+    [[nodiscard]] const std::string& path() const { return path_; }
+
+private:
+    // End of the bytes that may be decoded: the published committed length, else the file size.
+    [[nodiscard]] uint64_t limit() const {
+        if (committed_ != nullptr) {
+            const uint64_t c = std::atomic_ref<uint64_t>(*committed_).load(std::memory_order_acquire);
+            if (c != 0) {
+                published_ = true;
+                return c;
+            }
+        }
+        return published_ ? pos_ : file_size();
+    }
+
+    [[nodiscard]] size_t file_size() const {
+        struct stat st{};
+        return ::fstat(fd_, &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+    }
+
+    // Map at least `want` bytes, growing geometrically but never past the file end.
+    bool remap(size_t want) {
+        const size_t size = file_size();
+        if (want > size || want == 0) return false;
+        const size_t bytes = std::min(size, std::max(want, mapped_ * 2));
+        void* p = data_ == nullptr
+            ? ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd_, 0)
+            : ::mremap(const_cast<char*>(data_), mapped_, bytes, MREMAP_MAYMOVE);
+        if (p == MAP_FAILED) return false;
+        data_ = static_cast<const char*>(p);
+        mapped_ = bytes;
+        return true;
+    }
+
+    bool parse_preamble() {
+        size_t pos = 0;
+        while (pos + 1 < mapped_ && data_[pos] == '/' && data_[pos + 1] == '/') {
+            const void* nl = std::memchr(data_ + pos, '\n', mapped_ - pos);
+            if (nl == nullptr) return false;
+            pos = static_cast<size_t>(static_cast<const char*>(nl) - data_) + 1;
+        }
+        BinaryLogFileHeader h{};
+        if (!parse_binary_log_preamble(data_ + pos, mapped_ - pos, h, schema_)) return false;
+        header_offset_ = pos;
+        pos_ = pos + sizeof(BinaryLogFileHeader) + sizeof(BinaryLogSchema);
+        return true;
+    }
+
+    // Read-only shared mapping of the header page for commit_seq / committed_bytes; the futex
+    // wait in wait() needs only read access, so the reader never writes the log.
+    void map_header() {
+        if (header_offset_ % alignof(uint64_t) != 0) return;   // pre-alignment writer: size-follow only
+        const auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        header_bytes_ = (header_offset_ + sizeof(BinaryLogFileHeader) + page - 1) / page * page;
+        void* p = ::mmap(nullptr, header_bytes_, PROT_READ, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) return;
+        header_ = static_cast<char*>(p);
+        seq_ = detail::live_field<uint32_t>(header_, header_offset_, offsetof(BinaryLogFileHeader, commit_seq));
+        committed_ = detail::live_field<uint64_t>(header_, header_offset_, offsetof(BinaryLogFileHeader, committed_bytes));
+    }
+
+    void release() {
+        if (header_ != nullptr) ::munmap(header_, header_bytes_);
+        if (data_ != nullptr) ::munmap(const_cast<char*>(data_), mapped_);
+        if (fd_ >= 0) ::close(fd_);
+        header_ = nullptr;
+        data_ = nullptr;
+        fd_ = -1;
+    }
+
+    std::string path_;
+    LiveReadOptions options_;
+    int fd_ = -1;
+    const char* data_ = nullptr;
+    size_t mapped_ = 0;
+    char* header_ = nullptr;
+    size_t header_bytes_ = 0;
+    size_t header_offset_ = 0;
+    uint32_t* seq_ = nullptr;
+    uint64_t* committed_ = nullptr;
+    mutable bool published_ = false;
+    bool broken_ = false;
+    size_t polled_size_ = 0;         // unpublished: file size seen by the last poll()
+    size_t pos_ = 0;                 // next block header
+    BinaryLogSchema schema_{};
+    std::vector<char> decoded_;
+    std::vector<char> scratch_;
+    size_t records_read_ = 0;
+    size_t blocks_read_ = 0;
+    size_t corrupt_blocks_ = 0;
+};
+
+} // namespace jac::ts_store::inline_v001
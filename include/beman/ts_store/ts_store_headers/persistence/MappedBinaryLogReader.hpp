@@ -0,0 +1,168 @@
+#pragma once
+
+// MappedBinaryLogReader.hpp
+// Zero-copy sequential reader for BinaryEventLog files. The file is mapped once (MappedBinaryLog:
+// PROT_READ, MADV_SEQUENTIAL) and next() hands out BinaryRecordView objects whose strings and
+// metric pointers point straight into the mapping. Nothing is allocated per record. Each v2 block's
+// CRC32C is checked once before its records are returned. Compressed and compact blocks are
+// decoded into one reused buffer, so their views stay valid only until the next block is loaded.
+// Raw-block views stay valid while the reader lives.
+//
+// Same positioning as BinaryEventLogReader: seek_to_event / seek_to_time through the sparse
+// index, set_flag_filter to skip blocks (and records) by flag mask. v1 logs are read as one run
+// of records.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "BinaryLogFormat.hpp"
+#include "BinaryLogIndex.hpp"
+#include "BinaryLogRecovery.hpp"
+#include "BlockCompression.hpp"
+#include "CompactRecords.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+class MappedBinaryLogReader {
+public:
+    explicit MappedBinaryLogReader(std::string_view path)
+        : log_(path),
+          version_(log_.version()),
+          schema_(log_.schema()),
+          begin_(log_.data_begin()),
+          end_(version_ == kBinaryLogVersion ? log_.data_end() : log_.size())
+    {
+        rewind();
+    }
+
+    // Next record (passing the flag filter), or false at the end / at the first corrupt block.
+    bool next(BinaryRecordView& out) {
+        for (;;) {
+            while (cur_ == cur_end_) {
+                if (!load_next_block()) return false;
+            }
+            uint32_t len = 0;
+            if (static_cast<size_t>(cur_end_ - cur_) < sizeof(len)) return stop();
+            std::memcpy(&len, cur_, sizeof(len));
+            if (!MappedBinaryLog::decode(cur_ + sizeof(len), len,
+                                         static_cast<size_t>(cur_end_ - cur_) - sizeof(len), out)) {
+                return stop();
+            }
+            cur_ += sizeof(len) + len;
+            if (flag_mask_ != 0 && (out.raw_flags & flag_mask_) == 0) continue;
+            ++records_read_;
+            return true;
+        }
+    }
+
+    // Call f(const BinaryRecordView&) for every remaining record; returns how many.
+    template <typename F>
+    size_t for_each(F&& f) {
+        BinaryRecordView v;
+        size_t n = 0;
+        while (next(v)) {
+            f(static_cast<const BinaryRecordView&>(v));
+            ++n;
+        }
+        return n;
+    }
+
+    void rewind() {
+        records_read_ = 0;
+        done_ = false;
+        if (version_ == kBinaryLogVersion) {
+            pos_ = begin_;
+            cur_ = cur_end_ = nullptr;
+        } else {   // v1: the whole data area is one run of records
+            pos_ = end_;
+            cur_ = log_.data() + begin_;
+            cur_end_ = log_.data() + end_;
+        }
+    }
+
+    // v2: continue from the block holding event_id / the first block that may hold timestamps
+    // >= timestamp_us (that block's earlier records included). False when none qualifies or v1.
+    bool seek_to_event(uint64_t event_id) { return seek_to_block(index().find_event(event_id)); }
+    bool seek_to_time(uint64_t timestamp_us) { return seek_to_block(index().find_time(timestamp_us)); }
+
+    void set_flag_filter(uint64_t mask) { flag_mask_ = mask; }
+
+    const BinaryLogIndex& index() {
+        if (!index_) index_.emplace(log_.index());
+        return *index_;
+    }
+
+    [[nodiscard]] uint16_t version() const { return version_; }
+    [[nodiscard]] const BinaryLogSchema& schema() const { return schema_; }
+    [[nodiscard]] size_t records_read() const { return records_read_; }
+    [[nodiscard]] size_t corrupt_blocks() const { return corrupt_blocks_; }
+    [[nodiscard]] size_t skipped_blocks() const { return skipped_blocks_; }
+    [[nodiscard]] const MappedBinaryLog& log() const { return log_; }
+
+private:
+    bool stop() {
+        done_ = true;
+        cur_ = cur_end_ = nullptr;
+        return false;
+    }
+
+    bool seek_to_block(size_t block) {
+        if (version_ != kBinaryLogVersion || block == BinaryLogIndex::npos) return stop();
+        done_ = false;
+        pos_ = static_cast<size_t>(index_->entries()[block].block_offset);
+        cur_ = cur_end_ = nullptr;
+        return true;
+    }
+
+    bool load_next_block() {
+        if (done_ || version_ != kBinaryLogVersion) return stop();
+        const char* const base = log_.data();
+        BinaryBlockHeader h{};
+        for (;;) {
+            if (pos_ >= end_) return stop();   // clean end (index footer follows)
+            if (!parse_block_header(base + pos_, end_ - pos_, h)) {
+                ++corrupt_blocks_;
+                return stop();
+            }
+            const size_t body = pos_ + sizeof(BinaryBlockHeader);
+            pos_ = body + h.stored_bytes;
+            if (flag_mask_ != 0 && (h.flags_or & flag_mask_) == 0) {
+                ++skipped_blocks_;
+                continue;
+            }
+            if (!verify_block_payload(h, base + body)) {
+                ++corrupt_blocks_;
+                return stop();
+            }
+            size_t n = 0;   // inflated_ grows to the largest block, then stays
+            if (!block_records(h, base + body, inflated_, scratch_, cur_, n)) break;
+            cur_end_ = cur_ + n;
+            return true;
+        }
+        ++corrupt_blocks_;
+        return stop();
+    }
+
+    MappedBinaryLog log_;
+    uint16_t version_ = 1;
+    BinaryLogSchema schema_{};
+    size_t begin_ = 0;              // first block (v2) / record (v1)
+    size_t end_ = 0;                // end of block data (index footer or file end)
+    size_t pos_ = 0;                // v2: next block header
+    const char* cur_ = nullptr;     // records of the current block
+    const char* cur_end_ = nullptr;
+    bool done_ = false;
+    std::vector<char> inflated_;
+    std::vector<char> scratch_;     // compressed compact blocks: codec output
+    std::optional<BinaryLogIndex> index_;
+    uint64_t flag_mask_ = 0;
+    size_t records_read_ = 0;
+    size_t corrupt_blocks_ = 0;
+    size_t skipped_blocks_ = 0;
+};
+
+} // namespace jac::ts_store::inline_v001
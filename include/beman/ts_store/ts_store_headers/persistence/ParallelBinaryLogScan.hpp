@@ -0,0 +1,345 @@
+#pragma once
+
+// ParallelBinaryLogScan.hpp
+// Multi-threaded scan of a mapped binary log for offline processing.
+//
+// Work units: v2 logs are split by block (taken from the seek index, so blocks are found without
+// touching their payload). v1 logs have no framing, so one quick pass hops over the length
+// prefixes and cuts the records into runs of kV1RunRecords. Workers claim units from a shared
+// counter, check CRCs, expand compressed / compact blocks, decode records and hand BinaryRecordViews to
+// the visitor.
+//
+// Filter pushdown: BinaryScanFilter prunes whole blocks from their index entry (flag OR, time
+// and id ranges) before any byte of them is read, then tests each record. A category or payload
+// word filter also consults the per-block Bloom filters of the footer (BinaryLogBloom.hpp) when
+// the log has them, so a needle lookup only reads the blocks that may hold it.
+//
+// Delivery: unordered (default) calls the visitor concurrently from all workers. The visitor may
+// take (size_t worker, const BinaryRecordView&) to keep per-worker state. Ordered mode still
+// decodes in parallel, but each worker waits for its block's turn, so the visitor sees file order
+// and is never called concurrently.
+//
+// A block that fails its CRC or decode is skipped and counted; an exception thrown by the visitor
+// stops the scan and is rethrown on the calling thread.
+//
+// parallel_transform: ordered output where the per-record work is the expensive part (text
+// formatting, building rows). Each worker formats a whole unit into its own chunk in parallel;
+// only emit(chunk) waits for the unit's turn, so the output is in file order and emit is never
+// called concurrently. At most one chunk per worker is in flight.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "BinaryLogBloom.hpp"
+#include "BinaryLogFormat.hpp"
+#include "BinaryLogIndex.hpp"
+#include "BinaryLogRecovery.hpp"
+#include "BlockCompression.hpp"
+#include "CompactRecords.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+struct BinaryScanFilter {
+    uint64_t flag_mask = 0;                    // records with (flags & mask) != 0; 0 = any
+    uint64_t from_timestamp_us = 0;            // inclusive time range
+    uint64_t to_timestamp_us = UINT64_MAX;
+    uint64_t from_event_id = 0;                // inclusive id range
+    uint64_t to_event_id = UINT64_MAX;
+    std::optional<std::string> category;       // exact category
+    std::string tokens;                        // every word of this text is a word of the payload
+
+    [[nodiscard]] bool matches(const BinaryRecordView& r) const {
+        return (flag_mask == 0 || (r.raw_flags & flag_mask) != 0) &&
+               r.timestamp_us >= from_timestamp_us && r.timestamp_us <= to_timestamp_us &&
+               r.event_id >= from_event_id && r.event_id <= to_event_id &&
+               (!category || r.category == *category) && (tokens.empty() || payload_matches(r.payload));
+    }
+
+    [[nodiscard]] bool payload_matches(std::string_view payload) const {
+        bool all = true;
+        detail::for_each_token(tokens, [&](std::string_view t) {
+            if (all && !detail::text_has_token(payload, t)) all = false;
+        });
+        return all;
+    }
+
+    // True when the Bloom filters can rule blocks out for this filter.
+    [[nodiscard]] bool uses_bloom() const { return category.has_value() || !tokens.empty(); }
+
+    // False when no record of the block can match.
+    [[nodiscard]] bool may_match(const BinaryIndexEntry& e) const {
+        return (flag_mask == 0 || (e.flags_or & flag_mask) != 0) &&
+               e.max_timestamp_us >= from_timestamp_us && e.min_timestamp_us <= to_timestamp_us &&
+               e.max_event_id >= from_event_id && e.min_event_id <= to_event_id;
+    }
+
+    // False when block `block`'s Bloom filter rules out the category or a payload word.
+    [[nodiscard]] bool may_match(const BinaryBloomIndex& bloom, size_t block) const {
+        return (!category || bloom.may_contain_category(block, *category)) &&
+               (tokens.empty() || bloom.may_contain_tokens(block, tokens));
+    }
+};
+
+struct ParallelScanOptions {
+    size_t threads = 0;          // 0 = std::thread::hardware_concurrency()
+    bool ordered = false;        // deliver in file order, one record at a time
+    BinaryScanFilter filter{};
+};
+
+struct ParallelScanResult {
+    size_t records_decoded = 0;  // records in the blocks that were read
+    size_t records_matched = 0;  // handed to the visitor
+    size_t units_total = 0;      // blocks (v2) / record runs (v1)
+    size_t units_pruned = 0;     // skipped from the index entry alone
+    size_t units_pruned_by_bloom = 0;   // skipped by the block's Bloom filter
+    size_t corrupt_units = 0;
+    size_t threads = 0;
+    std::chrono::microseconds elapsed{0};
+};
+
+namespace detail {
+    inline constexpr size_t kV1RunRecords = 16 * 1024;
+
+    struct ScanUnit {
+        size_t offset = 0;   // v2: block header; v1: first record's length prefix
+        size_t end = 0;      // v1: one past the run
+    };
+
+    // Work units of the log: v2 blocks from the seek index (pruned by the filter), v1 record runs.
+    inline std::vector<ScanUnit> scan_units(const MappedBinaryLog& log, const BinaryScanFilter& filter,
+                                            ParallelScanResult& result) {
+        std::vector<ScanUnit> units;
+        if (log.version() == kBinaryLogVersion) {
+            const BinaryLogIndex index = log.index();
+            const BinaryBloomIndex bloom = filter.uses_bloom() ? log.bloom_filters() : BinaryBloomIndex{};
+            result.units_total = index.size();
+            for (size_t i = 0; i < index.size(); ++i) {
+                const BinaryIndexEntry& e = index.entries()[i];
+                if (!filter.may_match(e)) ++result.units_pruned;
+                else if (!bloom.empty() && !filter.may_match(bloom, i)) ++result.units_pruned_by_bloom;
+                else units.push_back({static_cast<size_t>(e.block_offset), 0});
+            }
+            return units;
+        }
+        const char* const base = log.data();
+        const size_t data_end = log.size();
+        size_t pos = log.data_begin(), run_start = pos, in_run = 0;
+        while (data_end - pos >= sizeof(uint32_t)) {
+            uint32_t len = 0;
+            std::memcpy(&len, base + pos, sizeof(len));
+            if (len < MappedBinaryLog::kMinRecordBody || len > data_end - pos - sizeof(len)) break;
+            pos += sizeof(len) + len;
+            if (++in_run == kV1RunRecords) {
+                units.push_back({run_start, pos});
+                run_start = pos;
+                in_run = 0;
+            }
+        }
+        if (in_run != 0) units.push_back({run_start, pos});
+        result.units_total = units.size();
+        return units;
+    }
+
+    // Check and decode one unit, calling on_match(view) for the records that pass the filter.
+    // False when the unit is damaged (records before the damage have been delivered).
+    template <typename OnMatch>
+    bool decode_unit(const MappedBinaryLog& log, const ScanUnit& unit, const BinaryScanFilter& filter,
+                     std::vector<char>& inflated, std::vector<char>& scratch, size_t& decoded, OnMatch&& on_match) {
+        const char* const base = log.data();
+        const char* p = nullptr;
+        const char* end = nullptr;
+        if (log.version() == kBinaryLogVersion) {
+            BinaryBlockHeader h{};
+            const size_t data_end = log.data_end();
+            size_t n = 0;
+            if (!parse_block_header(base + unit.offset, data_end - unit.offset, h) ||
+                !verify_block_payload(h, base + unit.offset + sizeof(h)) ||
+                !block_records(h, base + unit.offset + sizeof(h), inflated, scratch, p, n)) {
+                return false;
+            }
+            end = p + n;
+        } else {
+            p = base + unit.offset;
+            end = base + unit.end;
+        }
+        BinaryRecordView v;
+        while (p != end) {
+            uint32_t len = 0;
+            if (static_cast<size_t>(end - p) < sizeof(len)) return false;
+            std::memcpy(&len, p, sizeof(len));
+            if (!MappedBinaryLog::decode(p + sizeof(len), len, static_cast<size_t>(end - p) - sizeof(len), v)) {
+                return false;
+            }
+            p += sizeof(len) + len;
+            ++decoded;
+            if (filter.matches(v)) on_match(static_cast<const BinaryRecordView&>(v));
+        }
+        return true;
+    }
+}
+
+template <typename Visitor>
+ParallelScanResult parallel_scan(const MappedBinaryLog& log, Visitor&& visit, const ParallelScanOptions& options = {}) {
+    const auto start = std::chrono::steady_clock::now();
+    const BinaryScanFilter& filter = options.filter;
+    ParallelScanResult result;
+
+    // 1. Work units.
+    const std::vector<detail::ScanUnit> units = detail::scan_units(log, filter, result);
+
+    size_t threads = options.threads == 0 ? std::thread::hardware_concurrency() : options.threads;
+    threads = std::clamp<size_t>(threads, 1, std::max<size_t>(1, units.size()));
+    result.threads = threads;
+
+    // 2. Workers.
+    std::atomic<size_t> next_unit{0};
+    std::atomic<bool> abort{false};
+    std::exception_ptr error;
+    std::mutex turn_mtx;                 // ordered: delivery turn + error slot
+    std::condition_variable turn_cv;
+    size_t delivered = 0;
+
+    struct Counters { size_t decoded = 0, matched = 0, corrupt = 0; };
+    std::vector<Counters> counters(threads);
+
+    auto call = [&visit](size_t worker, const BinaryRecordView& v) {
+        if constexpr (std::is_invocable_v<Visitor&, size_t, const BinaryRecordView&>) visit(worker, v);
+        else visit(v);
+    };
+
+    auto worker = [&](size_t w) {
+        std::vector<char> inflated, scratch;
+        std::vector<BinaryRecordView> pending;   // ordered: matches of the current unit
+        Counters& c = counters[w];
+        try {
+            for (size_t i = next_unit.fetch_add(1); i < units.size() && !abort.load(std::memory_order_relaxed);
+                 i = next_unit.fetch_add(1)) {
+                pending.clear();
+                const bool ok = detail::decode_unit(log, units[i], filter, inflated, scratch, c.decoded,
+                    [&](const BinaryRecordView& v) {
+                        if (options.ordered) pending.push_back(v);
+                        else { call(w, v); ++c.matched; }
+                    });
+                if (!ok) ++c.corrupt;
+
+                if (options.ordered) {
+                    std::unique_lock lk(turn_mtx);
+                    turn_cv.wait(lk, [&] { return delivered == i || abort.load(std::memory_order_relaxed); });
+                    if (abort.load(std::memory_order_relaxed)) return;
+                    if (ok) {
+                        for (const auto& r : pending) call(w, r);
+                        c.matched += pending.size();
+                    }
+                    ++delivered;
+                    lk.unlock();
+                    turn_cv.notify_all();
+                }
+            }
+        } catch (...) {
+            std::lock_guard lk(turn_mtx);
+            if (!error) error = std::current_exception();
+            abort.store(true, std::memory_order_relaxed);
+            turn_cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (size_t t = 1; t < threads; ++t) pool.emplace_back(worker, t);
+    worker(0);   // calling thread is worker 0
+    for (auto& th : pool) th.join();
+    if (error) std::rethrow_exception(error);
+
+    for (const auto& c : counters) {
+        result.records_decoded += c.decoded;
+        result.records_matched += c.matched;
+        result.corrupt_units += c.corrupt;
+    }
+    result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    return result;
+}
+
+// Ordered transform: format(chunk, view) appends each matching record of a unit to the worker's
+// chunk (Chunk needs clear(); a moved-from chunk must be reusable), then emit(chunk) hands the
+// units over in file order. Damaged units contribute the records decoded before the damage.
+// options.ordered is ignored.
+template <typename Chunk, typename Format, typename Emit>
+ParallelScanResult parallel_transform(const MappedBinaryLog& log, Format&& format, Emit&& emit,
+                                      const ParallelScanOptions& options = {}) {
+    const auto start = std::chrono::steady_clock::now();
+    ParallelScanResult result;
+    const std::vector<detail::ScanUnit> units = detail::scan_units(log, options.filter, result);
+
+    size_t threads = options.threads == 0 ? std::thread::hardware_concurrency() : options.threads;
+    threads = std::clamp<size_t>(threads, 1, std::max<size_t>(1, units.size()));
+    result.threads = threads;
+
+    std::atomic<size_t> next_unit{0};
+    std::atomic<bool> abort{false};
+    std::exception_ptr error;
+    std::mutex turn_mtx;
+    std::condition_variable turn_cv;
+    size_t delivered = 0;
+
+    struct Counters { size_t decoded = 0, matched = 0, corrupt = 0; };
+    std::vector<Counters> counters(threads);
+
+    auto worker = [&](size_t w) {
+        std::vector<char> inflated, scratch;
+        Chunk chunk{};
+        Counters& c = counters[w];
+        try {
+            for (size_t i = next_unit.fetch_add(1); i < units.size() && !abort.load(std::memory_order_relaxed);
+                 i = next_unit.fetch_add(1)) {
+                chunk.clear();
+                size_t matched = 0;
+                if (!detail::decode_unit(log, units[i], options.filter, inflated, scratch, c.decoded,
+                                         [&](const BinaryRecordView& v) { format(chunk, v); ++matched; })) {
+                    ++c.corrupt;
+                }
+                std::unique_lock lk(turn_mtx);
+                turn_cv.wait(lk, [&] { return delivered == i || abort.load(std::memory_order_relaxed); });
+                if (abort.load(std::memory_order_relaxed)) return;
+                if (matched != 0) emit(chunk);
+                c.matched += matched;
+                ++delivered;
+                lk.unlock();
+                turn_cv.notify_all();
+            }
+        } catch (...) {
+            std::lock_guard lk(turn_mtx);
+            if (!error) error = std::current_exception();
+            abort.store(true, std::memory_order_relaxed);
+            turn_cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (size_t t = 1; t < threads; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& th : pool) th.join();
+    if (error) std::rethrow_exception(error);
+
+    for (const auto& c : counters) {
+        result.records_decoded += c.decoded;
+        result.records_matched += c.matched;
+        result.corrupt_units += c.corrupt;
+    }
+    result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    return result;
+}
+
+} // namespace jac::ts_store::inline_v001
@@ -1,7 +1,56 @@
 #pragma once
 
+#include <cstdint>
+
 namespace jac::ts_store::inline_v001 {
 
 enum class PersistMode { All, KeeperOnly, DatabaseOnly };
 
+// Event flag bit PersistMode::KeeperOnly keeps (TsStoreFlags::UserFlag::KeeperRecord).
+inline constexpr uint64_t KEEPER_BIT = 1ULL << 1;
+
+// How hard the persistence path works to make drained events durable (see DoubleBufferedWriter).
+//   None          — no fsync before finalize; the durable watermark tracks hand-off to the sink (page cache)
+//   PeriodicFsync — fsync at most once per DurabilityPolicy::interval
+//   FsyncPerBatch — fsync after every drained batch
+//   GroupCommit   — fsync only when a wait_durable() caller needs it; concurrent waiters share one fsync
+enum class DurabilityLevel { None, PeriodicFsync, FsyncPerBatch, GroupCommit };
+
+// How the binary and jText sinks put bytes into their files (see PipelinedFileWriter.hpp).
+//   Default — the sink's own choice (binary: Mmap, jText: Pwritev); TS_STORE_FILE_OUTPUT overrides it
+//   Mmap    — BinaryEventLog's sliding mapped window (jText treats it as Pwritev)
+//   Pwritev — pipelined buffers written by a dedicated I/O thread with pwritev
+//   IoUring — same pipeline through io_uring (registered buffers, batched SQEs, linked fsync);
+//             falls back to Pwritev when the kernel refuses io_uring
+//   Direct  — BinaryEventLog only: O_DIRECT from aligned, double-buffered blocks (DirectFileWriter.hpp),
+//             bypassing the page cache (jText treats it as Pwritev)
+enum class FileOutputBackend { Default, Mmap, Pwritev, IoUring, Direct };
+
+// Per-block compression of the v2 binary log (see BlockCompression.hpp), done on the writer thread.
+//   Default — TS_STORE_BINARY_COMPRESSION=none|lz|zlib|zstd, else None
+//   Lz      — built-in LZ4-style codec (always available)
+//   Zlib / Zstd — system libraries when found at configure time; otherwise Lz is used
+enum class BinaryCompression { Default, None, Lz, Zlib, Zstd };
+
+// Record layout inside v2 binary log blocks (see CompactRecords.hpp).
+//   Default — TS_STORE_BINARY_ENCODING=raw|compact, else Raw
+//   Raw     — fixed-width v1 records
+//   Compact — ids / timestamps / ints as zigzag varint deltas, doubles XOR-coded against the
+//             previous record, categories / payloads through a per-block string dictionary;
+//             applied before compression
+enum class BinaryRecordEncoding { Default, Raw, Compact };
+
+// Per-block Bloom filters in the v2 binary log footer (see BinaryLogBloom.hpp).
+//   Default  — TS_STORE_BINARY_BLOOM=none|category|tokens, else None
+//   Category — one key per distinct category of the block
+//   Tokens   — categories plus every word of the payloads
+enum class BinaryBloomFilters { Default, None, Category, Tokens };
+
+// How SqlEventSink stores category and payload text.
+//   Default    — TS_STORE_SQL_STRINGS=inline|dictionary, else Inline
+//   Inline     — TEXT columns in the main table
+//   Dictionary — each distinct string once in <base>_strings, integer codes in <base>_events;
+//                a view named <base> joins them back, so queries see the inline layout
+enum class SqlStringStorage { Default, Inline, Dictionary };
+
 } // namespace
@@ -0,0 +1,642 @@
+#pragma once
+
+// PipelinedFileWriter.hpp
+// Encode/IO pipeline for file sinks (jText always, BinaryEventLog when a non-mmap
+// FileOutputBackend is chosen).
+//
+// The sink's worker thread (the encoder) fills one byte buffer while a dedicated I/O thread
+// writes previously filled buffers. Batch N+1 is formatted while batch N is on its way to disk,
+// so CPU time and disk time overlap instead of adding up. The encoder only blocks when every
+// pool buffer is in flight.
+//
+// One PipelinedIo (one thread, one buffer pool) can serve several files — JTextSplitEventLog
+// shares one across its main/_Ints/_Floats outputs. Each I/O round takes every queued job:
+//   Pwritev  — consecutive buffers of one file coalesce into one pwritev; sync = fdatasync
+//   IoUring  — one SQE per buffer (WRITE_FIXED on the registered pool), all submitted with a
+//              single io_uring_enter; a sync request becomes an FSYNC(DATASYNC) linked behind
+//              that file's writes, so a durable batch costs one submission, not write + fsync
+// IoUring falls back to Pwritev when the ring cannot be created; pool registration failures fall
+// back to plain IORING_OP_WRITE.
+//
+// PipelinedOStream wraps a PipelinedFileWriter as a std::ostream so existing ostream-based
+// formatters (JTextWriter, write_file_comment_header) write straight into the pipeline buffers.
+// ostream::flush() hands the current buffer to the I/O thread without waiting; drain()/sync()
+// wait for completion.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <cerrno>
+
+#include "IoUringQueue.hpp"
+#include "PersistCommon.hpp"
+#include "ThreadPlacement.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+// Apply the TS_STORE_FILE_OUTPUT override (mmap | pwritev | io_uring | direct) to a Default request,
+// so existing binaries can be re-run on another backend without code changes.
+inline FileOutputBackend resolve_file_output_backend(FileOutputBackend requested) {
+    if (requested != FileOutputBackend::Default) return requested;
+    const char* env = std::getenv("TS_STORE_FILE_OUTPUT");
+    if (env == nullptr) return requested;
+    const std::string_view v(env);
+    if (v == "mmap")     return FileOutputBackend::Mmap;
+    if (v == "pwritev")  return FileOutputBackend::Pwritev;
+    if (v == "io_uring" || v == "uring") return FileOutputBackend::IoUring;
+    if (v == "direct" || v == "o_direct") return FileOutputBackend::Direct;
+    return requested;
+}
+
+struct PipelinedIoOptions {
+    FileOutputBackend backend = FileOutputBackend::Pwritev;   // Pwritev or IoUring (others mean Pwritev)
+    size_t buffer_bytes = 1 << 20;
+    // Pool shared by every file on this I/O thread (registered with io_uring). The pool grows
+    // past this when encoders hold all buffers, so it never deadlocks; extra buffers are unregistered.
+    size_t buffer_count = 4;
+    // I/O thread CPU set / scheduling; unset = ThreadPlacement::from_env("TS_STORE_IO").
+    std::optional<ThreadPlacement> placement;
+};
+
+struct PipelinedIoStats {
+    size_t rounds = 0;             // I/O thread wake-ups that wrote something
+    size_t submissions = 0;        // pwritev / fdatasync / io_uring_enter calls
+    size_t fixed_writes = 0;       // io_uring writes that used a registered buffer
+    size_t encoder_stalls = 0;     // times an encoder waited for a free pool buffer
+};
+
+class PipelinedFileWriter;
+
+// The I/O stage: one thread and one buffer pool for any number of PipelinedFileWriters.
+class PipelinedIo {
+public:
+    explicit PipelinedIo(PipelinedIoOptions options = {})
+        : buffer_bytes_(options.buffer_bytes)
+    {
+        if (buffer_bytes_ == 0 || options.buffer_count == 0) {
+            throw std::invalid_argument("PipelinedIo: buffer size/count must be > 0");
+        }
+        for (size_t b = 0; b < options.buffer_count; ++b) add_buffer();
+
+        if (options.backend == FileOutputBackend::IoUring) {
+            ring_ = IoUringQueue::try_create(kRingEntries);
+            if (ring_) {
+                std::vector<iovec> iov;
+                iov.reserve(buffers_.size());
+                for (auto& b : buffers_) iov.push_back({b.data.get(), buffer_bytes_});
+                if (ring_->register_buffers(iov)) registered_ = buffers_.size();
+            }
+        }
+        const ThreadPlacement placement = options.placement ? *options.placement
+                                                            : ThreadPlacement::from_env("TS_STORE_IO");
+        thread_ = std::thread([this, placement] {
+            {
+                auto eff = apply_thread_placement(placement);
+                std::lock_guard<std::mutex> lock(mutex_);
+                placement_ = std::move(eff);
+            }
+            worker_loop();
+        });
+    }
+
+    ~PipelinedIo() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        work_cv_.notify_one();
+        if (thread_.joinable()) thread_.join();
+        persist_report(describe_placement("io", placement_) +
+                       (ring_ ? " io_backend=io_uring" : " io_backend=pwritev"));
+    }
+
+    PipelinedIo(const PipelinedIo&) = delete;
+    PipelinedIo& operator=(const PipelinedIo&) = delete;
+
+    // Effective backend after fallback.
+    [[nodiscard]] FileOutputBackend backend() const {
+        return ring_ ? FileOutputBackend::IoUring : FileOutputBackend::Pwritev;
+    }
+    [[nodiscard]] size_t registered_buffers() const { return registered_; }
+    [[nodiscard]] size_t buffer_bytes() const { return buffer_bytes_; }
+
+    [[nodiscard]] PipelinedIoStats stats() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    // Placement granted to the I/O thread (empty until the thread has started).
+    [[nodiscard]] EffectivePlacement effective_placement() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return placement_;
+    }
+
+private:
+    friend class PipelinedFileWriter;
+
+    static constexpr unsigned kRingEntries = 64;
+    static constexpr size_t kSyncJob = static_cast<size_t>(-1);
+
+    struct Buffer {
+        std::unique_ptr<char[]> data;
+        size_t used = 0;
+    };
+
+    struct Job {
+        PipelinedFileWriter* file;
+        size_t buffer;             // pool index, or kSyncJob
+        Buffer* buf;               // resolved under the lock (buffers_ may grow concurrently)
+        uint64_t offset = 0;       // assigned by the I/O thread
+    };
+
+    // Caller holds mutex_ (or is the constructor).
+    size_t add_buffer() {
+        buffers_.push_back({std::make_unique<char[]>(buffer_bytes_), 0});
+        free_.push_back(buffers_.size() - 1);
+        return buffers_.size() - 1;
+    }
+
+    // Encoder side, mutex_ held. Waits while encoders of other files still hold filling buffers
+    // and writes are in flight; grows the pool only when nothing is in flight to wait for.
+    size_t acquire_locked(std::unique_lock<std::mutex>& lock) {
+        if (free_.empty()) {
+            ++stats_.encoder_stalls;
+            done_cv_.wait(lock, [this] { return !free_.empty() || jobs_in_flight_ == 0; });
+            if (free_.empty()) add_buffer();
+        }
+        const size_t b = free_.back();
+        free_.pop_back();
+        buffers_[b].used = 0;
+        return b;
+    }
+
+    void worker_loop();
+    void run_pwritev(std::vector<Job>& round, std::vector<int>& errs);
+    void run_uring(std::vector<Job>& round, std::vector<int>& errs);
+
+    size_t buffer_bytes_;
+    std::deque<Buffer> buffers_;   // deque: growth never moves existing buffers
+    std::unique_ptr<IoUringQueue> ring_;
+    size_t registered_ = 0;        // buffers_[0 .. registered_) are pinned in the ring
+
+    std::mutex mutex_;
+    std::condition_variable work_cv_;   // jobs queued / stop
+    std::condition_variable done_cv_;   // jobs completed
+    std::vector<size_t> free_;
+    std::deque<Job> jobs_;
+    size_t jobs_in_flight_ = 0;    // queued + being written
+    PipelinedIoStats stats_;
+    EffectivePlacement placement_;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+struct PipelinedFileWriterStats {
+    size_t bytes_written = 0;
+    size_t buffers_written = 0;
+    size_t syncs = 0;
+};
+
+class PipelinedFileWriter {
+public:
+    explicit PipelinedFileWriter(std::string_view path, std::shared_ptr<PipelinedIo> io = {})
+        : path_(path),
+          io_(io ? std::move(io) : std::make_shared<PipelinedIo>())
+    {
+        fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            throw std::runtime_error("PipelinedFileWriter: failed to open " + path_);
+        }
+    }
+
+    ~PipelinedFileWriter() {
+        try { close(); } catch (...) {}
+        if (fill_ != kNone) {
+            std::lock_guard<std::mutex> lock(io_->mutex_);
+            io_->free_.push_back(fill_);
+        }
+    }
+
+    PipelinedFileWriter(const PipelinedFileWriter&) = delete;
+    PipelinedFileWriter& operator=(const PipelinedFileWriter&) = delete;
+
+    // ---- Encoder side (one thread per file) ----
+
+    // Unused tail of the buffer being filled; acquires a pool buffer (possibly waiting) if none is held.
+    std::span<char> free_space() {
+        if (fill_ == kNone) {
+            std::unique_lock<std::mutex> lock(io_->mutex_);
+            throw_if_failed();
+            fill_ = io_->acquire_locked(lock);
+            fill_buf_ = &io_->buffers_[fill_];
+        }
+        return {fill_buf_->data.get() + fill_buf_->used, io_->buffer_bytes_ - fill_buf_->used};
+    }
+
+    // Mark n bytes of free_space() as filled.
+    void commit(size_t n) {
+        fill_buf_->used += n;
+        if (fill_buf_->used == io_->buffer_bytes_) hand_off();
+    }
+
+    void write(const void* data, size_t n) {
+        const char* p = static_cast<const char*>(data);
+        while (n > 0) {
+            auto space = free_space();
+            const size_t chunk = n < space.size() ? n : space.size();
+            std::memcpy(space.data(), p, chunk);
+            commit(chunk);
+            p += chunk;
+            n -= chunk;
+        }
+    }
+
+    void write(std::string_view bytes) { write(bytes.data(), bytes.size()); }
+
+    // Queue the filled part of the current buffer for the I/O thread; does not wait.
+    void hand_off() {
+        if (fill_ == kNone || fill_buf_->used == 0) return;
+        enqueue(fill_);
+        fill_ = kNone;
+        fill_buf_ = nullptr;
+    }
+
+    // Hand off and wait until every byte appended so far reached the kernel.
+    void drain() {
+        hand_off();
+        std::unique_lock<std::mutex> lock(io_->mutex_);
+        io_->done_cv_.wait(lock, [this] { return in_flight_ == 0; });
+        throw_if_failed();
+    }
+
+    // Durable up to the last appended byte. The fdatasync runs on the I/O thread
+    // (linked behind the pending writes under io_uring).
+    void sync() {
+        hand_off();
+        enqueue(PipelinedIo::kSyncJob);
+        drain();
+        syncs_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void close() {
+        if (fd_ < 0) return;
+        try {
+            drain();
+        } catch (...) {
+            ::close(fd_);
+            fd_ = -1;
+            throw;
+        }
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    [[nodiscard]] bool is_open() const { return fd_ >= 0; }
+    [[nodiscard]] const std::string& path() const { return path_; }
+    [[nodiscard]] const std::shared_ptr<PipelinedIo>& io() const { return io_; }
+
+    [[nodiscard]] PipelinedFileWriterStats stats() const {
+        PipelinedFileWriterStats s;
+        s.bytes_written   = bytes_written_.load(std::memory_order_relaxed);
+        s.buffers_written = buffers_written_.load(std::memory_order_relaxed);
+        s.syncs           = syncs_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    friend class PipelinedIo;
+
+    static constexpr size_t kNone = static_cast<size_t>(-1);
+
+    void enqueue(size_t buffer) {
+        {
+            std::lock_guard<std::mutex> lock(io_->mutex_);
+            ++in_flight_;
+            ++io_->jobs_in_flight_;
+            io_->jobs_.push_back({this, buffer,
+                                  buffer == PipelinedIo::kSyncJob ? nullptr : &io_->buffers_[buffer]});
+        }
+        io_->work_cv_.notify_one();
+    }
+
+    // Caller holds io_->mutex_.
+    void throw_if_failed() const {
+        if (io_errno_ != 0) {
+            throw std::runtime_error("PipelinedFileWriter: write failed for " + path_ + ": " +
+                                     std::strerror(io_errno_));
+        }
+    }
+
+    std::string path_;
+    std::shared_ptr<PipelinedIo> io_;
+    int fd_ = -1;
+
+    size_t fill_ = kNone;                      // encoder-owned
+    PipelinedIo::Buffer* fill_buf_ = nullptr;  // encoder-owned
+    uint64_t offset_ = 0;                      // I/O-thread-owned: next write position
+
+    // Guarded by io_->mutex_.
+    size_t in_flight_ = 0;
+    int io_errno_ = 0;
+
+    std::atomic<size_t> bytes_written_{0};
+    std::atomic<size_t> buffers_written_{0};
+    std::atomic<size_t> syncs_{0};
+};
+
+inline void PipelinedIo::worker_loop() {
+    std::vector<Job> round;
+    std::vector<int> errs;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        work_cv_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+        if (jobs_.empty()) break;   // stop_ and nothing left
+
+        const size_t take = ring_ ? std::min<size_t>(jobs_.size(), ring_->capacity()) : jobs_.size();
+        round.assign(jobs_.begin(), jobs_.begin() + static_cast<std::ptrdiff_t>(take));
+        jobs_.erase(jobs_.begin(), jobs_.begin() + static_cast<std::ptrdiff_t>(take));
+        lock.unlock();
+
+        // Group by file (stable: per-file order is preserved) and assign file offsets.
+        std::stable_sort(round.begin(), round.end(),
+                         [](const Job& a, const Job& b) { return a.file < b.file; });
+        for (auto& j : round) {
+            if (j.buffer == kSyncJob) continue;
+            j.offset = j.file->offset_;
+            j.file->offset_ += j.buf->used;
+        }
+        errs.assign(round.size(), 0);
+
+        if (ring_) {
+            run_uring(round, errs);
+        } else {
+            run_pwritev(round, errs);
+        }
+
+        lock.lock();
+        ++stats_.rounds;
+        for (size_t k = 0; k < round.size(); ++k) {
+            const Job& j = round[k];
+            if (j.buffer != kSyncJob) {
+                j.file->bytes_written_.fetch_add(j.buf->used, std::memory_order_relaxed);
+                j.file->buffers_written_.fetch_add(1, std::memory_order_relaxed);
+                free_.push_back(j.buffer);
+            }
+            if (errs[k] != 0 && j.file->io_errno_ == 0) j.file->io_errno_ = errs[k];
+            --j.file->in_flight_;
+            --jobs_in_flight_;
+        }
+        done_cv_.notify_all();
+    }
+}
+
+inline void PipelinedIo::run_pwritev(std::vector<Job>& round, std::vector<int>& errs) {
+    constexpr size_t kMaxIov = 64;
+    std::vector<iovec> iov;
+    size_t calls = 0;
+
+    size_t k = 0;
+    while (k < round.size()) {
+        PipelinedFileWriter* file = round[k].file;
+        if (round[k].buffer == kSyncJob) {
+            ++calls;
+            if (::fdatasync(file->fd_) != 0) errs[k] = errno;
+            ++k;
+            continue;
+        }
+
+        // Run of writes for this file (offsets are contiguous by construction).
+        size_t end = k;
+        iov.clear();
+        while (end < round.size() && round[end].file == file && round[end].buffer != kSyncJob &&
+               iov.size() < kMaxIov) {
+            iov.push_back({round[end].buf->data.get(), round[end].buf->used});
+            ++end;
+        }
+
+        uint64_t offset = round[k].offset;
+        size_t first = 0;
+        int err = 0;
+        while (first < iov.size()) {
+            const ssize_t n = ::pwritev(file->fd_, iov.data() + first, static_cast<int>(iov.size() - first),
+                                        static_cast<off_t>(offset));
+            ++calls;
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                err = errno;
+                break;
+            }
+            auto done = static_cast<size_t>(n);
+            offset += done;
+            while (first < iov.size() && done >= iov[first].iov_len) {
+                done -= iov[first].iov_len;
+                ++first;
+            }
+            if (first < iov.size() && done > 0) {   // partial write inside one iovec
+                iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + done;
+                iov[first].iov_len -= done;
+            }
+        }
+        for (size_t j = k; j < end; ++j) errs[j] = err;
+        k = end;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.submissions += calls;
+}
+
+inline void PipelinedIo::run_uring(std::vector<Job>& round, std::vector<int>& errs) {
+    size_t fixed = 0;
+
+    for (size_t k = 0; k < round.size(); ++k) {
+        const Job& j = round[k];
+        io_uring_sqe* sqe = ring_->next_sqe();   // round size <= capacity, never null
+
+        if (j.buffer == kSyncJob) {
+            sqe->opcode = IORING_OP_FSYNC;
+            sqe->fd = j.file->fd_;
+            sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+        } else {
+            const Buffer& b = *j.buf;
+            sqe->fd = j.file->fd_;
+            sqe->addr = reinterpret_cast<uint64_t>(b.data.get());
+            sqe->len = static_cast<uint32_t>(b.used);
+            sqe->off = j.offset;
+            if (j.buffer < registered_) {
+                sqe->opcode = IORING_OP_WRITE_FIXED;
+                sqe->buf_index = static_cast<uint16_t>(j.buffer);
+                ++fixed;
+            } else {
+                sqe->opcode = IORING_OP_WRITE;
+            }
+            // Chain this file's writes in front of its fsync so the fsync covers them.
+            bool sync_follows = false;
+            for (size_t n = k + 1; n < round.size() && round[n].file == j.file; ++n) {
+                if (round[n].buffer == kSyncJob) { sync_follows = true; break; }
+            }
+            if (sync_follows) sqe->flags |= IOSQE_IO_LINK;
+        }
+        sqe->user_data = k;
+    }
+
+    const auto count = static_cast<unsigned>(round.size());
+    unsigned completed = 0;
+    int rc = ring_->submit_and_wait(count);
+    while (rc == 0 && completed < count) {
+        completed += ring_->reap([&](uint64_t k, int res) {
+            const Job& j = round[k];
+            if (res < 0) {
+                errs[k] = -res;
+            } else if (j.buffer != kSyncJob &&
+                       static_cast<size_t>(res) < j.buf->used) {
+                // Short write (rare on regular files): finish the remainder synchronously.
+                const Buffer& b = *j.buf;
+                size_t done = static_cast<size_t>(res);
+                while (done < b.used) {
+                    const ssize_t n = ::pwrite(j.file->fd_, b.data.get() + done, b.used - done,
+                                               static_cast<off_t>(j.offset + done));
+                    if (n < 0) {
+                        if (errno == EINTR) continue;
+                        errs[k] = errno;
+                        break;
+                    }
+                    done += static_cast<size_t>(n);
+                }
+            }
+        });
+        if (completed < count) rc = ring_->submit_and_wait(count - completed);
+    }
+    if (rc != 0) {
+        for (size_t k = 0; k < round.size(); ++k) if (errs[k] == 0) errs[k] = -rc;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.submissions += 1;
+    stats_.fixed_writes += fixed;
+}
+
+// std::streambuf whose put area is the PipelinedFileWriter's current buffer (no extra copy).
+class PipelinedStreamBuf : public std::streambuf {
+public:
+    explicit PipelinedStreamBuf(PipelinedFileWriter& file) : file_(file) {}
+
+    // Publish what the ostream wrote and hand the buffer to the I/O thread.
+    void hand_off() {
+        publish();
+        file_.hand_off();
+    }
+
+protected:
+    int_type overflow(int_type ch) override {
+        hand_off();
+        auto space = file_.free_space();
+        setp(space.data(), space.data() + space.size());
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        std::streamsize left = n;
+        while (left > 0) {
+            if (pptr() == epptr()) overflow(traits_type::eof());
+            const auto room = static_cast<std::streamsize>(epptr() - pptr());
+            const auto chunk = left < room ? left : room;
+            std::memcpy(pptr(), s, static_cast<size_t>(chunk));
+            pbump(static_cast<int>(chunk));
+            s += chunk;
+            left -= chunk;
+        }
+        return n;
+    }
+
+    int sync() override {
+        hand_off();
+        return 0;
+    }
+
+private:
+    void publish() {
+        if (pbase() != nullptr && pptr() > pbase()) {
+            file_.commit(static_cast<size_t>(pptr() - pbase()));
+        }
+        setp(nullptr, nullptr);
+    }
+
+    PipelinedFileWriter& file_;
+};
+
+// ofstream-like front end: open(), is_open(), operator<<, flush() (non-blocking hand-off),
+// plus drain()/sync_file()/close() that wait for the I/O thread.
+class PipelinedOStream : public std::ostream {
+public:
+    PipelinedOStream() : std::ostream(nullptr) {}
+
+    ~PipelinedOStream() override {
+        try { close(); } catch (...) {}
+    }
+
+    void open(std::string_view path, std::shared_ptr<PipelinedIo> io = {}) {
+        close();
+        file_ = std::make_unique<PipelinedFileWriter>(path, std::move(io));
+        buf_ = std::make_unique<PipelinedStreamBuf>(*file_);
+        rdbuf(buf_.get());
+        clear();
+    }
+
+    [[nodiscard]] bool is_open() const { return file_ && file_->is_open(); }
+
+    void drain() {
+        if (!file_) return;
+        buf_->hand_off();
+        file_->drain();
+    }
+
+    void sync_file() {
+        if (!file_) return;
+        buf_->hand_off();
+        file_->sync();
+    }
+
+    void close() {
+        if (!file_) return;
+        buf_->hand_off();
+        file_->close();
+        rdbuf(nullptr);
+        buf_.reset();
+        file_.reset();
+    }
+
+    [[nodiscard]] PipelinedFileWriterStats stats() const {
+        return file_ ? file_->stats() : PipelinedFileWriterStats{};
+    }
+
+private:
+    std::unique_ptr<PipelinedFileWriter> file_;
+    std::unique_ptr<PipelinedStreamBuf> buf_;
+};
+
+} // namespace jac::ts_store::inline_v001
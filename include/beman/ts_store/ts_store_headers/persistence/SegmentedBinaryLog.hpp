@@ -0,0 +1,529 @@
+#pragma once
+
+// SegmentedBinaryLog.hpp
+// Rolling BinaryEventLog: the log is a sequence of bounded segment files plus a small index.
+//
+//   <base>.000001.bin, <base>.000002.bin, ...   each a complete v2 log (own header + blocks)
+//   <base>.segments                             index: one line per segment (tab separated)
+//
+// Rotation is checked at block boundaries (end_block, i.e. after every sink batch), so a segment
+// never splits a block. The writer thread only opens the next segment; finalizing the old one
+// (msync / pipeline drain, truncate), rewriting the index and applying retention run on a
+// background thread. Retention (count / bytes / age over closed segments) deletes the oldest
+// segments, or moves them to archive_dir when set. The index is rewritten through a temp file
+// and rename, so readers always see a complete one. Existing segments of the same base are
+// picked up from the index at startup and numbering continues after them.
+//
+// A segment the background thread fails to finalize stays listed as open (unfinalized, read like
+// a crashed segment); the error is counted in SegmentStats, reported, and rethrown by finalize().
+//
+// SegmentPolicy with no rotation threshold keeps the single-file layout (<base>.bin, no index).
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "BinaryEventLog.hpp"
+#include "PersistCommon.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+struct SegmentPolicy {
+    // Rotation: start a new segment once the current one holds this many bytes / is this old
+    // (0 = no limit). Both zero = one unsegmented <base>.bin.
+    size_t max_segment_bytes = 0;
+    std::chrono::seconds max_segment_age{0};
+    // Retention over closed segments (0 = unlimited); the active segment is never removed.
+    size_t keep_segments = 0;
+    size_t keep_bytes = 0;
+    std::chrono::seconds keep_age{0};
+    // Move expired segments here instead of deleting them (empty = delete).
+    std::string archive_dir;
+
+    [[nodiscard]] bool rotates() const { return max_segment_bytes != 0 || max_segment_age.count() != 0; }
+
+    // TS_STORE_SEGMENT_BYTES / _SEGMENT_SECONDS, TS_STORE_RETAIN_SEGMENTS / _RETAIN_BYTES /
+    // _RETAIN_SECONDS, TS_STORE_SEGMENT_ARCHIVE_DIR.
+    static SegmentPolicy from_env() {
+        SegmentPolicy p;
+        if (const char* v = std::getenv("TS_STORE_SEGMENT_BYTES")) p.max_segment_bytes = std::strtoull(v, nullptr, 10);
+        if (const char* v = std::getenv("TS_STORE_SEGMENT_SECONDS")) p.max_segment_age = std::chrono::seconds(std::strtoll(v, nullptr, 10));
+        if (const char* v = std::getenv("TS_STORE_RETAIN_SEGMENTS")) p.keep_segments = std::strtoull(v, nullptr, 10);
+        if (const char* v = std::getenv("TS_STORE_RETAIN_BYTES")) p.keep_bytes = std::strtoull(v, nullptr, 10);
+        if (const char* v = std::getenv("TS_STORE_RETAIN_SECONDS")) p.keep_age = std::chrono::seconds(std::strtoll(v, nullptr, 10));
+        if (const char* v = std::getenv("TS_STORE_SEGMENT_ARCHIVE_DIR")) p.archive_dir = v;
+        return p;
+    }
+};
+
+enum class SegmentState { Open, Closed, Archived };
+
+// One index line. Ids/timestamps cover the records written to the segment (0 when empty).
+struct SegmentInfo {
+    uint64_t seq = 0;
+    std::string path;
+    SegmentState state = SegmentState::Open;
+    uint64_t first_event_id = 0;
+    uint64_t last_event_id = 0;
+    uint64_t min_timestamp_us = 0;
+    uint64_t max_timestamp_us = 0;
+    size_t records = 0;
+    size_t bytes = 0;
+    uint64_t created_unix_us = 0;
+    uint64_t closed_unix_us = 0;
+};
+
+struct SegmentStats {
+    size_t rotations = 0;
+    size_t removed = 0;
+    size_t archived = 0;
+    size_t removed_bytes = 0;
+    size_t errors = 0;          // background finalize / index / archive failures
+    std::string last_error;
+};
+
+namespace detail {
+    inline uint64_t unix_now_us() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    // 0 when the file is gone or predates the epoch.
+    inline uint64_t file_mtime_unix_us(const std::string& path) {
+        std::error_code ec;
+        const auto t = std::filesystem::last_write_time(path, ec);
+        if (ec) return 0;
+        const auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::file_clock::to_sys(t).time_since_epoch()).count();
+        return us > 0 ? static_cast<uint64_t>(us) : 0;
+    }
+
+    inline std::string_view segment_state_name(SegmentState s) {
+        switch (s) {
+            case SegmentState::Open:     return "open";
+            case SegmentState::Closed:   return "closed";
+            case SegmentState::Archived: return "archived";
+        }
+        return "closed";
+    }
+
+    // BinaryEventLog base name of segment `seq` (the log adds ".bin").
+    inline std::string segment_base_name(std::string_view base_name, uint64_t seq) {
+        return std::format("{}.{:06}", base_name, seq);
+    }
+}
+
+inline std::string segment_index_path(std::string_view base_name) {
+    return std::string(base_name) + ".segments";
+}
+
+// Parse a <base>.segments file; missing file = no segments. Lines starting with // are comments.
+inline std::vector<SegmentInfo> read_segment_index(const std::string& index_path) {
+    std::vector<SegmentInfo> out;
+    std::ifstream in(index_path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line.starts_with("//") || line.starts_with("seq\t")) continue;
+        std::istringstream fields(line);
+        SegmentInfo s;
+        std::string state;
+        if (!(fields >> s.seq >> s.path >> state >> s.first_event_id >> s.last_event_id
+                     >> s.min_timestamp_us >> s.max_timestamp_us >> s.records >> s.bytes
+                     >> s.created_unix_us >> s.closed_unix_us)) {
+            throw std::runtime_error("read_segment_index: malformed line in " + index_path);
+        }
+        s.state = state == "open" ? SegmentState::Open
+                : state == "archived" ? SegmentState::Archived : SegmentState::Closed;
+        out.push_back(std::move(s));
+    }
+    return out;
+}
+
+class SegmentedBinaryLog {
+public:
+    SegmentedBinaryLog(std::string_view base_name,
+                       size_t int_count,
+                       size_t dbl_count,
+                       PersistMode mode = PersistMode::All,
+                       size_t internal_buffer_size = 64 * 1024 * 1024,
+                       FileOutputBackend output = FileOutputBackend::Default,
+                       BinaryCompression compression = BinaryCompression::Default,
+                       std::optional<SegmentPolicy> policy = std::nullopt)
+        : base_name_(base_name),
+          int_count_(int_count),
+          dbl_count_(dbl_count),
+          mode_(mode),
+          buffer_size_(internal_buffer_size),
+          output_(output),
+          compression_(compression),
+          policy_(policy ? *policy : SegmentPolicy::from_env())
+    {
+        if (!policy_.rotates()) {
+            active_ = make_log(base_name_);
+            return;
+        }
+        index_path_ = segment_index_path(base_name_);
+        segments_ = read_segment_index(index_path_);
+        for (auto& s : segments_) {
+            if (s.state == SegmentState::Open) {   // left open by a crash: treat as closed
+                s.state = SegmentState::Closed;
+                std::error_code ec;
+                const auto sz = std::filesystem::file_size(s.path, ec);
+                if (!ec) s.bytes = static_cast<size_t>(sz);
+                // Its last write stands in for the close time, so age retention does not expire it
+                // on the spot.
+                s.closed_unix_us = detail::file_mtime_unix_us(s.path);
+                if (s.closed_unix_us == 0) s.closed_unix_us = s.created_unix_us;
+            }
+        }
+        const uint64_t next_seq = segments_.empty() ? 1 : segments_.back().seq + 1;
+        open_segment(next_seq);
+        {
+            std::lock_guard lk(mtx_);
+            write_index();
+            index_dirty_ = false;
+        }
+        janitor_ = std::thread([this] { janitor_loop(); });
+    }
+
+    ~SegmentedBinaryLog() {
+        try { finalize(); } catch (...) {}
+    }
+
+    SegmentedBinaryLog(const SegmentedBinaryLog&) = delete;
+    SegmentedBinaryLog& operator=(const SegmentedBinaryLog&) = delete;
+
+    void append_event(size_t event_id,
+                      size_t thread_id,
+                      size_t per_thread_event_id,
+                      uint64_t raw_flags,
+                      std::string_view category,
+                      std::string_view payload,
+                      uint64_t timestamp_us,
+                      const std::vector<int64_t>& ints,
+                      const std::vector<double>& dbls)
+    {
+        const size_t before = active_->stats().rows_written;
+        active_->append_event(event_id, thread_id, per_thread_event_id, raw_flags, category, payload,
+                              timestamp_us, ints, dbls);
+        if (!policy_.rotates() || active_->stats().rows_written == before) return;   // filtered by mode
+
+        if (cur_.records == 0) {
+            cur_.first_event_id = event_id;
+            cur_.min_timestamp_us = cur_.max_timestamp_us = timestamp_us;
+        }
+        ++cur_.records;
+        cur_.last_event_id = event_id;
+        cur_.min_timestamp_us = std::min(cur_.min_timestamp_us, timestamp_us);
+        cur_.max_timestamp_us = std::max(cur_.max_timestamp_us, timestamp_us);
+    }
+
+    // Close the open block, then rotate if the active segment crossed a threshold.
+    void end_block() {
+        active_->end_block();
+        if (!policy_.rotates() || cur_.records == 0) return;
+        const bool too_big = policy_.max_segment_bytes != 0 &&
+                             active_->bytes_on_disk() >= policy_.max_segment_bytes;
+        const bool too_old = policy_.max_segment_age.count() != 0 &&
+                             std::chrono::steady_clock::now() - opened_at_ >= policy_.max_segment_age;
+        if (too_big || too_old) rotate();
+    }
+
+    // Start a new segment now (no-op when the active one is empty or rotation is off).
+    void rotate() {
+        if (!policy_.rotates() || cur_.records == 0) return;
+        active_->end_block();
+        std::unique_ptr<BinaryEventLog> old = std::move(active_);
+        SegmentInfo info = cur_;
+        open_segment(info.seq + 1);   // the writer only pays for opening the next file
+        {
+            std::lock_guard lk(mtx_);
+            retiring_.push_back({std::move(old), std::move(info)});
+            ++stats_.rotations;
+        }
+        cv_.notify_one();
+    }
+
+    void flush() { active_->flush(); }
+    void sync()  { active_->sync(); }
+
+    void finalize() {
+        if (finalized_) return;
+        finalized_ = true;
+        if (!policy_.rotates()) {
+            active_->finalize();
+            return;
+        }
+        {
+            std::lock_guard lk(mtx_);
+            stopping_ = true;
+        }
+        cv_.notify_one();
+        if (janitor_.joinable()) janitor_.join();
+
+        active_->finalize();
+        cur_.bytes = file_bytes(cur_.path);
+        cur_.state = SegmentState::Closed;
+        cur_.closed_unix_us = detail::unix_now_us();
+        std::lock_guard lk(mtx_);
+        close_in_index(cur_);
+        if (cur_.records == 0) remove_entry(cur_.seq);   // nothing written since the last rotation
+        apply_retention();
+        write_index();
+        persist_report("segments=" + std::to_string(segments_.size()) +
+                       " segment_rotations=" + std::to_string(stats_.rotations) +
+                       " segments_removed=" + std::to_string(stats_.removed) +
+                       " segments_archived=" + std::to_string(stats_.archived) +
+                       " segment_bytes_removed=" + std::to_string(stats_.removed_bytes) +
+                       " segment_errors=" + std::to_string(stats_.errors));
+        if (janitor_error_) std::rethrow_exception(janitor_error_);   // first background failure
+    }
+
+    // Snapshot of the index (closed, archived and the active segment).
+    [[nodiscard]] std::vector<SegmentInfo> segments() const {
+        std::lock_guard lk(mtx_);
+        return segments_;
+    }
+    [[nodiscard]] SegmentStats segment_stats() const {
+        std::lock_guard lk(mtx_);
+        return stats_;
+    }
+    [[nodiscard]] const SegmentPolicy& policy() const { return policy_; }
+    [[nodiscard]] const std::string& index_path() const { return index_path_; }
+    // Path of the file currently written.
+    [[nodiscard]] const std::string& file_path() const { return active_->file_path(); }
+    [[nodiscard]] const BinaryEventLog& active() const { return *active_; }
+
+private:
+    struct Retiring {
+        std::unique_ptr<BinaryEventLog> log;
+        SegmentInfo info;
+    };
+
+    std::unique_ptr<BinaryEventLog> make_log(const std::string& base) const {
+        return std::make_unique<BinaryEventLog>(base, int_count_, dbl_count_, mode_, buffer_size_,
+                                                output_, compression_);
+    }
+
+    // Writer thread: open segment `seq` and list it in the index as open.
+    void open_segment(uint64_t seq) {
+        active_ = make_log(detail::segment_base_name(base_name_, seq));
+        opened_at_ = std::chrono::steady_clock::now();
+        cur_ = SegmentInfo{};
+        cur_.seq = seq;
+        cur_.path = active_->file_path();
+        cur_.created_unix_us = detail::unix_now_us();
+        std::lock_guard lk(mtx_);
+        segments_.push_back(cur_);
+        index_dirty_ = true;
+    }
+
+    void janitor_loop() {
+        std::unique_lock lk(mtx_);
+        for (;;) {
+            cv_.wait(lk, [this] { return stopping_ || !retiring_.empty(); });
+            if (!retiring_.empty()) {
+                Retiring r = std::move(retiring_.front());
+                retiring_.pop_front();
+                lk.unlock();
+                std::exception_ptr failed;
+                try {
+                    r.log->finalize();   // msync / drain + truncate, off the writer thread
+                } catch (...) {
+                    failed = std::current_exception();
+                }
+                r.log.reset();
+                r.info.bytes = file_bytes(r.info.path);
+                if (!failed) {
+                    r.info.state = SegmentState::Closed;
+                    r.info.closed_unix_us = detail::unix_now_us();
+                }
+                lk.lock();
+                if (failed) note_error(failed, "finalize " + r.info.path);
+                close_in_index(r.info);   // a failed one stays open: unfinalized, out of retention
+                apply_retention();
+                index_dirty_ = true;
+            }
+            if (index_dirty_) {
+                try {
+                    write_index();
+                } catch (...) {
+                    note_error(std::current_exception(), "index");
+                }
+                index_dirty_ = false;
+            }
+            if (stopping_ && retiring_.empty()) return;
+        }
+    }
+
+    // mtx_ held. Janitor failures must not escape the thread (std::terminate); keep the first
+    // for finalize() and report each one.
+    void note_error(std::exception_ptr e, std::string_view what) {
+        std::string msg;
+        try {
+            std::rethrow_exception(e);
+        } catch (const std::exception& ex) {
+            msg = ex.what();
+        } catch (...) {
+            msg = "unknown error";
+        }
+        ++stats_.errors;
+        stats_.last_error = std::string(what) + ": " + msg;
+        if (!janitor_error_) janitor_error_ = e;
+        persist_report("segment_error=\"" + stats_.last_error + '"');
+    }
+
+    static size_t file_bytes(const std::string& path) {
+        std::error_code ec;
+        const auto sz = std::filesystem::file_size(path, ec);
+        return ec ? 0 : static_cast<size_t>(sz);
+    }
+
+    // mtx_ held.
+    void close_in_index(const SegmentInfo& info) {
+        for (auto& s : segments_) {
+            if (s.seq == info.seq) {
+                s = info;
+                return;
+            }
+        }
+    }
+
+    void remove_entry(uint64_t seq) {
+        std::error_code ec;
+        for (auto it = segments_.begin(); it != segments_.end(); ++it) {
+            if (it->seq == seq) {
+                std::filesystem::remove(it->path, ec);
+                segments_.erase(it);
+                return;
+            }
+        }
+    }
+
+    // mtx_ held. Drop (or archive) the oldest closed segments until every limit holds.
+    void apply_retention() {
+        if (policy_.keep_segments == 0 && policy_.keep_bytes == 0 && policy_.keep_age.count() == 0) return;
+        const uint64_t now = detail::unix_now_us();
+        const auto max_age_us = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(policy_.keep_age).count());
+        for (;;) {
+            size_t count = 0, bytes = 0;
+            SegmentInfo* oldest = nullptr;
+            for (auto& s : segments_) {
+                if (s.state != SegmentState::Closed) continue;
+                ++count;
+                bytes += s.bytes;
+                if (oldest == nullptr) oldest = &s;
+            }
+            if (oldest == nullptr) return;
+            const bool over = (policy_.keep_segments != 0 && count > policy_.keep_segments) ||
+                              (policy_.keep_bytes != 0 && bytes > policy_.keep_bytes) ||
+                              (max_age_us != 0 && oldest->closed_unix_us != 0 &&   // 0: close time unknown
+                               now > oldest->closed_unix_us + max_age_us);
+            if (!over || !expire(*oldest)) return;
+        }
+    }
+
+    // False when the segment could not be moved (it stays in place and retention stops).
+    bool expire(SegmentInfo& s) {
+        std::error_code ec;
+        if (!policy_.archive_dir.empty()) {
+            std::filesystem::create_directories(policy_.archive_dir, ec);
+            const auto dest = std::filesystem::path(policy_.archive_dir) / std::filesystem::path(s.path).filename();
+            std::filesystem::rename(s.path, dest, ec);
+            if (ec) {   // different filesystem
+                std::filesystem::copy_file(s.path, dest, std::filesystem::copy_options::overwrite_existing, ec);
+                if (ec) {
+                    // Neither moved nor copied: the segment stays where it is, listed as closed.
+                    std::error_code ignored;
+                    std::filesystem::remove(dest, ignored);   // partial copy
+                    note_error(std::make_exception_ptr(std::runtime_error(
+                                   "SegmentedBinaryLog: cannot archive to " + dest.string() + ": " + ec.message())),
+                               "archive " + s.path);
+                    return false;
+                }
+                std::filesystem::remove(s.path, ec);   // a leftover source only costs disk space
+            }
+            s.path = dest.string();
+            s.state = SegmentState::Archived;
+            ++stats_.archived;
+            return true;
+        }
+        std::filesystem::remove(s.path, ec);
+        stats_.removed_bytes += s.bytes;
+        ++stats_.removed;
+        const uint64_t seq = s.seq;
+        segments_.erase(std::remove_if(segments_.begin(), segments_.end(),
+                                       [seq](const SegmentInfo& x) { return x.seq == seq; }),
+                        segments_.end());
+        return true;
+    }
+
+    // mtx_ held. Write <base>.segments.tmp, then rename over the index.
+    void write_index() const {
+        const std::string tmp = index_path_ + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::trunc);
+            if (!out) throw std::runtime_error("SegmentedBinaryLog: failed to write " + tmp);
+            out << detail::binary_file_header(index_path_, "Binary Log Segment Index");
+            out << "seq\tfile\tstate\tfirst_event_id\tlast_event_id\tmin_timestamp_us\tmax_timestamp_us"
+                   "\trecords\tbytes\tcreated_unix_us\tclosed_unix_us\n";
+            for (const auto& s : segments_) {
+                out << s.seq << '\t' << s.path << '\t' << detail::segment_state_name(s.state) << '\t'
+                    << s.first_event_id << '\t' << s.last_event_id << '\t'
+                    << s.min_timestamp_us << '\t' << s.max_timestamp_us << '\t'
+                    << s.records << '\t' << s.bytes << '\t'
+                    << s.created_unix_us << '\t' << s.closed_unix_us << '\n';
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp, index_path_, ec);
+        if (ec) throw std::runtime_error("SegmentedBinaryLog: failed to replace " + index_path_);
+    }
+
+    std::string base_name_;
+    size_t int_count_;
+    size_t dbl_count_;
+    PersistMode mode_;
+    size_t buffer_size_;
+    FileOutputBackend output_;
+    BinaryCompression compression_;
+    SegmentPolicy policy_;
+    std::string index_path_;
+    bool finalized_ = false;
+
+    // Writer thread only.
+    std::unique_ptr<BinaryEventLog> active_;
+    SegmentInfo cur_;
+    std::chrono::steady_clock::time_point opened_at_{};
+
+    // Shared with the janitor (mtx_).
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    std::deque<Retiring> retiring_;
+    std::vector<SegmentInfo> segments_;
+    SegmentStats stats_;
+    bool index_dirty_ = false;
+    bool stopping_ = false;
+    std::exception_ptr janitor_error_;
+    std::thread janitor_;
+};
+
+} // namespace jac::ts_store::inline_v001
@@ -0,0 +1,182 @@
+#pragma once
+
+// ShardedWriter.hpp
+// K independent DoubleBufferedWriters, each with its own sink instance and output files.
+// Events are routed by thread_id % K, so one producer thread always lands in the same shard and
+// its per-thread order is preserved inside that shard's file. One worker per shard removes the
+// single-drain-thread ceiling when the sink (encode + I/O) is the bottleneck.
+//
+// Shard outputs are named <base>_shardNNN by the factory; a small <base>.shards manifest ties
+// them together (written at start, rewritten with final counts at finalize). All shards share one
+// DurableWatermark, so wait_durable(id) / durable_watermark() keep their global meaning.
+
+#include "DoubleBufferedWriter.hpp"
+#include "DurableWatermark.hpp"
+#include "EventSink.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace jac::ts_store::inline_v001 {
+
+// Builds the sink for one shard. shard_base is "<base>_shardNNN"; use it as the sink's base name.
+using ShardSinkFactory = std::function<std::unique_ptr<IEventSink>(size_t shard, std::string_view shard_base)>;
+
+class ShardedPersistenceWriter {
+public:
+    ShardedPersistenceWriter(std::string_view base_name,
+                             size_t shard_count,
+                             const ShardSinkFactory& factory,
+                             size_t batch_size = 10'000,
+                             DoubleBufferedWriterOptions options = {})
+        : base_name_(base_name),
+          durability_(options.durability)
+    {
+        if (shard_count == 0) {
+            throw std::invalid_argument("ShardedPersistenceWriter: shard_count must be > 0");
+        }
+        if (!factory) {
+            throw std::invalid_argument("ShardedPersistenceWriter: sink factory is empty");
+        }
+
+        if (!options.watermark) {
+            options.watermark = std::make_shared<DurableWatermark>(options.first_event_id);
+        }
+        watermark_ = options.watermark;
+
+        shards_.reserve(shard_count);
+        for (size_t s = 0; s < shard_count; ++s) {
+            Shard shard;
+            shard.base = shard_base_name(base_name_, s);
+            auto sink = factory(s, shard.base);
+            if (!sink) {
+                throw std::runtime_error("ShardedPersistenceWriter: factory returned null sink for " + shard.base);
+            }
+            shard.sink_name = std::string(sink->name());
+            shard.writer = std::make_unique<DoubleBufferedWriter>(std::move(sink), batch_size, options);
+            shard.submitted = std::make_unique<std::atomic<size_t>>(0);
+            shards_.push_back(std::move(shard));
+        }
+
+        write_manifest(false);
+    }
+
+    ~ShardedPersistenceWriter() {
+        stop();
+    }
+
+    ShardedPersistenceWriter(const ShardedPersistenceWriter&) = delete;
+    ShardedPersistenceWriter& operator=(const ShardedPersistenceWriter&) = delete;
+
+    static std::string shard_base_name(std::string_view base_name, size_t shard) {
+        return std::format("{}_shard{:03}", base_name, shard);
+    }
+
+    [[nodiscard]] size_t shard_for(size_t thread_id) const { return thread_id % shards_.size(); }
+
+    // Hot path. Thread-safe; contention is limited to producers that share a shard.
+    void submit_event(PersistedEvent&& event) {
+        auto& shard = shards_[shard_for(event.thread_id)];
+        shard.submitted->fetch_add(1, std::memory_order_relaxed);
+        shard.writer->submit_event(std::move(event));
+    }
+
+    void flush() {
+        for (auto& s : shards_) s.writer->flush();
+    }
+
+    void finalize() {
+        stop();
+    }
+
+    [[nodiscard]] bool is_durable(size_t event_id) const { return watermark_->is_durable(event_id); }
+    [[nodiscard]] size_t durable_watermark() const { return watermark_->value(); }
+
+    // The owning shard of an id is not known from the id alone, so every shard is nudged.
+    bool wait_durable(size_t event_id) {
+        return watermark_->wait_until(event_id, std::chrono::steady_clock::time_point::max(),
+                                      [this] { request_durable(); });
+    }
+
+    template <typename Rep, typename Period>
+    bool wait_durable_for(size_t event_id, std::chrono::duration<Rep, Period> timeout) {
+        return watermark_->wait_until(event_id, std::chrono::steady_clock::now() + timeout,
+                                      [this] { request_durable(); });
+    }
+
+    [[nodiscard]] const std::shared_ptr<DurableWatermark>& watermark() const { return watermark_; }
+
+    [[nodiscard]] size_t shard_count() const { return shards_.size(); }
+    [[nodiscard]] const std::string& manifest_path() const { return manifest_path_; }
+    [[nodiscard]] const DurabilityPolicy& durability() const { return durability_; }
+
+    [[nodiscard]] size_t sync_count() const {
+        size_t n = 0;
+        for (const auto& s : shards_) n += s.writer->sync_count();
+        return n;
+    }
+
+private:
+    struct Shard {
+        std::string base;
+        std::string sink_name;
+        std::unique_ptr<DoubleBufferedWriter> writer;
+        std::unique_ptr<std::atomic<size_t>> submitted;
+    };
+
+    void request_durable() {
+        for (auto& s : shards_) s.writer->request_durable();
+    }
+
+    void stop() {
+        if (stopped_.exchange(true)) return;
+        for (auto& s : shards_) s.writer->finalize();
+        write_manifest(true);
+    }
+
+    void write_manifest(bool final) {
+        manifest_path_ = base_name_ + ".shards";
+        std::ofstream out(manifest_path_, std::ios::trunc);
+        if (!out) {
+            if (final) return;   // reached from the destructor; the shard files themselves are complete
+            throw std::runtime_error("ShardedPersistenceWriter: failed to open " + manifest_path_);
+        }
+
+        auto now = std::chrono::system_clock::now();
+        auto today = std::chrono::floor<std::chrono::days>(now);
+        out << std::format("//File:    {}\n", manifest_path_);
+        out << std::format("//Date:    {:%Y-%m-%d}\n", today);
+        out << "//Purpose: Shard Manifest (events routed by thread_id % shard_count)\n";
+        out << "//\n";
+        out << std::format("base={}\n", base_name_);
+        out << std::format("shard_count={}\n", shards_.size());
+        out << std::format("state={}\n", final ? "final" : "open");
+        for (size_t s = 0; s < shards_.size(); ++s) {
+            const auto& shard = shards_[s];
+            out << std::format("shard={} base={} sink={} events={}\n",
+                               s, shard.base, shard.sink_name,
+                               shard.submitted->load(std::memory_order_relaxed));
+        }
+        if (final) {
+            out << std::format("durable_watermark={}\n", watermark_->value());
+        }
+    }
+
+    std::string base_name_;
+    std::string manifest_path_;
+    DurabilityPolicy durability_;
+    std::shared_ptr<DurableWatermark> watermark_;
+    std::vector<Shard> shards_;
+    std::atomic<bool> stopped_{false};
+};
+
+} // namespace jac::ts_store::inline_v001
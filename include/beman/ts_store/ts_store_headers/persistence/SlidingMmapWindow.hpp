@@ -0,0 +1,230 @@
+#pragma once
+
+// SlidingMmapWindow.hpp
+// Fixed-size write window over a growing file, used by BinaryEventLog's mmap output path.
+//
+// Windows sit on a grid with half-window stride: window k maps [k*S, k*S + W), S = W / 2. The
+// writer asks for a range [keep_from, end) — the open block plus the record being added — and
+// when end passes the window, moves to window k+1. As long as a range is at most S long it
+// always fits the next window. The window size is then independent of the file size, and each
+// move costs the same.
+//
+// A helper thread keeps the move off the writer's critical path:
+//   prepare — fallocate the file up to the end of window k+1 (extents are reserved ahead of use,
+//             never sparse), map it and prefault it for writing (MADV_POPULATE_WRITE, or
+//             MAP_POPULATE on older kernels); this starts as soon as the writer enters window k
+//   retire  — after a move, msync(MS_SYNC) the part of window k-1 that is final, MADV_DONTNEED it
+//             and unmap it, so mapped memory stays at about two windows
+// The writer waits only when the next window is not ready yet (SlidingMmapWindowStats::stalls).
+//
+// sync() of the owner still fdatasyncs the whole file; pages dirtied through retired windows are
+// in the page cache either way.
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace jac::ts_store::inline_v001 {
+
+struct SlidingMmapWindowStats {
+    size_t slides = 0;          // window moves
+    size_t stalls = 0;          // moves that had to wait for the helper
+    size_t prefaulted = 0;      // windows prepared in the background
+    size_t retired = 0;         // windows synced and released
+    uint64_t allocated_bytes = 0;   // file length reserved with fallocate
+};
+
+class SlidingMmapWindow {
+public:
+    // min_span: longest [keep_from, end) the writer will ask for; the window is at least twice that.
+    SlidingMmapWindow(int fd, size_t window_bytes, size_t min_span)
+        : fd_(fd)
+    {
+        const auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        size_t w = std::max(window_bytes, 2 * min_span);
+        w = (w + 2 * page - 1) / (2 * page) * (2 * page);   // stride stays page-aligned
+        window_ = w;
+        stride_ = w / 2;
+
+        cur_ = map_window(0, false);
+        next_index_ = 1;
+        helper_ = std::thread([this] { run(); });
+        request_prepare(1);
+    }
+
+    SlidingMmapWindow(const SlidingMmapWindow&) = delete;
+    SlidingMmapWindow& operator=(const SlidingMmapWindow&) = delete;
+
+    ~SlidingMmapWindow() {
+        close(0);
+    }
+
+    // Pointer to file offset `off`; valid for the current window only.
+    [[nodiscard]] char* at(size_t off) const { return cur_ + (off - cur_off_); }
+
+    // Make [keep_from, end) writable through at(). Only moves forward.
+    void ensure(size_t keep_from, size_t end) {
+        while (end > cur_off_ + window_) {
+            const size_t next_off = cur_off_ + stride_;
+            if (keep_from < next_off || end - keep_from > stride_) {
+                throw std::runtime_error("SlidingMmapWindow: range of " + std::to_string(end - keep_from) +
+                                         " bytes does not fit a " + std::to_string(window_) + "-byte window");
+            }
+            slide();
+        }
+    }
+
+    // msync the written part [current window start, end) of the current window.
+    void flush(size_t end, bool wait) {
+        if (cur_ == nullptr || end <= cur_off_) return;
+        ::msync(cur_, std::min(end, cur_off_ + window_) - cur_off_, wait ? MS_SYNC : MS_ASYNC);
+    }
+
+    // Sync and unmap everything and stop the helper. Called before the owner truncates the file.
+    void close(size_t end) {
+        if (cur_ == nullptr) return;
+        flush(end, true);
+        {
+            std::lock_guard lk(mtx_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        if (helper_.joinable()) helper_.join();
+        if (ready_ != nullptr) ::munmap(ready_, window_);
+        ::munmap(cur_, window_);
+        cur_ = ready_ = nullptr;
+    }
+
+    [[nodiscard]] size_t window_bytes() const { return window_; }
+    [[nodiscard]] SlidingMmapWindowStats stats() const {
+        std::lock_guard lk(mtx_);
+        return stats_;
+    }
+
+private:
+    // fallocate up to the window's end, map it, optionally prefault it for writing.
+    char* map_window(size_t off, bool prefault) {
+        const uint64_t want = off + window_;
+        if (want > allocated_) {   // helper or constructor only, never both at once
+            const int rc = ::posix_fallocate(fd_, static_cast<off_t>(allocated_), static_cast<off_t>(want - allocated_));
+            if (rc != 0 && ::ftruncate(fd_, static_cast<off_t>(want)) != 0) {   // no fallocate: sparse
+                throw std::runtime_error("SlidingMmapWindow: cannot extend file");
+            }
+            allocated_ = want;
+        }
+        int flags = MAP_SHARED;
+#if !defined(MADV_POPULATE_WRITE)
+        if (prefault) flags |= MAP_POPULATE;
+#endif
+        void* p = ::mmap(nullptr, window_, PROT_READ | PROT_WRITE, flags, fd_, static_cast<off_t>(off));
+        if (p == MAP_FAILED) {
+            throw std::runtime_error("SlidingMmapWindow: mmap failed");
+        }
+#if defined(MADV_POPULATE_WRITE)
+        if (prefault) ::madvise(p, window_, MADV_POPULATE_WRITE);   // EINVAL on old kernels: just faults later
+#endif
+        return static_cast<char*>(p);
+    }
+
+    void request_prepare(size_t index) {
+        {
+            std::lock_guard lk(mtx_);
+            prepare_index_ = index;
+        }
+        cv_.notify_all();
+    }
+
+    void slide() {
+        char* old = cur_;
+        {
+            std::unique_lock lk(mtx_);
+            if (ready_ == nullptr) {
+                ++stats_.stalls;
+                cv_.wait(lk, [&] { return ready_ != nullptr || error_; });
+                if (error_) throw std::runtime_error("SlidingMmapWindow: " + error_text_);
+            }
+            cur_ = ready_;
+            ready_ = nullptr;
+            cur_off_ = next_index_ * stride_;
+            ++next_index_;
+            ++stats_.slides;
+            retire_.push_back(old);
+            prepare_index_ = next_index_;
+        }
+        cv_.notify_all();
+    }
+
+    void run() {
+        std::unique_lock lk(mtx_);
+        for (;;) {
+            const auto want_prepare = [&] { return !stop_ && !error_ && ready_ == nullptr && prepare_index_ != 0; };
+            cv_.wait(lk, [&] { return stop_ || want_prepare() || !retire_.empty(); });
+            if (want_prepare()) {   // latency-critical first
+                const size_t off = prepare_index_ * stride_;
+                prepare_index_ = 0;
+                lk.unlock();
+                char* p = nullptr;
+                std::string err;
+                try {
+                    p = map_window(off, true);
+                } catch (const std::exception& e) {
+                    err = e.what();
+                }
+                lk.lock();
+                if (p != nullptr) {
+                    ready_ = p;
+                    ++stats_.prefaulted;
+                } else {
+                    error_ = true;
+                    error_text_ = err;
+                }
+                stats_.allocated_bytes = allocated_;
+                cv_.notify_all();
+                continue;
+            }
+            if (!retire_.empty()) {
+                char* const base = retire_.front();
+                retire_.pop_front();
+                lk.unlock();
+                ::msync(base, stride_, MS_SYNC);   // [off, off + S) is final once the writer moved on
+                ::madvise(base, window_, MADV_DONTNEED);
+                ::munmap(base, window_);
+                lk.lock();
+                ++stats_.retired;
+                continue;
+            }
+            if (stop_) return;
+        }
+    }
+
+    int fd_;
+    size_t window_ = 0;
+    size_t stride_ = 0;
+    char* cur_ = nullptr;           // current window (writer thread)
+    size_t cur_off_ = 0;
+    size_t next_index_ = 0;         // grid index of the window after cur_
+    uint64_t allocated_ = 0;
+
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    char* ready_ = nullptr;         // prepared window next_index_
+    size_t prepare_index_ = 0;      // 0 = nothing to prepare
+    std::deque<char*> retire_;   // windows the writer left
+    bool stop_ = false;
+    bool error_ = false;
+    std::string error_text_;
+    SlidingMmapWindowStats stats_;
+    std::thread helper_;
+};
+
+} // namespace jac::ts_store::inline_v001
@@ -1,5 +1,6 @@
 #include "SqlEventSink.hpp"
 
+#include <cstdlib>
 #include <filesystem>
 #include <sstream>
 #include <iomanip>
@@ -10,14 +11,25 @@ namespace jac::ts_store::inline_v001 {
 static constexpr uint64_t KEEPER_MASK    = 1ULL << 1;
 static constexpr uint64_t DATABASE_MASK = 1ULL << 2;
 
+// SqlStringStorage::Default -> TS_STORE_SQL_STRINGS (inline|dictionary), else Inline.
+static bool resolve_sql_dictionary(SqlStringStorage requested) {
+    if (requested == SqlStringStorage::Default) {
+        const char* env = std::getenv("TS_STORE_SQL_STRINGS");
+        return env != nullptr && std::string_view(env) == "dictionary";
+    }
+    return requested == SqlStringStorage::Dictionary;
+}
+
 SqlEventSink::SqlEventSink(std::string_view base_name,
                            size_t int_count,
                            size_t dbl_count,
                            PersistMode mode,
-                           bool write_debug_sql)
+                           bool write_debug_sql,
+                           SqlStringStorage strings)
     : int_count_(int_count)
     , dbl_count_(dbl_count)
     , mode_(mode)
+    , dictionary_(resolve_sql_dictionary(strings))
 {
     table_base_ = fs::path(std::string(base_name)).filename().string();
     if (table_base_.empty()) table_base_ = "persist";
@@ -50,8 +62,21 @@ SqlEventSink::~SqlEventSink() {
 }
 
 void SqlEventSink::ensure_tables_and_prepare() {
-    // Main table
     {
+        // A database from an earlier run keeps its layout: <base> is a table (inline) or a view.
+        Sqlite::Statement existing(*db_, "SELECT type FROM sqlite_master WHERE name = ?;");
+        existing.bind(table_base_);
+        if (existing.step()) {
+            std::string type;
+            existing.get(type);
+            dictionary_ = type == "view";
+        }
+    }
+
+    // Main table
+    if (dictionary_) {
+        prepare_dictionary();
+    } else {
         std::ostringstream oss;
         oss << "CREATE TABLE IF NOT EXISTS " << table_base_ << " (\n"
             << "    id BIGINT PRIMARY KEY,\n"
@@ -100,7 +125,7 @@ void SqlEventSink::ensure_tables_and_prepare() {
     }
 
     // Prepare INSERT statements (use OR IGNORE for tolerance)
-    {
+    if (!dictionary_) {
         std::ostringstream oss;
         oss << "INSERT OR IGNORE INTO " << table_base_
             << " (id, thread_id, per_thread_event_id, flags_raw, category, payload, timestamp_us) "
@@ -129,39 +154,143 @@ void SqlEventSink::ensure_tables_and_prepare() {
     }
 }
 
+void SqlEventSink::prepare_dictionary() {
+    const std::string strings = table_base_ + "_strings";
+    const std::string events = table_base_ + "_events";
+    {
+        std::ostringstream oss;
+        oss << "CREATE TABLE IF NOT EXISTS " << strings << " (\n"
+            << "    id INTEGER PRIMARY KEY,\n"
+            << "    value TEXT NOT NULL\n"
+            << ");\n";
+        db_->exec(oss.str());
+    }
+    {
+        std::ostringstream oss;
+        oss << "CREATE TABLE IF NOT EXISTS " << events << " (\n"
+            << "    id BIGINT PRIMARY KEY,\n"
+            << "    thread_id BIGINT,\n"
+            << "    per_thread_event_id BIGINT,\n"
+            << "    flags_raw BIGINT,\n"
+            << "    category_id INTEGER REFERENCES " << strings << "(id),\n"
+            << "    category TEXT,\n"
+            << "    payload_id INTEGER REFERENCES " << strings << "(id),\n"
+            << "    payload TEXT,\n"
+            << "    timestamp_us BIGINT\n"
+            << ");\n";
+        db_->exec(oss.str());
+    }
+    {
+        // Same columns as the inline table.
+        std::ostringstream oss;
+        oss << "CREATE VIEW IF NOT EXISTS " << table_base_ << " AS\n"
+            << "SELECT e.id, e.thread_id, e.per_thread_event_id, e.flags_raw,\n"
+            << "       COALESCE(c.value, e.category) AS category,\n"
+            << "       COALESCE(p.value, e.payload) AS payload,\n"
+            << "       e.timestamp_us\n"
+            << "FROM " << events << " e\n"
+            << "LEFT JOIN " << strings << " c ON c.id = e.category_id\n"
+            << "LEFT JOIN " << strings << " p ON p.id = e.payload_id;\n";
+        db_->exec(oss.str());
+    }
+
+    // Strings of earlier runs keep their ids.
+    Sqlite::Statement load(*db_, "SELECT id, value FROM " + strings + ";");
+    while (load.step()) {
+        int64_t id = 0;
+        std::string value;
+        load.get(id, value);
+        string_ids_.emplace(std::move(value), id);
+        if (id >= next_string_id_) next_string_id_ = id + 1;
+    }
+
+    stmt_string_ = std::make_unique<Sqlite::Statement>(*db_, "INSERT INTO " + strings + " (id, value) VALUES (?, ?);");
+    stmt_main_ = std::make_unique<Sqlite::Statement>(*db_,
+        "INSERT OR IGNORE INTO " + events +
+        " (id, thread_id, per_thread_event_id, flags_raw, category_id, category, payload_id, payload, timestamp_us) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?);");
+}
+
+int64_t SqlEventSink::string_code(const std::string& s) {
+    if (const auto it = string_ids_.find(s); it != string_ids_.end()) return it->second;
+    if (const auto it = batch_strings_.find(s); it != batch_strings_.end()) return it->second;
+    if (string_ids_.size() + batch_strings_.size() >= kMaxDictionaryEntries || s.size() > kMaxDictionaryBytes) return 0;
+
+    // Staged until the batch commits: a rolled-back batch must not leave ids that have no row.
+    const int64_t id = next_string_id_ + static_cast<int64_t>(batch_strings_.size());
+    stmt_string_->bind(id, s);   // same transaction as the row that uses it
+    while (stmt_string_->step()) {}
+    stmt_string_->reset();
+    batch_strings_.emplace(s, id);
+    if (debug_sql_.is_open()) {
+        debug_sql_ << "INSERT INTO " << table_base_ << "_strings (id, value) VALUES (" << id << ", '"
+                   << escape_for_sql(s) << "');\n";
+    }
+    return id;
+}
+
 void SqlEventSink::write_batch(std::span<const PersistedEvent> batch) {
     if (!db_ || batch.empty()) return;
 
     db_->begin();
-
-    for (const auto& e : batch) {
-        if (mode_ == PersistMode::KeeperOnly) {
-            if ((e.flags & KEEPER_MASK) == 0) continue;
-        } else if (mode_ == PersistMode::DatabaseOnly) {
-            if ((e.flags & DATABASE_MASK) == 0) continue;
+    try {
+        for (const auto& e : batch) {
+            if (mode_ == PersistMode::KeeperOnly) {
+                if ((e.flags & KEEPER_MASK) == 0) continue;
+            } else if (mode_ == PersistMode::DatabaseOnly) {
+                if ((e.flags & DATABASE_MASK) == 0) continue;
+            }
+            insert_event(e);
+        }
+        db_->commit();
+    } catch (...) {
+        batch_strings_.clear();   // their rows in <base>_strings are rolled back with the batch
+        for (auto* stmt : {stmt_main_.get(), stmt_string_.get()}) {
+            if (stmt) stmt->reset();
         }
-        insert_event(e);
+        try { db_->rollback(); } catch (...) {}   // COMMIT may have failed after SQLite rolled back
+        throw;
     }
 
-    db_->commit();
+    next_string_id_ += static_cast<int64_t>(batch_strings_.size());
+    string_ids_.merge(batch_strings_);
+    batch_strings_.clear();
 }
 
 void SqlEventSink::insert_event(const PersistedEvent& e) {
     // Main table (always prepared)
-    stmt_main_->bind(
-        static_cast<int64_t>(e.event_id),
-        static_cast<int64_t>(e.thread_id),
-        static_cast<int64_t>(e.per_thread_event_id),
-        static_cast<int64_t>(e.flags),
-        e.category,
-        e.payload,
-        static_cast<int64_t>(e.timestamp_us)
-    );
+    int64_t category_code = 0;
+    int64_t payload_code = 0;
+    if (dictionary_) {
+        category_code = string_code(e.category);
+        payload_code = string_code(e.payload);
+        stmt_main_->reset();
+        stmt_main_->clear_bindings();
+        stmt_main_->bind_int64(1, static_cast<int64_t>(e.event_id));
+        stmt_main_->bind_int64(2, static_cast<int64_t>(e.thread_id));
+        stmt_main_->bind_int64(3, static_cast<int64_t>(e.per_thread_event_id));
+        stmt_main_->bind_int64(4, static_cast<int64_t>(e.flags));
+        if (category_code != 0) stmt_main_->bind_int64(5, category_code);
+        else                    stmt_main_->bind_text(6, e.category);
+        if (payload_code != 0) stmt_main_->bind_int64(7, payload_code);
+        else                   stmt_main_->bind_text(8, e.payload);
+        stmt_main_->bind_int64(9, static_cast<int64_t>(e.timestamp_us));
+    } else {
+        stmt_main_->bind(
+            static_cast<int64_t>(e.event_id),
+            static_cast<int64_t>(e.thread_id),
+            static_cast<int64_t>(e.per_thread_event_id),
+            static_cast<int64_t>(e.flags),
+            e.category,
+            e.payload,
+            static_cast<int64_t>(e.timestamp_us)
+        );
+    }
     while (stmt_main_->step()) {}
     stmt_main_->reset();
     ++main_rows_inserted_;
 
-    write_debug_insert(e);
+    write_debug_insert(e, category_code, payload_code);
 
     // Ints table
     if (stmt_ints_) {
@@ -213,18 +342,32 @@ void SqlEventSink::finalize() {
     stmt_main_.reset();
     stmt_ints_.reset();
     stmt_dbls_.reset();
+    stmt_string_.reset();
     db_.reset();
     finalized_ = true;
 }
 
-void SqlEventSink::write_debug_insert(const PersistedEvent& e) {
+void SqlEventSink::write_debug_insert(const PersistedEvent& e, int64_t category_code, int64_t payload_code) {
     if (!debug_sql_.is_open()) return;
 
     auto esc = [this](const std::string& s) { return escape_for_sql(s); };
 
-    debug_sql_ << "INSERT OR IGNORE INTO " << table_base_ << " (id, thread_id, per_thread_event_id, flags_raw, category, payload, timestamp_us) VALUES ("
-               << e.event_id << ", " << e.thread_id << ", " << e.per_thread_event_id << ", " << e.flags << ", '"
-               << esc(e.category) << "', '" << esc(e.payload) << "', " << e.timestamp_us << ");\n";
+    if (dictionary_) {
+        auto code_or_text = [&](int64_t code, const std::string& s) {
+            if (code != 0) debug_sql_ << code << ", NULL";
+            else           debug_sql_ << "NULL, '" << esc(s) << "'";
+        };
+        debug_sql_ << "INSERT OR IGNORE INTO " << table_base_ << "_events (id, thread_id, per_thread_event_id, flags_raw, category_id, category, payload_id, payload, timestamp_us) VALUES ("
+                   << e.event_id << ", " << e.thread_id << ", " << e.per_thread_event_id << ", " << e.flags << ", ";
+        code_or_text(category_code, e.category);
+        debug_sql_ << ", ";
+        code_or_text(payload_code, e.payload);
+        debug_sql_ << ", " << e.timestamp_us << ");\n";
+    } else {
+        debug_sql_ << "INSERT OR IGNORE INTO " << table_base_ << " (id, thread_id, per_thread_event_id, flags_raw, category, payload, timestamp_us) VALUES ("
+                   << e.event_id << ", " << e.thread_id << ", " << e.per_thread_event_id << ", " << e.flags << ", '"
+                   << esc(e.category) << "', '" << esc(e.payload) << "', " << e.timestamp_us << ");\n";
+    }
 
     if (int_count_ > 0) {
         debug_sql_ << "INSERT OR IGNORE INTO " << table_base_ << "_ints (id";
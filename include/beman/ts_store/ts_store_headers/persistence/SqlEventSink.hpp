@@ -6,16 +6,27 @@
 // For debug, can also write the equivalent INSERT statements as text to a .sql file
 // (so you can inspect/replay the straight SQL).
 // Designed to work with DoubleBufferedWriter for asynchronous background draining.
+// Durability: each write_batch is one transaction, and SQLite's default synchronous=FULL
+// makes every COMMIT durable, so sync() only needs the inherited flush() of the debug file.
+//
+// String dictionary (SqlStringStorage::Dictionary / TS_STORE_SQL_STRINGS=dictionary): each
+// distinct category / payload is inserted once into <base>_strings, and <base>_events stores its
+// integer id (category_id / payload_id) instead of the text. Strings past the dictionary limits
+// stay inline in the category / payload columns of the same row. A view named <base> joins the
+// text back, so readers query the same columns as in the inline layout. Reopening an existing
+// database keeps the layout it was created with.
 
 #include "EventSink.hpp"
 #include "Sqlite.hpp"
 #include "PersistCommon.hpp"
 
+#include <cstdint>
 #include <memory>
 #include <fstream>
 #include <string>
 #include <string_view>
 #include <filesystem>
+#include <unordered_map>
 
 namespace jac::ts_store::inline_v001 {
 
@@ -25,11 +36,13 @@ public:
     // int_count, dbl_count: number of metric columns (determines schema for _ints / _floats tables)
     // mode: All, KeeperOnly (bit 1), or DatabaseOnly (bit 2)
     // write_debug_sql: if true, also emit textual INSERT statements to base.sql for debugging/replay
+    // strings: inline TEXT columns, or the <base>_strings dictionary (see above)
     SqlEventSink(std::string_view base_name,
                  size_t int_count,
                  size_t dbl_count,
                  PersistMode mode = PersistMode::All,
-                 bool write_debug_sql = true);
+                 bool write_debug_sql = true,
+                 SqlStringStorage strings = SqlStringStorage::Default);
 
     ~SqlEventSink() override;
 
@@ -40,11 +53,19 @@ public:
     std::string_view name() const override { return "SqlEventSink"; }
 
     [[nodiscard]] size_t main_row_count() const { return main_rows_inserted_; }
+    // Effective string storage (after TS_STORE_SQL_STRINGS and the layout of an existing database).
+    [[nodiscard]] bool dictionary_strings() const { return dictionary_; }
+    [[nodiscard]] size_t dictionary_size() const { return string_ids_.size(); }
 
 private:
+    static constexpr size_t kMaxDictionaryEntries = 65536;
+    static constexpr size_t kMaxDictionaryBytes = 256;
+
     void ensure_tables_and_prepare();
+    void prepare_dictionary();
+    int64_t string_code(const std::string& s);   // 0 = store inline
     void insert_event(const PersistedEvent& e);
-    void write_debug_insert(const PersistedEvent& e);
+    void write_debug_insert(const PersistedEvent& e, int64_t category_code, int64_t payload_code);
     std::string escape_for_sql(const std::string& s) const;
 
     std::unique_ptr<Sqlite> db_;
@@ -61,6 +82,12 @@ private:
     std::unique_ptr<Sqlite::Statement> stmt_main_;
     std::unique_ptr<Sqlite::Statement> stmt_ints_;
     std::unique_ptr<Sqlite::Statement> stmt_dbls_;
+    std::unique_ptr<Sqlite::Statement> stmt_string_;
+
+    bool dictionary_ = false;
+    std::unordered_map<std::string, int64_t> string_ids_;   // <base>_strings, loaded on open
+    std::unordered_map<std::string, int64_t> batch_strings_;   // added by the open transaction
+    int64_t next_string_id_ = 1;
 
     bool finalized_ = false;
     size_t main_rows_inserted_ = 0;
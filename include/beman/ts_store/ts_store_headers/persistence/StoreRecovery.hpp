@@ -0,0 +1,157 @@
+#pragma once
+
+// StoreRecovery.hpp
+// Warm start: bulk-load a BinaryEventLog file back into a ts_store after a restart.
+// The file is mapped and validated once (MappedBinaryLog::scan, which also inflates compressed
+// blocks), then the valid records are decoded straight into their row slots by N threads — no
+// save_event replay, no persistence resubmission. Rows keep their logged event_id (id == index),
+// and the store's next id continues after the newest recovered one so new events never reuse a
+// logged id.
+//
+// Lives on the persistence side: ts_store.hpp only forward-declares StoreRecovery and makes it a
+// friend, so the core header does not pull in the log reader.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "BinaryLogRecovery.hpp"
+
+namespace jac::ts_store::inline_v001 {
+
+template <typename Store>
+struct StoreRecovery {
+    using Config = typename Store::config_type;
+
+    static RecoveryResult from_binary_log(Store& store, std::string_view path, RecoveryOptions options) {
+        auto& rows = store.rows_;
+        // Claim the whole id space up front: a save_event racing with recovery gets an id past the
+        // rows and fails as "store full" instead of taking a slot recovery is about to fill.
+        size_t fresh = 0;
+        if (!store.next_id_.compare_exchange_strong(fresh, rows.size(), std::memory_order_acq_rel)) {
+            throw std::runtime_error("ts_store: recover_from_binary_log must run before save_event");
+        }
+        try {
+            return load(store, path, options);
+        } catch (...) {
+            store.next_id_.store(0, std::memory_order_release);
+            throw;
+        }
+    }
+
+private:
+    static RecoveryResult load(Store& store, std::string_view path, RecoveryOptions options) {
+        const auto start = std::chrono::steady_clock::now();
+        auto& rows = store.rows_;
+
+        size_t threads = options.threads == 0 ? std::thread::hardware_concurrency() : options.threads;
+
+        MappedBinaryLog log(path);
+        const BinaryLogScan scan = log.scan(threads);   // v2: block CRCs checked in parallel
+
+        RecoveryResult result;
+        result.records_valid = scan.records.size();
+        result.dropped_bytes = scan.dropped_bytes;
+
+        // Ids at or above limit would leave fewer than options.headroom free rows for new events.
+        const size_t limit = rows.size() - std::min(options.headroom, rows.size());
+
+        // The newest records are at the end of the file (append order). Walk back until the window
+        // holds `window` records that fit the store; everything before that is skipped.
+        const size_t window = options.max_events == 0 ? limit : std::min(options.max_events, limit);
+        size_t first = scan.records.size();
+        for (size_t fitting = 0; first > 0 && fitting < window; --first) {
+            if (MappedBinaryLog::event_id_of(scan.records[first - 1]) < limit) ++fitting;
+        }
+        for (size_t i = 0; i < first; ++i) {
+            if (MappedBinaryLog::event_id_of(scan.records[i]) < limit) ++result.skipped_window;
+            else ++result.skipped_range;
+        }
+
+        const size_t todo = scan.records.size() - first;
+        threads = std::clamp<size_t>(threads, 1, std::max<size_t>(1, todo / 4096));
+        result.threads = threads;
+
+        std::vector<size_t> loaded(threads, 0), out_of_range(threads, 0), max_id(threads, 0);
+        auto load_range = [&](size_t t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const BinaryRecordView rec = MappedBinaryLog::record(scan.records[i]);
+                if (rec.event_id >= limit) {
+                    ++out_of_range[t];
+                    continue;
+                }
+                auto& row = rows[rec.event_id];
+                row.thread_id   = rec.thread_id;
+                row.event_id    = rec.per_thread_event_id;
+                row.event_flags = rec.raw_flags;
+                row.is_debug    = false;
+                row.value_storage.assign_truncated(rec.payload, Config::max_payload_length);
+                row.category_storage.assign_truncated(rec.category, Config::max_category_length);
+                row.int_metrics = {};
+                for (size_t k = 0; k < std::min<size_t>(rec.int_count, Config::the_IntMetrics); ++k)
+                    row.int_metrics[k] = rec.int_metric(k);
+                row.dbl_metrics = {};
+                for (size_t k = 0; k < std::min<size_t>(rec.dbl_count, Config::the_DblMetrics); ++k)
+                    row.dbl_metrics[k] = rec.dbl_metric(k);
+                if constexpr (Config::use_timestamps) {
+                    row.ts_us = rec.timestamp_us;
+                }
+                ++loaded[t];
+                max_id[t] = std::max(max_id[t], static_cast<size_t>(rec.event_id) + 1);
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        const size_t chunk = (todo + threads - 1) / threads;
+        for (size_t t = 0; t < threads; ++t) {
+            const size_t b = first + std::min(todo, t * chunk);
+            const size_t e = first + std::min(todo, (t + 1) * chunk);
+            if (t + 1 == threads) {
+                load_range(t, b, e);   // calling thread takes the last chunk
+            } else {
+                workers.emplace_back(load_range, t, b, e);
+            }
+        }
+        for (auto& w : workers) w.join();
+
+        size_t next = 0;
+        for (size_t t = 0; t < threads; ++t) {
+            result.loaded += loaded[t];
+            result.skipped_range += out_of_range[t];
+            next = std::max(next, max_id[t]);
+        }
+        store.next_id_.store(next, std::memory_order_release);
+        result.next_id = next;
+        result.capacity_left = rows.size() - next;
+
+        if constexpr (Config::use_timestamps) {
+            if (options.continue_timestamps && result.loaded > 0) {
+                // New events get ts_us = now - epoch; start them just after the newest recovered one.
+                Store::s_epoch_base.store(std::chrono::steady_clock::now() -
+                                          std::chrono::microseconds(scan.max_timestamp_us + 1),
+                                          std::memory_order_relaxed);
+            }
+        }
+
+        result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start);
+        return result;
+    }
+};
+
+/// Must run on a fresh store (before any save_event); save_event calls made while it runs fail
+/// as if the store were full. Attach persistence afterwards with a new base name;
+/// attach_persistence starts the writer's durable watermark at result.next_id.
+/// Records with event_id >= expected_size() - options.headroom do not fit and are counted in
+/// skipped_range; result.capacity_left is how many events the store can still take.
+template <typename Store>
+RecoveryResult recover_from_binary_log(Store& store, std::string_view path, RecoveryOptions options = {}) {
+    return StoreRecovery<Store>::from_binary_log(store, path, options);
+}
+
+} // namespace jac::ts_store::inline_v001
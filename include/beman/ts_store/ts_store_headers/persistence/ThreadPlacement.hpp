@@ -0,0 +1,224 @@
+#pragma once
+
+// ThreadPlacement.hpp
+// CPU affinity, scheduling policy and nice level for the persistence threads
+// (DoubleBufferedWriter workers, PipelinedIo I/O threads).
+//
+// Placement is applied by the thread itself right after it starts, then read back so the run
+// manifest records what the kernel actually granted (a FIFO request without CAP_SYS_NICE, or a
+// CPU outside the cgroup's cpuset, shows up as an error instead of silently not happening).
+//
+// Environment (used when the owning options leave placement unset):
+//   <PREFIX>_CPUS   CPU list, e.g. "2-3,6"
+//   <PREFIX>_SCHED  other | batch | idle | fifo | rr
+//   <PREFIX>_PRIO   static priority for fifo/rr (1..99)
+//   <PREFIX>_NICE   nice level (-20..19)
+// with PREFIX = TS_STORE_PERSIST (writer workers) or TS_STORE_IO (I/O threads).
+// TS_STORE_PERSIST_REPORT=1 makes the threads print one "[persist] key=value ..." line at shutdown;
+// the test runner collects those lines into the run manifest.
+
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace jac::ts_store::inline_v001 {
+
+enum class SchedPolicy { Inherit, Other, Batch, Idle, Fifo, RoundRobin };
+
+struct ThreadPlacement {
+    std::vector<int> cpus;               // empty = leave affinity alone
+    SchedPolicy policy = SchedPolicy::Inherit;
+    int priority = 0;                    // Fifo / RoundRobin only; 0 = the policy's lowest
+    std::optional<int> nice;             // unset = leave alone
+
+    [[nodiscard]] bool empty() const {
+        return cpus.empty() && policy == SchedPolicy::Inherit && !nice;
+    }
+
+    // Parse "0-3,8,10-11". Invalid tokens are skipped.
+    static std::vector<int> parse_cpu_list(std::string_view text) {
+        std::vector<int> out;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t comma = text.find(',', pos);
+            if (comma == std::string_view::npos) comma = text.size();
+            const std::string token(text.substr(pos, comma - pos));
+            pos = comma + 1;
+            if (token.empty()) continue;
+
+            char* end = nullptr;
+            const long lo = std::strtol(token.c_str(), &end, 10);
+            if (end == token.c_str() || lo < 0) continue;
+            long hi = lo;
+            if (*end == '-') {
+                const char* hi_start = end + 1;
+                hi = std::strtol(hi_start, &end, 10);
+                if (end == hi_start || hi < lo) continue;
+            }
+            for (long c = lo; c <= hi && c < CPU_SETSIZE; ++c) out.push_back(static_cast<int>(c));
+        }
+        return out;
+    }
+
+    static std::optional<SchedPolicy> parse_policy(std::string_view v) {
+        if (v == "other" || v == "normal") return SchedPolicy::Other;
+        if (v == "batch") return SchedPolicy::Batch;
+        if (v == "idle")  return SchedPolicy::Idle;
+        if (v == "fifo")  return SchedPolicy::Fifo;
+        if (v == "rr")    return SchedPolicy::RoundRobin;
+        return std::nullopt;
+    }
+
+    static ThreadPlacement from_env(std::string_view prefix) {
+        ThreadPlacement p;
+        auto get = [&](std::string_view suffix) -> const char* {
+            return std::getenv((std::string(prefix) + std::string(suffix)).c_str());
+        };
+        if (const char* v = get("_CPUS")) p.cpus = parse_cpu_list(v);
+        if (const char* v = get("_SCHED")) {
+            if (auto pol = parse_policy(v)) p.policy = *pol;
+        }
+        if (const char* v = get("_PRIO")) p.priority = std::atoi(v);
+        if (const char* v = get("_NICE")) p.nice = std::atoi(v);
+        return p;
+    }
+};
+
+// What the calling thread ended up with after apply_thread_placement().
+struct EffectivePlacement {
+    std::vector<int> cpus;
+    SchedPolicy policy = SchedPolicy::Other;
+    int priority = 0;
+    int nice = 0;
+    std::string errors;   // space-separated: "affinity", "sched", "nice"
+};
+
+inline std::string format_cpu_list(const std::vector<int>& cpus) {
+    std::string out;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+        if (!out.empty()) out += ',';
+        out += std::to_string(cpus[i]);
+        if (j > i) out += '-' + std::to_string(cpus[j]);
+        i = j + 1;
+    }
+    return out;
+}
+
+inline std::string_view sched_policy_name(SchedPolicy p) {
+    switch (p) {
+        case SchedPolicy::Inherit:    return "inherit";
+        case SchedPolicy::Other:      return "other";
+        case SchedPolicy::Batch:      return "batch";
+        case SchedPolicy::Idle:       return "idle";
+        case SchedPolicy::Fifo:       return "fifo";
+        case SchedPolicy::RoundRobin: return "rr";
+    }
+    return "other";
+}
+
+namespace detail {
+    inline int to_native_policy(SchedPolicy p) {
+        switch (p) {
+            case SchedPolicy::Batch:      return SCHED_BATCH;
+            case SchedPolicy::Idle:       return SCHED_IDLE;
+            case SchedPolicy::Fifo:       return SCHED_FIFO;
+            case SchedPolicy::RoundRobin: return SCHED_RR;
+            default:                      return SCHED_OTHER;
+        }
+    }
+
+    inline SchedPolicy from_native_policy(int p) {
+        switch (p) {
+            case SCHED_BATCH: return SchedPolicy::Batch;
+            case SCHED_IDLE:  return SchedPolicy::Idle;
+            case SCHED_FIFO:  return SchedPolicy::Fifo;
+            case SCHED_RR:    return SchedPolicy::RoundRobin;
+            default:          return SchedPolicy::Other;
+        }
+    }
+}
+
+// Apply to the calling thread and read back the result. Never throws: a persistence thread that
+// cannot get its placement still runs, and the failure is recorded in EffectivePlacement::errors.
+inline EffectivePlacement apply_thread_placement(const ThreadPlacement& p) {
+    EffectivePlacement eff;
+    const pthread_t self = ::pthread_self();
+    const auto tid = static_cast<id_t>(::gettid());
+
+    if (!p.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int c : p.cpus) CPU_SET(static_cast<size_t>(c), &set);
+        if (::pthread_setaffinity_np(self, sizeof(set), &set) != 0) eff.errors += "affinity ";
+    }
+    if (p.policy != SchedPolicy::Inherit) {
+        sched_param sp{};
+        const bool realtime = p.policy == SchedPolicy::Fifo || p.policy == SchedPolicy::RoundRobin;
+        sp.sched_priority = 0;
+        if (realtime) {
+            // Priority 0 is EINVAL for fifo/rr: a bare "--persist-sched=fifo" gets the lowest one.
+            const int native = detail::to_native_policy(p.policy);
+            sp.sched_priority = p.priority > 0 ? p.priority : ::sched_get_priority_min(native);
+        }
+        if (::pthread_setschedparam(self, detail::to_native_policy(p.policy), &sp) != 0) eff.errors += "sched ";
+    }
+    if (p.nice) {
+        if (::setpriority(PRIO_PROCESS, tid, *p.nice) != 0) eff.errors += "nice ";
+    }
+    if (!eff.errors.empty()) eff.errors.pop_back();
+
+    cpu_set_t got;
+    CPU_ZERO(&got);
+    if (::pthread_getaffinity_np(self, sizeof(got), &got) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c) {
+            if (CPU_ISSET(static_cast<size_t>(c), &got)) eff.cpus.push_back(c);
+        }
+    }
+    int native = SCHED_OTHER;
+    sched_param sp{};
+    if (::pthread_getschedparam(self, &native, &sp) == 0) {
+        eff.policy = detail::from_native_policy(native);
+        eff.priority = sp.sched_priority;
+    }
+    errno = 0;
+    const int n = ::getpriority(PRIO_PROCESS, tid);
+    if (errno == 0) eff.nice = n;
+    return eff;
+}
+
+// "<role>_cpus=.. <role>_sched=.. <role>_nice=.." (+ "<role>_placement_errors=.." when any).
+inline std::string describe_placement(std::string_view role, const EffectivePlacement& eff) {
+    std::string s;
+    s += std::string(role) + "_cpus=" + format_cpu_list(eff.cpus);
+    s += ' ' + std::string(role) + "_sched=" + std::string(sched_policy_name(eff.policy));
+    if (eff.policy == SchedPolicy::Fifo || eff.policy == SchedPolicy::RoundRobin) {
+        s += ' ' + std::string(role) + "_prio=" + std::to_string(eff.priority);
+    }
+    s += ' ' + std::string(role) + "_nice=" + std::to_string(eff.nice);
+    if (!eff.errors.empty()) {
+        std::string errs = eff.errors;
+        for (char& c : errs) if (c == ' ') c = ',';
+        s += ' ' + std::string(role) + "_placement_errors=" + errs;
+    }
+    return s;
+}
+
+// One "[persist] ..." line on stdout when TS_STORE_PERSIST_REPORT is set (runner -> run manifest).
+inline void persist_report(std::string_view key_values) {
+    const char* env = std::getenv("TS_STORE_PERSIST_REPORT");
+    if (env == nullptr || env[0] == '\0' || env[0] == '0') return;
+    std::cout << "[persist] " << key_values << '\n' << std::flush;
+}
+
+} // namespace jac::ts_store::inline_v001
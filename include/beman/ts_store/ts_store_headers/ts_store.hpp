@@ -5,12 +5,18 @@
 #include "includes.hpp"
 
 #include "persistence/DoubleBufferedWriter.hpp"
+#include "persistence/ShardedWriter.hpp"
 
 namespace jac::ts_store::inline_v001 {
+// Warm start from a binary log (persistence/StoreRecovery.hpp); a friend so it can fill rows_.
+template <typename Store> struct StoreRecovery;
+
 // ——————————————————————— CONCEPTS ———————————————————————
 template<typename Config>
 class ts_store
 {
+    template <typename Store> friend struct StoreRecovery;
+
 private:
     struct row_data {
         size_t   event_flags{0};
@@ -29,6 +35,8 @@ private:
     const size_t max_threads_;
     const size_t events_per_thread_;
 public:
+    using config_type = Config;
+
     // ——— GETTERS ———
 [[nodiscard]] constexpr size_t id_width() const noexcept {
         const size_t max_id = expected_size() ? expected_size() - 1 : 0;
@@ -77,15 +85,38 @@ public:
     /// Attach a DoubleBufferedWriter (with any IEventSink: JTextEventSink, BinaryEventSink, or future SQL).
     /// Events will be submitted to the background writer after every successful save_event.
     /// This enables true double-buffered asynchronous persistence while keeping the hot path fast.
+    /// The writer's durable watermark is rebased to the next id: events saved earlier never reach it.
     void attach_persistence(std::unique_ptr<DoubleBufferedWriter> writer) {
+        sharded_writer_.reset();
+        if (writer) writer->watermark()->rebase(next_id_.load(std::memory_order_acquire));
         persistence_writer_ = std::move(writer);
     }
 
-    /// Drain and finalize the background persistence worker (for tests that inspect sink output).
+    /// Attach a ShardedPersistenceWriter: K workers, each with its own sink, routed by thread_id % K.
+    /// Replaces any single writer attached before.
+    void attach_persistence(std::unique_ptr<ShardedPersistenceWriter> writer) {
+        persistence_writer_.reset();
+        if (writer) writer->watermark()->rebase(next_id_.load(std::memory_order_acquire));
+        sharded_writer_ = std::move(writer);
+    }
+
+    /// Block until the event with this id (as returned by save_event) is durable at the attached
+    /// writer's DurabilityLevel. Returns false when no writer is attached, the event was saved
+    /// before it attached, or it stopped first.
+    bool wait_durable(size_t id) {
+        if (persistence_writer_) return persistence_writer_->wait_durable(id);
+        if (sharded_writer_) return sharded_writer_->wait_durable(id);
+        return false;
+    }
+
+    /// Drain and finalize the background persistence worker(s) (for tests that inspect sink output).
     void finalize_persistence() {
         if (persistence_writer_) {
             persistence_writer_->finalize();
         }
+        if (sharded_writer_) {
+            sharded_writer_->finalize();
+        }
     }
 
     explicit ts_store(size_t max_threads, size_t events_per_thread)
@@ -131,6 +162,7 @@ private:
     std::vector<row_data> rows_;
 
     std::unique_ptr<DoubleBufferedWriter> persistence_writer_;
+    std::unique_ptr<ShardedPersistenceWriter> sharded_writer_;
 
 public:
     static constexpr bool debug_mode_v = Config::debug_mode;
@@ -4,6 +4,7 @@ module;
 #include <filesystem>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 export module jac.report;
@@ -40,6 +41,8 @@ export struct RunResult {
     bool success        = false;
     double duration_sec = 0.0;
     fs::path log_path;
+    // key=value pairs from "[persist] ..." log lines (thread placement, batch sizing, ...)
+    std::vector<std::pair<std::string, std::string>> persist_report;
 };
 
 export struct HostInfo {
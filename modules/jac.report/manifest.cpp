@@ -123,6 +123,19 @@ std::optional<RunResult> parse_scenario_entry(const JTextEntry& e, const fs::pat
     return r;
 }
 
+// PersistTuning rows: test|compiler|persist|output_mode|key|value
+void attach_persist_entry(const JTextEntry& e, std::map<std::string, RunResult>& out) {
+    auto fields = split_fields(e);
+    if (fields.size() < 6) return;
+    for (auto& [_, r] : out) {
+        if (test_to_subdir_name(r.scenario.test) == fields[0] && r.scenario.compiler == fields[1] &&
+            r.scenario.persist == fields[2] && r.scenario.output_mode == fields[3]) {
+            r.persist_report.emplace_back(fields[4], fields[5]);
+            return;
+        }
+    }
+}
+
 bool load_existing_scenarios(const fs::path& jtext_path,
                              const fs::path& results_base,
                              std::map<std::string, RunResult>& out) {
@@ -142,6 +155,12 @@ bool load_existing_scenarios(const fs::path& jtext_path,
             }
         }
     }
+    for (const auto& sec : jf.sections) {
+        if (sec.name != "PersistTuning") continue;
+        for (const auto& entry : sec.entries) {
+            attach_persist_entry(entry, out);
+        }
+    }
     return true;
 }
 
@@ -261,8 +280,19 @@ bool write_run_manifest_jtext(const fs::path& results_base,
     });
 
     std::vector<std::vector<std::string>> scenario_rows;
+    std::vector<std::vector<std::string>> persist_rows;
     scenario_rows.reserve(sorted.size());
     for (const auto& r : sorted) {
+        for (const auto& [key, value] : r.persist_report) {
+            persist_rows.push_back({
+                test_to_subdir_name(r.scenario.test),
+                r.scenario.compiler,
+                r.scenario.persist,
+                r.scenario.output_mode,
+                key,
+                value,
+            });
+        }
         std::string log_rel;
         if (!r.log_path.empty()) {
             log_rel = fs::relative(r.log_path, results_base).generic_string();
@@ -287,6 +317,8 @@ bool write_run_manifest_jtext(const fs::path& results_base,
         inc_rel + "/run_manifest_scenarios_fields.jtFlds";
     const std::string hostinfo_fields =
         inc_rel + "/run_manifest_hostinfo_fields.jtFlds";
+    const std::string persist_fields =
+        inc_rel + "/run_manifest_persist_fields.jtFlds";
 
     std::ofstream out(jtext_path);
     if (!out) {
@@ -343,6 +375,10 @@ bool write_run_manifest_jtext(const fs::path& results_base,
 
     write_manifest_section(out, "Scenarios", scenarios_fields, scenario_rows);
 
+    if (!persist_rows.empty()) {
+        write_manifest_section(out, "PersistTuning", persist_fields, persist_rows);
+    }
+
     if (!out) {
         std::cerr << "ERROR writing manifest: " << jtext_path << "\n";
         return false;
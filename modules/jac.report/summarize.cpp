@@ -179,6 +179,17 @@ std::string test_purpose_blurb(const std::string& test_name) {
                "`KeeperRecord` → jText, `DatabaseEntry` → SQLite on disjoint indices — "
                "same verification as 008 TS.";
     }
+    if (test_name == "TS_STORE_TEST_009_TS" || test_name == "TS_STORE_TEST_009_XS") {
+        return "Binary log on-disk format stress: 1,000,000 events in four v2 block layouts "
+               "(raw, LZ, compact + dictionaries, compact + LZ + Bloom filters) — round trip through "
+               "the seek index, parallel scan and transcode, torn-tail repair, corrupt-block salvage, "
+               "CRC32C / LZ / compact decoder fuzzing and merge dedupe (jText builds).";
+    }
+    if (test_name == "TS_STORE_TEST_010_TS" || test_name == "TS_STORE_TEST_010_XS") {
+        return "Arrow IPC / columnar on-disk format stress: 1,000,000 events — Arrow file read back "
+               "through stream and footer, columnar log round trip and row group pruning, torn-tail "
+               "and corrupt-data cases for both.";
+    }
     return {};
 }
 
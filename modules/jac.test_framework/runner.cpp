@@ -16,6 +16,33 @@ module jac.test_framework;
 
 namespace fs = std::filesystem;
 
+namespace {
+
+// Collect key=value tokens from "[persist] ..." lines (printed when TS_STORE_PERSIST_REPORT=1).
+std::vector<std::pair<std::string, std::string>> read_persist_report(const fs::path& log_path) {
+    std::vector<std::pair<std::string, std::string>> out;
+    std::ifstream in(log_path);
+    std::string line;
+    constexpr std::string_view tag = "[persist] ";
+    while (std::getline(in, line)) {
+        if (!line.starts_with(tag)) continue;
+        std::string_view rest(line);
+        rest.remove_prefix(tag.size());
+        while (!rest.empty()) {
+            const size_t sp = rest.find(' ');
+            const std::string_view token = rest.substr(0, sp);
+            if (const size_t eq = token.find('='); eq != std::string_view::npos && eq > 0) {
+                out.emplace_back(std::string(token.substr(0, eq)), std::string(token.substr(eq + 1)));
+            }
+            if (sp == std::string_view::npos) break;
+            rest.remove_prefix(sp + 1);
+        }
+    }
+    return out;
+}
+
+} // namespace
+
 TestParams load_test_params(const fs::path& config_file) {
     TestParams params;
     std::ifstream file(config_file);
@@ -75,7 +102,7 @@ TestScaling get_test_params(const std::string& test_num_str, const std::string&
     while (tnum.size() < 3) tnum = "0" + tnum;
 
     if (!is_full) {
-        if (tnum == "005" || tnum == "006" || tnum == "007" || tnum == "008") {
+        if (tnum == "005" || tnum == "006" || tnum == "007" || tnum == "008" || tnum == "009" || tnum == "010") {
             res.threads           = 10;
             res.events_per_thread = 100;
             res.runs              = 1;
@@ -84,7 +111,7 @@ TestScaling get_test_params(const std::string& test_num_str, const std::string&
     }
 
     // SIZE=full (xFull): progressive scale tuned for ~30 min gcc+clang matrix on x7k.
-    // Heavy 005/006/007: 50×2000 = 100k; 008: 50×20k = 1M per run (×3 runs).
+    // Heavy 005/006/007: 50×2000 = 100k; 008: 50×20k = 1M per run (×3 runs); 009/010: 1M × 1 run.
     if (tnum == "001") {
         res.threads           = 8;
         res.events_per_thread = 64;
@@ -119,6 +146,10 @@ TestScaling get_test_params(const std::string& test_num_str, const std::string&
         res.threads           = 50;
         res.events_per_thread = 20000;
         res.runs              = 3;
+    } else if (tnum == "009" || tnum == "010") {
+        res.threads           = 50;
+        res.events_per_thread = 20000;
+        res.runs              = 1;
     } else {
         res.threads           = 50;
         res.events_per_thread = 2000;
@@ -144,6 +175,7 @@ std::string persist_log_dir_name(const std::string& persist) {
     if (persist == "none")  return "inmem_logs";
     if (persist == "unit")  return "unit_logs";
     if (persist == "flags") return "flags_logs";
+    if (persist == "formats") return "formats_logs";
     return "binary_logs";
 }
 
@@ -227,6 +259,26 @@ std::vector<Scenario> build_scenario_list(const std::vector<std::string>& select
             continue;
         }
 
+        // 009 / 010 write their own files in every on-disk format; no sink choice, no output mode.
+        if (test_base == "009" || test_base == "010") {
+            for (const auto& tsxs : std::vector<std::string>{"TS", "XS"}) {
+                std::string test = "ts_store_" + test_base + "_" + tsxs;
+                TestScaling scaling = get_test_params(test_base, size);
+                for (const auto& compiler : compilers) {
+                    Scenario s;
+                    s.test              = test;
+                    s.persist           = "formats";
+                    s.output_mode       = "off";
+                    s.compiler          = compiler;
+                    s.threads           = scaling.threads;
+                    s.events_per_thread = scaling.events_per_thread;
+                    s.runs              = scaling.runs;
+                    scenarios.push_back(s);
+                }
+            }
+            continue;
+        }
+
         for (const auto& tsxs : std::vector<std::string>{"TS", "XS"}) {
             std::string test = "ts_store_" + test_base + "_" + tsxs;
             TestScaling scaling = get_test_params(test_base, size);
@@ -275,7 +327,7 @@ RunResult run_scenario(const Scenario& scen,
     std::string color = (scen.output_mode == "on") ? "1" : "0";
 
     std::string cmd = std::format(
-        "\"{}\" --interactive=0 --color={} --persist={} --base-name=\"{}\" "
+        "TS_STORE_PERSIST_REPORT=1 \"{}\" --interactive=0 --color={} --persist={} --base-name=\"{}\" "
         "--threads={} --events-per-thread={} --runs={} > \"{}\" 2>&1",
         bin_path.string(),
         color,
@@ -298,6 +350,7 @@ RunResult run_scenario(const Scenario& scen,
 
     result.success = (ret == 0);
     result.duration_sec = secs;
+    result.persist_report = read_persist_report(log_path);
     std::cout << std::format("    {:<4} in {:6.1f}s -> {}\n",
                              (result.success ? "PASS" : "FAIL"), secs, log_path.string());
 
@@ -345,7 +398,7 @@ std::vector<std::string> infer_compilers(const std::string& compiler_opt,
 
 std::vector<std::string> get_selected_tests(const TestParams& params) {
     std::vector<std::string> sel;
-    for (int i = 1; i <= 8; ++i) {
+    for (int i = 1; i <= 10; ++i) {
         std::string key = std::format("{:03d}", i);
         if (params.selected_tests.count(key) && params.selected_tests.at(key)) {
             sel.push_back(key);
@@ -355,7 +408,7 @@ std::vector<std::string> get_selected_tests(const TestParams& params) {
         sel.push_back("flags");
     }
     if (sel.empty()) {
-        for (int i = 1; i <= 8; ++i) sel.push_back(std::format("{:03d}", i));
+        for (int i = 1; i <= 10; ++i) sel.push_back(std::format("{:03d}", i));
         sel.push_back("flags");
     }
     return sel;
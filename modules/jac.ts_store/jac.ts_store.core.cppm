@@ -7,12 +7,18 @@ module;
 #include <chrono>
 #include <cmath>
 #include <cctype>
+#include <condition_variable>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
 #include <iostream>
 #include <iomanip>
 #include <limits>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <print>
 #include <format>
 #include <stdexcept>
@@ -21,9 +27,19 @@ module;
 #include <thread>
 #include <utility>
 #include <vector>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/sysinfo.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <beman/ts_store/ts_store_headers/ts_store.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/MappedBinaryLogReader.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/ParallelBinaryLogScan.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/FixedStrideLogReader.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/LiveBinaryLogReader.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/BinaryLogTranscode.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/StoreRecovery.hpp>
 
 export module jac.ts_store.core;
 
@@ -34,4 +50,25 @@ export import jac.ts_store.persistence.writer;
 
 export namespace jac::ts_store::inline_v001 {
     using jac::ts_store::inline_v001::ts_store;
+    using jac::ts_store::inline_v001::BinaryRecordView;
+    using jac::ts_store::inline_v001::BinaryLogScan;
+    using jac::ts_store::inline_v001::MappedBinaryLog;
+    using jac::ts_store::inline_v001::MappedBinaryLogReader;
+    using jac::ts_store::inline_v001::BinaryScanFilter;
+    using jac::ts_store::inline_v001::ParallelScanOptions;
+    using jac::ts_store::inline_v001::ParallelScanResult;
+    using jac::ts_store::inline_v001::parallel_scan;
+    using jac::ts_store::inline_v001::parallel_transform;
+    using jac::ts_store::inline_v001::FixedStrideLogReader;
+    using jac::ts_store::inline_v001::LiveReadOptions;
+    using jac::ts_store::inline_v001::LiveBinaryLogReader;
+    using jac::ts_store::inline_v001::TranscodeOptions;
+    using jac::ts_store::inline_v001::TranscodeResult;
+    using jac::ts_store::inline_v001::append_csv_header;
+    using jac::ts_store::inline_v001::append_csv_row;
+    using jac::ts_store::inline_v001::transcode_binary_log_to_csv;
+    using jac::ts_store::inline_v001::transcode_binary_log_to_sink;
+    using jac::ts_store::inline_v001::RecoveryOptions;
+    using jac::ts_store::inline_v001::RecoveryResult;
+    using jac::ts_store::inline_v001::recover_from_binary_log;
 }
\ No newline at end of file
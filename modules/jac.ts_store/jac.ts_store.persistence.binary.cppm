@@ -1,25 +1,139 @@
 module;
 
+#include <algorithm>
+#include <bit>
 #include <chrono>
+#include <cmath>
+#include <condition_variable>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <filesystem>
 #include <format>
 #include <fstream>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <span>
+#include <sstream>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
+#include <array>
+
+#include <beman/ts_store/ts_store_headers/persistence/Crc32c.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/BinaryLogFormat.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/BinaryLogIndex.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/BinaryLogBloom.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/BlockCompression.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/CompactRecords.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/SlidingMmapWindow.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/DirectFileWriter.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/LiveBinaryLog.hpp>
 #include <beman/ts_store/ts_store_headers/persistence/BinaryEventLog.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/SegmentedBinaryLog.hpp>
 #include <beman/ts_store/ts_store_headers/persistence/BinaryEventSink.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/FixedStrideFormat.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/FixedStrideEventLog.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/FixedStrideEventSink.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/BinaryLogRepair.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/ArrowIpcFormat.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/ArrowIpcEventSink.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/ColumnarFormat.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/ColumnarEventLog.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/ColumnarEventSink.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/ColumnarLogReader.hpp>
 
 export module jac.ts_store.persistence.binary;
 
 export import jac.ts_store.persistence.common;
 
 export namespace jac::ts_store::inline_v001 {
+    using jac::ts_store::inline_v001::crc32c;
+    using jac::ts_store::inline_v001::kBinaryLogVersion;
+    using jac::ts_store::inline_v001::BlockCodec;
+    using jac::ts_store::inline_v001::BinaryLogFileHeader;
+    using jac::ts_store::inline_v001::BinaryLogSchema;
+    using jac::ts_store::inline_v001::BinaryBlockHeader;
+    using jac::ts_store::inline_v001::BinaryIndexEntry;
+    using jac::ts_store::inline_v001::BinaryIndexFooter;
+    using jac::ts_store::inline_v001::BinaryLogIndex;
+    using jac::ts_store::inline_v001::index_data_end;
+    using jac::ts_store::inline_v001::kBloomKeyCategory;
+    using jac::ts_store::inline_v001::kBloomKeyTokens;
+    using jac::ts_store::inline_v001::BinaryBloomHeader;
+    using jac::ts_store::inline_v001::resolve_bloom_keys;
+    using jac::ts_store::inline_v001::BinaryBloomBuilder;
+    using jac::ts_store::inline_v001::BinaryBloomIndex;
+    using jac::ts_store::inline_v001::block_codec_available;
+    using jac::ts_store::inline_v001::block_codec_name;
+    using jac::ts_store::inline_v001::resolve_block_codec;
+    using jac::ts_store::inline_v001::compress_block;
+    using jac::ts_store::inline_v001::decompress_block;
+    using jac::ts_store::inline_v001::kBlockCodecMask;
+    using jac::ts_store::inline_v001::kBlockCompactRecords;
+    using jac::ts_store::inline_v001::kBlockStringDictionary;
+    using jac::ts_store::inline_v001::block_codec_of;
+    using jac::ts_store::inline_v001::block_has_compact_records;
+    using jac::ts_store::inline_v001::block_has_string_dictionary;
+    using jac::ts_store::inline_v001::resolve_compact_records;
+    using jac::ts_store::inline_v001::compact_encode_records;
+    using jac::ts_store::inline_v001::compact_decode_records;
+    using jac::ts_store::inline_v001::block_records;
+    using jac::ts_store::inline_v001::kBinaryLogClosed;
+    using jac::ts_store::inline_v001::BinaryLogCommitPublisher;
+    using jac::ts_store::inline_v001::SlidingMmapWindowStats;
+    using jac::ts_store::inline_v001::SlidingMmapWindow;
+    using jac::ts_store::inline_v001::DirectFileWriterOptions;
+    using jac::ts_store::inline_v001::DirectFileWriterStats;
+    using jac::ts_store::inline_v001::DirectFileWriter;
+    using jac::ts_store::inline_v001::kDefaultBinaryBlockBytes;
+    using jac::ts_store::inline_v001::kMaxBinaryRecordBytes;
     using jac::ts_store::inline_v001::BinaryEventLogStats;
     using jac::ts_store::inline_v001::BinaryEventLog;
+    using jac::ts_store::inline_v001::SegmentPolicy;
+    using jac::ts_store::inline_v001::SegmentState;
+    using jac::ts_store::inline_v001::SegmentInfo;
+    using jac::ts_store::inline_v001::SegmentStats;
+    using jac::ts_store::inline_v001::segment_index_path;
+    using jac::ts_store::inline_v001::read_segment_index;
+    using jac::ts_store::inline_v001::SegmentedBinaryLog;
     using jac::ts_store::inline_v001::BinaryEventSink;
+    using jac::ts_store::inline_v001::kFixedSlotWritten;
+    using jac::ts_store::inline_v001::FixedStrideFileHeader;
+    using jac::ts_store::inline_v001::FixedSlotHeader;
+    using jac::ts_store::inline_v001::FixedStrideLayout;
+    using jac::ts_store::inline_v001::fixed_slot_crc;
+    using jac::ts_store::inline_v001::FixedStrideEventLogStats;
+    using jac::ts_store::inline_v001::FixedStrideEventLog;
+    using jac::ts_store::inline_v001::FixedStrideEventSink;
+    using jac::ts_store::inline_v001::BinaryLogCheckOptions;
+    using jac::ts_store::inline_v001::BinaryLogCheckReport;
+    using jac::ts_store::inline_v001::BinaryLogRepairResult;
+    using jac::ts_store::inline_v001::check_binary_log;
+    using jac::ts_store::inline_v001::repair_binary_log;
+    using jac::ts_store::inline_v001::ArrowIpcEventSinkStats;
+    using jac::ts_store::inline_v001::ArrowIpcEventSink;
+    using jac::ts_store::inline_v001::kDefaultColumnarGroupRows;
+    using jac::ts_store::inline_v001::ColumnType;
+    using jac::ts_store::inline_v001::ColumnEncoding;
+    using jac::ts_store::inline_v001::ColumnarFileHeader;
+    using jac::ts_store::inline_v001::ColumnarRowGroupHeader;
+    using jac::ts_store::inline_v001::ColumnarPageHeader;
+    using jac::ts_store::inline_v001::ColumnarIndexEntry;
+    using jac::ts_store::inline_v001::ColumnarSchema;
+    using jac::ts_store::inline_v001::ColumnarEventLogStats;
+    using jac::ts_store::inline_v001::ColumnarEventLog;
+    using jac::ts_store::inline_v001::ColumnarEventSink;
+    using jac::ts_store::inline_v001::ColumnarRange;
+    using jac::ts_store::inline_v001::ColumnarQuery;
+    using jac::ts_store::inline_v001::ColumnarScanStats;
+    using jac::ts_store::inline_v001::ColumnarColumn;
+    using jac::ts_store::inline_v001::ColumnarBatch;
+    using jac::ts_store::inline_v001::ColumnarLogReader;
 }
\ No newline at end of file
@@ -16,6 +16,12 @@ export module jac.ts_store.persistence.common;
 
 export namespace jac::ts_store::inline_v001 {
     using jac::ts_store::inline_v001::PersistMode;
+    using jac::ts_store::inline_v001::DurabilityLevel;
+    using jac::ts_store::inline_v001::FileOutputBackend;
+    using jac::ts_store::inline_v001::BinaryCompression;
+    using jac::ts_store::inline_v001::BinaryRecordEncoding;
+    using jac::ts_store::inline_v001::BinaryBloomFilters;
+    using jac::ts_store::inline_v001::SqlStringStorage;
     using jac::ts_store::inline_v001::PersistedEvent;
     using jac::ts_store::inline_v001::IEventSink;
     using jac::ts_store::inline_v001::FlagRoutingEventSink;
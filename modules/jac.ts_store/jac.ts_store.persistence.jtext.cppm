@@ -1,8 +1,14 @@
 module;
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <span>
 #include <string>
 #include <string_view>
@@ -10,6 +16,8 @@ module;
 
 #include <beman/ts_store/ts_store_headers/persistence/JTextSplitEventLog.hpp>
 #include <beman/ts_store/ts_store_headers/persistence/JTextEventSink.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/BinaryEventLogReader.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/BinaryLogMerge.hpp>
 
 export module jac.ts_store.persistence.jtext;
 
@@ -19,4 +27,10 @@ export namespace jac::ts_store::inline_v001 {
     using jac::ts_store::inline_v001::JTextSplitEventLogStats;
     using jac::ts_store::inline_v001::JTextSplitEventLog;
     using jac::ts_store::inline_v001::JTextEventSink;
+    using jac::ts_store::inline_v001::BinaryRecord;
+    using jac::ts_store::inline_v001::BinaryEventLogReader;
+    using jac::ts_store::inline_v001::MergeKey;
+    using jac::ts_store::inline_v001::BinaryLogMergeOptions;
+    using jac::ts_store::inline_v001::BinaryLogMergeStats;
+    using jac::ts_store::inline_v001::merge_binary_logs;
 }
\ No newline at end of file
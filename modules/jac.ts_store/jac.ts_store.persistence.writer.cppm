@@ -1,20 +1,45 @@
 module;
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstddef>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iterator>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <queue>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include <beman/ts_store/ts_store_headers/persistence/DoubleBufferedWriter.hpp>
+#include <beman/ts_store/ts_store_headers/persistence/ShardedWriter.hpp>
 
 export module jac.ts_store.persistence.writer;
 
 export import jac.ts_store.persistence.common;
 
 export namespace jac::ts_store::inline_v001 {
+    using jac::ts_store::inline_v001::SchedPolicy;
+    using jac::ts_store::inline_v001::ThreadPlacement;
+    using jac::ts_store::inline_v001::EffectivePlacement;
+    using jac::ts_store::inline_v001::format_cpu_list;
+    using jac::ts_store::inline_v001::DurableIdRun;
+    using jac::ts_store::inline_v001::DurableWatermark;
+    using jac::ts_store::inline_v001::DurabilityPolicy;
+    using jac::ts_store::inline_v001::AdaptiveBatchPolicy;
+    using jac::ts_store::inline_v001::BatchSizingStats;
+    using jac::ts_store::inline_v001::DoubleBufferedWriterOptions;
     using jac::ts_store::inline_v001::DoubleBufferedWriter;
+    using jac::ts_store::inline_v001::ShardSinkFactory;
+    using jac::ts_store::inline_v001::ShardedPersistenceWriter;
 }
\ No newline at end of file
@@ -0,0 +1,725 @@
+// tests/ts_store_009/test_009_XS.cpp
+//
+// XS variant of the binary log on-disk format stress: same layouts and cases as 009 TS, with
+// events that carry no timestamps (ts_store_config<false, ...>), so time seeks and time-range
+// index checks are skipped and compact timestamp deltas are all zero.
+// Full mode sizing from runner (currently 50×20k = 1M events × 1 run). See tests/test_params.txt.
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+import jac.ts_store.impl.testing;
+import jac.ts_store.persistence.binary;
+#ifdef TS_STORE_ENABLE_JTEXT_PERSIST
+import jac.ts_store.persistence.jtext;
+#endif
+
+using namespace jac::ts_store::inline_v001;
+using namespace std::chrono;
+namespace fs = std::filesystem;
+
+// XS: events carry no timestamps (all 0), as with ts_store_config<false, ...>.
+constexpr bool kUseTimestamps = false;
+constexpr size_t kIntMetrics = 3;
+constexpr size_t kDblMetrics = 2;
+constexpr size_t kBlockBytes = 16 * 1024;   // small blocks: many of them even in smoke mode
+
+size_t THREADS;
+size_t EVENTS_PER_THREAD;
+size_t TOTAL;
+size_t RUNS;
+
+namespace {
+
+size_t failures = 0;
+
+void check(bool ok, const std::string& what) {
+    if (!ok) {
+        ++failures;
+        std::cout << "    FAIL — " << what << "\n";
+    }
+}
+
+constexpr std::string_view kCategories[] = {"ORDER", "FILL", "QUOTE", "RISK", "ADMIN"};
+constexpr std::string_view kNeedleCategory = "AUDIT";
+constexpr std::string_view kNeedleWord = "zebracorn";
+
+struct LogLayout {
+    std::string_view name;
+    BinaryCompression compression;
+    BinaryRecordEncoding encoding;
+    BinaryBloomFilters bloom;
+};
+
+constexpr LogLayout kLayouts[] = {
+    {"raw",        BinaryCompression::None, BinaryRecordEncoding::Raw,     BinaryBloomFilters::None},
+    {"lz",         BinaryCompression::Lz,   BinaryRecordEncoding::Raw,     BinaryBloomFilters::None},
+    {"compact",    BinaryCompression::None, BinaryRecordEncoding::Compact, BinaryBloomFilters::Category},
+    {"compact_lz", BinaryCompression::Lz,   BinaryRecordEncoding::Compact, BinaryBloomFilters::Tokens},
+};
+
+void print_test_purpose() {
+    std::cout << "═══════════════════════════════════════════════════════════════\n";
+    std::cout << " TEST 009 " << (kUseTimestamps ? "TS" : "XS") << " — Binary log on-disk format stress\n";
+    std::cout << "═══════════════════════════════════════════════════════════════\n";
+    std::cout << " Purpose:\n";
+    std::cout << "   Round-trip, torn-tail and corrupt-block cases for every v2 block layout\n";
+    std::cout << "   (CRC32C framing, LZ blocks, compact records + dictionaries, Bloom filters),\n";
+    std::cout << "   through the seek index, repair / salvage, transcode and merge paths.\n\n";
+    std::cout << " Plan: " << format_locale_int(TOTAL) << " events × " << std::size(kLayouts)
+              << " layouts × " << RUNS << " runs, " << kBlockBytes / 1024 << " KiB blocks\n\n";
+}
+
+// Events in id order; thread ids round-robin like interleaved producers. Two needles (rare
+// category, rare payload word) sit at a third and two thirds of the log.
+std::vector<PersistedEvent> make_events(uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<PersistedEvent> events(TOTAL);
+    uint64_t ts = 1'000'000;
+    double price = 100.0;
+    for (size_t i = 0; i < TOTAL; ++i) {
+        PersistedEvent& e = events[i];
+        e.event_id = i;
+        e.thread_id = i % THREADS;
+        e.per_thread_event_id = i / THREADS;
+        e.flags = (i % 97 == 0) ? 4 : 1;
+        e.category = std::string(kCategories[rng() % std::size(kCategories)]);
+        e.payload = i % 3 == 0 ? "order " + std::to_string(i) + " accepted"
+                               : "heartbeat ok " + std::to_string(i % 11);
+        ts += 1 + rng() % 40;
+        e.timestamp_us = kUseTimestamps ? ts : 0;
+        price += static_cast<double>(static_cast<int>(rng() % 21) - 10) * 0.01;
+        e.int_metrics = {static_cast<int64_t>(i), static_cast<int64_t>(rng() % 1000), -static_cast<int64_t>(i / 7)};
+        e.dbl_metrics = {price, static_cast<double>(i % 8) * 0.25};
+    }
+    for (size_t i : {TOTAL / 3, 2 * TOTAL / 3}) {
+        events[i].category = std::string(kNeedleCategory);
+        events[i].payload = "alarm " + std::string(kNeedleWord) + " raised";
+    }
+    return events;
+}
+
+bool same_event(const BinaryRecordView& r, const PersistedEvent& e) {
+    if (r.event_id != e.event_id || r.thread_id != e.thread_id || r.per_thread_event_id != e.per_thread_event_id ||
+        r.raw_flags != e.flags || r.timestamp_us != e.timestamp_us || r.category != e.category ||
+        r.payload != e.payload || r.int_count != e.int_metrics.size() || r.dbl_count != e.dbl_metrics.size()) {
+        return false;
+    }
+    for (size_t k = 0; k < e.int_metrics.size(); ++k) {
+        if (r.int_metric(k) != e.int_metrics[k]) return false;
+    }
+    for (size_t k = 0; k < e.dbl_metrics.size(); ++k) {
+        if (std::bit_cast<uint64_t>(r.dbl_metric(k)) != std::bit_cast<uint64_t>(e.dbl_metrics[k])) return false;
+    }
+    return true;
+}
+
+bool same_event(const PersistedEvent& a, const PersistedEvent& e) {
+    return a.event_id == e.event_id && a.thread_id == e.thread_id &&
+           a.per_thread_event_id == e.per_thread_event_id && a.flags == e.flags &&
+           a.timestamp_us == e.timestamp_us && a.category == e.category && a.payload == e.payload &&
+           a.int_metrics == e.int_metrics &&
+           std::equal(a.dbl_metrics.begin(), a.dbl_metrics.end(), e.dbl_metrics.begin(), e.dbl_metrics.end(),
+                      [](double x, double y) { return std::bit_cast<uint64_t>(x) == std::bit_cast<uint64_t>(y); });
+}
+
+std::string write_log(const std::string& base, const LogLayout& layout, std::span<const PersistedEvent> events) {
+    BinaryEventLog log(base, kIntMetrics, kDblMetrics, PersistMode::All, 4 * 1024 * 1024, FileOutputBackend::Mmap,
+                       layout.compression, kBlockBytes, layout.encoding, layout.bloom);
+    for (const PersistedEvent& e : events) {
+        log.append_event(e.event_id, e.thread_id, e.per_thread_event_id, e.flags, e.category, e.payload,
+                         e.timestamp_us, e.int_metrics, e.dbl_metrics);
+    }
+    log.finalize();
+    if (layout.compression == BinaryCompression::Lz) {
+        check(log.stats().compressed_blocks > 0, std::string(layout.name) + ": no block was LZ-compressed");
+    }
+    if (layout.encoding == BinaryRecordEncoding::Compact) {
+        check(log.stats().compact_blocks == log.stats().blocks, std::string(layout.name) + ": raw blocks in a compact log");
+    }
+    return log.file_path();
+}
+
+struct ReadBack {
+    std::vector<uint64_t> ids;
+    size_t mismatches = 0;
+    size_t corrupt_blocks = 0;
+};
+
+ReadBack read_back(const std::string& path, const std::vector<PersistedEvent>& events) {
+    ReadBack rb;
+    MappedBinaryLogReader reader(path);
+    BinaryRecordView v;
+    while (reader.next(v)) {
+        if (v.event_id >= events.size() || !same_event(v, events[v.event_id])) ++rb.mismatches;
+        rb.ids.push_back(v.event_id);
+    }
+    rb.corrupt_blocks = reader.corrupt_blocks();
+    return rb;
+}
+
+std::vector<uint64_t> id_range(uint64_t first, uint64_t end) {
+    std::vector<uint64_t> ids;
+    for (uint64_t id = first; id < end; ++id) ids.push_back(id);
+    return ids;
+}
+
+std::string copy_log(const std::string& path, const std::string& suffix) {
+    const std::string out = path + suffix;
+    fs::copy_file(path, out, fs::copy_options::overwrite_existing);
+    return out;
+}
+
+void flip_byte(const std::string& path, size_t offset) {
+    std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+    f.seekg(static_cast<std::streamoff>(offset));
+    char c = 0;
+    f.get(c);
+    f.seekp(static_cast<std::streamoff>(offset));
+    f.put(static_cast<char>(c ^ 0x5A));
+}
+
+std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream s;
+    s << in.rdbuf();
+    return s.str();
+}
+
+// Collects transcode_binary_log_to_sink output.
+class CollectingSink : public IEventSink {
+public:
+    void write_batch(std::span<const PersistedEvent> batch) override {
+        rows.insert(rows.end(), batch.begin(), batch.end());
+    }
+    void flush() override {}
+    void finalize() override {}
+    std::string_view name() const override { return "CollectingSink"; }
+
+    std::vector<PersistedEvent> rows;
+};
+
+// ── CRC32C / codecs ────────────────────────────────────────────────────────────────────────
+
+uint32_t crc32c_bitwise(const unsigned char* p, size_t n) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < n; ++i) {
+        crc ^= p[i];
+        for (int b = 0; b < 8; ++b) crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+void test_crc32c(std::mt19937_64& rng) {
+    std::cout << "  CRC32C (block framing checksum)\n";
+    check(crc32c("123456789", 9) == 0xE3069283u, "crc32c check value of \"123456789\"");
+
+    // Sizes around the 3-stream stride of the hardware path, at every alignment.
+    std::vector<unsigned char> buf(3 * 4096 * 2 + 64);
+    for (auto& b : buf) b = static_cast<unsigned char>(rng());
+    size_t bad = 0;
+    for (size_t n : {size_t{0}, size_t{1}, size_t{7}, size_t{8}, size_t{63}, size_t{4095}, size_t{4096},
+                     size_t{3 * 4096 - 1}, size_t{3 * 4096}, size_t{3 * 4096 + 9}, size_t{2 * 3 * 4096}}) {
+        for (size_t align = 0; align < 8; ++align) {
+            const unsigned char* p = buf.data() + align;
+            const uint32_t want = crc32c_bitwise(p, n);
+            if (crc32c(p, n) != want) ++bad;
+            const size_t cut = n / 3;   // chained over two pieces
+            if (crc32c(crc32c(p, cut), p + cut, n - cut) != want) ++bad;
+        }
+    }
+    check(bad == 0, std::to_string(bad) + " CRC32C mismatches against the bitwise reference");
+}
+
+void test_lz_codec(std::mt19937_64& rng, size_t trials) {
+    std::cout << "  LZ codec round trip + bounds-checked decoder (" << trials << " buffers)\n";
+    constexpr size_t kGuard = 64;
+    constexpr char kCanary = '\x5C';
+    size_t not_shrunk = 0, bad_round_trip = 0, accepted_damage = 0, overruns = 0;
+    std::vector<char> src, out, dst;
+    for (size_t t = 0; t < trials; ++t) {
+        const size_t n = static_cast<size_t>(rng() % (t % 10 == 0 ? 256 * 1024 : 4096));
+        src.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            switch (t % 4) {
+                case 0:  src[i] = static_cast<char>(rng()); break;                       // incompressible
+                case 1:  src[i] = static_cast<char>('a' + rng() % 3); break;             // tiny alphabet
+                case 2:  src[i] = static_cast<char>(i % 7); break;                       // short period
+                default: src[i] = (i > 20 && rng() % 4 != 0) ? src[i - 1 - rng() % 20]  // overlapping matches
+                                                             : static_cast<char>(rng());
+            }
+        }
+        if (!compress_block(BlockCodec::Lz, src.data(), n, out)) {   // stored raw by the writer
+            if ((t % 4 == 1 || t % 4 == 2) && n >= 256) ++not_shrunk;   // must save 16 bytes
+            continue;
+        }
+
+        dst.assign(n + kGuard, kCanary);
+        if (!decompress_block(BlockCodec::Lz, out.data(), out.size(), dst.data(), n) ||
+            !std::equal(src.begin(), src.end(), dst.begin())) {
+            ++bad_round_trip;
+        }
+        // Wrong output sizes and truncated input must be refused.
+        if (n > 0 && decompress_block(BlockCodec::Lz, out.data(), out.size(), dst.data(), n - 1)) ++accepted_damage;
+        if (decompress_block(BlockCodec::Lz, out.data(), out.size() - 1, dst.data(), n)) ++accepted_damage;
+        // Bit flips may decode to something, but never past raw_n.
+        for (int k = 0; k < 4; ++k) {
+            std::vector<char> damaged = out;
+            damaged[rng() % damaged.size()] ^= static_cast<char>(1 + rng() % 255);
+            dst.assign(n + kGuard, kCanary);
+            (void)decompress_block(BlockCodec::Lz, damaged.data(), damaged.size(), dst.data(), n);
+            if (std::any_of(dst.begin() + static_cast<std::ptrdiff_t>(n), dst.end(), [](char c) { return c != kCanary; })) {
+                ++overruns;
+            }
+        }
+    }
+    check(not_shrunk == 0, std::to_string(not_shrunk) + " repetitive buffers did not LZ-compress");
+    check(bad_round_trip == 0, std::to_string(bad_round_trip) + " LZ round trips differ");
+    check(accepted_damage == 0, std::to_string(accepted_damage) + " truncated / mis-sized LZ inputs accepted");
+    check(overruns == 0, std::to_string(overruns) + " LZ decodes wrote past the output buffer");
+}
+
+// Damaged copies of one compact block fed straight to the decoder (no CRC in front of it).
+void fuzz_compact_block(const std::string& path, std::mt19937_64& rng, size_t trials) {
+    MappedBinaryLog log(path);
+    const BinaryLogIndex index = log.index();
+    if (index.empty()) return;
+    const BinaryIndexEntry& e = index.entries()[index.size() / 2];
+    BinaryBlockHeader h{};
+    std::memcpy(&h, log.data() + e.block_offset, sizeof(h));
+    const char* stored = log.data() + e.block_offset + sizeof(h);
+
+    std::vector<char> out, scratch;
+    const char* records = nullptr;
+    size_t record_bytes = 0;
+    check(block_records(h, stored, out, scratch, records, record_bytes), "intact compact block does not decode");
+
+    size_t accepted = 0;
+    for (size_t t = 0; t < trials; ++t) {
+        std::vector<char> s(stored, stored + h.stored_bytes);
+        for (size_t k = 0; k <= t % 5; ++k) s[rng() % s.size()] = static_cast<char>(rng());
+        if (t % 3 == 0) s.resize(static_cast<size_t>(rng() % s.size()));
+        BinaryBlockHeader damaged = h;
+        damaged.stored_bytes = static_cast<uint32_t>(s.size());
+        if (block_codec_of(h) == BlockCodec::None) damaged.raw_bytes = damaged.stored_bytes;
+        if (block_records(damaged, s.data(), out, scratch, records, record_bytes)) ++accepted;
+    }
+    std::cout << "    compact decoder fuzz: " << trials << " damaged blocks, " << accepted
+              << " still framed (CRC catches those)\n";
+}
+
+// Thread ids with the top byte set and flags above 0x7F take the compact escape path; every bit
+// must come back.
+void test_compact_wide_fields(const std::string& base) {
+    std::cout << "  compact records: 64-bit thread ids and flags\n";
+    std::vector<PersistedEvent> events(64);
+    for (size_t i = 0; i < events.size(); ++i) {
+        PersistedEvent& e = events[i];
+        e.event_id = i;
+        e.thread_id = i % 4 == 0 ? ~uint64_t{0} - i : (uint64_t{i} << 56) | i;
+        e.per_thread_event_id = i;
+        e.flags = i % 3 == 0 ? ~uint64_t{0} : uint64_t{1} << (i % 64);
+        e.category = "wide";
+        e.payload = "thread id " + std::to_string(e.thread_id);
+        e.timestamp_us = kUseTimestamps ? 1'000 + i : 0;
+        e.int_metrics = {static_cast<int64_t>(i), 0, 0};
+        e.dbl_metrics = {static_cast<double>(i), 0.0};
+    }
+    const std::string path = write_log(base + "_wide", kLayouts[2], events);
+    MappedBinaryLogReader reader(path);
+    BinaryRecordView v;
+    size_t n = 0, bad = 0;
+    for (; reader.next(v); ++n) {
+        if (v.event_id >= events.size() || !same_event(v, events[v.event_id])) ++bad;
+    }
+    check(n == events.size() && bad == 0, "compact: " + std::to_string(bad) + " wide thread ids / flags differ");
+    fs::remove(path);
+}
+
+// ── Per-layout cases ───────────────────────────────────────────────────────────────────────
+
+void test_round_trip(const std::string& path, const LogLayout& layout, const std::vector<PersistedEvent>& events) {
+    const std::string name(layout.name);
+    const ReadBack rb = read_back(path, events);
+    check(rb.ids == id_range(0, TOTAL), name + ": mapped reader did not return every id in order");
+    check(rb.mismatches == 0, name + ": " + std::to_string(rb.mismatches) + " records differ from what was written");
+
+    MappedBinaryLog log(path);
+    const BinaryLogScan scan = log.scan(4);
+    const BinaryLogSchema schema = log.schema();
+    check(scan.version == kBinaryLogVersion && schema.int_count == kIntMetrics && schema.dbl_count == kDblMetrics,
+          name + ": v2 preamble / schema block does not describe the log");
+    check(scan.block_offsets.size() > 1 && scan.dropped_bytes == 0 && scan.max_event_id == TOTAL - 1,
+          name + ": finalized log is not a clean multi-block file");
+
+    std::atomic<size_t> bad{0};
+    std::atomic<uint64_t> id_sum{0};
+    const ParallelScanResult pr = parallel_scan(log, [&](const BinaryRecordView& v) {
+        if (v.event_id >= events.size() || !same_event(v, events[v.event_id])) bad.fetch_add(1, std::memory_order_relaxed);
+        id_sum.fetch_add(v.event_id, std::memory_order_relaxed);
+    }, {.threads = 4});
+    check(pr.records_matched == TOTAL && pr.corrupt_units == 0 && bad.load() == 0 &&
+              id_sum.load() == uint64_t{TOTAL} * (TOTAL - 1) / 2,
+          name + ": parallel scan did not decode every record exactly once");
+
+    const BinaryLogCheckReport report = check_binary_log(path);
+    check(report.finalized && report.records_valid == TOTAL && report.first_error.empty() && report.tail_bytes == 0,
+          name + ": integrity check flags a clean log");
+
+    // Seek index: footer present, one entry per block, every probe lands on a block holding it.
+    MappedBinaryLogReader reader(path);
+    const BinaryLogIndex& index = reader.index();
+    check(index.from_footer(), name + ": index footer missing");
+    std::mt19937_64 rng(TOTAL);
+    std::vector<uint64_t> probes = {0, TOTAL / 2 + 1, TOTAL - 1};
+    for (int k = 0; k < 32; ++k) probes.push_back(rng() % TOTAL);
+    size_t missed = 0;
+    for (uint64_t target : probes) {
+        if (!reader.seek_to_event(target)) {
+            ++missed;
+            continue;
+        }
+        BinaryRecordView v;
+        bool found = false;
+        for (size_t steps = 0; !found && steps <= kBlockBytes && reader.next(v); ++steps) found = v.event_id == target;
+        if (!found) ++missed;
+        if constexpr (kUseTimestamps) {
+            const uint64_t ts = events[target].timestamp_us;
+            found = false;
+            if (reader.seek_to_time(ts)) {
+                while (!found && reader.next(v) && v.timestamp_us <= ts) found = v.event_id == target;
+            }
+            if (!found) ++missed;
+        }
+    }
+    check(missed == 0, name + ": " + std::to_string(missed) + " of " + std::to_string(probes.size()) + " index seeks missed");
+    reader.rewind();
+    check(!reader.seek_to_event(TOTAL + 5), name + ": seek past the last id succeeded");
+
+    // Without a valid footer the index is rebuilt from the block headers: same blocks, id ranges
+    // at least as wide as the footer's exact ones.
+    const std::string no_footer = copy_log(path, ".nofooter");
+    fs::resize_file(no_footer, fs::file_size(no_footer) - 3);
+    {
+        MappedBinaryLog nf(no_footer);
+        const BinaryLogIndex rebuilt = nf.index();
+        bool same = !rebuilt.from_footer() && rebuilt.size() == index.size();
+        for (size_t b = 0; same && b < rebuilt.size(); ++b) {
+            const BinaryIndexEntry& x = rebuilt.entries()[b];
+            const BinaryIndexEntry& y = index.entries()[b];
+            same = x.block_offset == y.block_offset && x.record_count == y.record_count &&
+                   x.min_event_id <= y.min_event_id && x.max_event_id >= y.max_event_id;
+        }
+        check(same, name + ": index rebuilt without the footer differs from the footer index");
+    }
+    fs::remove(no_footer);
+
+    // CSV transcode (parallel, ordered) matches a sequential rendering.
+    const std::string csv = path + ".csv";
+    const TranscodeResult tr = transcode_binary_log_to_csv(log, csv, kIntMetrics, kDblMetrics, {.threads = 4});
+    std::string want;
+    append_csv_header(want, kIntMetrics, kDblMetrics);
+    {
+        MappedBinaryLogReader seq(path);
+        BinaryRecordView v;
+        while (seq.next(v)) append_csv_row(want, v, kIntMetrics, kDblMetrics);
+    }
+    check(tr.scan.records_matched == TOTAL && read_file(csv) == want, name + ": CSV transcode differs");
+    fs::remove(csv);
+
+    CollectingSink sink;
+    const TranscodeResult ts = transcode_binary_log_to_sink(log, sink, {.threads = 4, .batch_rows = 1000});
+    bool same_rows = ts.scan.records_matched == TOTAL && sink.rows.size() == TOTAL;
+    for (size_t i = 0; same_rows && i < TOTAL; ++i) same_rows = same_event(sink.rows[i], events[i]);
+    check(same_rows, name + ": transcode to sink differs");
+}
+
+void test_torn_tail(const std::string& path, const LogLayout& layout, const std::vector<PersistedEvent>& events) {
+    const std::string name(layout.name);
+    size_t cut = 0;
+    size_t kept = 0;
+    {
+        MappedBinaryLog log(path);
+        const BinaryLogIndex index = log.index();
+        const BinaryIndexEntry& last = index.entries().back();
+        cut = (last.block_offset + log.data_end()) / 2;   // middle of the last block
+        kept = TOTAL - last.record_count;
+    }
+    const std::string torn = copy_log(path, ".torn");
+    fs::resize_file(torn, cut);
+    fs::resize_file(torn, cut + 64 * 1024);   // zero tail, as left by the preallocating writer
+
+    const ReadBack rb = read_back(torn, events);
+    check(rb.ids == id_range(0, kept) && rb.mismatches == 0, name + ": torn log does not read back its whole blocks");
+    {
+        MappedBinaryLog log(torn);
+        const BinaryLogScan scan = log.scan(4);
+        check(scan.records.size() == kept && scan.dropped_bytes > 0 && !log.index().from_footer(),
+              name + ": recovery scan of the torn log");
+    }
+
+    const BinaryLogCheckReport report = check_binary_log(torn);
+    check(!report.finalized && report.records_valid == kept && report.tail_bytes > 0 && !report.tail_zero,
+          name + ": integrity check of the torn log");
+
+    const BinaryLogRepairResult repaired = repair_binary_log(torn);
+    check(repaired.changed && repaired.index_written && repaired.records_kept == kept &&
+              repaired.size_after == fs::file_size(torn),
+          name + ": repair of the torn log");
+    const ReadBack after = read_back(torn, events);
+    check(after.ids == id_range(0, kept) && after.mismatches == 0, name + ": repaired log lost records");
+    const BinaryLogCheckReport clean = check_binary_log(torn);
+    check(clean.finalized && clean.records_valid == kept && clean.tail_bytes == 0, name + ": repaired log is not clean");
+    {
+        MappedBinaryLogReader reader(torn);
+        check(kept == 0 || (reader.index().from_footer() && reader.seek_to_event(kept - 1)),
+              name + ": repaired log has no usable index");
+    }
+    fs::remove(torn);
+}
+
+void test_corrupt_block(const std::string& path, const LogLayout& layout, const std::vector<PersistedEvent>& events) {
+    const std::string name(layout.name);
+    BinaryIndexEntry damaged{};
+    size_t blocks = 0;
+    size_t flip_at = 0;
+    {
+        MappedBinaryLog log(path);
+        const BinaryLogIndex index = log.index();
+        blocks = index.size();
+        if (blocks < 3) {
+            std::cout << "    (" << name << ": " << blocks << " blocks, corrupt-block case needs 3)\n";
+            return;
+        }
+        const size_t k = blocks / 2;
+        damaged = index.entries()[k];
+        const size_t body = damaged.block_offset + sizeof(BinaryBlockHeader);
+        flip_at = body + (index.entries()[k + 1].block_offset - body) / 2;
+    }
+    const std::string bad = copy_log(path, ".corrupt");
+    flip_byte(bad, flip_at);
+
+    const uint64_t first = damaged.min_event_id;
+    const uint64_t end = damaged.max_event_id + 1;
+    std::vector<uint64_t> survivors = id_range(0, first);
+    const std::vector<uint64_t> rest = id_range(end, TOTAL);
+    survivors.insert(survivors.end(), rest.begin(), rest.end());
+
+    // The sequential reader stops at the damaged block and counts it.
+    const ReadBack rb = read_back(bad, events);
+    check(rb.ids == id_range(0, first) && rb.mismatches == 0 && rb.corrupt_blocks == 1,
+          name + ": reader did not stop at the corrupt block");
+    {
+        MappedBinaryLog log(bad);
+        check(log.scan(4).records.size() == first, name + ": recovery scan did not stop at the corrupt block");
+    }
+
+    // The parallel scan skips it and delivers everything else.
+    {
+        MappedBinaryLog log(bad);
+        std::atomic<size_t> mismatches{0};
+        const ParallelScanResult pr = parallel_scan(log, [&](const BinaryRecordView& v) {
+            if (v.event_id >= events.size() || !same_event(v, events[v.event_id])) mismatches.fetch_add(1);
+        }, {.threads = 4});
+        check(pr.corrupt_units == 1 && pr.records_matched == survivors.size() && mismatches.load() == 0,
+              name + ": parallel scan of the corrupt log");
+    }
+
+    const BinaryLogCheckReport report = check_binary_log(bad, {.salvage = true});
+    check(report.first_error_offset == damaged.block_offset && report.records_valid == first &&
+              report.salvage_records == TOTAL - end && !report.first_error.empty(),
+          name + ": integrity check did not locate the corrupt block");
+
+    const BinaryLogRepairResult repaired = repair_binary_log(bad, {.salvage = true});
+    check(repaired.changed && repaired.records_kept == survivors.size() && repaired.blocks_kept == blocks - 1,
+          name + ": salvage repair");
+    const ReadBack after = read_back(bad, events);
+    check(after.ids == survivors && after.mismatches == 0 && after.corrupt_blocks == 0,
+          name + ": salvaged log does not hold every other block");
+    fs::remove(bad);
+}
+
+// Rare category / payload word: found exactly, and the Bloom filters let most blocks go unread.
+void test_bloom(const std::string& path, const LogLayout& layout) {
+    const std::string name(layout.name);
+    auto needle_scan = [](const MappedBinaryLog& log, bool by_token) {
+        ParallelScanOptions options{.threads = 4};
+        if (by_token) {
+            options.filter.tokens = std::string(kNeedleWord);
+        } else {
+            options.filter.category = std::string(kNeedleCategory);
+        }
+        return parallel_scan(log, [](const BinaryRecordView&) {}, options);
+    };
+
+    MappedBinaryLog log(path);
+    check(!log.bloom_filters().empty(), name + ": no Bloom filters in the footer");
+    for (bool by_token : {false, true}) {
+        if (by_token && layout.bloom != BinaryBloomFilters::Tokens) continue;
+        const ParallelScanResult pr = needle_scan(log, by_token);
+        check(pr.records_matched == 2, name + ": needle lookup found " + std::to_string(pr.records_matched) + " of 2");
+        if (pr.units_total >= 8) {
+            check(pr.units_pruned_by_bloom > 0, name + ": Bloom filters pruned no block");
+        }
+    }
+
+    // A damaged filter section is ignored: same answer, no Bloom pruning.
+    BinaryIndexFooter footer{};
+    check(log.index_footer(footer) && footer.bloom_bytes > 0, name + ": footer does not locate the Bloom section");
+    const std::string bad = copy_log(path, ".bloom");
+    flip_byte(bad, footer.index_offset - footer.bloom_bytes / 2);
+    {
+        MappedBinaryLog damaged(bad);
+        const ParallelScanResult pr = needle_scan(damaged, false);
+        check(damaged.bloom_filters().empty() && pr.records_matched == 2 && pr.units_pruned_by_bloom == 0,
+              name + ": damaged Bloom section was trusted");
+    }
+    fs::remove(bad);
+}
+
+#ifdef TS_STORE_ENABLE_JTEXT_PERSIST
+// Two overlapping logs merged by event id: each id written once, whole and in order; a torn or
+// corrupt input contributes its readable prefix.
+void test_merge(const std::string& base, const std::vector<PersistedEvent>& events) {
+    std::cout << "  merge with dedupe (two overlapping inputs)\n";
+    const size_t a_end = TOTAL * 6 / 10;
+    const size_t b_begin = TOTAL * 4 / 10;
+    const std::string a = write_log(base + "_merge_a", kLayouts[1], std::span(events).first(a_end));
+    const std::string b = write_log(base + "_merge_b", kLayouts[2], std::span(events).subspan(b_begin));
+
+    auto merged_ids = [&](const std::vector<std::string>& inputs, BinaryLogMergeStats& stats) {
+        stats = merge_binary_logs(inputs, base + "_merged", {.key = MergeKey::EventId});
+        return read_back(stats.output_path, events);
+    };
+
+    BinaryLogMergeStats stats;
+    ReadBack rb = merged_ids({a, b}, stats);
+    check(stats.records_written == TOTAL && stats.duplicates == a_end - b_begin && stats.corrupt_blocks == 0,
+          "merge: " + std::to_string(stats.records_written) + " written, " + std::to_string(stats.duplicates) + " duplicates");
+    check(rb.ids == id_range(0, TOTAL) && rb.mismatches == 0, "merge: output is not every event once, in id order");
+
+    // Corrupt block in the middle of input a: its later records are lost unless b has them.
+    {
+        MappedBinaryLog log(a);
+        const BinaryLogIndex index = log.index();
+        if (index.size() >= 3) {
+            const BinaryIndexEntry& e = index.entries()[index.size() / 2];
+            const std::string bad = copy_log(a, ".corrupt");
+            flip_byte(bad, e.block_offset + sizeof(BinaryBlockHeader) + 8);
+            rb = merged_ids({bad, b}, stats);
+            const uint64_t prefix = e.min_event_id;
+            std::vector<uint64_t> want = id_range(0, std::min<uint64_t>(prefix, b_begin));
+            const std::vector<uint64_t> tail = id_range(b_begin, TOTAL);
+            want.insert(want.end(), tail.begin(), tail.end());
+            check(stats.corrupt_blocks == 1 && rb.ids == want && rb.mismatches == 0,
+                  "merge: corrupt input block not contained");
+            fs::remove(bad);
+        }
+    }
+
+    // Torn input b: the merge stops reading it at its last whole block.
+    {
+        size_t cut = 0;
+        uint64_t kept_end = 0;
+        {
+            MappedBinaryLog log(b);
+            const BinaryLogIndex index = log.index();
+            const BinaryIndexEntry& last = index.entries().back();
+            cut = (last.block_offset + log.data_end()) / 2;
+            kept_end = std::max<uint64_t>(last.min_event_id, a_end);   // a still covers [0, a_end)
+        }
+        const std::string torn = copy_log(b, ".torn");
+        fs::resize_file(torn, cut);
+        rb = merged_ids({a, torn}, stats);
+        check(rb.ids == id_range(0, kept_end) && rb.mismatches == 0, "merge: torn input not cut at its last whole block");
+        fs::remove(torn);
+    }
+    fs::remove(stats.output_path);
+    fs::remove(a);
+    fs::remove(b);
+}
+#endif
+
+} // namespace
+
+int main(int argc, char** argv) {
+    auto opts = parse_test_options(argc, argv);
+
+    THREADS = opts.threads > 0 ? opts.threads : 10;
+    EVENTS_PER_THREAD = opts.events_per_thread > 0 ? opts.events_per_thread : 100;
+    // The needle, seek and compression cases need more than a handful of events.
+    EVENTS_PER_THREAD = std::max<size_t>(EVENTS_PER_THREAD, (64 + THREADS - 1) / THREADS);
+    TOTAL = THREADS * EVENTS_PER_THREAD;
+    RUNS = opts.runs > 0 ? opts.runs : 1;
+
+    if (std::cin.rdbuf()->in_avail() > 0) {
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+
+    print_test_purpose();
+
+    const std::string bname = (opts.base_name.empty() ? "persist" : opts.base_name) + "_009";
+    if (const fs::path dir = fs::path(bname).parent_path(); !dir.empty()) fs::create_directories(dir);
+
+    std::mt19937_64 rng(9);
+    test_crc32c(rng);
+    test_lz_codec(rng, std::clamp<size_t>(TOTAL / 10, 200, 5000));
+    test_compact_wide_fields(bname);
+
+    for (size_t run = 0; run < RUNS; ++run) {
+        std::cout << "\nRun " << (run + 1) << " / " << RUNS << "\n";
+        const std::vector<PersistedEvent> events = make_events(run + 1);
+
+        for (const LogLayout& layout : kLayouts) {
+            const auto t0 = steady_clock::now();
+            const std::string path = write_log(bname + "_" + std::string(layout.name), layout, events);
+            const auto write_us = duration_cast<microseconds>(steady_clock::now() - t0).count();
+
+            const auto t1 = steady_clock::now();
+            test_round_trip(path, layout, events);
+            test_torn_tail(path, layout, events);
+            test_corrupt_block(path, layout, events);
+            if (layout.bloom != BinaryBloomFilters::None) test_bloom(path, layout);
+            if (layout.encoding == BinaryRecordEncoding::Compact) fuzz_compact_block(path, rng, 500);
+            const auto check_us = duration_cast<microseconds>(steady_clock::now() - t1).count();
+
+            std::cout << "  " << std::string(layout.name) << ": "
+                      << format_locale_int(static_cast<std::uint64_t>(fs::file_size(path))) << " bytes, write "
+                      << format_locale_int(static_cast<std::uint64_t>(write_us)) << " µs, checks "
+                      << format_locale_int(static_cast<std::uint64_t>(check_us)) << " µs\n";
+            if (run + 1 < RUNS) fs::remove(path);   // the last run's logs stay for inspection
+        }
+
+#ifdef TS_STORE_ENABLE_JTEXT_PERSIST
+        test_merge(bname, events);
+#else
+        std::cout << "  (merge case skipped: needs TS_STORE_ENABLE_JTEXT_PERSIST=ON)\n";
+#endif
+    }
+
+    std::cout << "\n═══════════════════════════════════════════════════════════════\n";
+    if (failures != 0) {
+        std::cout << "  FAILED — " << failures << " format checks failed\n";
+        std::cout << "═══════════════════════════════════════════════════════════════\n";
+        return 1;
+    }
+    std::cout << "  PASS — " << format_locale_int(static_cast<std::uint64_t>(TOTAL))
+              << " events per layout: round trip, torn tail and corrupt block verified\n";
+    std::cout << "═══════════════════════════════════════════════════════════════\n";
+    return 0;
+}
@@ -0,0 +1,813 @@
+// tests/ts_store_010/test_010_TS.cpp
+//
+// On-disk format stress for the analytics outputs: the Arrow IPC file of ArrowIpcEventSink and
+// the columnar log (ColumnarEventLog / ColumnarLogReader). THREADS × EVENTS_PER_THREAD synthetic
+// events, some carrying fewer metrics than the schema, go through:
+//   Arrow IPC  round trip     every row read back bit-exact twice — walking the stream and
+//                             through the footer blocks — by a bounds-checked reader written here
+//                             from the spec (no libarrow); 64-byte body alignment
+//              torn tail      a copy taken before finalize, and the finished file cut inside its
+//                             last batch: the stream prefix keeps every whole batch
+//              corrupt        a damaged length prefix / message flatbuffer: the stream walk stops
+//                             there, the footer still reaches every other batch
+//   columnar   round trip     every column of every row (nulls included), raw and LZ pages
+//              pruning        id / time ranges skip row groups by the index, metric and thread
+//                             predicates by page statistics; results match a brute-force filter
+//              torn tail      last row group cut, footer gone: groups walked up to the torn one
+//              corrupt        a flipped page byte costs only the queries that read that page; a
+//                             damaged row group header ends the walk there
+// Full mode sizing from runner (currently 50×20k = 1M events × 1 run). See tests/test_params.txt.
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+import jac.ts_store.impl.testing;
+import jac.ts_store.persistence.binary;
+
+using namespace jac::ts_store::inline_v001;
+using namespace std::chrono;
+namespace fs = std::filesystem;
+
+// TS: events carry increasing microsecond timestamps, as with ts_store_config<true, ...>.
+constexpr bool kUseTimestamps = true;
+constexpr size_t kIntMetrics = 3;
+constexpr size_t kDblMetrics = 2;
+
+size_t THREADS;
+size_t EVENTS_PER_THREAD;
+size_t TOTAL;
+size_t RUNS;
+
+namespace {
+
+size_t failures = 0;
+
+void check(bool ok, const std::string& what) {
+    if (!ok) {
+        ++failures;
+        std::cout << "    FAIL — " << what << "\n";
+    }
+}
+
+constexpr std::string_view kCategories[] = {"ORDER", "FILL", "QUOTE", "RISK", "ADMIN"};
+constexpr std::string_view kNeedleCategory = "AUDIT";
+constexpr uint64_t kRareFlag = 4;
+
+struct ColumnarLayout {
+    std::string_view name;
+    BinaryCompression compression;
+};
+
+constexpr ColumnarLayout kColumnarLayouts[] = {
+    {"columnar_raw", BinaryCompression::None},
+    {"columnar_lz",  BinaryCompression::Lz},
+};
+
+void print_test_purpose() {
+    std::cout << "═══════════════════════════════════════════════════════════════\n";
+    std::cout << " TEST 010 " << (kUseTimestamps ? "TS" : "XS") << " — Arrow IPC / columnar on-disk format stress\n";
+    std::cout << "═══════════════════════════════════════════════════════════════\n";
+    std::cout << " Purpose:\n";
+    std::cout << "   Round-trip, torn-tail and corrupt cases for the Arrow IPC file and the\n";
+    std::cout << "   columnar log, plus row group pruning by index and page statistics.\n\n";
+    std::cout << " Plan: " << format_locale_int(TOTAL) << " events × (1 Arrow file + "
+              << std::size(kColumnarLayouts) << " columnar logs) × " << RUNS << " runs\n\n";
+}
+
+// Events in id order; thread ids round-robin like interleaved producers. Every 50th event has
+// one int metric and no doubles (columnar nulls, Arrow zeros); two needles carry a rare category.
+std::vector<PersistedEvent> make_events(uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<PersistedEvent> events(TOTAL);
+    uint64_t ts = 1'000'000;
+    double price = 100.0;
+    for (size_t i = 0; i < TOTAL; ++i) {
+        PersistedEvent& e = events[i];
+        e.event_id = i;
+        e.thread_id = i % THREADS;
+        e.per_thread_event_id = i / THREADS;
+        e.flags = (i % 97 == 0) ? kRareFlag : 1;
+        e.category = std::string(kCategories[rng() % std::size(kCategories)]);
+        e.payload = i % 3 == 0 ? "order " + std::to_string(i) + " accepted"
+                               : "heartbeat ok " + std::to_string(i % 11);
+        ts += 1 + rng() % 40;
+        e.timestamp_us = kUseTimestamps ? ts : 0;
+        price += static_cast<double>(static_cast<int>(rng() % 21) - 10) * 0.01;
+        if (i % 50 == 49) {
+            e.int_metrics = {static_cast<int64_t>(i)};
+        } else {
+            e.int_metrics = {static_cast<int64_t>(i), static_cast<int64_t>(rng() % 1000), -static_cast<int64_t>(i / 7)};
+            e.dbl_metrics = {price, static_cast<double>(i % 8) * 0.25};
+        }
+    }
+    for (size_t i : {TOTAL / 3, 2 * TOTAL / 3}) events[i].category = std::string(kNeedleCategory);
+    return events;
+}
+
+std::vector<uint64_t> id_range(uint64_t first, uint64_t end) {
+    std::vector<uint64_t> ids;
+    for (uint64_t id = first; id < end; ++id) ids.push_back(id);
+    return ids;
+}
+
+std::string copy_file(const std::string& path, const std::string& suffix) {
+    const std::string out = path + suffix;
+    fs::copy_file(path, out, fs::copy_options::overwrite_existing);
+    return out;
+}
+
+void patch_file(const std::string& path, size_t offset, const void* bytes, size_t n) {
+    std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(static_cast<std::streamoff>(offset));
+    f.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(n));
+}
+
+void flip_byte(const std::string& path, size_t offset) {
+    std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+    f.seekg(static_cast<std::streamoff>(offset));
+    char c = 0;
+    f.get(c);
+    f.seekp(static_cast<std::streamoff>(offset));
+    f.put(static_cast<char>(c ^ 0x5A));
+}
+
+std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream s;
+    s << in.rdbuf();
+    return s.str();
+}
+
+// ── Arrow IPC reader ───────────────────────────────────────────────────────────────────────
+// Independent of ArrowIpcFormat.hpp: FlatBuffers tables are read from the wire layout, and
+// every offset is checked against its buffer, so damaged files fail with Malformed instead of
+// reading out of bounds.
+
+struct Malformed : std::runtime_error {
+    Malformed() : std::runtime_error("malformed Arrow IPC data") {}
+};
+
+template <class T>
+T load(std::string_view buf, size_t at) {
+    if (at > buf.size() || buf.size() - at < sizeof(T)) throw Malformed();
+    T v;
+    std::memcpy(&v, buf.data() + at, sizeof(T));
+    return v;
+}
+
+// A table inside a FlatBuffers buffer: soffset to its vtable, then the fields.
+class FlatTable {
+public:
+    FlatTable(std::string_view buf, size_t pos) : buf_(buf), pos_(pos) {
+        const auto soffset = load<int32_t>(buf_, pos_);
+        const auto vt = static_cast<int64_t>(pos_) - soffset;
+        if (vt < 0) throw Malformed();
+        vtable_ = static_cast<size_t>(vt);
+        vtable_size_ = load<uint16_t>(buf_, vtable_);
+        if (vtable_size_ < 4 || vtable_size_ % 2 != 0) throw Malformed();
+    }
+
+    static FlatTable root(std::string_view buf) { return {buf, load<uint32_t>(buf, 0)}; }
+
+    template <class T>
+    T scalar(size_t field, T fallback = {}) const {
+        const size_t at = field_pos(field);
+        return at == 0 ? fallback : load<T>(buf_, at);
+    }
+
+    FlatTable table(size_t field) const { return {buf_, target(field)}; }
+
+    std::string_view string(size_t field) const {
+        const size_t at = target(field);
+        const auto n = load<uint32_t>(buf_, at);
+        if (buf_.size() - at - 4 < n) throw Malformed();
+        return buf_.substr(at + 4, n);
+    }
+
+    // Vector of `elem`-byte items: (position of the first, count).
+    std::pair<size_t, size_t> vector(size_t field, size_t elem) const {
+        const size_t at = target(field);
+        const auto n = load<uint32_t>(buf_, at);
+        if ((buf_.size() - at - 4) / elem < n) throw Malformed();
+        return {at + 4, n};
+    }
+
+    std::string_view buffer() const { return buf_; }
+
+private:
+    size_t field_pos(size_t field) const {
+        if (4 + 2 * field >= vtable_size_) return 0;
+        const auto off = load<uint16_t>(buf_, vtable_ + 4 + 2 * field);
+        return off == 0 ? 0 : pos_ + off;
+    }
+
+    size_t target(size_t field) const {
+        const size_t at = field_pos(field);
+        if (at == 0) throw Malformed();
+        return at + load<uint32_t>(buf_, at);
+    }
+
+    std::string_view buf_;
+    size_t pos_;
+    size_t vtable_ = 0;
+    uint16_t vtable_size_ = 0;
+};
+
+constexpr uint8_t kHeaderSchema = 1;
+constexpr uint8_t kHeaderRecordBatch = 3;
+
+struct ArrowBlockRef {
+    uint64_t offset = 0;
+    uint64_t metadata_length = 0;
+    uint64_t body_length = 0;
+    bool operator==(const ArrowBlockRef&) const = default;
+};
+
+struct ArrowFileRead {
+    bool magic = false;
+    bool end_of_stream = false;                 // 0xFFFFFFFF 0 seen by the stream walk
+    bool footer = false;                        // footer and trailing magic present
+    std::vector<std::string> columns;
+    std::vector<ArrowBlockRef> stream_batches;  // found by walking the stream
+    std::vector<PersistedEvent> stream_rows;
+    std::vector<ArrowBlockRef> footer_batches;  // listed in the footer
+    std::vector<PersistedEvent> footer_rows;    // decoded through the footer blocks
+    size_t footer_batches_bad = 0;              // footer blocks that did not decode
+    size_t misaligned = 0;                      // bodies / buffers off their alignment
+};
+
+// Record batch message `msg` with its body at file offset `body`: rows appended to `out`.
+void decode_record_batch(std::string_view file, const FlatTable& msg, size_t body, size_t& misaligned,
+                         std::vector<PersistedEvent>& out) {
+    const auto body_length = msg.scalar<int64_t>(3);
+    if (body_length < 0 || body > file.size() || file.size() - body < static_cast<uint64_t>(body_length)) {
+        throw Malformed();
+    }
+    const std::string_view data = file.substr(body, static_cast<size_t>(body_length));
+    if (body % 64 != 0) ++misaligned;
+
+    const FlatTable batch = msg.table(2);
+    const auto rows = batch.scalar<int64_t>(0);
+    const auto [nodes_at, node_count] = batch.vector(1, 16);
+    const auto [buffers_at, buffer_count] = batch.vector(2, 16);
+    // Nodes: 4 uint64, 2 utf8, timestamp, then list + item for ints and for dbls. Buffers: validity
+    // + data per fixed-width node, validity + offsets + data per utf8 node, validity per list node.
+    if (rows < 0 || node_count != 11 || buffer_count != 22) throw Malformed();
+    const std::string_view meta = batch.buffer();
+    const auto n = static_cast<size_t>(rows);
+    for (size_t k = 0; k < node_count; ++k) {
+        const auto length = load<int64_t>(meta, nodes_at + 16 * k);
+        const auto nulls = load<int64_t>(meta, nodes_at + 16 * k + 8);
+        const size_t items = k == 8 ? n * kIntMetrics : (k == 10 ? n * kDblMetrics : n);
+        if (length != static_cast<int64_t>(items) || nulls != 0) throw Malformed();
+    }
+    // Buffer `b` of the body, at least `min_bytes` long.
+    auto buffer = [&](size_t b, size_t min_bytes) {
+        const auto off = load<int64_t>(meta, buffers_at + 16 * b);
+        const auto len = load<int64_t>(meta, buffers_at + 16 * b + 8);
+        if (off < 0 || len < 0 || static_cast<uint64_t>(off) > data.size() ||
+            data.size() - static_cast<size_t>(off) < static_cast<uint64_t>(len) ||
+            static_cast<uint64_t>(len) < min_bytes) {
+            throw Malformed();
+        }
+        if (off % 8 != 0) ++misaligned;
+        return data.substr(static_cast<size_t>(off), static_cast<size_t>(len));
+    };
+    const std::string_view ids = buffer(1, n * 8), threads = buffer(3, n * 8), per_thread = buffer(5, n * 8);
+    const std::string_view flags = buffer(7, n * 8), ts = buffer(15, n * 8);
+    const std::string_view cat_off = buffer(9, (n + 1) * 4), cat = buffer(10, 0);
+    const std::string_view pay_off = buffer(12, (n + 1) * 4), pay = buffer(13, 0);
+    const std::string_view ints = buffer(18, n * kIntMetrics * 8), dbls = buffer(21, n * kDblMetrics * 8);
+
+    auto text = [&](std::string_view offsets, std::string_view chars, size_t r) {
+        const auto b = load<int32_t>(offsets, r * 4);
+        const auto e = load<int32_t>(offsets, r * 4 + 4);
+        if (b < 0 || e < b || static_cast<size_t>(e) > chars.size()) throw Malformed();
+        return std::string(chars.substr(static_cast<size_t>(b), static_cast<size_t>(e - b)));
+    };
+    for (size_t r = 0; r < n; ++r) {
+        PersistedEvent e;
+        e.event_id = load<uint64_t>(ids, r * 8);
+        e.thread_id = load<uint64_t>(threads, r * 8);
+        e.per_thread_event_id = load<uint64_t>(per_thread, r * 8);
+        e.flags = load<uint64_t>(flags, r * 8);
+        e.timestamp_us = load<uint64_t>(ts, r * 8);
+        e.category = text(cat_off, cat, r);
+        e.payload = text(pay_off, pay, r);
+        for (size_t k = 0; k < kIntMetrics; ++k) e.int_metrics.push_back(load<int64_t>(ints, (r * kIntMetrics + k) * 8));
+        for (size_t k = 0; k < kDblMetrics; ++k) e.dbl_metrics.push_back(load<double>(dbls, (r * kDblMetrics + k) * 8));
+        out.push_back(std::move(e));
+    }
+}
+
+// Message at `at` whose metadata (marker and length prefix included) is `metadata_length` bytes:
+// a schema fills read.columns, a record batch appends its rows to `rows`. Returns its block.
+ArrowBlockRef read_message(std::string_view file, size_t at, uint64_t metadata_length, ArrowFileRead& read,
+                           std::vector<PersistedEvent>& rows) {
+    const std::string_view meta = file.substr(at + 8, static_cast<size_t>(metadata_length - 8));
+    const FlatTable msg = FlatTable::root(meta);
+    const auto type = msg.scalar<uint8_t>(1);
+    const size_t body = at + static_cast<size_t>(metadata_length);
+    if (type == kHeaderSchema) {
+        const FlatTable schema = msg.table(2);
+        const auto [fields_at, field_count] = schema.vector(1, 4);
+        read.columns.clear();
+        for (size_t k = 0; k < field_count; ++k) {
+            const size_t slot = fields_at + 4 * k;
+            read.columns.emplace_back(FlatTable(meta, slot + load<uint32_t>(meta, slot)).string(0));
+        }
+    } else if (type == kHeaderRecordBatch) {
+        decode_record_batch(file, msg, body, read.misaligned, rows);
+    } else {
+        throw Malformed();
+    }
+    return {at, metadata_length, static_cast<uint64_t>(msg.scalar<int64_t>(3))};
+}
+
+ArrowFileRead read_arrow_file(const std::string& path) {
+    const std::string bytes = read_file(path);
+    const std::string_view file = bytes;
+    ArrowFileRead read;
+    read.magic = file.substr(0, 6) == "ARROW1";
+    if (!read.magic) return read;
+
+    // Stream walk: continuation marker, metadata length, metadata, body; until EOS or damage.
+    size_t at = 8;
+    bool schema = false;
+    try {
+        while (true) {
+            if (load<uint32_t>(file, at) != 0xFFFFFFFFu) break;
+            const auto len = load<int32_t>(file, at + 4);
+            if (len == 0) {
+                read.end_of_stream = true;
+                break;
+            }
+            if (len < 0 || file.size() - at - 8 < static_cast<size_t>(len)) break;
+            std::vector<PersistedEvent> rows;
+            const ArrowBlockRef block = read_message(file, at, 8 + static_cast<uint64_t>(len), read, rows);
+            if (schema) {
+                read.stream_batches.push_back(block);
+                read.stream_rows.insert(read.stream_rows.end(), rows.begin(), rows.end());
+            }
+            schema = true;
+            at += static_cast<size_t>(block.metadata_length + block.body_length);
+        }
+    } catch (const Malformed&) {
+    }
+
+    // Footer: int32 length and magic at the end; field 3 lists (offset, metadata length, body length).
+    if (file.size() < 16 || file.substr(file.size() - 6) != "ARROW1") return read;
+    try {
+        const auto footer_len = load<int32_t>(file, file.size() - 10);
+        if (footer_len <= 0 || static_cast<size_t>(footer_len) > file.size() - 18) return read;
+        const std::string_view footer = file.substr(file.size() - 10 - static_cast<size_t>(footer_len),
+                                                    static_cast<size_t>(footer_len));
+        const auto [blocks_at, block_count] = FlatTable::root(footer).vector(3, 24);
+        read.footer = true;
+        for (size_t k = 0; k < block_count; ++k) {
+            const size_t b = blocks_at + 24 * k;
+            read.footer_batches.push_back({static_cast<uint64_t>(load<int64_t>(footer, b)),
+                                           static_cast<uint64_t>(load<int32_t>(footer, b + 8)),
+                                           static_cast<uint64_t>(load<int64_t>(footer, b + 16))});
+        }
+    } catch (const Malformed&) {
+        read.footer = false;
+        return read;
+    }
+    for (const ArrowBlockRef& block : read.footer_batches) {
+        std::vector<PersistedEvent> rows;
+        try {
+            if (block.metadata_length < 8 || block.offset > file.size() ||
+                file.size() - block.offset < block.metadata_length) {
+                throw Malformed();
+            }
+            read_message(file, static_cast<size_t>(block.offset), block.metadata_length, read, rows);
+            read.footer_rows.insert(read.footer_rows.end(), rows.begin(), rows.end());
+        } catch (const Malformed&) {
+            ++read.footer_batches_bad;
+        }
+    }
+    return read;
+}
+
+// Arrow rows hold exactly kIntMetrics / kDblMetrics values; missing ones read as 0.
+bool same_arrow_row(const PersistedEvent& a, const PersistedEvent& e) {
+    if (a.event_id != e.event_id || a.thread_id != e.thread_id || a.per_thread_event_id != e.per_thread_event_id ||
+        a.flags != e.flags || a.timestamp_us != e.timestamp_us || a.category != e.category || a.payload != e.payload) {
+        return false;
+    }
+    for (size_t k = 0; k < kIntMetrics; ++k) {
+        if (a.int_metrics[k] != (k < e.int_metrics.size() ? e.int_metrics[k] : 0)) return false;
+    }
+    for (size_t k = 0; k < kDblMetrics; ++k) {
+        const double want = k < e.dbl_metrics.size() ? e.dbl_metrics[k] : 0.0;
+        if (std::bit_cast<uint64_t>(a.dbl_metrics[k]) != std::bit_cast<uint64_t>(want)) return false;
+    }
+    return true;
+}
+
+// `rows` are events[0, count) in order, minus those in [skip_begin, skip_end).
+bool rows_are(const std::vector<PersistedEvent>& rows, const std::vector<PersistedEvent>& events, size_t count,
+              size_t skip_begin = 0, size_t skip_end = 0) {
+    if (rows.size() != count - (skip_end - skip_begin)) return false;
+    size_t r = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (i >= skip_begin && i < skip_end) continue;
+        if (!same_arrow_row(rows[r++], events[i])) return false;
+    }
+    return true;
+}
+
+void test_arrow(const std::string& base, const std::vector<PersistedEvent>& events, std::mt19937_64& rng) {
+    std::cout << "  Arrow IPC file\n";
+    const auto t0 = steady_clock::now();
+
+    // Batches of uneven sizes, as drained by a writer thread; a copy is taken before the last one.
+    std::vector<size_t> batch_rows;
+    std::string path, live;
+    ArrowIpcEventSinkStats stats;
+    {
+        ArrowIpcEventSink sink(base + "_arrow", kIntMetrics, kDblMetrics);
+        path = sink.file_path();
+        const size_t max_batch = std::max<size_t>(1, TOTAL / 8);
+        for (size_t at = 0; at < TOTAL;) {
+            const size_t n = std::min(TOTAL - at, 1 + static_cast<size_t>(rng() % max_batch));
+            if (at + n == TOTAL) {
+                sink.sync();
+                live = copy_file(path, ".live");
+            }
+            sink.write_batch(std::span(events).subspan(at, n));
+            batch_rows.push_back(n);
+            at += n;
+        }
+        sink.finalize();
+        stats = sink.stats();
+    }
+    const auto write_us = duration_cast<microseconds>(steady_clock::now() - t0).count();
+    const size_t batches = batch_rows.size();
+    const size_t last_rows = batch_rows.back();
+
+    // Round trip.
+    const ArrowFileRead read = read_arrow_file(path);
+    check(stats.rows_written == TOTAL && stats.record_batches == batches, "arrow: sink stats");
+    check(read.magic && read.end_of_stream && read.footer, "arrow: file framing (magic, end of stream, footer)");
+    check(read.columns == std::vector<std::string>{"event_id", "thread_id", "per_thread_event_id", "flags_raw",
+                                                   "category", "payload", "timestamp_us", "ints", "dbls"},
+          "arrow: schema columns");
+    check(read.stream_batches.size() == batches && rows_are(read.stream_rows, events, TOTAL),
+          "arrow: stream walk did not read back every row");
+    check(read.footer_batches == read.stream_batches && read.footer_batches_bad == 0 &&
+              rows_are(read.footer_rows, events, TOTAL),
+          "arrow: footer blocks do not match the stream");
+    check(read.misaligned == 0, "arrow: " + std::to_string(read.misaligned) + " misaligned bodies / buffers");
+
+    // Crash before finalize: everything after the magic is still a stream, minus its end marker.
+    {
+        const ArrowFileRead r = read_arrow_file(live);
+        check(r.magic && !r.end_of_stream && !r.footer && r.stream_batches.size() == batches - 1 &&
+                  rows_are(r.stream_rows, events, TOTAL - last_rows),
+              "arrow: unfinalized file does not read as a stream of its whole batches");
+        fs::remove(live);
+    }
+
+    // Torn last batch: cut inside its length prefix, its metadata and its body.
+    const ArrowBlockRef last = read.stream_batches.back();
+    for (const uint64_t cut : {last.offset + 6, last.offset + last.metadata_length / 2,
+                               last.offset + last.metadata_length + last.body_length / 2}) {
+        const std::string torn = copy_file(path, ".torn");
+        fs::resize_file(torn, cut);
+        const ArrowFileRead r = read_arrow_file(torn);
+        check(!r.footer && r.stream_batches.size() == batches - 1 && rows_are(r.stream_rows, events, TOTAL - last_rows),
+              "arrow: torn file (cut at " + std::to_string(cut) + ") does not keep its whole batches");
+        fs::remove(torn);
+    }
+
+    // Damage in a middle batch: the walk stops there; the footer still locates the other batches.
+    if (batches >= 3) {
+        const size_t k = batches / 2;
+        const ArrowBlockRef victim = read.stream_batches[k];
+        size_t before = 0;
+        for (size_t b = 0; b < k; ++b) before += batch_rows[b];
+
+        const std::string bad = copy_file(path, ".corrupt");
+        const int32_t huge = 0x7FFFFFF0;
+        patch_file(bad, static_cast<size_t>(victim.offset) + 4, &huge, sizeof(huge));
+        ArrowFileRead r = read_arrow_file(bad);
+        check(r.stream_batches.size() == k && rows_are(r.stream_rows, events, before),
+              "arrow: damaged length prefix not contained by the stream walk");
+        check(r.footer && r.footer_batches_bad == 0 && rows_are(r.footer_rows, events, TOTAL),
+              "arrow: footer blocks do not bypass a damaged length prefix");
+
+        fs::copy_file(path, bad, fs::copy_options::overwrite_existing);
+        const uint32_t wild = 0xFFFFFF00u;   // root table offset far outside the message
+        patch_file(bad, static_cast<size_t>(victim.offset) + 8, &wild, sizeof(wild));
+        r = read_arrow_file(bad);
+        check(r.stream_batches.size() == k && rows_are(r.stream_rows, events, before),
+              "arrow: damaged message not contained by the stream walk");
+        check(r.footer && r.footer_batches_bad == 1 && rows_are(r.footer_rows, events, TOTAL, before, before + batch_rows[k]),
+              "arrow: footer read of a damaged message");
+        fs::remove(bad);
+    } else {
+        std::cout << "    (arrow: " << batches << " batches, corrupt case needs 3)\n";
+    }
+
+    std::cout << "  arrow: " << format_locale_int(static_cast<std::uint64_t>(fs::file_size(path))) << " bytes, "
+              << batches << " batches, write " << format_locale_int(static_cast<std::uint64_t>(write_us)) << " µs\n";
+}
+
+// ── Columnar log ───────────────────────────────────────────────────────────────────────────
+
+struct ColumnarRead {
+    std::vector<uint64_t> ids;
+    size_t mismatches = 0;
+    ColumnarScanStats stats;
+};
+
+// Rows of `query`, each checked against the event it claims to be (for every decoded column).
+ColumnarRead scan_columnar(const ColumnarLogReader& reader, const ColumnarQuery& query,
+                           const std::vector<PersistedEvent>& events) {
+    ColumnarRead out;
+    out.stats = reader.scan(query, [&](const ColumnarBatch& batch) {
+        const ColumnarSchema& schema = batch.schema();
+        const ColumnarColumn& ids = batch.column("event_id");
+        for (const uint32_t r : batch.selection()) {
+            const uint64_t id = ids.u64(r);
+            out.ids.push_back(id);
+            if (id >= events.size()) {
+                ++out.mismatches;
+                continue;
+            }
+            const PersistedEvent& e = events[id];
+            bool same = true;
+            for (size_t c = 0; c < schema.column_count() && same; ++c) {
+                if (!query.columns.empty() &&
+                    std::find(query.columns.begin(), query.columns.end(), schema.name(c)) == query.columns.end()) {
+                    continue;
+                }
+                const ColumnarColumn& col = batch.column(c);
+                switch (c) {
+                    case ColumnarSchema::kEventId:          same = col.u64(r) == e.event_id; break;
+                    case ColumnarSchema::kThreadId:         same = col.u64(r) == e.thread_id; break;
+                    case ColumnarSchema::kPerThreadEventId: same = col.u64(r) == e.per_thread_event_id; break;
+                    case ColumnarSchema::kFlags:            same = col.u64(r) == e.flags; break;
+                    case ColumnarSchema::kTimestamp:        same = col.u64(r) == e.timestamp_us; break;
+                    case ColumnarSchema::kCategory:         same = col.strings[r] == e.category; break;
+                    case ColumnarSchema::kPayload:          same = col.strings[r] == e.payload; break;
+                    default:
+                        if (c < schema.dbl_column(0)) {
+                            const size_t k = c - schema.int_column(0);
+                            same = k < e.int_metrics.size() ? col.is_valid(r) && col.i64(r) == e.int_metrics[k]
+                                                            : !col.is_valid(r);
+                        } else {
+                            const size_t k = c - schema.dbl_column(0);
+                            same = k < e.dbl_metrics.size()
+                                       ? col.is_valid(r) && col.values[r] == std::bit_cast<uint64_t>(e.dbl_metrics[k])
+                                       : !col.is_valid(r);
+                        }
+                }
+            }
+            if (!same) ++out.mismatches;
+        }
+    });
+    return out;
+}
+
+// Ids of the events `keep` accepts, in order.
+template <class Keep>
+std::vector<uint64_t> brute_force(const std::vector<PersistedEvent>& events, Keep keep) {
+    std::vector<uint64_t> ids;
+    for (const PersistedEvent& e : events) {
+        if (keep(e)) ids.push_back(e.event_id);
+    }
+    return ids;
+}
+
+void test_columnar_pruning(const ColumnarLogReader& reader, const ColumnarLayout& layout,
+                           const std::vector<PersistedEvent>& events) {
+    const std::string name(layout.name);
+    const size_t groups = reader.row_groups().size();
+    const uint64_t lo = TOTAL / 2;
+    const uint64_t hi = std::min<uint64_t>(lo + 10, TOTAL - 1);
+
+    // Id range: the index alone leaves at most the two groups around it.
+    ColumnarQuery q;
+    q.from_event_id = lo;
+    q.to_event_id = hi;
+    ColumnarRead r = scan_columnar(reader, q, events);
+    check(r.ids == id_range(lo, hi + 1) && r.mismatches == 0, name + ": id range query");
+    check(r.stats.groups_pruned_by_index + 2 >= groups, name + ": id range did not prune row groups by the index");
+
+    if constexpr (kUseTimestamps) {
+        q = {};
+        q.from_timestamp_us = events[lo].timestamp_us;
+        q.to_timestamp_us = events[hi].timestamp_us;
+        r = scan_columnar(reader, q, events);
+        check(r.ids == id_range(lo, hi + 1) && r.mismatches == 0, name + ": time range query");
+        check(r.stats.groups_pruned_by_index + 2 >= groups, name + ": time range did not prune row groups by the index");
+    }
+
+    // int0 == event id: the same range through page statistics only.
+    q = {};
+    q.ranges.push_back({"int0", static_cast<double>(lo), static_cast<double>(hi)});
+    r = scan_columnar(reader, q, events);
+    check(r.ids == id_range(lo, hi + 1) && r.mismatches == 0, name + ": metric range query");
+    check(r.stats.groups_pruned_by_index == 0 && r.stats.groups_pruned_by_pages + 2 >= groups,
+          name + ": metric range did not prune row groups by page statistics");
+
+    // A column with nulls: null rows never match, even an unbounded range.
+    q = {};
+    q.ranges.push_back({"dbl1"});
+    r = scan_columnar(reader, q, events);
+    check(r.ids == brute_force(events, [](const PersistedEvent& e) { return e.dbl_metrics.size() > 1; }) &&
+              r.mismatches == 0,
+          name + ": range over a column with nulls");
+
+    // Predicates on category, thread and flags, restricted to two columns.
+    q = {};
+    q.columns = {"event_id", "payload"};
+    q.category = std::string(kNeedleCategory);
+    r = scan_columnar(reader, q, events);
+    check(r.ids == brute_force(events, [](const PersistedEvent& e) { return e.category == kNeedleCategory; }) &&
+              r.mismatches == 0,
+          name + ": category query");
+
+    q = {};
+    q.thread_id = THREADS / 2;
+    q.flag_mask = kRareFlag;
+    r = scan_columnar(reader, q, events);
+    check(r.ids == brute_force(events, [](const PersistedEvent& e) {
+              return e.thread_id == THREADS / 2 && (e.flags & kRareFlag) != 0;
+          }) && r.mismatches == 0,
+          name + ": thread + flag query");
+}
+
+void test_columnar(const std::string& base, const ColumnarLayout& layout, const std::vector<PersistedEvent>& events) {
+    const std::string name(layout.name);
+    const size_t group_rows = std::max<size_t>(16, TOTAL / 12);
+    const auto t0 = steady_clock::now();
+
+    // One sync in the middle cuts a short group; a copy is taken while the writer is still open.
+    std::string path, live;
+    ColumnarEventLogStats stats;
+    {
+        ColumnarEventLog log(base + "_" + name, kIntMetrics, kDblMetrics, PersistMode::All, layout.compression,
+                             group_rows);
+        path = log.file_path();
+        for (const PersistedEvent& e : events) {
+            log.append_event(e.event_id, e.thread_id, e.per_thread_event_id, e.flags, e.category, e.payload,
+                             e.timestamp_us, e.int_metrics, e.dbl_metrics);
+            if (e.event_id == TOTAL / 2 + 3) log.sync();
+        }
+        log.sync();
+        live = copy_file(path, ".live");
+        log.finalize();
+        stats = log.stats();
+    }
+    const auto write_us = duration_cast<microseconds>(steady_clock::now() - t0).count();
+    check(stats.rows_written == TOTAL && stats.short_groups >= 1, name + ": writer stats");
+    if (layout.compression == BinaryCompression::Lz) {
+        check(stats.stored_bytes < stats.raw_bytes, name + ": no page was LZ-compressed");
+    }
+
+    const auto t1 = steady_clock::now();
+    std::vector<ColumnarIndexEntry> groups;
+    {
+        const ColumnarLogReader reader(path);
+        groups = reader.row_groups();
+        check(reader.finalized() && reader.row_count() == TOTAL && groups.size() == stats.row_groups,
+              name + ": footer index");
+        const ColumnarRead all = scan_columnar(reader, {}, events);
+        check(all.ids == id_range(0, TOTAL) && all.mismatches == 0 && all.stats.corrupt_groups == 0,
+              name + ": full scan did not read back every row");
+        test_columnar_pruning(reader, layout, events);
+    }
+    {
+        const ColumnarLogReader reader(live);
+        check(!reader.finalized() && reader.row_count() == TOTAL && reader.row_groups().size() == groups.size(),
+              name + ": unfinalized file does not walk to its last synced group");
+    }
+    fs::remove(live);
+
+    // Torn last group, with and without the zero tail of a preallocating file system.
+    const ColumnarIndexEntry& last = groups.back();
+    for (const size_t zeros : {size_t{0}, size_t{64 * 1024}}) {
+        const std::string torn = copy_file(path, ".torn");
+        const size_t cut = static_cast<size_t>(last.offset + last.group_bytes / 2);
+        fs::resize_file(torn, cut);
+        fs::resize_file(torn, cut + zeros);
+        const ColumnarLogReader reader(torn);
+        const ColumnarRead r = scan_columnar(reader, {}, events);
+        check(!reader.finalized() && reader.row_groups().size() == groups.size() - 1 &&
+                  r.ids == id_range(0, TOTAL - last.row_count) && r.mismatches == 0,
+              name + ": torn file does not keep its whole row groups");
+        fs::remove(torn);
+    }
+
+    // Damaged payload page in a middle group: only queries reading payloads lose that group.
+    if (groups.size() >= 3) {
+        const size_t k = groups.size() / 2;
+        const ColumnarIndexEntry& g = groups[k];
+        const std::string bytes = read_file(path);
+        ColumnarPageHeader ph{};
+        std::memcpy(&ph, bytes.data() + g.offset + sizeof(ColumnarRowGroupHeader) +
+                             ColumnarSchema::kPayload * sizeof(ColumnarPageHeader), sizeof(ph));
+        const std::string bad = copy_file(path, ".corrupt");
+        flip_byte(bad, static_cast<size_t>(g.offset + ph.offset + ph.stored_bytes / 2));
+        {
+            const ColumnarLogReader reader(bad);
+            ColumnarRead r = scan_columnar(reader, {}, events);
+            std::vector<uint64_t> want = id_range(0, g.min_event_id);
+            const std::vector<uint64_t> tail = id_range(g.max_event_id + 1, TOTAL);
+            want.insert(want.end(), tail.begin(), tail.end());
+            check(reader.finalized() && r.stats.corrupt_groups == 1 && r.ids == want && r.mismatches == 0,
+                  name + ": damaged page not contained to its row group");
+            ColumnarQuery q;
+            q.columns = {"event_id", "int0", "dbl0"};
+            r = scan_columnar(reader, q, events);
+            check(r.stats.corrupt_groups == 0 && r.ids == id_range(0, TOTAL) && r.mismatches == 0,
+                  name + ": query without the damaged column lost rows");
+        }
+
+        // Damaged row group header: the footer index is rejected and the walk stops before it.
+        fs::copy_file(path, bad, fs::copy_options::overwrite_existing);
+        flip_byte(bad, static_cast<size_t>(g.offset + offsetof(ColumnarRowGroupHeader, min_event_id)));
+        {
+            const ColumnarLogReader reader(bad);
+            const ColumnarRead r = scan_columnar(reader, {}, events);
+            check(!reader.finalized() && reader.row_groups().size() == k && r.ids == id_range(0, g.min_event_id) &&
+                      r.mismatches == 0,
+                  name + ": damaged row group header not caught");
+        }
+        fs::remove(bad);
+    } else {
+        std::cout << "    (" << name << ": " << groups.size() << " row groups, corrupt case needs 3)\n";
+    }
+    const auto check_us = duration_cast<microseconds>(steady_clock::now() - t1).count();
+
+    std::cout << "  " << name << ": " << format_locale_int(static_cast<std::uint64_t>(fs::file_size(path)))
+              << " bytes, " << groups.size() << " row groups, write "
+              << format_locale_int(static_cast<std::uint64_t>(write_us)) << " µs, checks "
+              << format_locale_int(static_cast<std::uint64_t>(check_us)) << " µs\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    auto opts = parse_test_options(argc, argv);
+
+    THREADS = opts.threads > 0 ? opts.threads : 10;
+    EVENTS_PER_THREAD = opts.events_per_thread > 0 ? opts.events_per_thread : 100;
+    // Pruning and corrupt-group cases need several row groups of a few rows each.
+    EVENTS_PER_THREAD = std::max<size_t>(EVENTS_PER_THREAD, (64 + THREADS - 1) / THREADS);
+    TOTAL = THREADS * EVENTS_PER_THREAD;
+    RUNS = opts.runs > 0 ? opts.runs : 1;
+
+    if (std::cin.rdbuf()->in_avail() > 0) {
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+
+    print_test_purpose();
+
+    const std::string bname = (opts.base_name.empty() ? "persist" : opts.base_name) + "_010";
+    if (const fs::path dir = fs::path(bname).parent_path(); !dir.empty()) fs::create_directories(dir);
+
+    std::mt19937_64 rng(10);
+    for (size_t run = 0; run < RUNS; ++run) {
+        std::cout << "\nRun " << (run + 1) << " / " << RUNS << "\n";
+        const std::vector<PersistedEvent> events = make_events(run + 1);
+
+        test_arrow(bname, events, rng);
+        for (const ColumnarLayout& layout : kColumnarLayouts) test_columnar(bname, layout, events);
+        if (run + 1 < RUNS) {   // the last run's files stay for inspection
+            fs::remove(bname + "_arrow.arrow");
+            for (const ColumnarLayout& layout : kColumnarLayouts) fs::remove(bname + "_" + std::string(layout.name) + ".tscol");
+        }
+    }
+
+    std::cout << "\n═══════════════════════════════════════════════════════════════\n";
+    if (failures != 0) {
+        std::cout << "  FAILED — " << failures << " format checks failed\n";
+        std::cout << "═══════════════════════════════════════════════════════════════\n";
+        return 1;
+    }
+    std::cout << "  PASS — " << format_locale_int(static_cast<std::uint64_t>(TOTAL))
+              << " events per file: round trip, pruning, torn tail and corrupt data verified\n";
+    std::cout << "═══════════════════════════════════════════════════════════════\n";
+    return 0;
+}
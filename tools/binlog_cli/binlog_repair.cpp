@@ -0,0 +1,108 @@
+// tools/binlog_cli/binlog_repair.cpp
+//
+// ts_binlog_repair - integrity check and crash repair for BinaryEventLog files.
+//
+// Invocation:
+//   ts_binlog_repair check  <file.bin>... [--threads N] [--salvage]
+//   ts_binlog_repair repair <file.bin>... [--threads N] [--salvage]
+//
+// check validates block framing, CRCs and record framing in parallel and prints the last
+// consistent offset; it never writes. repair cuts the file there, keeps intact blocks found after
+// the damage with --salvage, and rewrites the seek index footer. Exit status: 0 when every file
+// is (now) consistent, 1 when check found something to repair, 2 on errors.
+//
+// Library API: check_binary_log / repair_binary_log (BinaryLogRepair.hpp).
+
+#include <cstdlib>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <string>
+#include <vector>
+
+import jac.ts_store.persistence.binary;
+
+using namespace jac::ts_store::inline_v001;
+
+static void print_usage() {
+    std::cout << "ts_binlog_repair - check / repair binary event logs\n\n"
+              << "Usage:\n"
+              << "  ts_binlog_repair check  <file.bin>... [--threads N] [--salvage]\n"
+              << "  ts_binlog_repair repair <file.bin>... [--threads N] [--salvage]\n\n"
+              << "  --threads N   validation threads (default: all cores)\n"
+              << "  --salvage     keep intact blocks that follow a damaged one (v2 logs)\n";
+}
+
+static void print_report(const BinaryLogCheckReport& r) {
+    std::cout << std::format("{}: v{} {} bytes, {} blocks / {} records valid, max id {}\n",
+                             r.path, r.version, r.file_bytes, r.blocks_valid, r.records_valid, r.max_event_id);
+    std::cout << std::format("  consistent to {} of {}{}", r.consistent_end, r.data_end,
+                             r.finalized ? " (index footer present)" : "");
+    if (r.committed_bytes != 0) std::cout << std::format(", writer committed {}", r.committed_bytes);
+    std::cout << '\n';
+    if (!r.first_error.empty()) {
+        std::cout << std::format("  stopped at {}: {}\n", r.first_error_offset, r.first_error);
+    }
+    if (r.tail_bytes != 0) {
+        std::cout << std::format("  tail {} bytes{}\n", r.tail_bytes, r.tail_zero ? " (all zero: preallocated)" : "");
+    }
+    if (r.salvage_blocks != 0) {
+        std::cout << std::format("  salvageable: {} blocks / {} records after the damage\n",
+                                 r.salvage_blocks, r.salvage_records);
+    }
+    std::cout << std::format("  checked in {:.1f} ms on {} threads\n",
+                             static_cast<double>(r.elapsed.count()) / 1000.0, r.threads);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        print_usage();
+        return 2;
+    }
+    const std::string command = argv[1];
+    if (command != "check" && command != "repair") {
+        print_usage();
+        return 2;
+    }
+
+    BinaryLogCheckOptions options;
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (a == "--salvage") {
+            options.salvage = true;
+        } else if (a == "--threads" && i + 1 < argc) {
+            options.threads = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10));
+        } else if (a.starts_with("--")) {
+            std::cerr << "unknown option " << a << '\n';
+            return 2;
+        } else {
+            files.push_back(a);
+        }
+    }
+
+    int status = 0;
+    for (const std::string& f : files) {
+        try {
+            if (command == "check") {
+                const BinaryLogCheckReport r = check_binary_log(f, options);
+                print_report(r);
+                if (r.needs_repair()) status = std::max(status, 1);
+            } else {
+                const BinaryLogRepairResult res = repair_binary_log(f, options);
+                print_report(res.check);
+                if (!res.changed) {
+                    std::cout << "  nothing to repair\n";
+                } else {
+                    std::cout << std::format("  repaired: {} -> {} bytes, kept {} blocks / {} records, dropped {} bytes{}\n",
+                                             res.size_before, res.size_after, res.blocks_kept, res.records_kept,
+                                             res.dropped_bytes, res.index_written ? ", index rewritten" : "");
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << f << ": " << e.what() << '\n';
+            status = 2;
+        }
+    }
+    return status;
+}